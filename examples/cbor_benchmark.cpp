@@ -0,0 +1,238 @@
+// JSON vs CBOR wire benchmark
+// Replays a recorded CDP session (one JSON message per line) through a real pipe
+// into PipeTransport in both wire formats and measures end-to-end decode throughput.
+//
+// Usage: cdp_cbor_benchmark [session.jsonl] [rounds]
+// Without a session file a synthetic one is generated (screencast frames,
+// network events and command responses).
+
+#include <cdp/CDP.hpp>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <random>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+using namespace cdp;
+
+namespace {
+
+struct WireResult {
+    size_t bytes = 0;
+    size_t messages = 0;
+    double encodeMs = 0;
+    double transferMs = 0;
+};
+
+std::vector<JsonValue> loadSession(const std::string& path) {
+    std::vector<JsonValue> messages;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        try {
+            messages.push_back(JsonValue::parse(line));
+        } catch (const std::exception& e) {
+            std::cerr << "Skipping malformed line: " << e.what() << "\n";
+        }
+    }
+    return messages;
+}
+
+std::vector<JsonValue> syntheticSession() {
+    std::vector<JsonValue> messages;
+    std::mt19937 rng(42);
+    std::string frame(96 * 1024, '\0');
+    for (auto& c : frame) c = static_cast<char>(rng() & 0xff);
+    std::string frameBase64 = Base64::encode(frame);
+
+    for (int i = 0; i < 2000; i++) {
+        if (i % 10 == 0) {
+            // Page.screencastFrame: binary payload, Chrome tags it in CBOR
+            JsonObject metadata;
+            metadata["offsetTop"] = 0.0;
+            metadata["pageScaleFactor"] = 1.0;
+            metadata["deviceWidth"] = 1280.0;
+            metadata["deviceHeight"] = 720.0;
+            metadata["timestamp"] = 1700000000.0 + i * 0.016;
+            JsonObject params;
+            params["data"] = frameBase64;
+            params["metadata"] = metadata;
+            params["sessionId"] = static_cast<double>(i);
+            JsonObject msg;
+            msg["method"] = "Page.screencastFrame";
+            msg["params"] = params;
+            messages.push_back(JsonValue(msg));
+        } else if (i % 3 == 0) {
+            // Command response with mostly numeric content
+            JsonArray quads;
+            for (int q = 0; q < 8; q++) quads.push_back(JsonValue(static_cast<double>(q * 17 + i)));
+            JsonObject result;
+            result["quads"] = quads;
+            result["nodeId"] = static_cast<double>(i);
+            JsonObject msg;
+            msg["id"] = static_cast<double>(i);
+            msg["result"] = result;
+            messages.push_back(JsonValue(msg));
+        } else {
+            // Network.responseReceived-style event
+            JsonObject headers;
+            headers["content-type"] = "text/html; charset=utf-8";
+            headers["cache-control"] = "max-age=3600";
+            headers["server"] = "benchmark";
+            JsonObject timing;
+            timing["requestTime"] = 12345.678 + i;
+            timing["dnsStart"] = 0.25;
+            timing["dnsEnd"] = 1.5;
+            timing["connectStart"] = 1.5;
+            timing["connectEnd"] = 12.75;
+            timing["sendStart"] = 13.0;
+            timing["receiveHeadersEnd"] = 42.125;
+            JsonObject response;
+            response["url"] = "https://example.com/resource/" + std::to_string(i);
+            response["status"] = 200.0;
+            response["statusText"] = "OK";
+            response["headers"] = headers;
+            response["mimeType"] = "text/html";
+            response["timing"] = timing;
+            response["encodedDataLength"] = static_cast<double>(1024 + i);
+            JsonObject params;
+            params["requestId"] = "1000." + std::to_string(i);
+            params["loaderId"] = "LOADER";
+            params["timestamp"] = 1700000000.0 + i;
+            params["type"] = "Document";
+            params["response"] = response;
+            JsonObject msg;
+            msg["method"] = "Network.responseReceived";
+            msg["params"] = params;
+            messages.push_back(JsonValue(msg));
+        }
+    }
+    return messages;
+}
+
+double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+#if !defined(_WIN32)
+
+WireResult runWire(const std::vector<JsonValue>& session, WireFormat format, int rounds) {
+    WireResult result;
+
+    // Encode the session as Chrome would put it on the wire
+    CborEncodeOptions cborOptions;
+    cborOptions.binaryKeys = {"data"};
+    std::string wire;
+    auto encodeStart = std::chrono::steady_clock::now();
+    for (const auto& msg : session) {
+        if (format == WireFormat::Cbor) {
+            Cbor::encode(msg, wire, cborOptions);
+        } else {
+            wire += msg.serialize();
+            wire += '\0';
+        }
+    }
+    result.encodeMs = msSince(encodeStart);
+    result.bytes = wire.size();
+
+    for (int round = 0; round < rounds; round++) {
+        int fromBrowser[2];
+        int toBrowser[2];
+        if (pipe(fromBrowser) != 0 || pipe(toBrowser) != 0) {
+            std::cerr << "pipe() failed\n";
+            return result;
+        }
+
+        PipeTransport transport(fromBrowser[0], toBrowser[1], format);
+        size_t received = 0;
+        TransportCallbacks callbacks;
+        callbacks.onMessage = [&](const std::string& message) {
+            JsonValue json = format == WireFormat::Cbor ? Cbor::decode(message) : JsonValue::parse(message);
+            if (json["method"].getString() == "Page.screencastFrame") {
+                Base64::decode(json["params"]["data"].getString());
+            }
+            received++;
+        };
+        transport.setCallbacks(callbacks);
+
+        auto start = std::chrono::steady_clock::now();
+        std::thread writer([&] {
+            size_t offset = 0;
+            while (offset < wire.size()) {
+                ssize_t n = write(fromBrowser[1], wire.data() + offset, wire.size() - offset);
+                if (n <= 0) break;
+                offset += static_cast<size_t>(n);
+            }
+            close(fromBrowser[1]);
+        });
+
+        while (transport.isConnected() && received < session.size()) {
+            transport.pollAll(100);
+        }
+        writer.join();
+        result.transferMs += msSince(start);
+        result.messages += received;
+        close(toBrowser[0]);
+    }
+    return result;
+}
+
+#endif
+
+void report(const char* name, const WireResult& r, int rounds) {
+    double seconds = r.transferMs / 1000.0;
+    double bytes = static_cast<double>(r.bytes);
+    std::cout << std::left << std::setw(6) << name
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << bytes / 1024.0 << " KB"
+              << std::setw(12) << r.encodeMs << " ms"
+              << std::setw(12) << r.transferMs / rounds << " ms"
+              << std::setw(12) << (seconds > 0 ? bytes * rounds / seconds / (1024.0 * 1024.0) : 0) << " MB/s"
+              << std::setw(12) << std::setprecision(0) << (seconds > 0 ? static_cast<double>(r.messages) / seconds : 0) << " msg/s\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+#if defined(_WIN32)
+    (void)argc;
+    (void)argv;
+    std::cout << "The pipe benchmark requires a POSIX platform\n";
+    return 0;
+#else
+    std::vector<JsonValue> session = argc > 1 ? loadSession(argv[1]) : syntheticSession();
+    int rounds = argc > 2 ? (std::max)(1, std::atoi(argv[2])) : 5;
+    if (session.empty()) {
+        std::cerr << "No messages to replay\n";
+        return 1;
+    }
+
+    std::cout << "Replaying " << session.size() << " messages x " << rounds << " rounds\n\n";
+    std::cout << std::left << std::setw(6) << "wire" << std::right
+              << std::setw(15) << "size" << std::setw(15) << "encode"
+              << std::setw(15) << "round" << std::setw(17) << "throughput"
+              << std::setw(18) << "rate" << "\n";
+
+    WireResult json = runWire(session, WireFormat::Json, rounds);
+    WireResult cbor = runWire(session, WireFormat::Cbor, rounds);
+    report("json", json, rounds);
+    report("cbor", cbor, rounds);
+
+    if (json.messages != cbor.messages) {
+        std::cerr << "\nMessage count mismatch: json=" << json.messages << " cbor=" << cbor.messages << "\n";
+        return 1;
+    }
+
+    std::cout << "\ncbor/json size " << std::setprecision(2) << static_cast<double>(cbor.bytes) / static_cast<double>(json.bytes)
+              << ", time " << cbor.transferMs / json.transferMs << "\n";
+    return 0;
+#endif
+}
@@ -5,6 +5,7 @@
 
 #include "core/Json.hpp"
 #include "core/Base64.hpp"
+#include "core/Cbor.hpp"
 #include "core/SHA1.hpp"
 #include "core/TypedResponses.hpp"
 #include "core/Enums.hpp"
@@ -14,6 +15,9 @@
 #include "net/Socket.hpp"
 #include "net/HttpClient.hpp"
 #include "net/WebSocket.hpp"
+#include "net/Transport.hpp"
+#include "net/PipeTransport.hpp"
+#include "net/SessionTransport.hpp"
 
 
 #include "protocol/CDPConnection.hpp"
@@ -22,6 +26,8 @@
 
 #include "browser/ChromeLauncher.hpp"
 #include "browser/ExtensionLoader.hpp"
+#include "browser/ProfileTemplate.hpp"
+#include "browser/ProcessMonitor.hpp"
 #include "browser/QuickStart.hpp"
 
 
@@ -29,7 +35,19 @@
 #include "highlevel/Page.hpp"
 #include "highlevel/ElementHandle.hpp"
 #include "highlevel/Browser.hpp"
+#include "highlevel/StreamReader.hpp"
+#include "highlevel/Screencast.hpp"
+#include "highlevel/VideoWriter.hpp"
+#include "highlevel/ImageDiff.hpp"
+#include "highlevel/UrlMatcher.hpp"
 #include "highlevel/NetworkInterceptor.hpp"
+#include "highlevel/FixtureBundle.hpp"
+#include "highlevel/ResponseCache.hpp"
+#include "highlevel/AdblockEngine.hpp"
+#include "highlevel/NetworkCapture.hpp"
+#include "highlevel/HarReplayer.hpp"
+#include "highlevel/PagePool.hpp"
+#include "highlevel/BrowserFleet.hpp"
 #include "highlevel/InputHelpers.hpp"
 #include "highlevel/Frame.hpp"
 #include "highlevel/Async.hpp"
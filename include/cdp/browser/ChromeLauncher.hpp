@@ -2,8 +2,10 @@
 
 #pragma once
 
-
+#include "../net/PipeTransport.hpp"
+#include "ProcessMonitor.hpp"
 #include <string>
+#include <memory>
 #include <vector>
 #include <optional>
 #include <functional>
@@ -63,11 +65,15 @@ struct ChromeLaunchOptions {
     
     int debuggingPort = 0;              
     std::string host = "127.0.0.1";     
+    bool remoteDebuggingPipe = false;   
+    bool pipeCbor = false;              
 
     
     bool useTempProfile = true;         
     std::string userDataDir;            
     std::string tempProfilePrefix = "cdp_chrome_";  
+    std::string tempProfileRoot;        
+    std::string profileTemplateDir;     
 
     
     bool headless = false;              
@@ -108,6 +114,7 @@ struct ChromeLaunchOptions {
 
     
     bool cleanupTempProfile = true;     
+    bool asyncProfileCleanup = true;    
     bool killOnDestruct = true;         
 
     
@@ -204,7 +211,13 @@ public:
     static int findFreePort();
 
     
-    static int cleanupStaleTempProfiles(const std::string& prefix = "cdp_chrome_");
+    static int cleanupStaleTempProfiles(const std::string& prefix = "cdp_chrome_",
+                                        const std::string& directory = "");
+
+#ifndef _WIN32
+    // Consumes complete stderr lines from pending; returns the browser WebSocket URL once seen.
+    static std::optional<std::string> scanStderr(std::string& pending, std::string& lastLine);
+#endif
 
     
     [[nodiscard]] bool launch();
@@ -251,17 +264,36 @@ public:
     
     const std::string& lastError() const { return lastError_; }
 
+    
+    std::unique_ptr<PipeTransport> takePipeTransport() { return std::move(pipeTransport_); }
+
+    
+    ProcessMonitor* startProcessMonitor(const ProcessMonitorOptions& options = {});
+    ProcessMonitor* processMonitor() const { return processMonitor_.get(); }
+    ProcessTreeSample sampleProcessTree(bool collectPss = false) const;
+
 private:
     bool startProcess(const std::string& chromePath, const std::vector<std::string>& args);
     bool createTempProfile();
     void cleanupTempProfile();
     bool checkEndpointReady();
+#ifndef _WIN32
+    bool pollEndpointReady(int timeoutMs);
+    bool waitForProcessExit(int timeoutMs);
+    bool reapProcess(bool block);
+    void closeProcessFds();
+    void startStderrPump(const std::string& pending);
+
+    struct StderrPump;
+#endif
 
     ChromeLaunchOptions options_;
     ChromeInstallation installation_;
     std::string userDataDir_;
     std::string lastError_;
     std::atomic<bool> launched_{false};
+    std::unique_ptr<PipeTransport> pipeTransport_;
+    std::unique_ptr<ProcessMonitor> processMonitor_;
 
 #ifdef _WIN32
     HANDLE processHandle_ = nullptr;
@@ -269,6 +301,13 @@ private:
     DWORD processId_ = 0;
 #else
     int processId_ = 0;
+    int pidFd_ = -1;
+    int stderrFd_ = -1;
+    bool exited_ = false;
+    int exitStatus_ = 0;
+    std::string browserWsUrl_;
+    std::string stderrTail_;
+    std::unique_ptr<StderrPump> stderrPump_;
 #endif
 };
 
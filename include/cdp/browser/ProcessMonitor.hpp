@@ -0,0 +1,133 @@
+#pragma once
+
+#include "../core/Json.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <optional>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+namespace cdp {
+
+
+struct ProcessSample {
+    uint32_t pid = 0;
+    uint32_t parentPid = 0;
+    std::string type;
+    std::string subType;
+    double cpuSeconds = 0;
+    double cpuPercent = 0;
+    uint64_t rssBytes = 0;
+    uint64_t pssBytes = 0;
+    size_t openFds = 0;
+    size_t threads = 0;
+};
+
+
+struct ProcStat {
+    uint32_t parentPid = 0;
+    uint64_t cpuTicks = 0;
+    uint64_t startTime = 0;
+    uint64_t rssPages = 0;
+    size_t threads = 0;
+    std::string command;
+};
+
+
+struct ProcessTreeSample {
+    std::chrono::system_clock::time_point timestamp;
+    std::vector<ProcessSample> processes;
+    double cpuPercent = 0;
+    uint64_t rssBytes = 0;
+    uint64_t pssBytes = 0;
+    size_t openFds = 0;
+
+
+    uint64_t rssBytesOfType(const std::string& type) const;
+    size_t countOfType(const std::string& type) const;
+};
+
+
+struct ProcessMonitorOptions {
+    int intervalMs = 1000;
+    size_t historySize = 600;
+    bool collectPss = true;
+    int pssEverySamples = 5;
+    bool collectFds = true;
+    int processInfoEverySamples = 10;
+};
+
+
+class ProcessMonitor {
+public:
+    using SampleCallback = std::function<void(const ProcessTreeSample&)>;
+    using ProcessInfoProvider = std::function<JsonValue()>;
+
+    explicit ProcessMonitor(uint32_t rootPid, const ProcessMonitorOptions& options = {});
+    ~ProcessMonitor();
+
+    ProcessMonitor(const ProcessMonitor&) = delete;
+    ProcessMonitor& operator=(const ProcessMonitor&) = delete;
+
+
+    bool start();
+    void stop();
+    bool isRunning() const;
+
+
+    ProcessTreeSample sampleNow();
+
+
+    std::optional<ProcessTreeSample> latest() const;
+    std::vector<ProcessTreeSample> history(size_t maxSamples = 0) const;
+
+    void onSample(SampleCallback callback);
+
+
+    void setProcessInfoProvider(ProcessInfoProvider provider);
+
+    uint32_t rootPid() const { return rootPid_; }
+    const ProcessMonitorOptions& options() const { return options_; }
+
+
+    static std::vector<uint32_t> listProcessTree(uint32_t rootPid);
+    static ProcessTreeSample sampleTree(uint32_t rootPid, bool collectPss = false, bool collectFds = true);
+    // Parses the contents of /proc/<pid>/stat; the command may contain spaces and parentheses.
+    static bool parseStat(const std::string& stat, ProcStat& fields);
+
+private:
+    struct Tracked {
+        uint64_t startTime = 0;
+        uint64_t cpuTicks = 0;
+        uint64_t pssBytes = 0;
+        std::string command;
+        std::string type;
+        std::string subType;
+    };
+
+    void run();
+    void applyProcessInfo(const JsonValue& info);
+
+    uint32_t rootPid_;
+    ProcessMonitorOptions options_;
+    std::map<uint32_t, Tracked> tracked_;
+    std::map<uint32_t, std::string> reportedTypes_;
+    std::chrono::steady_clock::time_point lastSampleTime_;
+    uint64_t sampleCount_ = 0;
+    ProcessInfoProvider processInfoProvider_;
+    SampleCallback callback_;
+    std::deque<ProcessTreeSample> history_;
+    std::mutex sampleMutex_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    bool running_ = false;
+    std::thread thread_;
+};
+
+}
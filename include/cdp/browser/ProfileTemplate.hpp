@@ -0,0 +1,84 @@
+#pragma once
+
+#include "ChromeLauncher.hpp"
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+
+namespace cdp {
+
+
+struct ProfileCloneStats {
+    size_t files = 0;
+    size_t directories = 0;
+    size_t reflinked = 0;
+    uint64_t bytes = 0;
+    double elapsedMs = 0;
+};
+
+
+class ProfileTemplate {
+public:
+    explicit ProfileTemplate(std::string dir);
+
+
+    bool prepare(const ChromeLaunchOptions& options);
+    bool isPrepared() const;
+    // Prepared with the same extensions and extension flags as options.
+    bool matches(const ChromeLaunchOptions& options) const;
+
+
+    bool cloneTo(const std::string& destDir, ProfileCloneStats* stats = nullptr);
+
+    const std::string& dir() const { return dir_; }
+    const std::string& lastError() const { return lastError_; }
+
+
+    static std::string preferredRoot();
+    static std::string extensionKey(const ChromeLaunchOptions& options);
+
+    static constexpr const char* kMarkerFile = ".cdp_profile_template";
+
+private:
+    void stripRuntimeState();
+
+    std::string dir_;
+    std::string lastError_;
+};
+
+
+class ProfileDeleter {
+public:
+    static ProfileDeleter& instance();
+
+    ProfileDeleter(const ProfileDeleter&) = delete;
+    ProfileDeleter& operator=(const ProfileDeleter&) = delete;
+
+
+    void remove(const std::string& path);
+    void flush();
+    size_t pending() const;
+    // Finishes queued deletions and joins the worker; the instance is never destroyed.
+    void shutdown();
+
+private:
+    ProfileDeleter() = default;
+    ~ProfileDeleter() = default;
+
+    void run();
+
+    std::deque<std::string> queue_;
+    std::string current_;
+    bool busy_ = false;
+    bool stopping_ = false;
+    uint64_t counter_ = 0;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::thread thread_;
+};
+
+}
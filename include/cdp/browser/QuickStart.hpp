@@ -3,6 +3,7 @@
 
 #include "ChromeLauncher.hpp"
 #include "../protocol/CDPClient.hpp"
+#include "../net/SessionTransport.hpp"
 #include "../highlevel/Page.hpp"
 #include "../highlevel/Result.hpp"
 #include <memory>
@@ -457,6 +458,7 @@ private:
 
     
     PageResult createPageInContext(const std::string& url, const std::string& contextId);
+    bool attachPageClient(CDPClient& client, const std::string& targetId, std::string& error);
 
     std::unique_ptr<ChromeLauncher> launcher_;
     CDPClientConfig config_;
@@ -470,6 +472,8 @@ private:
     bool fetchEnabled_ = false;
     FetchHandler fetchHandler_;
     std::vector<RequestPattern> fetchPatterns_;
+
+    std::shared_ptr<SessionRouter> sessions_;
 };
 
 
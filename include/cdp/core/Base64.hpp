@@ -2,12 +2,16 @@
 
 #include <string>
 #include <vector>
+#include <functional>
 #include <cstdint>
+#include <cstddef>
 
 namespace cdp {
 
 class Base64 {
 public:
+    using Sink = std::function<bool(const uint8_t* data, size_t length)>;
+
     static std::string encode(const std::string& input);
     static std::string encode(const uint8_t* data, size_t len);
     static std::string encode(const std::vector<uint8_t>& data);
@@ -15,10 +19,43 @@ public:
     static std::vector<uint8_t> decode(const std::string& input);
     static std::string decodeToString(const std::string& input);
 
+
+    static size_t decode(const char* input, size_t len, uint8_t* out);
+    static constexpr size_t decodedSizeBound(size_t len) { return ((len + 3) / 4) * 3; }
+
+
+    static bool decodeTo(const char* input, size_t len, const Sink& sink);
+    static bool decodeTo(const std::string& input, const Sink& sink) {
+        return decodeTo(input.data(), input.size(), sink);
+    }
+    static bool decodeToFile(const std::string& input, const std::string& path);
+
 private:
     static constexpr char ALPHABET[] =
         "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
     static constexpr char PAD = '=';
 };
 
-} 
+
+class Base64Decoder {
+public:
+
+    size_t feed(const char* input, size_t len, uint8_t* out);
+    bool feed(const char* input, size_t len, const Base64::Sink& sink);
+
+
+    size_t finish(uint8_t* out);
+    bool finish(const Base64::Sink& sink);
+
+    void reset() { pending_ = 0; pendingCount_ = 0; }
+
+    static constexpr size_t maxOutput(size_t len) { return ((len + 3) * 3) / 4; }
+
+private:
+    size_t flushPartial(uint8_t* out);
+
+    uint32_t pending_ = 0;
+    int pendingCount_ = 0;
+};
+
+}
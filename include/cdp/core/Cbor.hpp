@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Json.hpp"
+#include <string>
+#include <string_view>
+#include <set>
+#include <cstdint>
+#include <cstddef>
+
+namespace cdp {
+
+
+struct CborEncodeOptions {
+    bool envelopes = true;
+    std::set<std::string> binaryKeys;
+};
+
+
+class Cbor {
+public:
+    static std::string encode(const JsonValue& value, const CborEncodeOptions& options = {});
+    static void encode(const JsonValue& value, std::string& out, const CborEncodeOptions& options = {});
+    // Encoding for a command's message: its protocol-typed binary params are sent as byte strings.
+    static const CborEncodeOptions& commandOptions(std::string_view method);
+
+
+    static JsonValue decode(const std::string& data);
+    static JsonValue decode(const uint8_t* data, size_t size);
+
+
+    static int64_t messageSize(const uint8_t* data, size_t available);
+
+
+    static size_t beginMap(std::string& out, bool envelope = true);
+    static void endMap(std::string& out, size_t envelopeAt);
+    static void appendString(std::string& out, std::string_view s);
+    static void appendInteger(std::string& out, int64_t value);
+    static void encodeEntries(const JsonObject& entries, std::string& out, const CborEncodeOptions& options = {});
+
+    static constexpr uint8_t kEnvelopeTag = 24;
+    static constexpr uint8_t kBinaryTag = 22;
+};
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace cdp {
+
+
+class Inflater {
+public:
+    explicit Inflater(bool zlibHeader = true);
+
+
+    void addInput(const uint8_t* data, size_t len);
+    // Until finish() is called, running out of input suspends read() instead of failing.
+    void finish() { inputEnded_ = true; }
+
+    size_t read(uint8_t* out, size_t len);
+
+    bool done() const { return state_ == State::Done; }
+    bool failed() const { return state_ == State::Error; }
+    bool needsInput() const { return state_ != State::Done && state_ != State::Error && starved_; }
+    const std::string& error() const { return error_; }
+    uint64_t totalOut() const { return totalOut_; }
+
+    static bool inflate(const uint8_t* data, size_t len, std::vector<uint8_t>& out, bool zlibHeader = true);
+
+private:
+    static constexpr int kFastBits = 9;
+
+    struct Huffman {
+        uint16_t counts[16];
+        uint16_t symbols[288];
+        uint16_t fast[1 << kFastBits];
+    };
+
+    enum class State { ZlibHeader, BlockHeader, Stored, Compressed, Trailer, Done, Error };
+
+    struct Checkpoint {
+        size_t inputIndex;
+        size_t inputPos;
+        uint64_t bitBuf;
+        int bitCount;
+        bool finalBlock;
+    };
+
+    bool fill(int bits);
+    uint32_t getBits(int bits);
+    bool build(Huffman& h, const uint8_t* lengths, int count);
+    int decode(const Huffman& h);
+    bool readBlockHeader();
+    bool readDynamicTables();
+    bool readTrailer();
+    void updateAdler(const uint8_t* data, size_t len);
+    size_t decompress(uint8_t* out, size_t len);
+    Checkpoint checkpoint() const;
+    void rewind(const Checkpoint& cp);
+    void fail(const std::string& message);
+
+    std::vector<std::pair<const uint8_t*, size_t>> inputs_;
+    size_t inputIndex_ = 0;
+    size_t inputPos_ = 0;
+    uint64_t bitBuf_ = 0;
+    int bitCount_ = 0;
+    bool inputEnded_ = false;
+    bool starved_ = false;
+
+    State state_;
+    bool zlibHeader_;
+    bool finalBlock_ = false;
+    uint32_t storedRemaining_ = 0;
+    uint32_t matchLength_ = 0;
+    uint32_t matchDistance_ = 0;
+
+    Huffman lit_;
+    Huffman dist_;
+    std::vector<uint8_t> window_;
+    uint64_t totalOut_ = 0;
+    uint32_t adlerA_ = 1;
+    uint32_t adlerB_ = 0;
+    std::string error_;
+};
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Inflate.hpp"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace cdp {
+
+
+class PngDecoder {
+public:
+    PngDecoder() = default;
+
+
+    bool open(const uint8_t* data, size_t len);
+    bool open(const std::vector<uint8_t>& data) { return open(data.data(), data.size()); }
+
+
+    bool readRow(uint8_t* rgba);
+
+    void setMaxPixels(uint64_t maxPixels) { maxPixels_ = maxPixels; }
+    uint64_t maxPixels() const { return maxPixels_; }
+    static constexpr uint64_t kDefaultMaxPixels = uint64_t{1} << 28;
+    static constexpr int kMaxDimension = 1 << 24;
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int rowsRead() const { return row_; }
+    const std::string& error() const { return error_; }
+
+    static bool decode(const uint8_t* data, size_t len, std::vector<uint8_t>& rgba,
+                       int& width, int& height);
+
+private:
+    bool fail(const std::string& message);
+    void unfilter(uint8_t filter);
+    void expandRow(uint8_t* rgba) const;
+    uint32_t sample(const uint8_t* row, int index) const;
+
+    Inflater inflater_;
+    int width_ = 0;
+    int height_ = 0;
+    int bitDepth_ = 0;
+    int colorType_ = 0;
+    int channels_ = 0;
+    int filterBpp_ = 0;
+    size_t rowBytes_ = 0;
+    int row_ = 0;
+    uint64_t maxPixels_ = kDefaultMaxPixels;
+
+    std::vector<uint8_t> current_;
+    std::vector<uint8_t> previous_;
+    uint8_t palette_[256 * 4] = {};
+    bool hasTransparentKey_ = false;
+    uint16_t transparentKey_[3] = {};
+    std::string error_;
+};
+
+}
@@ -81,62 +81,7 @@ private:
 };
 
 
-class EventToken {
-public:
-    EventToken() = default;
-
-    EventToken(CDPConnection* conn, std::string eventName)
-        : connection_(conn), eventName_(std::move(eventName)), active_(true) {}
-
-    
-    EventToken(const EventToken&) = delete;
-    EventToken& operator=(const EventToken&) = delete;
-
-    EventToken(EventToken&& other) noexcept
-        : connection_(other.connection_), eventName_(std::move(other.eventName_)), active_(other.active_) {
-        other.connection_ = nullptr;
-        other.active_ = false;
-    }
-
-    EventToken& operator=(EventToken&& other) noexcept {
-        if (this != &other) {
-            release();
-            connection_ = other.connection_;
-            eventName_ = std::move(other.eventName_);
-            active_ = other.active_;
-            other.connection_ = nullptr;
-            other.active_ = false;
-        }
-        return *this;
-    }
-
-    ~EventToken() {
-        release();
-    }
-
-    
-    void release() {
-        if (active_ && connection_) {
-            
-            
-            connection_->removeEventHandler(eventName_);
-            active_ = false;
-            connection_ = nullptr;  
-        }
-    }
-
-    
-    bool isActive() const { return active_; }
-    explicit operator bool() const { return active_; }
-
-    
-    const std::string& eventName() const { return eventName_; }
-
-private:
-    CDPConnection* connection_ = nullptr;
-    std::string eventName_;
-    bool active_ = false;
-};
+using EventToken = CDPConnection::EventToken;
 
 
 class Domain {
@@ -212,9 +157,7 @@ public:
 
     
     [[nodiscard]] EventToken onScoped(const std::string& event, EventCallback callback) {
-        std::string fullEvent = domainName_ + "." + event;
-        connection_.onEvent(fullEvent, std::move(callback));
-        return EventToken(&connection_, fullEvent);
+        return connection_.onEventScoped(domainName_ + "." + event, std::move(callback));
     }
 
     
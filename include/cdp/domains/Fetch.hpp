@@ -21,6 +21,8 @@ struct RequestPattern {
     static RequestPattern all() { return {"*", "", "Request"}; }
     static RequestPattern url(const std::string& pattern) { return {pattern, "", "Request"}; }
     static RequestPattern type(const std::string& resType) { return {"*", resType, "Request"}; }
+
+    bool operator==(const RequestPattern& other) const = default;
 };
 
 
@@ -140,6 +142,19 @@ public:
     }
 
     
+    CDPResponse setPatterns(const std::vector<RequestPattern>& patterns) {
+        currentPatterns_ = patterns;
+        return call("enable", patternParams(patterns));
+    }
+
+    int64_t setPatternsAsync(const std::vector<RequestPattern>& patterns, ResponseCallback callback = nullptr) {
+        currentPatterns_ = patterns;
+        return callAsync("enable", patternParams(patterns), callback);
+    }
+
+    const std::vector<RequestPattern>& patterns() const { return currentPatterns_; }
+
+    
     CDPResponse disable() {
         authHandlingRequired_ = false;
         currentPatterns_.clear();
@@ -237,8 +252,8 @@ public:
     }
 
     
-    void continueRequestAsync(const std::string& requestId) {
-        callAsync("continueRequest", Params().set("requestId", requestId));
+    void continueRequestAsync(const std::string& requestId, ResponseCallback callback = nullptr) {
+        callAsync("continueRequest", Params().set("requestId", requestId), callback);
     }
 
     
@@ -246,7 +261,8 @@ public:
                                const std::vector<HeaderEntry>& headers,
                                const std::string& url = "",
                                const std::string& method = "",
-                               const std::string& postData = "") {
+                               const std::string& postData = "",
+                               ResponseCallback callback = nullptr) {
         Params params;
         params.set("requestId", requestId);
         if (!url.empty()) params.set("url", url);
@@ -257,14 +273,15 @@ public:
             for (const auto& h : headers) arr.push_back(h.toJson());
             params.set("headers", arr);
         }
-        callAsync("continueRequest", params);
+        callAsync("continueRequest", params, callback);
     }
 
     
-    void failRequestAsync(const std::string& requestId, const std::string& errorReason) {
+    void failRequestAsync(const std::string& requestId, const std::string& errorReason,
+                          ResponseCallback callback = nullptr) {
         callAsync("failRequest", Params()
             .set("requestId", requestId)
-            .set("errorReason", errorReason));
+            .set("errorReason", errorReason), callback);
     }
 
     
@@ -273,7 +290,8 @@ public:
                               const std::vector<HeaderEntry>& responseHeaders = {},
                               const std::string& body = "",
                               const std::string& responsePhrase = "",
-                              const std::string& binaryResponseHeaders = "") {
+                              const std::string& binaryResponseHeaders = "",
+                              ResponseCallback callback = nullptr) {
         Params params;
         params.set("requestId", requestId);
         params.set("responseCode", responseCode);
@@ -287,7 +305,7 @@ public:
         if (!body.empty()) params.set("body", body);
         if (!responsePhrase.empty()) params.set("responsePhrase", responsePhrase);
 
-        callAsync("fulfillRequest", params);
+        callAsync("fulfillRequest", params, callback);
     }
 
     
@@ -295,7 +313,8 @@ public:
                                 int responseCode = 0,
                                 const std::string& responsePhrase = "",
                                 const std::vector<HeaderEntry>& responseHeaders = {},
-                                const std::string& binaryResponseHeaders = "") {
+                                const std::string& binaryResponseHeaders = "",
+                                ResponseCallback callback = nullptr) {
         Params params;
         params.set("requestId", requestId);
         if (responseCode > 0) params.set("responseCode", responseCode);
@@ -306,7 +325,7 @@ public:
             params.set("responseHeaders", arr);
         }
         if (!binaryResponseHeaders.empty()) params.set("binaryResponseHeaders", binaryResponseHeaders);
-        callAsync("continueResponse", params);
+        callAsync("continueResponse", params, callback);
     }
 
     
@@ -322,11 +341,19 @@ public:
         return call("getResponseBody", Params().set("requestId", requestId));
     }
 
+    int64_t getResponseBodyAsync(const std::string& requestId, ResponseCallback callback) {
+        return callAsync("getResponseBody", Params().set("requestId", requestId), callback);
+    }
+
     
     CDPResponse takeResponseBodyAsStream(const std::string& requestId) {
         return call("takeResponseBodyAsStream", Params().set("requestId", requestId));
     }
 
+    int64_t takeResponseBodyAsStreamAsync(const std::string& requestId, ResponseCallback callback) {
+        return callAsync("takeResponseBodyAsStream", Params().set("requestId", requestId), callback);
+    }
+
     
     void onRequestPaused(std::function<void(const std::string& requestId,
                                              const JsonValue& request,
@@ -369,6 +396,17 @@ public:
     }
 
 private:
+    Params patternParams(const std::vector<RequestPattern>& patterns) const {
+        JsonArray arr;
+        for (const auto& p : patterns) arr.push_back(p.toJson());
+        Params params;
+        params.set("patterns", arr);
+        if (authHandlingRequired_) {
+            params.set("handleAuthRequests", true);
+        }
+        return params;
+    }
+
     bool authHandlingRequired_ = false;
     std::vector<RequestPattern> currentPatterns_;
 };
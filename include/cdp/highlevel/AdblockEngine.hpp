@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../core/MappedFile.hpp"
+#include "Result.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace cdp {
+namespace highlevel {
+
+
+struct AdblockStats {
+    size_t filters = 0;
+    size_t exceptions = 0;
+    size_t untokenized = 0;
+    size_t comments = 0;
+    size_t cosmetic = 0;
+    size_t unsupported = 0;
+};
+
+
+struct AdblockMatch {
+    bool blocked = false;
+    bool excepted = false;
+    std::string_view filter;
+};
+
+
+class AdblockEngine {
+public:
+    static Result<std::shared_ptr<AdblockEngine>> compile(std::string_view rules);
+    static Result<std::shared_ptr<AdblockEngine>> compileFiles(const std::vector<std::string>& paths);
+
+
+    static Result<std::shared_ptr<AdblockEngine>> open(const std::string& path);
+    Result<void> save(const std::string& path) const;
+
+
+    AdblockMatch match(std::string_view url, std::string_view resourceType = {},
+                       std::string_view sourceUrl = {}) const;
+    bool shouldBlock(std::string_view url, std::string_view resourceType = {},
+                     std::string_view sourceUrl = {}) const {
+        return match(url, resourceType, sourceUrl).blocked;
+    }
+
+    const AdblockStats& stats() const { return stats_; }
+    size_t sizeBytes() const { return size_; }
+
+private:
+    AdblockEngine() = default;
+
+    bool attach(const uint8_t* data, size_t size, std::string& error);
+
+    std::vector<uint8_t> owned_;
+    MappedFile mapped_;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    AdblockStats stats_;
+};
+
+}
+}
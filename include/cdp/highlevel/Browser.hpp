@@ -3,10 +3,13 @@
 #include "Result.hpp"
 #include "Page.hpp"
 #include "../protocol/CDPClient.hpp"
+#include "../net/SessionTransport.hpp"
+#include "../browser/ProcessMonitor.hpp"
 #include <string>
 #include <vector>
 #include <memory>
 #include <map>
+#include <unordered_map>
 #include <mutex>
 #include <optional>
 #include <functional>
@@ -41,6 +44,22 @@ struct NewPageOptions {
 };
 
 
+class ManagedPage;
+
+
+using PageSetupStep = std::function<Result<void>(ManagedPage& page)>;
+
+
+struct PageRecyclePolicy {
+    uint64_t maxNavigations = 0;
+    uint64_t maxJsHeapBytes = 0;
+    // Compared with the total renderer RSS seen by the Browser's attached ProcessMonitor.
+    uint64_t maxRendererRssBytes = 0;
+
+    bool enabled() const { return maxNavigations > 0 || maxJsHeapBytes > 0 || maxRendererRssBytes > 0; }
+};
+
+
 class ManagedPage {
 public:
     ManagedPage(std::unique_ptr<CDPClient> client, const std::string& targetId,
@@ -65,7 +84,11 @@ public:
     const std::string& contextId() const { return contextId_; }
 
     
-    bool isConnected() const { return client_ && client_->isConnected(); }
+    bool isConnected() const { return client_ && client_->isConnected() && !isDead(); }
+
+    
+    bool isDead() const { return client_ && client_->connection().isTargetDead(); }
+    std::string deadReason() const { return client_ ? client_->connection().deadReason() : ""; }
 
     
     Result<void> close();
@@ -73,11 +96,61 @@ public:
     
     Result<void> bringToFront();
 
+    
+    Result<void> setViewport(int width, int height, double deviceScaleFactor = 1.0);
+    Result<void> setUserAgent(const std::string& userAgent);
+    Result<void> addInitScript(const std::string& source);
+    Result<void> setCookies(const JsonArray& cookies);
+    Result<void> addSetupStep(PageSetupStep step);
+    void clearSetup();
+
+    
+    Result<void> applySetup();
+
+    
+    void setRecyclePolicy(const PageRecyclePolicy& policy) { recyclePolicy_ = policy; }
+    const PageRecyclePolicy& recyclePolicy() const { return recyclePolicy_; }
+
+    
+    Result<uint64_t> jsHeapUsedBytes();
+
+    
+    std::string recycleReason();
+
+    
+    Result<bool> recycleIfNeeded();
+
+    
+    // Re-enables Page, DOM and Runtime and re-applies enabled NetworkInterceptors; other domains need addSetupStep().
+    Result<void> recycle();
+
+    uint64_t recycleCount() const { return recycles_; }
+
 private:
+    friend class Browser;
+    friend class BrowserContext;
+
+    struct Setup {
+        bool hasViewport = false;
+        int width = 0;
+        int height = 0;
+        double deviceScaleFactor = 1.0;
+        std::string userAgent;
+        std::vector<std::string> initScripts;
+        JsonArray cookies;
+        std::vector<PageSetupStep> steps;
+    };
+
     std::unique_ptr<CDPClient> client_;
     std::unique_ptr<Page> page_;
     std::string targetId_;
     std::string contextId_;
+    Browser* browser_ = nullptr;
+    Setup setup_;
+    PageRecyclePolicy recyclePolicy_;
+    uint64_t recycles_ = 0;
+    bool performanceEnabled_ = false;
+    std::vector<EventToken> proxyAuthTokens_;
 };
 
 
@@ -104,6 +177,9 @@ public:
     std::vector<ManagedPage*> pages();
 
     
+    Result<void> closePage(ManagedPage* page);
+
+    
     Result<void> close();
 
     
@@ -141,6 +217,7 @@ public:
 
     
     Result<void> connect();
+    Result<void> connect(std::unique_ptr<Transport> transport);
 
     
     void disconnect();
@@ -164,6 +241,9 @@ public:
     std::vector<BrowserContext*> contexts();
 
     
+    Result<void> closeContext(BrowserContext* context);
+
+    
     Result<ManagedPage*> newPage(const NewPageOptions& options = {});
 
     
@@ -176,10 +256,23 @@ public:
     CDPClient& browserClient() { return browserClient_; }
 
     
+    std::vector<TargetInfo> targets() const;
+    std::optional<TargetInfo> findTarget(const std::string& targetId) const;
+    size_t targetCount() const;
+
+    
+    std::string pageWebSocketUrl(const std::string& targetId) const;
+
+    
+    void attachProcessMonitor(ProcessMonitor& monitor);
+    ProcessMonitor* processMonitor() const { return processMonitor_; }
+
+    
     const CDPClientConfig& config() const { return config_; }
 
 private:
     friend class BrowserContext;
+    friend class ManagedPage;
 
     
     Result<std::unique_ptr<ManagedPage>> createPage(const std::string& url,
@@ -188,14 +281,32 @@ private:
                                                      bool background);
 
     
+    Result<std::string> createTarget(const std::string& url,
+                                     int width, int height,
+                                     const std::string& browserContextId,
+                                     bool background);
+
+    
     Result<void> closeTarget(const std::string& targetId);
 
+    
+    Result<void> attachClient(CDPClient& client, const std::string& targetId, bool retarget);
+
+    
+    void trackTargets();
+
     CDPClientConfig config_;
     CDPClient browserClient_;  
     std::unique_ptr<BrowserContext> defaultContext_;
     std::vector<std::unique_ptr<BrowserContext>> incognitoContexts_;
     mutable std::mutex mutex_;
     bool connected_ = false;
+
+    std::unordered_map<std::string, TargetInfo> targets_;
+    std::unordered_map<std::string, std::string> pageSessions_;
+    mutable std::mutex targetsMutex_;
+    std::shared_ptr<SessionRouter> sessions_;
+    ProcessMonitor* processMonitor_ = nullptr;
 };
 
 
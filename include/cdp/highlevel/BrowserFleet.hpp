@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Browser.hpp"
+#include "Result.hpp"
+#include "../browser/ChromeLauncher.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <thread>
+#include <cstdint>
+
+namespace cdp {
+namespace highlevel {
+
+
+enum class FleetBrowserState {
+    Starting,
+    Ready,
+    Draining,
+    Restarting,
+    Stopped
+};
+
+
+struct BrowserFleetOptions {
+    size_t browsers = 2;
+    ChromeLaunchOptions launch = ChromeLaunchOptions::headlessMode();
+    // Supplies connected browsers instead of launching Chrome; called again on every restart.
+    std::function<Result<std::unique_ptr<Browser>>(size_t index)> browserFactory;
+    NewPageOptions pageOptions;
+    size_t maxPagesPerBrowser = 8;
+    int maxAttempts = 3;
+
+
+    double pageWeight = 1.0;
+    double pendingCommandWeight = 0.25;
+    double memoryWeightPerGB = 4.0;
+
+
+    int healthCheckIntervalMs = 5000;
+    int healthCheckTimeoutMs = 3000;
+    double maxHealthyLatencyMs = 1000.0;
+    int maxFailedChecks = 3;
+    uint64_t maxMemoryBytes = 0;
+    int drainTimeoutMs = 30000;
+};
+
+
+struct FleetBrowserStats {
+    size_t index = 0;
+    FleetBrowserState state = FleetBrowserState::Stopped;
+    int port = 0;
+    uint32_t pid = 0;
+    size_t activePages = 0;
+    size_t queued = 0;
+    size_t pendingCommands = 0;
+    uint64_t memoryBytes = 0;
+    double lastLatencyMs = 0;
+    int failedChecks = 0;
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    uint64_t requeued = 0;
+    uint64_t restarts = 0;
+    double load = 0;
+};
+
+
+struct BrowserFleetStats {
+    size_t queued = 0;
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    uint64_t requeued = 0;
+    uint64_t restarts = 0;
+    std::vector<FleetBrowserStats> browsers;
+};
+
+
+using FleetTask = std::function<Result<void>(ManagedPage& page)>;
+
+
+class BrowserFleet {
+public:
+    explicit BrowserFleet(const BrowserFleetOptions& options = {});
+    ~BrowserFleet();
+
+    BrowserFleet(const BrowserFleet&) = delete;
+    BrowserFleet& operator=(const BrowserFleet&) = delete;
+
+
+    Result<void> start();
+    void shutdown();
+    bool isRunning() const;
+
+
+    std::future<Result<void>> submit(FleetTask task);
+
+
+    Result<void> drain(size_t index);
+    Result<void> restart(size_t index);
+    void checkHealth();
+
+
+    size_t size() const { return members_.size(); }
+    BrowserFleetStats stats() const;
+
+private:
+    struct Job {
+        FleetTask task;
+        std::shared_ptr<std::promise<Result<void>>> promise;
+        int attempts = 0;
+    };
+
+    struct Member {
+        size_t index = 0;
+        FleetBrowserState state = FleetBrowserState::Stopped;
+        std::unique_ptr<ChromeLauncher> launcher;
+        std::unique_ptr<Browser> browser;
+        std::deque<Job> queue;
+        size_t active = 0;
+        size_t probes = 0;
+        bool cycling = false;
+        bool parked = false;
+        std::condition_variable wake;
+        std::condition_variable idle;
+        std::vector<std::thread> workers;
+        std::thread restarter;
+        FleetBrowserStats stats;
+    };
+
+    Result<void> launchMember(Member& member);
+    void workerLoop(Member& member);
+    void runJob(Member& member, Browser* browser, Job job);
+    void cycleMember(Member& member, bool kill, bool relaunch);
+    void probeMember(Member& member);
+    void healthLoop();
+
+    bool beginCycleLocked(Member& member);
+    void scheduleRestartLocked(Member& member, bool kill);
+    void dispatchLocked();
+    double loadLocked(const Member& member) const;
+
+    BrowserFleetOptions options_;
+    bool running_ = false;
+    std::vector<std::unique_ptr<Member>> members_;
+    std::deque<Job> queue_;
+    BrowserFleetStats stats_;
+    mutable std::mutex mutex_;
+    std::condition_variable healthWake_;
+    std::thread healthThread_;
+};
+
+}
+}
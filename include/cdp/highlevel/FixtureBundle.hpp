@@ -0,0 +1,50 @@
+#pragma once
+
+#include "NetworkInterceptor.hpp"
+#include "../core/MappedFile.hpp"
+#include "Result.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <unordered_map>
+
+namespace cdp {
+namespace highlevel {
+
+
+class FixtureBundle {
+public:
+    static Result<std::shared_ptr<FixtureBundle>> open(const std::string& path);
+
+    
+    std::shared_ptr<const MockResponse> find(const std::string& url) const;
+    bool contains(const std::string& url) const;
+
+    size_t size() const { return entries_.size(); }
+    std::vector<std::string> keys() const;
+
+    
+    static std::string keyForUrl(const std::string& url);
+    static std::string contentTypeFor(const std::string& key);
+
+private:
+    struct Entry {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        std::string filePath;
+        mutable std::atomic<std::shared_ptr<const MockResponse>> response;
+    };
+
+    FixtureBundle() = default;
+
+    bool indexDirectory(const std::string& root, std::string& error);
+    bool indexArchive(std::string& error);
+    std::shared_ptr<const MockResponse> load(const std::string& key, const Entry& entry) const;
+
+    MappedFile archive_;
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+}
+}
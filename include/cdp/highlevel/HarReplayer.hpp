@@ -0,0 +1,79 @@
+#pragma once
+
+#include "NetworkInterceptor.hpp"
+#include "Result.hpp"
+#include "../core/Json.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+
+namespace cdp {
+namespace highlevel {
+
+
+enum class HarMissPolicy {
+    Continue,
+    Fail
+};
+
+
+struct HarReplayOptions {
+    std::string urlPattern = "*";
+    HarMissPolicy onMiss = HarMissPolicy::Continue;
+    bool matchPostData = true;
+    bool sortQuery = true;
+    std::vector<std::string> ignoredQueryParams;
+};
+
+
+struct HarReplayStats {
+    uint64_t entries = 0;
+    uint64_t skipped = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+
+class HarReplayer {
+public:
+    static Result<std::shared_ptr<HarReplayer>> open(const std::string& path,
+                                                     const HarReplayOptions& options = {});
+    static Result<std::shared_ptr<HarReplayer>> load(const JsonValue& har,
+                                                     const HarReplayOptions& options = {});
+
+
+    std::shared_ptr<const MockResponse> find(const std::string& method, const std::string& url,
+                                             const std::string& postData = "");
+    void rewind();
+
+    size_t size() const { return index_.size(); }
+    const HarReplayOptions& options() const { return options_; }
+    HarReplayStats stats() const;
+
+
+    std::string requestKey(const std::string& method, const std::string& url,
+                           const std::string& postData) const;
+    static std::string normalizeUrl(const std::string& url, bool sortQuery = true,
+                                    const std::vector<std::string>& ignoredQueryParams = {});
+
+private:
+    struct Slot {
+        std::vector<std::shared_ptr<const MockResponse>> responses;
+        size_t next = 0;
+    };
+
+    explicit HarReplayer(const HarReplayOptions& options) : options_(options) {}
+
+    bool addEntry(const JsonValue& entry);
+
+    HarReplayOptions options_;
+    std::unordered_map<std::string, Slot> index_;
+    HarReplayStats stats_;
+    mutable std::mutex mutex_;
+};
+
+}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Result.hpp"
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+namespace cdp {
+namespace highlevel {
+
+
+struct ImageDiffOptions {
+    double threshold = 0.1;
+    int regionGap = 4;
+    bool ignoreAlpha = false;
+    bool collectMask = false;
+    std::function<void(int y, const uint8_t* maskRow)> maskRowCallback;
+};
+
+
+struct DiffRegion {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    int64_t pixels = 0;
+};
+
+
+struct ImageDiffResult {
+    int width = 0;
+    int height = 0;
+    int64_t totalPixels = 0;
+    int64_t diffPixels = 0;
+    double diffRatio = 0;
+    double maxDelta = 0;
+    bool sizeMismatch = false;
+    std::vector<DiffRegion> regions;
+    std::vector<uint8_t> mask;
+
+    bool identical() const { return !sizeMismatch && diffPixels == 0; }
+};
+
+
+class ImageDiff {
+public:
+    static Result<ImageDiffResult> compare(const uint8_t* pngA, size_t lenA,
+                                           const uint8_t* pngB, size_t lenB,
+                                           const ImageDiffOptions& options = {});
+
+    static Result<ImageDiffResult> compare(const std::vector<uint8_t>& pngA,
+                                           const std::vector<uint8_t>& pngB,
+                                           const ImageDiffOptions& options = {}) {
+        return compare(pngA.data(), pngA.size(), pngB.data(), pngB.size(), options);
+    }
+
+
+    static int changedPixels(const uint8_t* rowA, const uint8_t* rowB, int width, uint8_t* changed);
+};
+
+}
+}
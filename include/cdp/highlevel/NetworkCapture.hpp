@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Utilities.hpp"
+#include "Result.hpp"
+#include "../protocol/CDPConnection.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <ostream>
+#include <cstdint>
+
+namespace cdp {
+namespace highlevel {
+
+
+struct NetworkCaptureOptions {
+    bool captureHeaders = true;
+    bool includePending = false;
+};
+
+
+class NetworkCapture {
+public:
+    explicit NetworkCapture(CDPConnection& conn, const NetworkCaptureOptions& options = {});
+    ~NetworkCapture();
+
+    NetworkCapture(const NetworkCapture&) = delete;
+    NetworkCapture& operator=(const NetworkCapture&) = delete;
+
+
+    Result<void> start();
+    void stop();
+    void clear();
+    bool isRecording() const;
+
+
+    void recordEvent(const std::string& method, const JsonValue& params);
+
+
+    size_t size() const;
+    size_t pendingCount() const;
+    size_t failedCount() const;
+    int64_t totalBytes() const;
+
+    std::map<std::string, int64_t> bytesByType() const;
+    std::map<std::string, int64_t> bytesByHost() const;
+    std::map<std::string, size_t> requestsByHost() const;
+    std::vector<HAREntry> slowest(size_t n) const;
+
+
+    HAREntry entry(size_t index) const;
+    Result<void> writeHAR(std::ostream& out) const;
+    Result<void> saveHAR(const std::string& path) const;
+
+
+    size_t memoryUsage() const;
+
+private:
+    class StringPool {
+    public:
+        uint32_t intern(std::string_view value);
+        std::string_view get(uint32_t id) const { return strings_[id]; }
+        size_t size() const { return strings_.size(); }
+        size_t bytes() const { return bytes_; }
+        void clear();
+
+    private:
+        std::deque<std::string> strings_;
+        std::unordered_map<std::string_view, uint32_t> ids_;
+        size_t bytes_ = 0;
+    };
+
+    enum RowState : uint8_t { Pending = 0, Finished = 1, Failed = 2 };
+
+    void onRequest(const JsonValue& params);
+    void onResponse(uint32_t row, const JsonValue& response);
+    void onFinished(const JsonValue& params);
+    void onFailed(const JsonValue& params);
+
+    uint32_t appendText(std::string_view text, uint64_t& offset);
+    std::string_view text(uint64_t offset, uint32_t length) const;
+    void appendHeaders(const JsonValue* headers, uint32_t& start, uint32_t& count);
+    std::string_view hostOf(std::string_view url) const;
+    double durationMs(size_t row) const;
+    bool exported(size_t row) const;
+    HAREntry materialize(size_t row) const;
+
+    CDPConnection& connection_;
+    NetworkCaptureOptions options_;
+    bool recording_ = false;
+    std::vector<CDPConnection::EventToken> tokens_;
+    mutable std::mutex mutex_;
+
+    StringPool pool_;
+    std::string text_;
+    std::unordered_map<std::string, uint32_t> inflight_;
+
+
+    std::vector<uint64_t> urlOffset_;
+    std::vector<uint32_t> urlLength_;
+    std::vector<uint32_t> host_;
+    std::vector<uint32_t> method_;
+    std::vector<uint32_t> type_;
+    std::vector<uint32_t> mime_;
+    std::vector<uint32_t> statusText_;
+    std::vector<uint32_t> error_;
+    std::vector<int32_t> status_;
+    std::vector<uint8_t> state_;
+    std::vector<double> wallTime_;
+    std::vector<double> startTs_;
+    std::vector<double> endTs_;
+    std::vector<int64_t> bytes_;
+    std::vector<float> dns_;
+    std::vector<float> connect_;
+    std::vector<float> ssl_;
+    std::vector<float> send_;
+    std::vector<float> wait_;
+    std::vector<uint32_t> requestHeaderStart_;
+    std::vector<uint32_t> requestHeaderCount_;
+    std::vector<uint32_t> responseHeaderStart_;
+    std::vector<uint32_t> responseHeaderCount_;
+
+
+    std::vector<uint32_t> headerName_;
+    std::vector<uint64_t> headerValueOffset_;
+    std::vector<uint32_t> headerValueLength_;
+};
+
+}
+}
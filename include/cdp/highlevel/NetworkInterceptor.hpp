@@ -2,19 +2,45 @@
 
 #include "../protocol/CDPClient.hpp"
 #include "Result.hpp"
+#include "UrlMatcher.hpp"
+#include "StreamReader.hpp"
 #include <string>
 #include <vector>
 #include <map>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <regex>
+#include <deque>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <optional>
+#include <unordered_map>
 
 namespace cdp {
 namespace highlevel {
 
 
 class NetworkInterceptor;
+class FixtureBundle;
+class AdblockEngine;
+class HarReplayer;
+
+
+class FulfillParams {
+public:
+    explicit FulfillParams(std::string json) : json_(std::move(json)) {}
+
+    const std::string& json() const { return json_; }
+    const std::string& cbor() const;
+
+private:
+    std::string json_;
+    mutable std::once_flag cborOnce_;
+    mutable std::string cbor_;
+};
 
 
 struct MockResponse {
@@ -65,13 +91,29 @@ struct MockResponse {
     
     MockResponse& withHeader(const std::string& name, const std::string& value) {
         headers[name] = value;
+        prepared_.reset();
         return *this;
     }
 
     MockResponse& withContentType(const std::string& contentType) {
         headers["Content-Type"] = contentType;
+        prepared_.reset();
         return *this;
     }
+
+    
+    MockResponse& prepare();
+    bool isPrepared() const { return prepared_ != nullptr; }
+    std::shared_ptr<const FulfillParams> fulfillParams() const;
+
+    
+    static MockResponse preEncoded(const uint8_t* data, size_t len,
+                                   const std::map<std::string, std::string>& headers, int status = 200);
+    static MockResponse preEncoded(const uint8_t* data, size_t len,
+                                   const std::vector<HeaderEntry>& headers, int status = 200);
+
+private:
+    std::shared_ptr<const FulfillParams> prepared_;
 };
 
 
@@ -82,6 +124,13 @@ struct InterceptedRequest {
     std::map<std::string, std::string> headers;
     std::string postData;
     std::string resourceType;  
+    std::string frameId;
+
+    
+    bool responseStage = false;
+    int responseStatusCode = 0;
+    std::string responseErrorReason;
+    std::vector<HeaderEntry> responseHeaders;
 };
 
 
@@ -101,7 +150,13 @@ public:
 
     static InterceptAction fulfill(const MockResponse& response) {
         InterceptAction action(Type::Fulfill);
-        action.mockResponse_ = response;
+        action.mockResponse_ = std::make_shared<const MockResponse>(response);
+        return action;
+    }
+
+    static InterceptAction fulfill(std::shared_ptr<const MockResponse> response) {
+        InterceptAction action(Type::Fulfill);
+        action.mockResponse_ = std::move(response);
         return action;
     }
 
@@ -116,7 +171,10 @@ public:
     }
 
     Type type() const { return type_; }
-    const MockResponse& mockResponse() const { return mockResponse_; }
+    const MockResponse& mockResponse() const {
+        static const MockResponse empty;
+        return mockResponse_ ? *mockResponse_ : empty;
+    }
     const std::map<std::string, std::string>& modifiedHeaders() const { return modifiedHeaders_; }
     const std::string& failReason() const { return failReason_; }
 
@@ -124,7 +182,7 @@ private:
     explicit InterceptAction(Type type) : type_(type) {}
 
     Type type_;
-    MockResponse mockResponse_;
+    std::shared_ptr<const MockResponse> mockResponse_;
     std::map<std::string, std::string> modifiedHeaders_;
     std::string failReason_;
 };
@@ -132,12 +190,26 @@ private:
 
 using InterceptCallback = std::function<InterceptAction(const InterceptedRequest&)>;
 using ObserveCallback = std::function<void(const InterceptedRequest&)>;
+using ResponseBodyCallback = std::function<void(const InterceptedRequest&, const uint8_t* data, size_t len)>;
+using RequestFilter = std::function<bool(const InterceptedRequest&)>;
+using ResponseSinkFactory = std::function<StreamSink(const InterceptedRequest&)>;
+
+
+// By default the body goes only to the sink and the page's request is aborted.
+// replayToPage buffers it in memory (up to maxReplayBytes) to fulfill it back to the page.
+struct ResponseStreamOptions {
+    StreamReadOptions read;
+    bool replayToPage = false;
+    size_t maxReplayBytes = 4 * 1024 * 1024;
+    RequestFilter filter;
+    std::function<void(const InterceptedRequest&, const Result<int64_t>&)> onComplete;
+};
 
 
 class InterceptorHandle {
 public:
     InterceptorHandle() : interceptor_(nullptr), id_(0), active_(false) {}
-    InterceptorHandle(NetworkInterceptor* interceptor, uint64_t id);
+    InterceptorHandle(NetworkInterceptor* interceptor, uint64_t id, Result<void> applied = {});
     ~InterceptorHandle();
 
     
@@ -149,17 +221,39 @@ public:
     void remove();
     bool isActive() const { return active_; }
     uint64_t id() const { return id_; }
+    const Result<void>& applied() const { return applied_; }
 
 private:
     NetworkInterceptor* interceptor_;
     uint64_t id_;
     bool active_;
+    Result<void> applied_;
+};
+
+
+struct InterceptorOptions {
+    size_t workerThreads = 0;
+    int decisionTimeoutMs = 0;
+    bool caseSensitivePatterns = false;
+};
+
+
+struct InterceptorStats {
+    uint64_t paused = 0;
+    uint64_t continued = 0;
+    uint64_t fulfilled = 0;
+    uint64_t failed = 0;
+    uint64_t timedOut = 0;
+    uint64_t callbackErrors = 0;
+    uint64_t commandErrors = 0;
+    size_t pendingDeadlines = 0;
+    std::string lastCommandError;
 };
 
 
 class NetworkInterceptor {
 public:
-    explicit NetworkInterceptor(CDPClient& client);
+    explicit NetworkInterceptor(CDPClient& client, const InterceptorOptions& options = {});
     ~NetworkInterceptor();
 
     
@@ -167,9 +261,15 @@ public:
     Result<void> disable();
     bool isEnabled() const { return enabled_; }
 
+    // Called automatically when the client is retargeted, e.g. by ManagedPage::recycle().
+    Result<void> reapply();
+
     
     InterceptorHandle mockRequest(const std::string& urlPattern, const MockResponse& response);
+    InterceptorHandle serveFixtures(const std::string& urlPattern, std::shared_ptr<const FixtureBundle> bundle);
+    InterceptorHandle serveHar(std::shared_ptr<HarReplayer> replayer);
     InterceptorHandle blockResource(const std::string& urlPattern);
+    InterceptorHandle blockWithFilters(std::shared_ptr<const AdblockEngine> engine);
     InterceptorHandle modifyRequestHeaders(const std::string& urlPattern,
                                            const std::map<std::string, std::string>& headers);
 
@@ -178,44 +278,168 @@ public:
 
     
     InterceptorHandle intercept(const std::string& urlPattern, InterceptCallback callback);
+    InterceptorHandle intercept(const std::string& urlPattern, const std::string& resourceType,
+                                InterceptCallback callback);
     InterceptorHandle observe(const std::string& urlPattern, ObserveCallback callback);
 
     
-    void clear();
+    InterceptorHandle interceptResponse(const std::string& urlPattern, InterceptCallback callback);
+    InterceptorHandle captureResponseBody(const std::string& urlPattern, ResponseBodyCallback callback,
+                                          RequestFilter filter = nullptr);
+    InterceptorHandle streamResponseBody(const std::string& urlPattern, ResponseSinkFactory sinkFactory,
+                                         const ResponseStreamOptions& options = {});
+    InterceptorHandle streamResponseToFile(const std::string& urlPattern,
+                                           std::function<std::string(const InterceptedRequest&)> pathFor,
+                                           const ResponseStreamOptions& options = {});
+
+    
+    Result<void> clear();
 
     
-    void removeRule(uint64_t id);
+    Result<void> removeRule(uint64_t id);
+
+    
+    std::vector<RequestPattern> requestPatterns();
+    Result<void> setPatternFiltering(bool enabled);
+
+    InterceptorStats stats() const;
 
 private:
     struct InterceptRule {
         uint64_t id;
         std::string pattern;
-        std::regex regex;
+        std::string resourceType;
+        std::string stage = "Request";
         InterceptCallback callback;
+        ResponseBodyCallback bodyCallback;
+        ResponseSinkFactory sinkFactory;
+        std::shared_ptr<const ResponseStreamOptions> streamOptions;
+        RequestFilter filter;
         bool isObserver = false;  
     };
 
+    struct RuleSet {
+        std::vector<InterceptRule> rules;
+        UrlMatcher matcher;
+    };
+
+    struct Counters {
+        std::atomic<uint64_t> paused{0};
+        std::atomic<uint64_t> continued{0};
+        std::atomic<uint64_t> fulfilled{0};
+        std::atomic<uint64_t> failed{0};
+        std::atomic<uint64_t> timedOut{0};
+        std::atomic<uint64_t> callbackErrors{0};
+        std::atomic<uint64_t> commandErrors{0};
+        std::mutex errorMutex;
+        std::string lastCommandError;
+    };
+
+    struct PendingDecision;
+    using DeadlineMap = std::multimap<std::chrono::steady_clock::time_point, std::shared_ptr<PendingDecision>>;
+
+    struct PendingDecision {
+        InterceptedRequest request;
+        std::shared_ptr<const RuleSet> ruleSet;
+        std::vector<uint32_t> matches;
+        std::vector<uint32_t> captures;
+        std::vector<uint32_t> streams;
+        bool bodyTaken = false;
+        std::shared_ptr<const std::vector<uint8_t>> streamedBody;
+        std::atomic<bool> resolved{false};
+        std::optional<DeadlineMap::iterator> deadline;
+    };
+
+    using PendingPtr = std::shared_ptr<PendingDecision>;
+
+    struct BodyOps {
+        std::mutex mutex;
+        std::condition_variable cv;
+        size_t inflight = 0;
+        size_t running = 0;
+        bool closed = false;
+    };
+
+    class BodyOpScope {
+    public:
+        explicit BodyOpScope(BodyOps& ops);
+        ~BodyOpScope();
+        BodyOpScope(const BodyOpScope&) = delete;
+        BodyOpScope& operator=(const BodyOpScope&) = delete;
+        explicit operator bool() const { return entered_; }
+    private:
+        BodyOps& ops_;
+        bool entered_;
+    };
+
     CDPClient& client_;
+    InterceptorOptions options_;
     bool enabled_ = false;
     std::vector<InterceptRule> rules_;
+    std::shared_ptr<const RuleSet> ruleSet_ = std::make_shared<RuleSet>();
     std::mutex rulesMutex_;
     uint64_t nextRuleId_ = 1;
+    std::string mainFrameId_;
+    bool patternFiltering_ = true;
+    std::vector<RequestPattern> issuedPatterns_;
     EventToken requestPausedToken_;
+    uint64_t retargetHook_ = 0;
+
+    struct FrameInfo {
+        std::string url;
+        std::string parentId;
+    };
+    std::unordered_map<std::string, FrameInfo> frames_;
+    std::mutex framesMutex_;
+    std::vector<EventToken> frameTokens_;
+    std::shared_ptr<Counters> counters_ = std::make_shared<Counters>();
+    std::shared_ptr<BodyOps> bodyOps_ = std::make_shared<BodyOps>();
 
     
-    static std::regex patternToRegex(const std::string& pattern);
+    std::vector<std::thread> workers_;
+    std::thread deadlineThread_;
+    std::deque<PendingPtr> jobs_;
+    DeadlineMap deadlines_;
+    mutable std::mutex jobsMutex_;
+    std::condition_variable jobsCv_;
+    std::condition_variable deadlineCv_;
+    bool workersRunning_ = false;
 
     
-    static bool urlMatches(const std::string& url, const std::regex& regex);
+    InterceptorHandle addRule(InterceptRule rule);
+    std::future<CDPResponse> publishRules();
+    std::future<CDPResponse> sendPatterns(const std::vector<RequestPattern>& patterns);
+    Result<void> awaitPatterns(std::future<CDPResponse> update);
+    std::shared_ptr<const RuleSet> currentRules();
+    std::vector<RequestPattern> derivePatterns() const;
 
     
     void handleRequestPaused(const JsonValue& params);
+    void trackFrames();
+    std::string sourceUrlFor(const InterceptedRequest& request);
+    void captureBody(const PendingPtr& pending);
+    bool streamBody(const PendingPtr& pending);
+    std::shared_ptr<void> beginBodyOp();
+    void drainBodyOps();
+    void dispatch(const PendingPtr& pending);
+    InterceptAction decide(const PendingDecision& pending);
+    bool resolve(PendingDecision& pending, const InterceptAction& action);
+    void releaseStreamed(const PendingDecision& pending, const InterceptAction& action);
+    void runCaptures(const PendingDecision& pending, const uint8_t* data, size_t len);
+    void applyAction(const InterceptedRequest& request, const InterceptAction& action);
+    ResponseCallback commandCallback() const;
+
+    
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop();
+    void deadlineLoop();
 
     
     void fulfillRequest(const std::string& requestId, const MockResponse& response);
 
     
-    void continueRequest(const std::string& requestId,
+    void continueRequest(const InterceptedRequest& request,
                         const std::map<std::string, std::string>* modifiedHeaders = nullptr);
 
     
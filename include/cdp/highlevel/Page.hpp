@@ -2,6 +2,8 @@
 
 #include "Result.hpp"
 #include "ElementHandle.hpp"
+#include "StreamReader.hpp"
+#include "ImageDiff.hpp"
 #include "../protocol/CDPClient.hpp"
 #include <string>
 #include <vector>
@@ -256,12 +258,20 @@ public:
     Result<void> screenshotToFile(const std::string& path, const ScreenshotOptions& options = {});
 
     
+    Result<ImageDiffResult> compareScreenshot(const std::vector<uint8_t>& baselinePng,
+                                              const ImageDiffOptions& diffOptions = {},
+                                              const ScreenshotOptions& options = {});
+
+    
     Result<std::vector<uint8_t>> pdf();
 
     
     Result<void> pdfToFile(const std::string& path);
 
     
+    Result<int64_t> pdfToSink(const StreamSink& sink, const StreamReadOptions& options = {});
+
+    
     Result<void> setViewport(int width, int height, double deviceScaleFactor = 1.0);
 
     
@@ -290,6 +300,15 @@ public:
     const std::string& frameId() const { return frameId_; }
 
     
+    uint64_t navigationCount() const { return navigations_.load(); }
+
+    // Re-enables Page, DOM, Runtime, and Inspector if crash detection was on.
+    void reattach();
+
+    // Enables Inspector so a renderer crash marks the target dead; automatic with CDPClientConfig::detectCrashes.
+    Result<void> enableCrashDetection();
+
+    
     int rootNodeId();
 
     
@@ -592,6 +611,10 @@ private:
     Result<std::string> evalString(const std::string& js);
 
     
+    Result<std::string> openPdfStream();
+    Result<CDPResponse> captureScreenshotResponse(const ScreenshotOptions& options);
+
+    
     template<typename Func>
     Result<void> pollWithBackoff(const WaitOptions& options, const std::string& description, Func&& condition);
 
@@ -599,9 +622,11 @@ private:
     std::string frameId_;
     int rootNodeId_ = 0;
     bool domainEnabled_ = false;
+    bool crashDetection_ = false;
 
     
     std::atomic<int> inflightRequests_{0};
+    std::atomic<uint64_t> navigations_{0};
     std::chrono::steady_clock::time_point lastNetworkActivity_;
     std::mutex networkMutex_;
 };
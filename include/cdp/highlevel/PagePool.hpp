@@ -0,0 +1,171 @@
+#pragma once
+
+#include "Browser.hpp"
+#include "Result.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+namespace cdp {
+namespace highlevel {
+
+
+struct PagePoolOptions {
+    size_t contexts = 1;
+    size_t pagesPerContext = 4;
+    size_t maxUsesPerContext = 0;
+    bool isolateContexts = true;
+    BrowserContextOptions contextOptions;
+    NewPageOptions pageOptions;
+    bool clearStorage = true;
+    int resetTimeoutMs = 10000;
+    PageRecyclePolicy recyclePolicy;
+};
+
+
+struct PagePoolStats {
+    size_t capacity = 0;
+    size_t idle = 0;
+    size_t leased = 0;
+    size_t waiting = 0;
+    uint64_t leases = 0;
+    uint64_t returns = 0;
+    uint64_t leaseTimeouts = 0;
+    uint64_t replacedPages = 0;
+    uint64_t recycledPages = 0;
+    uint64_t crashedPages = 0;
+    uint64_t recycledContexts = 0;
+    uint64_t failedPages = 0;
+    uint64_t failedContexts = 0;
+    size_t broken = 0;
+    double totalWaitMs = 0;
+    double maxWaitMs = 0;
+
+    double averageWaitMs() const { return leases > 0 ? totalWaitMs / static_cast<double>(leases) : 0.0; }
+    double occupancy() const { return capacity > 0 ? static_cast<double>(leased) / static_cast<double>(capacity) : 0.0; }
+};
+
+
+class PageLease;
+
+
+class PagePool {
+public:
+    explicit PagePool(Browser& browser, const PagePoolOptions& options = {});
+    ~PagePool();
+
+    PagePool(const PagePool&) = delete;
+    PagePool& operator=(const PagePool&) = delete;
+
+
+    Result<void> start();
+    // Leased pages stay open until returned; the destructor waits for outstanding leases.
+    void shutdown();
+
+
+    Result<PageLease> lease(int timeoutMs = 30000);
+
+    PagePoolStats stats() const;
+
+private:
+    friend class PageLease;
+
+    struct ContextSlot {
+        BrowserContext* context = nullptr;
+        size_t uses = 0;
+        size_t leased = 0;
+        bool retiring = false;
+    };
+
+    struct PageSlot {
+        ManagedPage* page = nullptr;
+        ContextSlot* context = nullptr;
+        bool leased = false;
+    };
+
+    Result<void> addContext();
+    Result<void> fillContext(ContextSlot* context, size_t count);
+    Result<ManagedPage*> createPage(ContextSlot* context);
+    bool recyclePage(PageSlot* slot);
+    bool resetPage(PageSlot* slot);
+    void giveBack(PageSlot* slot, bool broken);
+    void closeReturned(PageSlot* slot);
+    void replacePage(PageSlot* slot);
+    bool restorePage(PageSlot* slot);
+    void retryBroken();
+    void recycleContext(ContextSlot* context);
+
+    Browser& browser_;
+    PagePoolOptions options_;
+    bool running_ = false;
+
+    std::vector<std::unique_ptr<ContextSlot>> contexts_;
+    std::vector<std::unique_ptr<PageSlot>> pages_;
+    std::deque<PageSlot*> idle_;
+    std::deque<PageSlot*> broken_;
+    PagePoolStats stats_;
+    mutable std::mutex mutex_;
+    std::mutex retryMutex_;
+    std::condition_variable available_;
+};
+
+
+class PageLease {
+public:
+    PageLease() = default;
+    ~PageLease() { release(); }
+
+    PageLease(const PageLease&) = delete;
+    PageLease& operator=(const PageLease&) = delete;
+
+    PageLease(PageLease&& other) noexcept : pool_(other.pool_), slot_(other.slot_) {
+        other.pool_ = nullptr;
+        other.slot_ = nullptr;
+    }
+
+    PageLease& operator=(PageLease&& other) noexcept {
+        if (this != &other) {
+            release();
+            pool_ = other.pool_;
+            slot_ = other.slot_;
+            other.pool_ = nullptr;
+            other.slot_ = nullptr;
+        }
+        return *this;
+    }
+
+
+    bool valid() const { return slot_ != nullptr; }
+    explicit operator bool() const { return valid(); }
+
+    ManagedPage* get() const { return slot_ ? slot_->page : nullptr; }
+    ManagedPage* operator->() const { return get(); }
+    ManagedPage& operator*() const { return *get(); }
+    Page& page() const { return slot_->page->page(); }
+    CDPClient& client() const { return slot_->page->client(); }
+
+
+    void release() { giveBack(false); }
+    void discard() { giveBack(true); }
+
+private:
+    friend class PagePool;
+
+    PageLease(PagePool* pool, PagePool::PageSlot* slot) : pool_(pool), slot_(slot) {}
+
+    void giveBack(bool broken) {
+        if (pool_ && slot_) pool_->giveBack(slot_, broken);
+        pool_ = nullptr;
+        slot_ = nullptr;
+    }
+
+    PagePool* pool_ = nullptr;
+    PagePool::PageSlot* slot_ = nullptr;
+};
+
+}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "NetworkInterceptor.hpp"
+#include "Result.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace cdp {
+namespace highlevel {
+
+
+struct ResponseCacheOptions {
+    std::string directory;
+    std::string urlPattern = "*";
+    std::vector<std::string> methods = {"GET"};
+    std::vector<std::string> varyHeaders;
+    std::vector<int> cacheableStatus = {200, 203, 204, 404, 410};
+
+    uint64_t maxBytes = 256ull * 1024 * 1024;
+    size_t maxEntries = 10000;
+
+
+    int64_t defaultTtlSeconds = 3600;
+    int64_t maxTtlSeconds = 0;
+    bool honorCacheControl = true;
+    bool serveStale = false;
+};
+
+
+struct ResponseCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t expired = 0;
+    uint64_t stores = 0;
+    uint64_t skipped = 0;
+    uint64_t evictions = 0;
+    uint64_t errors = 0;
+    uint64_t entries = 0;
+    uint64_t bytes = 0;
+
+    double hitRatio() const {
+        uint64_t total = hits + misses;
+        return total > 0 ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+    }
+};
+
+
+class ResponseCache {
+public:
+    explicit ResponseCache(const ResponseCacheOptions& options);
+    ~ResponseCache();
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+
+    Result<void> open();
+    Result<void> flush();
+    void clear();
+
+
+    Result<void> attach(NetworkInterceptor& interceptor);
+    void detach();
+
+
+    std::shared_ptr<const MockResponse> lookup(const InterceptedRequest& request);
+    bool store(const InterceptedRequest& response, const uint8_t* body, size_t len);
+
+    ResponseCacheStats stats() const;
+
+
+    static std::string cacheKey(const std::string& method, const std::string& url,
+                                const std::map<std::string, std::string>& requestHeaders,
+                                const std::vector<std::string>& varyHeaders);
+
+    class State;
+
+private:
+    std::shared_ptr<State> state_;
+    InterceptorHandle requestRule_;
+    InterceptorHandle responseRule_;
+};
+
+}
+}
@@ -26,6 +26,7 @@ enum class ErrorCategory {
     NotSupported,       
     Internal,           
     Cancelled,          
+    Crashed,            
 };
 
 
@@ -77,6 +78,8 @@ namespace ErrorCode {
     constexpr int Internal = 900;
 }
 
+static_assert(ErrorCode::PageCrashed == CDPResponse::TargetCrashedCode);
+
 
 inline ErrorCategory categoryFromCode(int code) {
     if (code == 0) return ErrorCategory::None;
@@ -93,7 +96,10 @@ inline ErrorCategory categoryFromCode(int code) {
             if (code == ErrorCode::ElementNotEnabled) return ErrorCategory::ElementNotEnabled;
             return ErrorCategory::ElementNotFound;
         }
-        case 5: return ErrorCategory::Navigation;
+        case 5: {
+            if (code == ErrorCode::PageCrashed) return ErrorCategory::Crashed;
+            return ErrorCategory::Navigation;
+        }
         case 6: return ErrorCategory::JavaScript;
         case 7: return ErrorCategory::InvalidArgument;
         case 8: {
@@ -111,6 +117,7 @@ inline ErrorCategory toErrorCategory(CDPErrorCategory cdpCategory) {
         case CDPErrorCategory::None: return ErrorCategory::None;
         case CDPErrorCategory::Protocol: return ErrorCategory::Protocol;
         case CDPErrorCategory::Target: return ErrorCategory::Navigation;  
+        case CDPErrorCategory::Crashed: return ErrorCategory::Crashed;
         case CDPErrorCategory::Timeout: return ErrorCategory::Timeout;
         case CDPErrorCategory::Connection: return ErrorCategory::Network;
         case CDPErrorCategory::JavaScript: return ErrorCategory::JavaScript;
@@ -129,6 +136,7 @@ inline int toErrorCode(const CDPResponse& response) {
         case CDPErrorCategory::None: return 0;
         case CDPErrorCategory::Protocol: return ErrorCode::ProtocolError;
         case CDPErrorCategory::Target: return ErrorCode::PageCrashed;
+        case CDPErrorCategory::Crashed: return ErrorCode::PageCrashed;
         case CDPErrorCategory::Timeout: return ErrorCode::Timeout;
         case CDPErrorCategory::Connection: return ErrorCode::ConnectionClosed;
         case CDPErrorCategory::JavaScript: return ErrorCode::JavaScriptError;
@@ -194,6 +202,7 @@ struct Error {
     bool isElementStale() const noexcept { return category() == ErrorCategory::ElementStale; }
     bool isNetwork() const noexcept { return category() == ErrorCategory::Network; }
     bool isCancelled() const noexcept { return category() == ErrorCategory::Cancelled; }
+    bool isCrashed() const noexcept { return category() == ErrorCategory::Crashed; }
     bool isRetryable() const noexcept {
         return isTimeout() || isNetwork() || isElementStale();
     }
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "../protocol/CDPClient.hpp"
+#include "Result.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+namespace cdp {
+namespace highlevel {
+
+
+struct ScreencastOptions {
+    std::string format = "jpeg";
+    int quality = 80;
+    int maxWidth = 0;
+    int maxHeight = 0;
+    int everyNthFrame = 1;
+    size_t bufferFrames = 32;
+    size_t maxPendingFrames = 32;
+};
+
+
+struct ScreencastFrame {
+    uint64_t sequence = 0;
+    std::vector<uint8_t> data;
+    double timestamp = 0;
+    double offsetTop = 0;
+    double pageScaleFactor = 1;
+    double deviceWidth = 0;
+    double deviceHeight = 0;
+    double scrollOffsetX = 0;
+    double scrollOffsetY = 0;
+    std::chrono::steady_clock::time_point receivedAt;
+    std::chrono::steady_clock::time_point decodedAt;
+};
+
+using ScreencastFramePtr = std::shared_ptr<const ScreencastFrame>;
+
+
+struct ScreencastStats {
+    uint64_t framesReceived = 0;
+    uint64_t framesDecoded = 0;
+    uint64_t framesDropped = 0;
+    uint64_t framesEvicted = 0;
+    uint64_t ackErrors = 0;
+    double fps = 0;
+    double avgCaptureLatencyMs = 0;
+    double avgDecodeLatencyMs = 0;
+    double maxDecodeLatencyMs = 0;
+};
+
+
+class ScreencastRecorder {
+public:
+    using FrameCallback = std::function<void(const ScreencastFramePtr&)>;
+
+    explicit ScreencastRecorder(CDPClient& client);
+    ~ScreencastRecorder();
+
+    ScreencastRecorder(const ScreencastRecorder&) = delete;
+    ScreencastRecorder& operator=(const ScreencastRecorder&) = delete;
+
+    Result<void> start(const ScreencastOptions& options = {});
+    Result<void> stop();
+    bool isRecording() const { return recording_; }
+
+
+    void onFrame(FrameCallback callback);
+
+
+    ScreencastFramePtr latestFrame() const;
+    ScreencastFramePtr waitForFrame(uint64_t afterSequence, int timeoutMs = 5000) const;
+
+
+    std::vector<ScreencastFramePtr> frames() const;
+    std::vector<ScreencastFramePtr> framesSince(uint64_t sequence) const;
+
+    ScreencastStats stats() const;
+
+private:
+    struct PendingFrame {
+        std::string base64;
+        JsonValue metadata;
+        std::chrono::steady_clock::time_point receivedAt;
+        std::chrono::system_clock::time_point receivedWall;
+    };
+
+    void handleFrame(const CDPEvent& event);
+    void decodeLoop();
+    void store(std::shared_ptr<ScreencastFrame> frame, double captureLatencyMs);
+
+    CDPClient& client_;
+    ScreencastOptions options_;
+    std::atomic<bool> recording_{false};
+    std::thread decoder_;
+    CDPConnection::EventToken frameToken_;
+
+    std::mutex pendingMutex_;
+    std::condition_variable pendingCv_;
+    std::deque<PendingFrame> pending_;
+
+    mutable std::mutex ringMutex_;
+    mutable std::condition_variable ringCv_;
+    std::vector<ScreencastFramePtr> ring_;
+    size_t ringHead_ = 0;
+    size_t ringSize_ = 0;
+    uint64_t nextSequence_ = 1;
+    FrameCallback callback_;
+
+    std::atomic<uint64_t> framesReceived_{0};
+    std::atomic<uint64_t> framesDropped_{0};
+    std::atomic<uint64_t> framesEvicted_{0};
+    std::shared_ptr<std::atomic<uint64_t>> ackErrors_ = std::make_shared<std::atomic<uint64_t>>(0);
+    uint64_t framesDecoded_ = 0;
+    double captureLatencyTotalMs_ = 0;
+    double decodeLatencyTotalMs_ = 0;
+    double decodeLatencyMaxMs_ = 0;
+    std::deque<std::chrono::steady_clock::time_point> recentDecodes_;
+};
+
+}
+}
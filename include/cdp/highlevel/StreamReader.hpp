@@ -0,0 +1,57 @@
+
+
+#pragma once
+
+#include "Result.hpp"
+#include "../protocol/CDPConnection.hpp"
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+namespace cdp {
+namespace highlevel {
+
+
+using StreamSink = std::function<bool(const uint8_t* data, size_t length)>;
+using StreamDoneCallback = std::function<void(const Result<int64_t>&)>;
+
+
+struct StreamReadOptions {
+    int chunkSize = 1024 * 1024;
+    int maxInFlight = 4;
+    int timeoutMs = 60000;
+    bool closeWhenDone = true;
+};
+
+
+class StreamReader {
+public:
+    explicit StreamReader(CDPConnection& conn) : connection_(conn) {}
+
+
+    Result<int64_t> read(const std::string& handle, const StreamSink& sink,
+                         const StreamReadOptions& options = {});
+
+
+    Result<int64_t> readToFile(const std::string& handle, const std::string& path,
+                               const StreamReadOptions& options = {});
+
+
+    Result<std::vector<uint8_t>> readToBytes(const std::string& handle,
+                                             const StreamReadOptions& options = {});
+
+
+    Result<std::string> readToString(const std::string& handle,
+                                     const StreamReadOptions& options = {});
+
+
+    void readAsync(const std::string& handle, StreamSink sink, const StreamReadOptions& options,
+                   StreamDoneCallback done);
+
+private:
+    CDPConnection& connection_;
+};
+
+}
+}
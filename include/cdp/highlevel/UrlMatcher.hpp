@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <cstdint>
+
+namespace cdp {
+namespace highlevel {
+
+
+class UrlMatcher {
+public:
+    UrlMatcher() : UrlMatcher(false) {}
+    explicit UrlMatcher(bool caseSensitive);
+
+    bool caseSensitive() const { return caseSensitive_; }
+
+    void add(uint64_t id, const std::string& pattern);
+    void build();
+    void clear();
+
+
+    std::vector<uint64_t> match(std::string_view url) const;
+    void matchIndices(std::string_view url, std::vector<uint32_t>& indices) const;
+
+    size_t size() const { return patterns_.size(); }
+    bool empty() const { return patterns_.empty(); }
+    uint64_t idAt(size_t index) const { return patterns_[index].id; }
+    const std::string& patternAt(size_t index) const { return patterns_[index].source; }
+
+
+    static bool globMatch(std::string_view pattern, std::string_view url);
+
+private:
+    struct CompiledPattern {
+        uint64_t id = 0;
+        std::string source;
+        std::vector<std::string> fragments;
+        std::string anchor;
+    };
+
+    using FoldTable = std::array<uint8_t, 256>;
+
+    static bool verify(const CompiledPattern& pattern, std::string_view url, const FoldTable& fold);
+
+    bool caseSensitive_ = false;
+    FoldTable fold_{};
+
+    std::vector<CompiledPattern> patterns_;
+    std::vector<uint32_t> alwaysCheck_;
+
+    std::array<uint16_t, 256> classOf_{};
+    size_t classCount_ = 1;
+    std::vector<int32_t> transitions_;
+    std::vector<std::vector<uint32_t>> outputs_;
+    bool built_ = false;
+};
+
+}
+}
@@ -3,8 +3,11 @@
 #pragma once
 
 #include "Result.hpp"
+#include "StreamReader.hpp"
 #include "../protocol/CDPConnection.hpp"
+#include "../domains/Domain.hpp"
 #include "../core/Json.hpp"
+#include "../core/Base64.hpp"
 #include <string>
 #include <vector>
 #include <map>
@@ -18,6 +21,8 @@
 #include <cmath>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
+#include <memory>
 
 namespace cdp {
 namespace highlevel {
@@ -468,7 +473,8 @@ public:
     }
 
     
-    Result<void> startTracing(const std::vector<std::string>& categories = {}) {
+    Result<void> startTracing(const std::vector<std::string>& categories = {},
+                              bool returnAsStream = false) {
         std::string cats = categories.empty()
             ? "-*,devtools.timeline,v8.execute"
             : "";
@@ -477,47 +483,129 @@ public:
             cats += categories[i];
         }
 
-        auto response = connection_.sendCommandSync("Tracing.start",
-            Params().set("categories", cats).build());
+        auto params = Params().set("categories", cats);
+        if (returnAsStream) {
+            params.set("transferMode", "ReturnAsStream");
+            params.set("streamFormat", "json");
+        }
+
+        auto response = connection_.sendCommandSync("Tracing.start", params.build());
         if (response.hasError) return Error::fromCDPResponse(response);
         return {};
     }
 
     
-    Result<std::string> stopTracing() {
-        std::string traceData;
-        std::mutex mutex;
-        std::atomic<bool> done{false};
+    Result<int64_t> stopTracingToSink(const StreamSink& sink, const StreamReadOptions& options = {},
+                                      int timeoutMs = 30000) {
+        struct TraceState {
+            std::mutex mutex;
+            std::condition_variable cv;
+            StreamSink sink;
+            bool done = false;
+            bool anyEvents = false;
+            bool sinkFailed = false;
+            int64_t bytes = 0;
+            std::string streamHandle;
+        };
+        auto state = std::make_shared<TraceState>();
+        state->sink = sink;
+
+        auto write = [](TraceState& st, const std::string& text) {
+            if (st.sinkFailed || !st.sink) return;
+            if (!st.sink(reinterpret_cast<const uint8_t*>(text.data()), text.size())) {
+                st.sinkFailed = true;
+                return;
+            }
+            st.bytes += static_cast<int64_t>(text.size());
+        };
 
-        
-        connection_.onEvent("Tracing.dataCollected", [&](const CDPEvent& evt) {
-            std::lock_guard<std::mutex> lock(mutex);
+        auto dataToken = connection_.onEventScoped("Tracing.dataCollected", [state, write](const CDPEvent& evt) {
+            std::lock_guard<std::mutex> lock(state->mutex);
             const auto* arr = evt.params.getPath("value");
-            if (arr && arr->isArray()) {
-                for (const auto& item : arr->asArray()) {
-                    if (!traceData.empty()) traceData += ",";
-                    traceData += item.serialize();
-                }
+            if (!arr || !arr->isArray()) return;
+            for (const auto& item : arr->asArray()) {
+                write(*state, state->anyEvents ? "," : "[");
+                state->anyEvents = true;
+                write(*state, item.serialize());
             }
         });
 
-        connection_.onEvent("Tracing.tracingComplete", [&](const CDPEvent&) {
-            done = true;
+        auto completeToken = connection_.onEventScoped("Tracing.tracingComplete", [state](const CDPEvent& evt) {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->streamHandle = evt.params.getStringAt("stream");
+                state->done = true;
+            }
+            state->cv.notify_all();
         });
 
-        auto response = connection_.sendCommandSync("Tracing.end", {});
-        if (response.hasError) return Error::fromCDPResponse(response);
+        // A callback already copied out on the message thread may still run after the
+        // tokens go; dropping the sink under the mutex waits for any in-flight write.
+        auto detach = [&]() {
+            dataToken.release();
+            completeToken.release();
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->sink = nullptr;
+        };
 
-        
-        auto start = std::chrono::steady_clock::now();
-        while (!done) {
-            if (std::chrono::steady_clock::now() - start > std::chrono::seconds(30)) {
-                return Error::timeout("stopTracing", 30000);
+        auto response = connection_.sendCommandSync("Tracing.end");
+        if (response.hasError) {
+            detach();
+            return Error::fromCDPResponse(response);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            if (!state->cv.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                                    [&state]() { return state->done; })) {
+                lock.unlock();
+                detach();
+                return Error::timeout("stopTracing", timeoutMs);
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
 
-        return "[" + traceData + "]";
+        if (!state->streamHandle.empty()) {
+            detach();
+            return StreamReader(connection_).read(state->streamHandle, sink, options);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            write(*state, state->anyEvents ? "]" : "[]");
+        }
+        detach();
+        if (state->sinkFailed) return Error::cancelled();
+        return state->bytes;
+    }
+
+    
+    Result<int64_t> stopTracingToFile(const std::string& path, const StreamReadOptions& options = {},
+                                      int timeoutMs = 30000) {
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            return Error(ErrorCode::Internal, "Failed to open trace file: " + path);
+        }
+
+        auto result = stopTracingToSink([&file](const uint8_t* data, size_t length) {
+            file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(length));
+            return static_cast<bool>(file);
+        }, options, timeoutMs);
+
+        if (result && !file) {
+            return Error(ErrorCode::Internal, "Failed to write trace file: " + path);
+        }
+        return result;
+    }
+
+    
+    Result<std::string> stopTracing() {
+        std::string traceData;
+        auto result = stopTracingToSink([&traceData](const uint8_t* data, size_t length) {
+            traceData.append(reinterpret_cast<const char*>(data), length);
+            return true;
+        });
+        if (!result) return result.error();
+        return traceData;
     }
 
 private:
@@ -540,44 +628,112 @@ struct HAREntry {
     std::map<std::string, std::string> responseHeaders;
     std::string requestBody;
     std::string responseBody;
+    bool responseBodyRecorded = false;
+    std::string resourceType;
+    std::string errorText;
+    double dns = -1;
+    double connect = -1;
+    double ssl = -1;
+    double send = -1;
+    double wait = -1;
+};
+
+
+struct HARStreamOptions {
+    int64_t maxFileBytes = 0;
+    size_t maxEntriesPerFile = 0;
 };
 
 class HARExporter {
 public:
-    explicit HARExporter(CDPConnection& conn) : connection_(conn) {}
+    explicit HARExporter(CDPConnection& conn) : connection_(conn) { bodyGuard_->owner = this; }
+    ~HARExporter() {
+        eventTokens_.clear();
+        {
+            std::lock_guard<std::mutex> lock(bodyGuard_->mutex);
+            bodyGuard_->owner = nullptr;
+        }
+        closeStream();
+    }
 
     
     Result<void> startRecording() {
-        entries_.clear();
-        pendingRequests_.clear();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            entries_.clear();
+            pendingRequests_.clear();
+        }
 
         
-        auto r = connection_.sendCommandSync("Network.enable", {});
+        auto r = connection_.sendCommandSync("Network.enable");
         if (r.hasError) return Error::fromCDPResponse(r);
 
         
-        connection_.onEvent("Network.requestWillBeSent", [this](const CDPEvent& evt) {
+        eventTokens_.clear();
+        eventTokens_.push_back(connection_.onEventScoped("Network.requestWillBeSent", [this](const CDPEvent& evt) {
             handleRequestWillBeSent(evt);
-        });
+        }));
 
-        connection_.onEvent("Network.responseReceived", [this](const CDPEvent& evt) {
+        eventTokens_.push_back(connection_.onEventScoped("Network.responseReceived", [this](const CDPEvent& evt) {
             handleResponseReceived(evt);
-        });
+        }));
 
-        connection_.onEvent("Network.loadingFinished", [this](const CDPEvent& evt) {
+        eventTokens_.push_back(connection_.onEventScoped("Network.loadingFinished", [this](const CDPEvent& evt) {
             handleLoadingFinished(evt);
-        });
+        }));
+
+        eventTokens_.push_back(connection_.onEventScoped("Network.loadingFailed", [this](const CDPEvent& evt) {
+            handleLoadingFailed(evt);
+        }));
 
         recording_ = true;
         return {};
     }
 
     
+    Result<void> startStreaming(const std::string& path, const HARStreamOptions& options = {}) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closeStreamLocked();
+            streamPath_ = path;
+            streamOptions_ = options;
+            streamFiles_.clear();
+            streamedEntries_ = 0;
+            lastError_.clear();
+            if (!openStreamFile()) {
+                return Error(ErrorCode::Internal, lastError_);
+            }
+        }
+
+        auto r = startRecording();
+        if (!r) closeStream();
+        return r;
+    }
+
+    
     void stopRecording() {
         recording_ = false;
+        eventTokens_.clear();
+        closeStream();
     }
 
     
+    bool isStreaming() const { return streaming_; }
+    size_t streamedEntries() const { return streamedEntries_; }
+    std::vector<std::string> streamFiles() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return streamFiles_;
+    }
+    std::string lastError() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lastError_;
+    }
+
+    // Off by default; when on, each finished request costs a Network.getResponseBody round trip.
+    void setRecordBodies(bool enable) { recordBodies_ = enable; }
+    bool recordBodies() const { return recordBodies_; }
+
+    
     const std::vector<HAREntry>& entries() const { return entries_; }
 
     
@@ -590,57 +746,98 @@ public:
 
         JsonArray entriesArr;
         for (const auto& e : entries_) {
-            JsonObject entry;
+            entriesArr.push_back(toJson(e));
+        }
 
-            entry["startedDateTime"] = formatTime(e.startTime);
-            entry["time"] = e.duration;
+        log["entries"] = entriesArr;
+        har["log"] = log;
 
-            
-            JsonObject request;
-            request["method"] = e.method;
-            request["url"] = e.url;
-            request["httpVersion"] = "HTTP/1.1";
-
-            JsonArray reqHeaders;
-            for (const auto& [k, v] : e.requestHeaders) {
-                reqHeaders.push_back(JsonObject{{"name", k}, {"value", v}});
-            }
-            request["headers"] = reqHeaders;
-            request["headersSize"] = static_cast<int64_t>(e.requestSize);
-            request["bodySize"] = static_cast<int64_t>(e.requestBody.size());
-            entry["request"] = request;
+        return JsonValue(har).serialize(true);
+    }
 
-            
-            JsonObject response;
-            response["status"] = e.status;
-            response["statusText"] = e.statusText;
-            response["httpVersion"] = "HTTP/1.1";
-
-            JsonArray respHeaders;
-            for (const auto& [k, v] : e.responseHeaders) {
-                respHeaders.push_back(JsonObject{{"name", k}, {"value", v}});
-            }
-            response["headers"] = respHeaders;
+    
+    static JsonValue toJson(const HAREntry& e) {
+        JsonObject entry;
 
-            JsonObject content;
-            content["size"] = e.responseSize;
-            content["mimeType"] = e.mimeType;
-            response["content"] = content;
+        entry["startedDateTime"] = formatTime(e.startTime);
+        entry["time"] = e.duration;
 
-            response["headersSize"] = -1;
-            response["bodySize"] = e.responseSize;
-            entry["response"] = response;
+        
+        JsonObject request;
+        request["method"] = e.method;
+        request["url"] = e.url;
+        request["httpVersion"] = "HTTP/1.1";
+
+        JsonArray reqHeaders;
+        for (const auto& [k, v] : e.requestHeaders) {
+            reqHeaders.push_back(JsonObject{{"name", k}, {"value", v}});
+        }
+        request["headers"] = reqHeaders;
+        request["headersSize"] = static_cast<int64_t>(e.requestSize);
+        request["bodySize"] = static_cast<int64_t>(e.requestBody.size());
+        if (!e.requestBody.empty()) {
+            auto type = e.requestHeaders.find("Content-Type");
+            request["postData"] = JsonObject{
+                {"mimeType", type != e.requestHeaders.end() ? type->second : std::string()},
+                {"text", e.requestBody}};
+        }
+        entry["request"] = request;
 
-            entry["cache"] = JsonObject{};
-            entry["timings"] = JsonObject{{"wait", 0}, {"receive", e.duration}};
+        
+        JsonObject response;
+        response["status"] = e.status;
+        response["statusText"] = e.statusText;
+        response["httpVersion"] = "HTTP/1.1";
+
+        JsonArray respHeaders;
+        for (const auto& [k, v] : e.responseHeaders) {
+            respHeaders.push_back(JsonObject{{"name", k}, {"value", v}});
+        }
+        response["headers"] = respHeaders;
+
+        JsonObject content;
+        content["size"] = e.responseBodyRecorded ? static_cast<int64_t>(e.responseBody.size()) : e.responseSize;
+        content["mimeType"] = e.mimeType;
+        if (!e.responseBody.empty()) {
+            content["text"] = Base64::encode(e.responseBody);
+            content["encoding"] = "base64";
+        }
+        response["content"] = content;
 
-            entriesArr.push_back(entry);
+        response["headersSize"] = -1;
+        response["bodySize"] = e.responseSize;
+        entry["response"] = response;
+
+        entry["cache"] = JsonObject{};
+
+        
+        double wait = e.wait >= 0 ? e.wait : 0;
+        double used = wait;
+        for (double phase : {e.dns, e.connect, e.send}) {
+            if (phase > 0) used += phase;
         }
+        entry["timings"] = JsonObject{
+            {"dns", e.dns}, {"connect", e.connect}, {"ssl", e.ssl},
+            {"send", e.send >= 0 ? e.send : 0}, {"wait", wait},
+            {"receive", (std::max)(0.0, e.duration - used)}};
+
+        if (!e.resourceType.empty()) entry["_resourceType"] = e.resourceType;
+        if (!e.errorText.empty()) entry["_error"] = e.errorText;
+        return JsonValue(entry);
+    }
 
-        log["entries"] = entriesArr;
-        har["log"] = log;
+    
+    static void writePrologue(std::ostream& out) {
+        out << R"({"log":{"version":"1.2","creator":{"name":"CDP for C++","version":"1.0"},"entries":[)";
+    }
 
-        return JsonValue(har).serialize(true);
+    static void writeEntry(std::ostream& out, const HAREntry& entry, bool first) {
+        if (!first) out << ",\n";
+        out << toJson(entry).serialize();
+    }
+
+    static void writeEpilogue(std::ostream& out) {
+        out << "]}}\n";
     }
 
     
@@ -654,16 +851,40 @@ public:
     }
 
 private:
+    struct PendingRequest {
+        HAREntry entry;
+        double timestamp = 0;
+        double endTime = 0;
+    };
+
     void handleRequestWillBeSent(const CDPEvent& evt) {
         if (!recording_) return;
 
         std::lock_guard<std::mutex> lock(mutex_);
 
         std::string requestId = evt.params.getStringAt("requestId");
-        HAREntry entry;
+        auto previous = pendingRequests_.find(requestId);
+        if (previous != pendingRequests_.end()) {
+            if (const JsonValue* redirect = evt.params.find("redirectResponse")) {
+                applyResponse(previous->second.entry, *redirect);
+            }
+            complete(previous, evt.params.getDoubleAt("timestamp", 0));
+        }
+
+        PendingRequest pending;
+        HAREntry& entry = pending.entry;
         entry.url = evt.params.getStringAt("request/url");
         entry.method = evt.params.getStringAt("request/method");
         entry.startTime = evt.params.getDoubleAt("wallTime", 0);
+        entry.resourceType = evt.params.getStringAt("type");
+        entry.requestBody = evt.params.getStringAt("request/postData");
+        const auto* postEntries = evt.params.getPath("request/postDataEntries");
+        if (entry.requestBody.empty() && postEntries && postEntries->isArray()) {
+            for (const auto& part : postEntries->asArray()) {
+                entry.requestBody += Base64::decodeToString(part.getStringAt("bytes"));
+            }
+        }
+        pending.timestamp = evt.params.getDoubleAt("timestamp", 0);
 
         const auto* headers = evt.params.getPath("request/headers");
         if (headers && headers->isObject()) {
@@ -672,7 +893,7 @@ private:
             }
         }
 
-        pendingRequests_[requestId] = entry;
+        pendingRequests_[requestId] = std::move(pending);
     }
 
     void handleResponseReceived(const CDPEvent& evt) {
@@ -684,14 +905,20 @@ private:
         auto it = pendingRequests_.find(requestId);
         if (it == pendingRequests_.end()) return;
 
-        it->second.status = evt.params.getIntAt("response/status");
-        it->second.statusText = evt.params.getStringAt("response/statusText");
-        it->second.mimeType = evt.params.getStringAt("response/mimeType");
+        if (const JsonValue* response = evt.params.find("response")) {
+            applyResponse(it->second.entry, *response);
+        }
+    }
+
+    static void applyResponse(HAREntry& entry, const JsonValue& response) {
+        entry.status = response.getIntAt("status");
+        entry.statusText = response.getStringAt("statusText");
+        entry.mimeType = response.getStringAt("mimeType");
 
-        const auto* headers = evt.params.getPath("response/headers");
+        const auto* headers = response.find("headers");
         if (headers && headers->isObject()) {
             for (const auto& [k, v] : headers->asObject()) {
-                it->second.responseHeaders[k] = v.getString();
+                entry.responseHeaders[k] = v.getString();
             }
         }
     }
@@ -699,34 +926,157 @@ private:
     void handleLoadingFinished(const CDPEvent& evt) {
         if (!recording_) return;
 
+        std::string requestId = evt.params.getStringAt("requestId");
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = pendingRequests_.find(requestId);
+            if (it == pendingRequests_.end()) return;
+
+            it->second.entry.responseSize = evt.params.getInt64At("encodedDataLength");
+            if (!recordBodies_) {
+                complete(it, evt.params.getDoubleAt("timestamp", 0));
+                return;
+            }
+            it->second.endTime = evt.params.getDoubleAt("timestamp", 0);
+        }
+
+        connection_.sendCommand("Network.getResponseBody", JsonObject{{"requestId", requestId}},
+                                [guard = bodyGuard_, requestId](const CDPResponse& response) {
+            std::lock_guard<std::mutex> lock(guard->mutex);
+            if (guard->owner) guard->owner->handleResponseBody(requestId, response);
+        });
+    }
+
+    void handleResponseBody(const std::string& requestId, const CDPResponse& response) {
+        if (!recording_) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pendingRequests_.find(requestId);
+        if (it == pendingRequests_.end()) return;
+
+        HAREntry& entry = it->second.entry;
+        if (!response.hasError) {
+            std::string body = response.result.getStringAt("body");
+            entry.responseBody = response.result.getBoolAt("base64Encoded") ? Base64::decodeToString(body) : body;
+            entry.responseBodyRecorded = true;
+        }
+        complete(it, it->second.endTime);
+    }
+
+    void handleLoadingFailed(const CDPEvent& evt) {
+        if (!recording_) return;
+
         std::lock_guard<std::mutex> lock(mutex_);
 
         std::string requestId = evt.params.getStringAt("requestId");
         auto it = pendingRequests_.find(requestId);
         if (it == pendingRequests_.end()) return;
 
-        it->second.responseSize = evt.params.getInt64At("encodedDataLength");
-        double endTime = evt.params.getDoubleAt("timestamp", 0);
-        if (it->second.startTime > 0 && endTime > 0) {
-            it->second.duration = (endTime - it->second.startTime) * 1000;
-        }
+        it->second.entry.errorText = evt.params.getStringAt("errorText");
+        complete(it, evt.params.getDoubleAt("timestamp", 0));
+    }
 
-        entries_.push_back(std::move(it->second));
+    void complete(std::map<std::string, PendingRequest>::iterator it, double endTime) {
+        HAREntry entry = std::move(it->second.entry);
+        if (it->second.timestamp > 0 && endTime > 0) {
+            entry.duration = (endTime - it->second.timestamp) * 1000;
+        }
         pendingRequests_.erase(it);
+
+        if (!streaming_) {
+            entries_.push_back(std::move(entry));
+            return;
+        }
+
+        bool rotate = (streamOptions_.maxEntriesPerFile > 0 && fileEntries_ >= streamOptions_.maxEntriesPerFile) ||
+                      (streamOptions_.maxFileBytes > 0 && static_cast<int64_t>(stream_.tellp()) >= streamOptions_.maxFileBytes);
+        if (rotate && fileEntries_ > 0) {
+            openStreamFile();
+        }
+
+        writeEntry(stream_, entry, fileEntries_ == 0);
+        stream_.flush();
+        fileEntries_++;
+        streamedEntries_++;
+    }
+
+    bool openStreamFile() {
+        std::string path = streamPath_;
+        if (!streamFiles_.empty()) {
+            std::string suffix = "." + std::to_string(streamFiles_.size());
+            size_t dot = path.find_last_of('.');
+            size_t slash = path.find_last_of("/\\");
+            if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+                path.insert(dot, suffix);
+            } else {
+                path += suffix;
+            }
+        }
+
+        std::ofstream next(path, std::ios::binary | std::ios::trunc);
+        if (!next) {
+            lastError_ = "Failed to open HAR file: " + path;
+            return false;
+        }
+        if (streaming_) finishStreamFile();
+        stream_ = std::move(next);
+        streamFiles_.push_back(path);
+        writePrologue(stream_);
+        stream_.flush();
+        fileEntries_ = 0;
+        streaming_ = true;
+        return true;
+    }
+
+    void finishStreamFile() {
+        writeEpilogue(stream_);
+        stream_.close();
     }
 
-    std::string formatTime(double timestamp) const {
+    void closeStream() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closeStreamLocked();
+    }
+
+    void closeStreamLocked() {
+        if (!streaming_) return;
+        finishStreamFile();
+        streaming_ = false;
+        pendingRequests_.clear();
+    }
+
+    static std::string formatTime(double timestamp) {
         auto time = static_cast<time_t>(timestamp);
+        int millis = static_cast<int>((timestamp - std::floor(timestamp)) * 1000);
         std::ostringstream oss;
-        oss << std::put_time(std::gmtime(&time), "%Y-%m-%dT%H:%M:%S.000Z");
+        oss << std::put_time(std::gmtime(&time), "%Y-%m-%dT%H:%M:%S.")
+            << std::setw(3) << std::setfill('0') << millis << 'Z';
         return oss.str();
     }
 
     CDPConnection& connection_;
-    bool recording_ = false;
+    std::atomic<bool> recording_{false};
+    std::atomic<bool> recordBodies_{false};
+    std::vector<CDPConnection::EventToken> eventTokens_;
+
+    // Body replies can arrive after destruction; they only reach the exporter through here.
+    struct BodyGuard {
+        std::mutex mutex;
+        HARExporter* owner = nullptr;
+    };
+    std::shared_ptr<BodyGuard> bodyGuard_ = std::make_shared<BodyGuard>();
     std::vector<HAREntry> entries_;
-    std::map<std::string, HAREntry> pendingRequests_;
-    std::mutex mutex_;
+    std::map<std::string, PendingRequest> pendingRequests_;
+    mutable std::mutex mutex_;
+
+    std::ofstream stream_;
+    std::string streamPath_;
+    HARStreamOptions streamOptions_;
+    std::vector<std::string> streamFiles_;
+    std::atomic<bool> streaming_{false};
+    size_t fileEntries_ = 0;
+    std::atomic<size_t> streamedEntries_{0};
+    std::string lastError_;
 };
 
 
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Result.hpp"
+#include "Screencast.hpp"
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+
+namespace cdp {
+namespace highlevel {
+
+
+struct VideoWriterOptions {
+    int fps = 25;
+    int width = 0;
+    int height = 0;
+    bool honorTimestamps = true;
+    int64_t maxFileBytes = 0xFFFFFFFFLL - (64LL << 20);
+};
+
+
+class MjpegAviWriter {
+public:
+    MjpegAviWriter() = default;
+    ~MjpegAviWriter();
+
+    MjpegAviWriter(const MjpegAviWriter&) = delete;
+    MjpegAviWriter& operator=(const MjpegAviWriter&) = delete;
+
+    Result<void> open(const std::string& path, const VideoWriterOptions& options = {});
+
+
+    Result<void> writeFrame(const uint8_t* jpeg, size_t length, double timestamp = 0);
+    Result<void> close();
+
+    bool isOpen() const { return file_.is_open(); }
+    uint32_t frameCount() const { return totalChunks_; }
+    uint32_t framesWritten() const { return framesWritten_; }
+    uint32_t framesSkipped() const { return framesSkipped_; }
+    int64_t bytesWritten() const { return static_cast<int64_t>(position_); }
+
+private:
+    Result<void> writeChunk(const uint8_t* data, uint32_t length);
+    void writeHeader();
+    void patchHeader();
+
+    std::ofstream file_;
+    std::ofstream index_;
+    std::string path_;
+    std::string indexPath_;
+    VideoWriterOptions options_;
+
+    uint64_t position_ = 0;
+    uint32_t totalChunks_ = 0;
+    uint32_t framesWritten_ = 0;
+    uint32_t framesSkipped_ = 0;
+    uint32_t maxChunkSize_ = 0;
+    int width_ = 0;
+    int height_ = 0;
+    double firstTimestamp_ = -1;
+    int64_t lastSlot_ = -1;
+};
+
+
+class ScreencastVideoRecorder {
+public:
+    explicit ScreencastVideoRecorder(CDPClient& client) : recorder_(client) {}
+    ~ScreencastVideoRecorder();
+
+    Result<void> start(const std::string& path,
+                       const VideoWriterOptions& videoOptions = {},
+                       const ScreencastOptions& screencastOptions = {});
+    Result<void> stop();
+
+    bool isRecording() const { return recorder_.isRecording(); }
+    ScreencastStats stats() const { return recorder_.stats(); }
+    uint32_t framesWritten() const;
+    std::string lastError() const;
+
+private:
+    ScreencastRecorder recorder_;
+    MjpegAviWriter writer_;
+    mutable std::mutex writerMutex_;
+    std::string lastError_;
+};
+
+}
+}
@@ -0,0 +1,49 @@
+
+
+#pragma once
+
+#include "Transport.hpp"
+#include <string>
+#include <atomic>
+#include <mutex>
+
+namespace cdp {
+
+
+class PipeTransport : public Transport {
+public:
+    
+    PipeTransport(int readFd, int writeFd, WireFormat format = WireFormat::Json);
+    ~PipeTransport() override;
+
+    PipeTransport(const PipeTransport&) = delete;
+    PipeTransport& operator=(const PipeTransport&) = delete;
+
+    bool isConnected() const override { return connected_.load(); }
+    bool send(const std::string& message) override;
+    int pollAll(int timeoutMs = 0) override;
+    void close() override;
+    WireFormat wireFormat() const override { return format_; }
+
+    
+    void setMaxMessageSize(size_t size) { maxMessageSize_ = size; }
+
+    int readFd() const { return readFd_; }
+    int writeFd() const { return writeFd_; }
+
+private:
+    void fail(const std::string& reason);
+    int dispatchFrames();
+
+    int readFd_ = -1;
+    int writeFd_ = -1;
+    WireFormat format_ = WireFormat::Json;
+    std::atomic<bool> connected_{false};
+    std::string buffer_;
+    size_t scanned_ = 0;
+    size_t maxMessageSize_ = 256 * 1024 * 1024;
+    std::mutex sendMutex_;
+    std::mutex recvMutex_;
+};
+
+}
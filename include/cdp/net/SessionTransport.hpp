@@ -0,0 +1,93 @@
+
+
+#pragma once
+
+#include "Transport.hpp"
+#include <string>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <atomic>
+
+namespace cdp {
+
+
+class SessionRouter : public std::enable_shared_from_this<SessionRouter> {
+public:
+    static std::shared_ptr<SessionRouter> create(std::unique_ptr<Transport> root);
+    ~SessionRouter();
+
+    SessionRouter(const SessionRouter&) = delete;
+    SessionRouter& operator=(const SessionRouter&) = delete;
+
+
+    std::unique_ptr<Transport> open(const std::string& sessionId = "");
+
+    bool isConnected() const { return root_->isConnected(); }
+    WireFormat wireFormat() const { return root_->wireFormat(); }
+    size_t sessionCount() const;
+    void close();
+
+
+    static std::string sessionIdOf(const std::string& message, WireFormat format);
+    static std::string withSessionId(const std::string& message, const std::string& sessionId, WireFormat format);
+
+private:
+    friend class SessionTransport;
+
+    struct Channel {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<std::string> queue;
+        bool closed = false;
+        std::string closeReason;
+    };
+
+    explicit SessionRouter(std::unique_ptr<Transport> root) : root_(std::move(root)) {}
+
+    void route(const std::string& message);
+    void closeChannel(const std::string& sessionId, const std::string& reason);
+    void closeAll(const std::string& reason);
+    void detach(const std::string& sessionId, const std::shared_ptr<Channel>& channel);
+    bool pump(int timeoutMs);
+
+    std::unique_ptr<Transport> root_;
+    mutable std::mutex channelsMutex_;
+    std::map<std::string, std::shared_ptr<Channel>> channels_;
+    std::mutex pumpMutex_;
+};
+
+
+class SessionTransport : public Transport {
+public:
+    ~SessionTransport() override;
+
+    SessionTransport(const SessionTransport&) = delete;
+    SessionTransport& operator=(const SessionTransport&) = delete;
+
+    bool isConnected() const override;
+    bool send(const std::string& message) override;
+    int pollAll(int timeoutMs = 0) override;
+    void close() override;
+    WireFormat wireFormat() const override { return router_->wireFormat(); }
+
+    const std::string& sessionId() const { return sessionId_; }
+
+private:
+    friend class SessionRouter;
+
+    SessionTransport(std::shared_ptr<SessionRouter> router, std::string sessionId,
+                     std::shared_ptr<SessionRouter::Channel> channel)
+        : router_(std::move(router)), sessionId_(std::move(sessionId)), channel_(std::move(channel)) {}
+
+    int drain();
+
+    std::shared_ptr<SessionRouter> router_;
+    std::string sessionId_;
+    std::shared_ptr<SessionRouter::Channel> channel_;
+    std::atomic<bool> open_{true};
+};
+
+}
@@ -0,0 +1,77 @@
+
+
+#pragma once
+
+#include <string>
+#include <functional>
+#include <mutex>
+
+namespace cdp {
+
+
+enum class WireFormat {
+    Json,
+    Cbor
+};
+
+
+struct TransportCallbacks {
+    std::function<void(const std::string&)> onMessage;
+    std::function<void(const std::string&)> onClose;
+    std::function<void(const std::string&)> onError;
+};
+
+
+class Transport {
+public:
+    virtual ~Transport() = default;
+
+    
+    virtual bool isConnected() const = 0;
+    virtual bool send(const std::string& message) = 0;
+    virtual int pollAll(int timeoutMs = 0) = 0;
+    virtual void close() = 0;
+
+    
+    virtual bool ping() { return isConnected(); }
+    virtual WireFormat wireFormat() const { return WireFormat::Json; }
+
+    void setCallbacks(const TransportCallbacks& callbacks) {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        callbacks_ = callbacks;
+    }
+
+protected:
+    void emitMessage(const std::string& message) {
+        std::function<void(const std::string&)> cb;
+        {
+            std::lock_guard<std::mutex> lock(callbackMutex_);
+            cb = callbacks_.onMessage;
+        }
+        if (cb) cb(message);
+    }
+
+    void emitClose(const std::string& reason) {
+        std::function<void(const std::string&)> cb;
+        {
+            std::lock_guard<std::mutex> lock(callbackMutex_);
+            cb = callbacks_.onClose;
+        }
+        if (cb) cb(reason);
+    }
+
+    void emitError(const std::string& error) {
+        std::function<void(const std::string&)> cb;
+        {
+            std::lock_guard<std::mutex> lock(callbackMutex_);
+            cb = callbacks_.onError;
+        }
+        if (cb) cb(error);
+    }
+
+private:
+    std::mutex callbackMutex_;
+    TransportCallbacks callbacks_;
+};
+
+}
@@ -58,6 +58,8 @@
 #include "../domains/WebAudio.hpp"
 #include <memory>
 #include <functional>
+#include <map>
+#include <mutex>
 #include <chrono>
 
 namespace cdp {
@@ -83,6 +85,17 @@ struct CDPClientConfig {
     int reconnectMaxAttempts = 0;       
     double reconnectBackoffMultiplier = 2.0;  
 
+    // Pages enable Inspector so Inspector.targetCrashed marks the target dead.
+    bool detectCrashes = false;
+
+    // Probes wait behind the renderer main thread, so the deadline must outlast long tasks.
+    // Probing pauses while a JavaScript dialog is open or the debugger is paused.
+    bool enableWatchdog = false;
+    int watchdogIntervalMs = 1000;
+    int watchdogDeadlineMs = 5000;
+    int watchdogMissedProbes = 2;
+    bool watchdogReviveOnLateReply = false;
+
     
     std::string validate() const {
         if (host.empty()) {
@@ -103,6 +116,15 @@ struct CDPClientConfig {
         if (reconnectDelayMs < 100) {
             return "Reconnect delay must be at least 100ms";
         }
+        if (watchdogIntervalMs < 100) {
+            return "Watchdog interval must be at least 100ms";
+        }
+        if (watchdogDeadlineMs <= 0) {
+            return "Watchdog deadline must be positive";
+        }
+        if (watchdogMissedProbes < 1) {
+            return "Watchdog missed probes must be at least 1";
+        }
         return "";  
     }
 
@@ -137,9 +159,22 @@ public:
     [[nodiscard]] bool connectToBrowser();
 
     
+    [[nodiscard]] bool connect(std::unique_ptr<Transport> transport);
+    [[nodiscard]] bool connectToTarget(std::unique_ptr<Transport> transport);
+
+    
     void disconnect();
 
     
+    [[nodiscard]] bool retarget(const std::string& webSocketUrl);
+    [[nodiscard]] bool retarget(std::unique_ptr<Transport> transport);
+
+    // Hooks run in order after retarget() re-enables domains; returning false fails the retarget.
+    using RetargetHook = std::function<bool(std::string& error)>;
+    uint64_t addRetargetHook(RetargetHook hook);
+    void removeRetargetHook(uint64_t id);
+
+    
     [[nodiscard]] bool isConnected() const;
 
     
@@ -230,12 +265,17 @@ public:
 
 private:
     void enableDomains();
+    bool runRetargetHooks();
     void setError(const std::string& error) { lastError_ = error; }
 
     CDPClientConfig config_;
     CDPConnection connection_;
+    EventToken loadEventToken_;
     std::atomic<bool> pageLoaded_{false};
     std::string lastError_;  
+    std::mutex retargetHooksMutex_;
+    std::map<uint64_t, RetargetHook> retargetHooks_;
+    uint64_t nextRetargetHook_ = 1;
 };
 
 } 
@@ -4,9 +4,13 @@
 
 #include "../net/WebSocket.hpp"
 #include "../net/HttpClient.hpp"
+#include "../net/Transport.hpp"
 #include "../core/Json.hpp"
 #include <string>
+#include <string_view>
+#include <initializer_list>
 #include <map>
+#include <set>
 #include <functional>
 #include <atomic>
 #include <mutex>
@@ -58,6 +62,7 @@ enum class CDPErrorCategory {
     None = 0,           
     Protocol,           
     Target,             
+    Crashed,            
     Timeout,            
     Connection,         
     JavaScript,         
@@ -73,12 +78,15 @@ struct CDPResponse {
     int errorCode = 0;
     std::string errorMessage;
 
+    static constexpr int TargetCrashedCode = 501;
+
     bool isSuccess() const { return !hasError; }
     explicit operator bool() const { return !hasError; }
 
     
     CDPErrorCategory errorCategory() const {
         if (!hasError) return CDPErrorCategory::None;
+        if (errorCode == TargetCrashedCode) return CDPErrorCategory::Crashed;
 
         
         if (errorCode == -32601) return CDPErrorCategory::Protocol;  
@@ -103,6 +111,7 @@ struct CDPResponse {
     
     bool isTimeout() const { return errorCategory() == CDPErrorCategory::Timeout; }
     bool isTargetClosed() const { return errorCategory() == CDPErrorCategory::Target; }
+    bool isCrashed() const { return errorCategory() == CDPErrorCategory::Crashed; }
     bool isNotFound() const { return errorCategory() == CDPErrorCategory::NotFound; }
     bool isInvalidState() const { return errorCategory() == CDPErrorCategory::InvalidState; }
     bool isProtocolError() const { return errorCategory() == CDPErrorCategory::Protocol; }
@@ -215,6 +224,15 @@ struct ReconnectSettings {
 };
 
 
+struct WatchdogSettings {
+    bool enabled = false;
+    int intervalMs = 1000;
+    int deadlineMs = 5000;
+    int missedProbes = 2;
+    bool reviveOnLateReply = false;
+};
+
+
 class CDPConnection {
 public:
     CDPConnection();
@@ -236,9 +254,16 @@ public:
     bool connect(const std::string& host, int port, const CDPTarget& target);
     bool connectToTarget(const std::string& host, int port, int targetIndex = 0);
     bool connectToBrowser(const std::string& host = "localhost", int port = 9222);
+    bool connect(std::unique_ptr<Transport> transport);
     void disconnect();
 
-    bool isConnected() const { return ws_.isConnected(); }
+
+    bool retarget(const std::string& wsUrl);
+    bool retarget(std::unique_ptr<Transport> transport);
+
+    bool isConnected() const { return transport_ ? transport_->isConnected() : ws_.isConnected(); }
+    bool usesTransport() const { return transport_ != nullptr; }
+    bool cborWire() const { return transport_ && transport_->wireFormat() == WireFormat::Cbor; }
     ConnectionState connectionState() const { return connectionState_.load(); }
 
     
@@ -253,6 +278,10 @@ public:
     
     int64_t sendCommand(const std::string& method, ResponseCallback callback = nullptr);
     int64_t sendCommand(const std::string& method, const JsonValue& params, ResponseCallback callback = nullptr);
+    int64_t sendCommandRaw(const std::string& method, std::initializer_list<std::string_view> paramsJson,
+                           ResponseCallback callback = nullptr);
+    int64_t sendCommandRawCbor(const std::string& method, std::initializer_list<std::string_view> paramsCbor,
+                               ResponseCallback callback = nullptr);
 
     
     CDPResponse sendCommandSync(const std::string& method, int timeoutMs = 30000);
@@ -263,6 +292,9 @@ public:
     void onAnyEvent(EventCallback callback);
     void removeEventHandler(const std::string& method);
     void removeEventHandlersByPrefix(const std::string& prefix);  
+    std::vector<std::string> eventHandlerMethods() const;
+    // Drops every handler not owned by a live EventToken, plus the onAnyEvent handler.
+    void removeUnscopedEventHandlers();
 
     
     class EventToken {
@@ -304,6 +336,7 @@ public:
 
         bool isActive() const { return active_; }
         explicit operator bool() const { return active_; }
+        const std::string& eventName() const { return eventName_; }
 
     private:
         CDPConnection* connection_ = nullptr;
@@ -311,10 +344,7 @@ public:
         bool active_ = false;
     };
 
-    [[nodiscard]] EventToken onEventScoped(const std::string& method, EventCallback callback) {
-        onEvent(method, std::move(callback));
-        return EventToken(this, method);
-    }
+    [[nodiscard]] EventToken onEventScoped(const std::string& method, EventCallback callback);
 
     
     void poll(int timeoutMs = 0);
@@ -334,6 +364,22 @@ public:
     bool isReconnectThreadRunning() const { return reconnectThreadRunning_.load(); }
 
     
+    void setWatchdogSettings(const WatchdogSettings& settings) { watchdogSettings_ = settings; }
+    const WatchdogSettings& watchdogSettings() const { return watchdogSettings_; }
+    void stopWatchdogThread();
+    bool isWatchdogRunning() const { return watchdogThreadRunning_.load(); }
+
+    
+    void failTarget(const std::string& reason);
+    bool isTargetDead() const { return targetDead_.load(); }
+    std::string deadReason() const;
+
+    void onTargetDead(std::function<void(const std::string& reason)> callback) {
+        std::lock_guard<std::mutex> lock(errorCallbackMutex_);
+        targetDeadCallback_ = std::move(callback);
+    }
+
+    
     void onError(std::function<void(const std::string&)> callback) {
         std::lock_guard<std::mutex> lock(errorCallbackMutex_);
         errorCallback_ = callback;
@@ -414,28 +460,39 @@ public:
 
     
     int64_t currentMessageId() const { return messageId_.load(); }
+    size_t pendingCommandCount() const;
+    void failPendingCommands(const std::string& message, int errorCode = 0);
 
 private:
     void handleMessage(const std::string& message);
+    int64_t dispatchCommand(int64_t id, const std::string& message, ResponseCallback callback);
     void handleResponse(const JsonValue& json);
     void handleEvent(const JsonValue& json);
     void messageThreadFunc();
     void heartbeatThreadFunc();
+    void startWatchdogThread();
+    void watchdogThreadFunc();
+    bool probingSuspended() const { return dialogOpen_.load() || debuggerPaused_.load(); }
+    void failTarget(const std::string& reason, int64_t probeId);
     void attemptReconnect();
 
     int64_t nextMessageId() { return ++messageId_; }
+    bool sendMessage(const std::string& message) { return transport_ ? transport_->send(message) : ws_.send(message); }
+    std::string encodeRequest(const CDPRequest& request) const;
 
     WebSocket ws_;
+    std::unique_ptr<Transport> transport_;
     std::atomic<int64_t> messageId_{0};
 
     
-    std::mutex callbackMutex_;
+    mutable std::mutex callbackMutex_;
     std::map<int64_t, ResponseCallback> pendingCallbacks_;
     std::map<int64_t, std::promise<CDPResponse>> pendingPromises_;
 
     
     mutable std::shared_mutex eventMutex_;
     std::map<std::string, EventCallback> eventHandlers_;
+    std::set<std::string> scopedEventHandlers_;
     EventCallback anyEventHandler_;
 
     
@@ -445,6 +502,7 @@ private:
     std::function<void(int)> reconnectingCallback_;
     std::function<void()> reconnectedCallback_;
     std::function<void(const std::string&)> reconnectFailedCallback_;
+    std::function<void(const std::string&)> targetDeadCallback_;
 
     
     std::thread messageThread_;
@@ -460,6 +518,19 @@ private:
     std::mutex activityMutex_;
 
     
+    WatchdogSettings watchdogSettings_;
+    std::thread watchdogThread_;
+    std::atomic<bool> watchdogThreadRunning_{false};
+    std::atomic<bool> stopWatchdogThread_{false};
+    std::atomic<bool> dialogOpen_{false};
+    std::atomic<bool> debuggerPaused_{false};
+
+    
+    std::atomic<bool> targetDead_{false};
+    std::string deadReason_;
+    int64_t watchdogProbeId_ = -1;
+
+    
     ReconnectSettings reconnectSettings_;
     std::atomic<ConnectionState> connectionState_{ConnectionState::Disconnected};
     std::string lastWsUrl_;                    
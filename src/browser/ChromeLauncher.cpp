@@ -11,6 +11,7 @@
 #include "cdp/net/HttpClient.hpp"
 #include "cdp/core/Json.hpp"
 #include "cdp/browser/ExtensionLoader.hpp"
+#include "cdp/browser/ProfileTemplate.hpp"
 #include <algorithm>
 #include <thread>
 #include <random>
@@ -553,6 +554,11 @@ bool ChromeLauncher::launch(const ChromeLaunchOptions& options) {
     options_ = options;
     lastError_.clear();
 
+    if (options_.remoteDebuggingPipe) {
+        lastError_ = "--remote-debugging-pipe is not supported on this platform";
+        return false;
+    }
+
     
     if (options_.debuggingPort == 0) {
         int freePort = findFreePort();
@@ -625,13 +631,16 @@ bool ChromeLauncher::launch(const ChromeLaunchOptions& options) {
         }
 
         
+        bool fromTemplate = options_.useTempProfile && !options_.profileTemplateDir.empty();
         try {
-            extension::ExtensionLoader::loadExtensions(
-                userDataDir_,
-                options_.extensions,
-                options_.extensionIncognitoEnabled,
-                options_.extensionFileAccessEnabled
-            );
+            if (!fromTemplate) {
+                extension::ExtensionLoader::loadExtensions(
+                    userDataDir_,
+                    options_.extensions,
+                    options_.extensionIncognitoEnabled,
+                    options_.extensionFileAccessEnabled
+                );
+            }
 
             
             if (options_.disableExtensions) {
@@ -726,15 +735,21 @@ bool ChromeLauncher::startProcess(const std::string& chromePath,
 bool ChromeLauncher::createTempProfile() {
 #ifdef _WIN32
     
-    cleanupStaleTempProfiles(options_.tempProfilePrefix);
+    std::string tempPath = options_.tempProfileRoot;
+    if (tempPath.empty()) {
+        char buffer[MAX_PATH];
+        DWORD len = GetTempPathA(MAX_PATH, buffer);
+        if (len == 0 || len > MAX_PATH) {
+            lastError_ = "Failed to get temp directory";
+            return false;
+        }
+        tempPath = buffer;
+    } else if (tempPath.back() != '\\' && tempPath.back() != '/') {
+        tempPath += '\\';
+    }
 
     
-    char tempPath[MAX_PATH];
-    DWORD len = GetTempPathA(MAX_PATH, tempPath);
-    if (len == 0 || len > MAX_PATH) {
-        lastError_ = "Failed to get temp directory";
-        return false;
-    }
+    cleanupStaleTempProfiles(options_.tempProfilePrefix, tempPath);
 
     
     std::random_device rd;
@@ -742,7 +757,25 @@ bool ChromeLauncher::createTempProfile() {
     std::uniform_int_distribution<> dis(100000, 999999);
 
     std::string uniqueFolder = options_.tempProfilePrefix + std::to_string(dis(gen));
-    userDataDir_ = std::string(tempPath) + uniqueFolder;
+    userDataDir_ = tempPath + uniqueFolder;
+
+    if (!options_.profileTemplateDir.empty()) {
+        ProfileTemplate profileTemplate(options_.profileTemplateDir);
+        if (!profileTemplate.isPrepared()) {
+            lastError_ = "Profile template is not prepared: " + options_.profileTemplateDir;
+            return false;
+        }
+        if (!profileTemplate.matches(options_)) {
+            lastError_ = "Profile template was prepared with different extensions: " + options_.profileTemplateDir;
+            return false;
+        }
+        if (!profileTemplate.cloneTo(userDataDir_)) {
+            lastError_ = profileTemplate.lastError();
+            ProfileDeleter::instance().remove(userDataDir_);
+            return false;
+        }
+        return true;
+    }
 
     
     try {
@@ -764,29 +797,35 @@ void ChromeLauncher::cleanupTempProfile() {
         return;
     }
 
-    
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    if (options_.asyncProfileCleanup) {
+        ProfileDeleter::instance().remove(userDataDir_);
+        return;
+    }
 
-    try {
-        std::filesystem::remove_all(userDataDir_);
-    } catch (const std::exception&) {
-        
+    
+    for (int attempt = 0; attempt < 10; ++attempt) {
+        std::error_code ec;
+        std::filesystem::remove_all(userDataDir_, ec);
+        if (!ec) return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
     }
 }
 
-int ChromeLauncher::cleanupStaleTempProfiles(const std::string& prefix) {
+int ChromeLauncher::cleanupStaleTempProfiles(const std::string& prefix, const std::string& directory) {
     int cleanedCount = 0;
 
 #ifdef _WIN32
     
-    char tempPath[MAX_PATH];
-    DWORD len = GetTempPathA(MAX_PATH, tempPath);
-    if (len == 0 || len > MAX_PATH) {
-        return 0;
+    std::filesystem::path tempDir(directory);
+    if (directory.empty()) {
+        char tempPath[MAX_PATH];
+        DWORD len = GetTempPathA(MAX_PATH, tempPath);
+        if (len == 0 || len > MAX_PATH) {
+            return 0;
+        }
+        tempDir = tempPath;
     }
 
-    std::filesystem::path tempDir(tempPath);
-
     try {
         for (const auto& entry : std::filesystem::directory_iterator(tempDir)) {
             if (!entry.is_directory()) {
@@ -947,6 +986,15 @@ bool ChromeLauncher::waitForExit(int timeoutMs) {
 #endif
 }
 
+ProcessMonitor* ChromeLauncher::startProcessMonitor(const ProcessMonitorOptions&) {
+    lastError_ = "Process monitoring is not supported on this platform";
+    return nullptr;
+}
+
+ProcessTreeSample ChromeLauncher::sampleProcessTree(bool) const {
+    return ProcessTreeSample{};
+}
+
 uint32_t ChromeLauncher::getProcessId() const {
 #ifdef _WIN32
     return processId_;
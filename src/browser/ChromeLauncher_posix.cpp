@@ -7,9 +7,11 @@
 #include "cdp/net/Socket.hpp"
 #include "cdp/core/Json.hpp"
 #include "cdp/browser/ExtensionLoader.hpp"
+#include "cdp/browser/ProfileTemplate.hpp"
 
 #include <algorithm>
 #include <thread>
+#include <atomic>
 #include <random>
 #include <sstream>
 #include <cstdlib>
@@ -25,16 +27,46 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <pwd.h>
+#include <poll.h>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
 namespace cdp {
 
+namespace {
+
+int openPidFd(pid_t pid) {
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
+int remainingMs(std::chrono::steady_clock::time_point deadline) {
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now()).count();
+    return left > 0 ? static_cast<int>(left) : 0;
+}
+
+}
+
 
 std::vector<std::string> ChromeLaunchOptions::buildArgs() const {
     std::vector<std::string> args;
 
     
-    args.push_back("--remote-debugging-port=" + std::to_string(debuggingPort));
-    args.push_back("--remote-debugging-address=" + host);
+    if (remoteDebuggingPipe) {
+        args.push_back(pipeCbor ? "--remote-debugging-pipe=cbor" : "--remote-debugging-pipe");
+    } else {
+        args.push_back("--remote-debugging-port=" + std::to_string(debuggingPort));
+        args.push_back("--remote-debugging-address=" + host);
+    }
 
     
     if (!userDataDir.empty()) {
@@ -154,6 +186,7 @@ ChromeLauncher::~ChromeLauncher() {
     if (options_.killOnDestruct && launched_.load()) {
         kill();
     }
+    closeProcessFds();
 
     if (options_.cleanupTempProfile && options_.useTempProfile) {
         cleanupTempProfile();
@@ -166,9 +199,20 @@ ChromeLauncher::ChromeLauncher(ChromeLauncher&& other) noexcept
     , userDataDir_(std::move(other.userDataDir_))
     , lastError_(std::move(other.lastError_))
     , launched_(other.launched_.load())
+    , pipeTransport_(std::move(other.pipeTransport_))
+    , processMonitor_(std::move(other.processMonitor_))
     , processId_(other.processId_)
+    , pidFd_(other.pidFd_)
+    , stderrFd_(other.stderrFd_)
+    , exited_(other.exited_)
+    , exitStatus_(other.exitStatus_)
+    , browserWsUrl_(std::move(other.browserWsUrl_))
+    , stderrTail_(std::move(other.stderrTail_))
+    , stderrPump_(std::move(other.stderrPump_))
 {
     other.processId_ = 0;
+    other.pidFd_ = -1;
+    other.stderrFd_ = -1;
     other.launched_ = false;
 }
 
@@ -177,14 +221,26 @@ ChromeLauncher& ChromeLauncher::operator=(ChromeLauncher&& other) noexcept {
         if (options_.killOnDestruct && launched_.load()) {
             kill();
         }
+        closeProcessFds();
 
         options_ = std::move(other.options_);
         installation_ = std::move(other.installation_);
         userDataDir_ = std::move(other.userDataDir_);
         lastError_ = std::move(other.lastError_);
         launched_ = other.launched_.load();
+        pipeTransport_ = std::move(other.pipeTransport_);
+        processMonitor_ = std::move(other.processMonitor_);
         processId_ = other.processId_;
+        pidFd_ = other.pidFd_;
+        stderrFd_ = other.stderrFd_;
+        exited_ = other.exited_;
+        exitStatus_ = other.exitStatus_;
+        browserWsUrl_ = std::move(other.browserWsUrl_);
+        stderrTail_ = std::move(other.stderrTail_);
+        stderrPump_ = std::move(other.stderrPump_);
         other.processId_ = 0;
+        other.pidFd_ = -1;
+        other.stderrFd_ = -1;
         other.launched_ = false;
     }
     return *this;
@@ -467,7 +523,9 @@ bool ChromeLauncher::launch(const ChromeLaunchOptions& options) {
     lastError_.clear();
 
     
-    if (options_.debuggingPort == 0) {
+    if (options_.remoteDebuggingPipe) {
+        options_.debuggingPort = 0;
+    } else if (options_.debuggingPort == 0) {
         int freePort = findFreePort();
         if (freePort == 0) {
             lastError_ = "Failed to find a free port for CDP debugging";
@@ -529,13 +587,17 @@ bool ChromeLauncher::launch(const ChromeLaunchOptions& options) {
                       << "              This modifies Secure Preferences. Ensure you have backups!\n";
         }
 
+        
+        bool fromTemplate = options_.useTempProfile && !options_.profileTemplateDir.empty();
         try {
-            extension::ExtensionLoader::loadExtensions(
-                userDataDir_,
-                options_.extensions,
-                options_.extensionIncognitoEnabled,
-                options_.extensionFileAccessEnabled
-            );
+            if (!fromTemplate) {
+                extension::ExtensionLoader::loadExtensions(
+                    userDataDir_,
+                    options_.extensions,
+                    options_.extensionIncognitoEnabled,
+                    options_.extensionFileAccessEnabled
+                );
+            }
 
             if (options_.disableExtensions) {
                 options_.disableExtensions = false;
@@ -557,17 +619,58 @@ bool ChromeLauncher::launch(const ChromeLaunchOptions& options) {
     launched_ = true;
 
     
+    if (options_.remoteDebuggingPipe) {
+        startStderrPump({});
+        return true;
+    }
+
+    
     if (!waitForReady(options_.maxStartupWaitMs)) {
-        lastError_ = "Chrome started but CDP endpoint not available after " +
-                     std::to_string(options_.maxStartupWaitMs) + "ms";
+        if (lastError_.empty()) {
+            lastError_ = "Chrome started but CDP endpoint not available after " +
+                         std::to_string(options_.maxStartupWaitMs) + "ms";
+        }
         return false;
     }
 
+    startStderrPump({});
     return true;
 }
 
 bool ChromeLauncher::startProcess(const std::string& chromePath,
                                    const std::vector<std::string>& args) {
+    closeProcessFds();
+    exited_ = false;
+    exitStatus_ = 0;
+    browserWsUrl_.clear();
+    stderrTail_.clear();
+
+    
+    int errPipe[2] = {-1, -1};
+    bool captureStderr = ::pipe(errPipe) == 0;
+    if (captureStderr) {
+        fcntl(errPipe[0], F_SETFD, FD_CLOEXEC);
+        fcntl(errPipe[1], F_SETFD, FD_CLOEXEC);
+        fcntl(errPipe[0], F_SETFL, O_NONBLOCK);
+    }
+
+    
+    pipeTransport_.reset();
+    int toChrome[2] = {-1, -1};
+    int fromChrome[2] = {-1, -1};
+    if (options_.remoteDebuggingPipe) {
+        if (::pipe(toChrome) != 0 || ::pipe(fromChrome) != 0) {
+            for (int fd : {toChrome[0], toChrome[1], fromChrome[0], fromChrome[1], errPipe[0], errPipe[1]}) {
+                if (fd >= 0) close(fd);
+            }
+            lastError_ = "Failed to create remote debugging pipes";
+            return false;
+        }
+        for (int fd : {toChrome[0], toChrome[1], fromChrome[0], fromChrome[1]}) {
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+    }
+
     pid_t pid = fork();
 
     if (pid == 0) {
@@ -584,11 +687,23 @@ bool ChromeLauncher::startProcess(const std::string& chromePath,
         argv.push_back(nullptr);
 
         
+        if (captureStderr) {
+            dup2(errPipe[1], STDERR_FILENO);
+        }
+
+        
+        if (options_.remoteDebuggingPipe) {
+            int commandFd = fcntl(toChrome[0], F_DUPFD_CLOEXEC, 10);
+            int replyFd = fcntl(fromChrome[1], F_DUPFD_CLOEXEC, 10);
+            if (commandFd < 0 || replyFd < 0 || dup2(commandFd, 3) < 0 || dup2(replyFd, 4) < 0) {
+                _exit(1);
+            }
+        }
         if (options_.headless) {
             int devnull = open("/dev/null", O_WRONLY);
             if (devnull >= 0) {
                 dup2(devnull, STDOUT_FILENO);
-                dup2(devnull, STDERR_FILENO);
+                if (!captureStderr) dup2(devnull, STDERR_FILENO);
                 close(devnull);
             }
         }
@@ -599,24 +714,44 @@ bool ChromeLauncher::startProcess(const std::string& chromePath,
         
         _exit(1);
     } else if (pid < 0) {
+        for (int fd : {toChrome[0], toChrome[1], fromChrome[0], fromChrome[1], errPipe[0], errPipe[1]}) {
+            if (fd >= 0) close(fd);
+        }
         lastError_ = "Failed to fork process";
         return false;
     }
 
     
     processId_ = pid;
+    pidFd_ = openPidFd(pid);
+    if (captureStderr) {
+        close(errPipe[1]);
+        stderrFd_ = errPipe[0];
+    }
+    if (options_.remoteDebuggingPipe) {
+        close(toChrome[0]);
+        close(fromChrome[1]);
+        pipeTransport_ = std::make_unique<PipeTransport>(fromChrome[0], toChrome[1],
+                                                         options_.pipeCbor ? WireFormat::Cbor : WireFormat::Json);
+    }
     return true;
 }
 
 bool ChromeLauncher::createTempProfile() {
     
-    cleanupStaleTempProfiles(options_.tempProfilePrefix);
+    std::string tmpDir = options_.tempProfileRoot;
+    if (tmpDir.empty() && !options_.profileTemplateDir.empty()) {
+        tmpDir = ProfileTemplate::preferredRoot();
+    }
+    if (tmpDir.empty()) {
+        const char* env = getenv("TMPDIR");
+        if (!env) env = getenv("TMP");
+        if (!env) env = getenv("TEMP");
+        tmpDir = env ? env : "/tmp";
+    }
 
     
-    const char* tmpDir = getenv("TMPDIR");
-    if (!tmpDir) tmpDir = getenv("TMP");
-    if (!tmpDir) tmpDir = getenv("TEMP");
-    if (!tmpDir) tmpDir = "/tmp";
+    cleanupStaleTempProfiles(options_.tempProfilePrefix, tmpDir);
 
     
     std::random_device rd;
@@ -624,7 +759,25 @@ bool ChromeLauncher::createTempProfile() {
     std::uniform_int_distribution<> dis(100000, 999999);
 
     std::string uniqueFolder = options_.tempProfilePrefix + std::to_string(dis(gen));
-    userDataDir_ = std::string(tmpDir) + "/" + uniqueFolder;
+    userDataDir_ = tmpDir + "/" + uniqueFolder;
+
+    if (!options_.profileTemplateDir.empty()) {
+        ProfileTemplate profileTemplate(options_.profileTemplateDir);
+        if (!profileTemplate.isPrepared()) {
+            lastError_ = "Profile template is not prepared: " + options_.profileTemplateDir;
+            return false;
+        }
+        if (!profileTemplate.matches(options_)) {
+            lastError_ = "Profile template was prepared with different extensions: " + options_.profileTemplateDir;
+            return false;
+        }
+        if (!profileTemplate.cloneTo(userDataDir_)) {
+            lastError_ = profileTemplate.lastError();
+            ProfileDeleter::instance().remove(userDataDir_);
+            return false;
+        }
+        return true;
+    }
 
     try {
         std::filesystem::create_directories(userDataDir_);
@@ -641,8 +794,10 @@ void ChromeLauncher::cleanupTempProfile() {
         return;
     }
 
-    
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    if (options_.asyncProfileCleanup) {
+        ProfileDeleter::instance().remove(userDataDir_);
+        return;
+    }
 
     try {
         std::filesystem::remove_all(userDataDir_);
@@ -651,14 +806,18 @@ void ChromeLauncher::cleanupTempProfile() {
     }
 }
 
-int ChromeLauncher::cleanupStaleTempProfiles(const std::string& prefix) {
+int ChromeLauncher::cleanupStaleTempProfiles(const std::string& prefix, const std::string& directory) {
     int cleanedCount = 0;
 
-    const char* tmpDir = getenv("TMPDIR");
-    if (!tmpDir) tmpDir = getenv("TMP");
-    if (!tmpDir) tmpDir = getenv("TEMP");
-    if (!tmpDir) tmpDir = "/tmp";
+    std::string tmpDir = directory;
+    if (tmpDir.empty()) {
+        const char* env = getenv("TMPDIR");
+        if (!env) env = getenv("TMP");
+        if (!env) env = getenv("TEMP");
+        tmpDir = env ? env : "/tmp";
+    }
 
+    std::vector<std::string> stale;
     try {
         for (const auto& entry : std::filesystem::directory_iterator(tmpDir)) {
             if (!entry.is_directory()) {
@@ -671,22 +830,39 @@ int ChromeLauncher::cleanupStaleTempProfiles(const std::string& prefix) {
             }
 
             
-            try {
-                std::filesystem::remove_all(entry.path());
-                ++cleanedCount;
-            } catch (const std::filesystem::filesystem_error&) {
-                
+            char lockTarget[256];
+            ssize_t lockLen = readlink((entry.path() / "SingletonLock").c_str(), lockTarget, sizeof(lockTarget) - 1);
+            if (lockLen > 0) {
+                lockTarget[lockLen] = '\0';
+                const char* dash = strrchr(lockTarget, '-');
+                int ownerPid = dash ? atoi(dash + 1) : 0;
+                if (ownerPid > 0 && (::kill(ownerPid, 0) == 0 || errno == EPERM)) {
+                    continue;
+                }
             }
+
+            stale.push_back(entry.path().string());
         }
     } catch (const std::filesystem::filesystem_error&) {
         
     }
 
+    
+    for (const auto& path : stale) {
+        ProfileDeleter::instance().remove(path);
+        ++cleanedCount;
+    }
     return cleanedCount;
 }
 
 bool ChromeLauncher::isRunning() const {
-    if (processId_ <= 0) return false;
+    if (processId_ <= 0 || exited_) return false;
+
+    
+    if (pidFd_ >= 0) {
+        pollfd pfd{pidFd_, POLLIN, 0};
+        return ::poll(&pfd, 1, 0) == 0;
+    }
 
     
     if (::kill(processId_, 0) == 0) {
@@ -699,11 +875,134 @@ bool ChromeLauncher::isRunning() const {
     return result == 0;  
 }
 
+std::optional<std::string> ChromeLauncher::scanStderr(std::string& pending, std::string& lastLine) {
+    static const std::string marker = "DevTools listening on ";
+    size_t eol;
+    while ((eol = pending.find('\n')) != std::string::npos) {
+        std::string line = pending.substr(0, eol);
+        pending.erase(0, eol + 1);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        size_t at = line.find(marker);
+        if (at != std::string::npos) return line.substr(at + marker.size());
+        if (!line.empty()) lastLine = line;
+    }
+    return std::nullopt;
+}
+
 bool ChromeLauncher::waitForReady(int timeoutMs) {
-    auto startTime = std::chrono::steady_clock::now();
+    if (stderrFd_ < 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(options_.startupWaitMs));
+        return pollEndpointReady((std::max)(timeoutMs - options_.startupWaitMs, 0));
+    }
 
     
-    std::this_thread::sleep_for(std::chrono::milliseconds(options_.startupWaitMs));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::string pending;
+    bool stderrOpen = true;
+
+    while (stderrOpen) {
+        int waitMs = remainingMs(deadline);
+        if (waitMs <= 0) return false;
+
+        pollfd fds[2] = {{stderrFd_, POLLIN, 0}, {pidFd_, POLLIN, 0}};
+        int ready = ::poll(fds, pidFd_ >= 0 ? 2 : 1, waitMs);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (ready == 0) continue;
+
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            char buffer[4096];
+            ssize_t n = ::read(stderrFd_, buffer, sizeof(buffer));
+            if (n > 0) {
+                pending.append(buffer, static_cast<size_t>(n));
+                if (auto url = scanStderr(pending, stderrTail_)) {
+                    browserWsUrl_ = *url;
+                    startStderrPump(pending);
+                    return true;
+                }
+                continue;
+            }
+            if (n == 0) {
+                stderrOpen = false;
+            } else if (errno != EAGAIN && errno != EINTR) {
+                stderrOpen = false;
+            }
+        }
+
+        if (pidFd_ >= 0 && (fds[1].revents & POLLIN)) {
+            break;
+        }
+    }
+
+    if (waitForProcessExit((std::min)(remainingMs(deadline), 250))) {
+        lastError_ = "Chrome process exited unexpectedly";
+        if (!stderrTail_.empty()) lastError_ += ": " + stderrTail_;
+        return false;
+    }
+
+    
+    return pollEndpointReady(remainingMs(deadline));
+}
+
+struct ChromeLauncher::StderrPump {
+    StderrPump(int fd, bool forward) : fd_(fd), forward_(forward) {
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~StderrPump() {
+        stop_ = true;
+        if (thread_.joinable()) thread_.join();
+        close(fd_);
+    }
+
+    static void forward(const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::write(STDERR_FILENO, data, size);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+    }
+
+private:
+    void run() {
+        char buffer[4096];
+        while (!stop_) {
+            pollfd pfd{fd_, POLLIN, 0};
+            int ready = ::poll(&pfd, 1, 100);
+            if (ready < 0 && errno != EINTR) return;
+            if (ready <= 0) continue;
+
+            ssize_t n = ::read(fd_, buffer, sizeof(buffer));
+            if (n > 0) {
+                if (forward_) forward(buffer, static_cast<size_t>(n));
+                continue;
+            }
+            if (n == 0 || (errno != EAGAIN && errno != EINTR)) return;
+        }
+    }
+
+    int fd_;
+    bool forward_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+void ChromeLauncher::startStderrPump(const std::string& pending) {
+    if (stderrFd_ < 0 || stderrPump_) return;
+
+    bool forward = !options_.headless;
+    if (forward && !pending.empty()) StderrPump::forward(pending.data(), pending.size());
+    stderrPump_ = std::make_unique<StderrPump>(stderrFd_, forward);
+    stderrFd_ = -1;
+}
+
+bool ChromeLauncher::pollEndpointReady(int timeoutMs) {
+    auto startTime = std::chrono::steady_clock::now();
 
     while (true) {
         if (!isRunning()) {
@@ -740,6 +1039,10 @@ std::string ChromeLauncher::getDebugUrl() const {
 }
 
 std::string ChromeLauncher::getBrowserWebSocketUrl() const {
+    if (!browserWsUrl_.empty() && isRunning()) {
+        return browserWsUrl_;
+    }
+
     HttpClient http;
     if (!http.connect(options_.host, options_.debuggingPort)) {
         return "";
@@ -759,65 +1062,129 @@ std::string ChromeLauncher::getBrowserWebSocketUrl() const {
 }
 
 void ChromeLauncher::kill() {
+    if (processMonitor_) {
+        processMonitor_->stop();
+    }
     if (processId_ > 0) {
-        
-        ::kill(processId_, SIGTERM);
+        if (!exited_) {
+            
+            ::kill(processId_, SIGTERM);
 
-        
-        for (int i = 0; i < 50; ++i) {
-            int status;
-            pid_t result = waitpid(processId_, &status, WNOHANG);
-            if (result != 0) {
-                break;  
+            
+            if (!waitForProcessExit(5000)) {
+                ::kill(processId_, SIGKILL);
+                waitForProcessExit(-1);
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
-
-        
-        if (isRunning()) {
-            ::kill(processId_, SIGKILL);
-            waitpid(processId_, nullptr, 0);
         }
 
         processId_ = 0;
     }
+    closeProcessFds();
     launched_ = false;
 }
 
 bool ChromeLauncher::waitForExit(int timeoutMs) {
-    if (processId_ <= 0) return true;
+    return waitForProcessExit(timeoutMs);
+}
+
+ProcessMonitor* ChromeLauncher::startProcessMonitor(const ProcessMonitorOptions& options) {
+    uint32_t pid = getProcessId();
+    if (pid == 0) {
+        lastError_ = "Chrome is not running";
+        return nullptr;
+    }
+
+    processMonitor_ = std::make_unique<ProcessMonitor>(pid, options);
+    if (!processMonitor_->start()) {
+        lastError_ = "Process monitoring is not supported on this platform";
+        processMonitor_.reset();
+        return nullptr;
+    }
+    return processMonitor_.get();
+}
+
+ProcessTreeSample ChromeLauncher::sampleProcessTree(bool collectPss) const {
+    return ProcessMonitor::sampleTree(getProcessId(), collectPss);
+}
+
+bool ChromeLauncher::waitForProcessExit(int timeoutMs) {
+    if (processId_ <= 0 || exited_) return true;
+
+    
+    if (pidFd_ >= 0) {
+        pollfd pfd{pidFd_, POLLIN, 0};
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds((std::max)(timeoutMs, 0));
+        while (true) {
+            int ready = ::poll(&pfd, 1, timeoutMs < 0 ? -1 : remainingMs(deadline));
+            if (ready > 0) return reapProcess(true);
+            if (ready == 0) return false;
+            if (errno != EINTR) break;
+        }
+    }
 
     if (timeoutMs < 0) {
-        
-        int status;
-        waitpid(processId_, &status, 0);
-        return true;
+        return reapProcess(true);
     }
 
     
     auto startTime = std::chrono::steady_clock::now();
     while (true) {
-        int status;
-        pid_t result = waitpid(processId_, &status, WNOHANG);
-        if (result != 0) {
-            return true;  
+        if (reapProcess(false)) {
+            return true;
         }
 
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::steady_clock::now() - startTime).count();
         if (elapsed >= timeoutMs) {
-            return false;  
+            return false;
         }
 
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
     }
 }
 
+bool ChromeLauncher::reapProcess(bool block) {
+    if (processId_ <= 0 || exited_) return true;
+
+    int status = 0;
+    pid_t result;
+    do {
+        result = waitpid(processId_, &status, block ? 0 : WNOHANG);
+    } while (result < 0 && errno == EINTR);
+
+    if (result == processId_) {
+        exited_ = true;
+        exitStatus_ = status;
+        return true;
+    }
+    if (result < 0) {
+        
+        exited_ = true;
+        return true;
+    }
+    return false;
+}
+
+void ChromeLauncher::closeProcessFds() {
+    stderrPump_.reset();
+    if (pidFd_ >= 0) {
+        close(pidFd_);
+        pidFd_ = -1;
+    }
+    if (stderrFd_ >= 0) {
+        close(stderrFd_);
+        stderrFd_ = -1;
+    }
+}
+
 uint32_t ChromeLauncher::getProcessId() const {
     return static_cast<uint32_t>(processId_);
 }
 
 int ChromeLauncher::getExitCode() const {
+    if (exited_) {
+        return WIFEXITED(exitStatus_) ? WEXITSTATUS(exitStatus_) : -1;
+    }
     if (processId_ <= 0) return -1;
 
     int status;
@@ -0,0 +1,401 @@
+
+
+#include "cdp/browser/ProcessMonitor.hpp"
+#include <algorithm>
+#include <set>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace cdp {
+
+namespace {
+
+#ifdef __linux__
+
+bool readProcFile(const std::string& path, std::string& out) {
+    out.clear();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    char buffer[4096];
+    while (true) {
+        ssize_t n = ::read(fd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        out.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return !out.empty();
+}
+
+bool readStat(uint32_t pid, ProcStat& fields) {
+    std::string stat;
+    if (!readProcFile("/proc/" + std::to_string(pid) + "/stat", stat)) return false;
+    return ProcessMonitor::parseStat(stat, fields);
+}
+
+void readProcessType(uint32_t pid, bool isRoot, std::string& type, std::string& subType) {
+    std::string cmdline;
+    readProcFile("/proc/" + std::to_string(pid) + "/cmdline", cmdline);
+
+    type.clear();
+    subType.clear();
+    size_t start = 0;
+    while (start < cmdline.size()) {
+        size_t end = cmdline.find('\0', start);
+        if (end == std::string::npos) end = cmdline.size();
+        std::string_view arg(cmdline.data() + start, end - start);
+        if (arg.rfind("--type=", 0) == 0) {
+            type = std::string(arg.substr(7));
+        } else if (arg.rfind("--utility-sub-type=", 0) == 0) {
+            subType = std::string(arg.substr(19));
+        }
+        start = end + 1;
+    }
+    if (type.empty()) {
+        type = isRoot ? "browser" : "other";
+    }
+}
+
+uint64_t readPss(uint32_t pid) {
+    std::string rollup;
+    if (!readProcFile("/proc/" + std::to_string(pid) + "/smaps_rollup", rollup)) return 0;
+    size_t pos = rollup.find("\nPss:");
+    if (pos == std::string::npos) return 0;
+    return std::strtoull(rollup.c_str() + pos + 5, nullptr, 10) * 1024;
+}
+
+size_t countFds(uint32_t pid) {
+    DIR* dir = opendir(("/proc/" + std::to_string(pid) + "/fd").c_str());
+    if (!dir) return 0;
+    size_t count = 0;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') count++;
+    }
+    closedir(dir);
+    return count;
+}
+
+bool readChildren(uint32_t pid, std::vector<uint32_t>& children) {
+    DIR* dir = opendir(("/proc/" + std::to_string(pid) + "/task").c_str());
+    if (!dir) return false;
+
+    bool supported = false;
+    std::string content;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+        std::string path = "/proc/" + std::to_string(pid) + "/task/" + entry->d_name + "/children";
+        if (::access(path.c_str(), R_OK) != 0) continue;
+        supported = true;
+        if (!readProcFile(path, content)) continue;
+        const char* p = content.c_str();
+        char* end;
+        while (true) {
+            unsigned long child = std::strtoul(p, &end, 10);
+            if (end == p) break;
+            children.push_back(static_cast<uint32_t>(child));
+            p = end;
+        }
+    }
+    closedir(dir);
+    return supported;
+}
+
+std::vector<uint32_t> scanProcessTree(uint32_t rootPid) {
+    std::map<uint32_t, std::vector<uint32_t>> childrenOf;
+    DIR* dir = opendir("/proc");
+    if (!dir) return {rootPid};
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') continue;
+        uint32_t pid = static_cast<uint32_t>(std::strtoul(entry->d_name, nullptr, 10));
+        ProcStat fields;
+        if (readStat(pid, fields)) {
+            childrenOf[fields.parentPid].push_back(pid);
+        }
+    }
+    closedir(dir);
+
+    std::vector<uint32_t> tree{rootPid};
+    for (size_t i = 0; i < tree.size(); i++) {
+        auto it = childrenOf.find(tree[i]);
+        if (it != childrenOf.end()) {
+            tree.insert(tree.end(), it->second.begin(), it->second.end());
+        }
+    }
+    return tree;
+}
+
+#endif
+
+}
+
+
+uint64_t ProcessTreeSample::rssBytesOfType(const std::string& type) const {
+    uint64_t total = 0;
+    for (const auto& process : processes) {
+        if (process.type == type) total += process.rssBytes;
+    }
+    return total;
+}
+
+size_t ProcessTreeSample::countOfType(const std::string& type) const {
+    return static_cast<size_t>(std::count_if(processes.begin(), processes.end(),
+        [&](const ProcessSample& process) { return process.type == type; }));
+}
+
+
+ProcessMonitor::ProcessMonitor(uint32_t rootPid, const ProcessMonitorOptions& options)
+    : rootPid_(rootPid), options_(options) {
+    options_.intervalMs = (std::max)(options_.intervalMs, 10);
+    options_.pssEverySamples = (std::max)(options_.pssEverySamples, 1);
+    options_.historySize = (std::max)(options_.historySize, static_cast<size_t>(1));
+}
+
+ProcessMonitor::~ProcessMonitor() {
+    stop();
+}
+
+bool ProcessMonitor::start() {
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return true;
+    if (rootPid_ == 0) return false;
+    if (thread_.joinable()) thread_.join();
+    running_ = true;
+    thread_ = std::thread(&ProcessMonitor::run, this);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ProcessMonitor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
+        thread_.join();
+    }
+}
+
+bool ProcessMonitor::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+void ProcessMonitor::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        lock.unlock();
+        ProcessTreeSample sample = sampleNow();
+        lock.lock();
+
+
+        if (sample.processes.empty()) {
+            running_ = false;
+            break;
+        }
+        wake_.wait_for(lock, std::chrono::milliseconds(options_.intervalMs), [this] { return !running_; });
+    }
+}
+
+void ProcessMonitor::onSample(SampleCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    callback_ = std::move(callback);
+}
+
+void ProcessMonitor::setProcessInfoProvider(ProcessInfoProvider provider) {
+    std::lock_guard<std::mutex> lock(sampleMutex_);
+    processInfoProvider_ = std::move(provider);
+}
+
+std::optional<ProcessTreeSample> ProcessMonitor::latest() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (history_.empty()) return std::nullopt;
+    return history_.back();
+}
+
+std::vector<ProcessTreeSample> ProcessMonitor::history(size_t maxSamples) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = maxSamples == 0 ? history_.size() : (std::min)(maxSamples, history_.size());
+    return std::vector<ProcessTreeSample>(history_.end() - static_cast<std::ptrdiff_t>(count), history_.end());
+}
+
+void ProcessMonitor::applyProcessInfo(const JsonValue& info) {
+    const JsonValue& list = info.contains("processInfo") ? info["processInfo"] : info;
+    if (!list.isArray()) return;
+
+    reportedTypes_.clear();
+    for (const auto& entry : list.asArray()) {
+        uint32_t pid = static_cast<uint32_t>(entry["id"].getInt());
+        std::string type = entry["type"].getString();
+        if (pid != 0 && !type.empty()) {
+            reportedTypes_[pid] = type;
+        }
+    }
+}
+
+ProcessTreeSample ProcessMonitor::sampleNow() {
+    ProcessTreeSample sample;
+    sample.timestamp = std::chrono::system_clock::now();
+
+#ifdef __linux__
+    std::lock_guard<std::mutex> sampleLock(sampleMutex_);
+
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = sampleCount_ == 0 ? 0.0 : std::chrono::duration<double>(now - lastSampleTime_).count();
+    lastSampleTime_ = now;
+    bool refreshPss = options_.collectPss && sampleCount_ % static_cast<uint64_t>(options_.pssEverySamples) == 0;
+    bool refreshInfo = processInfoProvider_ && options_.processInfoEverySamples > 0 &&
+                       sampleCount_ % static_cast<uint64_t>(options_.processInfoEverySamples) == 0;
+    sampleCount_++;
+
+    if (refreshInfo) {
+        try {
+            applyProcessInfo(processInfoProvider_());
+        } catch (const std::exception&) {
+
+        }
+    }
+
+    static const double ticksPerSecond = static_cast<double>(sysconf(_SC_CLK_TCK));
+    static const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+
+    std::set<uint32_t> seen;
+    for (uint32_t pid : listProcessTree(rootPid_)) {
+        ProcStat fields;
+        if (!readStat(pid, fields)) continue;
+
+        auto it = tracked_.find(pid);
+        bool fresh = it == tracked_.end() || it->second.startTime != fields.startTime;
+        Tracked& tracked = tracked_[pid];
+        if (fresh) {
+            tracked = Tracked{};
+            tracked.startTime = fields.startTime;
+        }
+        
+        if (fresh || tracked.command != fields.command) {
+            tracked.command = fields.command;
+            readProcessType(pid, pid == rootPid_, tracked.type, tracked.subType);
+        }
+
+        ProcessSample process;
+        process.pid = pid;
+        process.parentPid = fields.parentPid;
+        process.type = tracked.type;
+        process.subType = tracked.subType;
+        auto reported = reportedTypes_.find(pid);
+        if (reported != reportedTypes_.end()) {
+            process.type = reported->second;
+        }
+        process.cpuSeconds = static_cast<double>(fields.cpuTicks) / ticksPerSecond;
+        if (!fresh && elapsed > 0) {
+            process.cpuPercent = static_cast<double>(fields.cpuTicks - tracked.cpuTicks) / ticksPerSecond / elapsed * 100.0;
+        }
+        tracked.cpuTicks = fields.cpuTicks;
+        process.rssBytes = fields.rssPages * pageSize;
+        if (options_.collectPss && (refreshPss || fresh)) {
+            tracked.pssBytes = readPss(pid);
+        }
+        process.pssBytes = tracked.pssBytes;
+        if (options_.collectFds) {
+            process.openFds = countFds(pid);
+        }
+        process.threads = fields.threads;
+
+        sample.cpuPercent += process.cpuPercent;
+        sample.rssBytes += process.rssBytes;
+        sample.pssBytes += process.pssBytes;
+        sample.openFds += process.openFds;
+        sample.processes.push_back(std::move(process));
+        seen.insert(pid);
+    }
+
+    for (auto it = tracked_.begin(); it != tracked_.end();) {
+        it = seen.count(it->first) ? std::next(it) : tracked_.erase(it);
+    }
+
+    SampleCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        history_.push_back(sample);
+        while (history_.size() > options_.historySize) {
+            history_.pop_front();
+        }
+        callback = callback_;
+    }
+    if (callback) callback(sample);
+#endif
+
+    return sample;
+}
+
+std::vector<uint32_t> ProcessMonitor::listProcessTree(uint32_t rootPid) {
+#ifdef __linux__
+    if (rootPid == 0) return {};
+
+    std::vector<uint32_t> tree{rootPid};
+    for (size_t i = 0; i < tree.size(); i++) {
+        std::vector<uint32_t> children;
+        if (!readChildren(tree[i], children)) {
+            if (i == 0 && ::access(("/proc/" + std::to_string(rootPid)).c_str(), F_OK) == 0) {
+                return scanProcessTree(rootPid);
+            }
+            continue;
+        }
+        tree.insert(tree.end(), children.begin(), children.end());
+    }
+    if (::access(("/proc/" + std::to_string(rootPid)).c_str(), F_OK) != 0) return {};
+    return tree;
+#else
+    (void)rootPid;
+    return {};
+#endif
+}
+
+ProcessTreeSample ProcessMonitor::sampleTree(uint32_t rootPid, bool collectPss, bool collectFds) {
+    ProcessMonitorOptions options;
+    options.collectPss = collectPss;
+    options.collectFds = collectFds;
+    options.historySize = 1;
+    ProcessMonitor monitor(rootPid, options);
+    return monitor.sampleNow();
+}
+
+bool ProcessMonitor::parseStat(const std::string& stat, ProcStat& fields) {
+    size_t lparen = stat.find('(');
+    size_t paren = stat.rfind(')');
+    if (lparen == std::string::npos || paren == std::string::npos || paren < lparen || paren + 2 >= stat.size()) {
+        return false;
+    }
+    fields.command = stat.substr(lparen + 1, paren - lparen - 1);
+
+    const char* p = stat.c_str() + paren + 2;
+    uint64_t values[22] = {};
+    int field = 0;
+    for (; field < 22 && *p; field++) {
+        while (*p == ' ') p++;
+        if (field > 0) {
+            values[field] = std::strtoull(p, nullptr, 10);
+        }
+        while (*p && *p != ' ') p++;
+    }
+    if (field < 22) return false;
+
+    fields.parentPid = static_cast<uint32_t>(values[1]);
+    fields.cpuTicks = values[11] + values[12];
+    fields.threads = static_cast<size_t>(values[17]);
+    fields.startTime = values[19];
+    fields.rssPages = values[21];
+    return true;
+}
+
+}
@@ -0,0 +1,432 @@
+
+
+#include "cdp/browser/ProfileTemplate.hpp"
+#include "cdp/browser/ExtensionLoader.hpp"
+
+#include <filesystem>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+#ifdef __linux__
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
+
+namespace cdp {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+
+const char* kRuntimeState[] = {
+    "SingletonLock",
+    "SingletonSocket",
+    "SingletonCookie",
+    "DevToolsActivePort",
+    "Crashpad",
+    "ShaderCache",
+    "GrShaderCache",
+    "GraphiteDawnCache",
+    "Default/Cache",
+    "Default/Code Cache",
+    "Default/GPUCache",
+    "Default/DawnCache",
+};
+
+#if !defined(_WIN32)
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool copyStream(int in, int out) {
+    char buffer[128 * 1024];
+    while (true) {
+        ssize_t n = ::read(in, buffer, sizeof(buffer));
+        if (n == 0) return true;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (!writeAll(out, buffer, static_cast<size_t>(n))) return false;
+    }
+}
+
+bool copyContents(int in, int out, off_t size, bool& reflinked) {
+#ifdef __linux__
+
+    if (::ioctl(out, FICLONE, in) == 0) {
+        reflinked = true;
+        return true;
+    }
+
+    off_t copied = 0;
+    while (copied < size) {
+        ssize_t n = ::copy_file_range(in, nullptr, out, nullptr, static_cast<size_t>(size - copied), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && copied == 0 &&
+            (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP)) {
+            return copyStream(in, out);
+        }
+        if (n <= 0) return false;
+        copied += n;
+    }
+    return true;
+#else
+    (void)size;
+    return copyStream(in, out);
+#endif
+}
+
+bool copyFile(const fs::path& from, const fs::path& to, uint64_t& bytes, bool& reflinked, std::string& error) {
+    reflinked = false;
+    int in = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        error = "Failed to open " + from.string() + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat st {};
+    fstat(in, &st);
+    int out = ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 07777);
+    if (out < 0) {
+        error = "Failed to create " + to.string() + ": " + std::strerror(errno);
+        ::close(in);
+        return false;
+    }
+
+    bool ok = copyContents(in, out, st.st_size, reflinked);
+    if (!ok) error = "Failed to copy " + from.string() + ": " + std::strerror(errno);
+    ::close(in);
+    if (::close(out) != 0 && ok) {
+        error = "Failed to write " + to.string() + ": " + std::strerror(errno);
+        ok = false;
+    }
+    if (ok) bytes += static_cast<uint64_t>(st.st_size);
+    return ok;
+}
+
+#else
+
+bool copyFile(const fs::path& from, const fs::path& to, uint64_t& bytes, bool& reflinked, std::string& error) {
+    reflinked = false;
+    std::error_code ec;
+    fs::copy_file(from, to, fs::copy_options::overwrite_existing, ec);
+    if (ec) {
+        error = "Failed to copy " + from.string() + ": " + ec.message();
+        return false;
+    }
+    bytes += fs::file_size(to, ec);
+    return true;
+}
+
+#endif
+
+}
+
+
+ProfileTemplate::ProfileTemplate(std::string dir) : dir_(std::move(dir)) {}
+
+bool ProfileTemplate::isPrepared() const {
+    std::error_code ec;
+    return !dir_.empty() && fs::exists(fs::path(dir_) / kMarkerFile, ec);
+}
+
+bool ProfileTemplate::matches(const ChromeLaunchOptions& options) const {
+    if (!isPrepared()) return false;
+    std::ifstream marker(fs::path(dir_) / kMarkerFile);
+    std::string version;
+    std::getline(marker, version);
+    std::string key((std::istreambuf_iterator<char>(marker)), std::istreambuf_iterator<char>());
+    return key == extensionKey(options);
+}
+
+std::string ProfileTemplate::extensionKey(const ChromeLaunchOptions& options) {
+    if (options.extensions.empty()) return {};
+
+    std::vector<std::string> paths;
+    for (const auto& extension : options.extensions) {
+        std::error_code ec;
+        fs::path path = fs::weakly_canonical(fs::absolute(extension, ec), ec);
+        paths.push_back(ec ? extension : path.string());
+    }
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+
+    std::string key = "incognito=" + std::string(options.extensionIncognitoEnabled ? "1" : "0") +
+                      "\nfileAccess=" + (options.extensionFileAccessEnabled ? "1" : "0") + "\n";
+    for (const auto& path : paths) key += path + "\n";
+    return key;
+}
+
+bool ProfileTemplate::prepare(const ChromeLaunchOptions& options) {
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+    if (ec) {
+        lastError_ = "Failed to create profile template directory: " + ec.message();
+        return false;
+    }
+    fs::remove(fs::path(dir_) / kMarkerFile, ec);
+
+    ChromeLaunchOptions opts = options;
+    opts.useTempProfile = false;
+    opts.userDataDir = dir_;
+    opts.profileTemplateDir.clear();
+    opts.remoteDebuggingPipe = false;
+    opts.startUrl = "about:blank";
+
+
+    if (!opts.extensions.empty()) {
+        try {
+            extension::ExtensionLoader::loadExtensions(
+                dir_,
+                opts.extensions,
+                opts.extensionIncognitoEnabled,
+                opts.extensionFileAccessEnabled
+            );
+        } catch (const std::exception& e) {
+            lastError_ = "Failed to load extensions: " + std::string(e.what());
+            return false;
+        }
+        opts.extensions.clear();
+        opts.disableExtensions = false;
+    }
+
+    {
+        ChromeLauncher launcher(opts);
+        if (!launcher.launch()) {
+            lastError_ = "Failed to launch Chrome for profile template: " + launcher.lastError();
+            return false;
+        }
+
+        launcher.kill();
+    }
+
+    stripRuntimeState();
+
+    std::ofstream marker(fs::path(dir_) / kMarkerFile);
+    marker << "1\n" << extensionKey(options);
+    if (!marker) {
+        lastError_ = "Failed to write profile template marker";
+        return false;
+    }
+    return true;
+}
+
+void ProfileTemplate::stripRuntimeState() {
+    for (const char* entry : kRuntimeState) {
+        std::error_code ec;
+        fs::remove_all(fs::path(dir_) / entry, ec);
+    }
+}
+
+bool ProfileTemplate::cloneTo(const std::string& destDir, ProfileCloneStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    ProfileCloneStats result;
+
+    std::vector<std::pair<fs::path, fs::path>> files;
+    std::error_code ec;
+    fs::path root(dir_);
+    fs::path dest(destDir);
+
+    fs::create_directories(dest, ec);
+    if (ec) {
+        lastError_ = "Failed to create profile directory: " + ec.message();
+        return false;
+    }
+
+
+    fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        fs::path relative = it->path().lexically_relative(root);
+        if (relative == kMarkerFile) continue;
+
+        fs::path target = dest / relative;
+        std::error_code entryEc;
+        auto status = it->symlink_status(entryEc);
+        if (fs::is_symlink(status)) {
+            fs::copy_symlink(it->path(), target, entryEc);
+        } else if (fs::is_directory(status)) {
+            fs::create_directory(target, entryEc);
+            result.directories++;
+        } else if (fs::is_regular_file(status)) {
+            files.emplace_back(it->path(), std::move(target));
+        }
+        if (entryEc) {
+            lastError_ = "Failed to clone " + it->path().string() + ": " + entryEc.message();
+            return false;
+        }
+    }
+    if (ec) {
+        lastError_ = "Failed to read profile template: " + ec.message();
+        return false;
+    }
+
+
+    size_t workers = (std::min)(files.size() / 32 + 1, static_cast<size_t>((std::max)(std::thread::hardware_concurrency(), 1u)));
+    workers = (std::min)(workers, static_cast<size_t>(8));
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<size_t> reflinked{0};
+    std::mutex errorMutex;
+
+    auto copyLoop = [&] {
+        uint64_t localBytes = 0;
+        size_t localReflinked = 0;
+        std::string error;
+        size_t i;
+        while (!failed.load() && (i = next.fetch_add(1)) < files.size()) {
+            bool cloned = false;
+            if (!copyFile(files[i].first, files[i].second, localBytes, cloned, error)) {
+                if (!failed.exchange(true)) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    lastError_ = error;
+                }
+                break;
+            }
+            if (cloned) localReflinked++;
+        }
+        bytes += localBytes;
+        reflinked += localReflinked;
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < workers; t++) {
+        threads.emplace_back(copyLoop);
+    }
+    copyLoop();
+    for (auto& t : threads) t.join();
+
+    if (failed.load()) return false;
+
+    result.files = files.size();
+    result.bytes = bytes.load();
+    result.reflinked = reflinked.load();
+    result.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (stats) *stats = result;
+    return true;
+}
+
+std::string ProfileTemplate::preferredRoot() {
+#if defined(__linux__)
+
+    if (::access("/dev/shm", W_OK | X_OK) == 0) {
+        return "/dev/shm";
+    }
+#endif
+#ifdef _WIN32
+    return fs::temp_directory_path().string();
+#else
+    const char* tmpDir = getenv("TMPDIR");
+    if (!tmpDir) tmpDir = getenv("TMP");
+    if (!tmpDir) tmpDir = getenv("TEMP");
+    if (!tmpDir) tmpDir = "/tmp";
+    return tmpDir;
+#endif
+}
+
+
+ProfileDeleter& ProfileDeleter::instance() {
+    static ProfileDeleter* deleter = new ProfileDeleter;
+    return *deleter;
+}
+
+void ProfileDeleter::shutdown() {
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        worker = std::move(thread_);
+    }
+    wake_.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = false;
+}
+
+void ProfileDeleter::remove(const std::string& path) {
+    if (path.empty()) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (path == current_ || std::find(queue_.begin(), queue_.end(), path) != queue_.end()) return;
+
+
+    std::error_code ec;
+    fs::path trash = path + ".trash" + std::to_string(++counter_);
+    fs::rename(path, trash, ec);
+    queue_.push_back(ec ? path : trash.string());
+
+    if (!thread_.joinable()) {
+        thread_ = std::thread(&ProfileDeleter::run, this);
+    }
+    wake_.notify_one();
+}
+
+void ProfileDeleter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return queue_.empty() && !busy_; });
+}
+
+size_t ProfileDeleter::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size() + (busy_ ? 1 : 0);
+}
+
+void ProfileDeleter::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) break;
+
+        current_ = std::move(queue_.front());
+        queue_.pop_front();
+        busy_ = true;
+        std::string path = current_;
+        lock.unlock();
+
+
+        for (int attempt = 0; attempt < 10; ++attempt) {
+            std::error_code ec;
+            fs::remove_all(path, ec);
+            if (!ec) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+
+        lock.lock();
+        current_.clear();
+        busy_ = false;
+        if (queue_.empty()) idle_.notify_all();
+    }
+    idle_.notify_all();
+}
+
+}
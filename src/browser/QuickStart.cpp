@@ -497,18 +497,22 @@ bool QuickPage::exec(const std::string& script) {
 
 
 bool QuickPage::screenshot(const std::string& filePath) {
-    auto bytes = screenshotBytes();
-    if (bytes.empty()) {
+    auto resp = client_->Page.captureScreenshot("png");
+    if (resp.hasError) {
+        lastError_ = resp.errorMessage;
         return false;
     }
 
-    std::ofstream file(filePath, std::ios::binary);
-    if (!file) {
-        lastError_ = "Failed to open file for writing: " + filePath;
+    auto* data = resp.result.find("data");
+    if (!data || !data->isString()) {
+        lastError_ = "No screenshot data in response";
         return false;
     }
 
-    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    if (!Base64::decodeToFile(data->asString(), filePath)) {
+        lastError_ = "Failed to write file: " + filePath;
+        return false;
+    }
     return true;
 }
 
@@ -562,9 +566,10 @@ bool QuickPage::screenshotElement(const std::string& selector, const std::string
         return false;
     }
 
-    auto bytes = Base64::decode(data->asString());
-    std::ofstream file(filePath, std::ios::binary);
-    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    if (!Base64::decodeToFile(data->asString(), filePath)) {
+        lastError_ = "Failed to write file: " + filePath;
+        return false;
+    }
     return true;
 }
 
@@ -597,34 +602,22 @@ bool QuickPage::screenshotFullPage(const std::string& filePath) {
         return false;
     }
 
-    auto bytes = Base64::decode(data->asString());
-    std::ofstream file(filePath, std::ios::binary);
-    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    if (!Base64::decodeToFile(data->asString(), filePath)) {
+        lastError_ = "Failed to write file: " + filePath;
+        return false;
+    }
     return true;
 }
 
 
 bool QuickPage::pdf(const std::string& filePath) {
-    auto resp = client_->Page.printToPDF();
-    if (resp.hasError) {
-        lastError_ = resp.errorMessage;
-        return false;
-    }
-
-    auto* data = resp.result.find("data");
-    if (!data || !data->isString()) {
-        lastError_ = "No PDF data in response";
-        return false;
-    }
+    CDP_PAGE_GUARD_BOOL();
 
-    auto bytes = Base64::decode(data->asString());
-    std::ofstream file(filePath, std::ios::binary);
-    if (!file) {
-        lastError_ = "Failed to open file for writing: " + filePath;
+    auto result = page_->pdfToFile(filePath);
+    if (!result) {
+        lastError_ = result.error().message;
         return false;
     }
-
-    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
     return true;
 }
 
@@ -1191,7 +1184,22 @@ std::vector<QuickPage*> QuickBrowser::pages() {
 }
 
 std::vector<CDPTarget> QuickBrowser::listPages() {
-    auto targets = browserClient_.listTargets();
+    std::vector<CDPTarget> targets;
+    if (sessions_) {
+        auto resp = browserClient_.Target.getTargets();
+        if (!resp.hasError && resp.result["targetInfos"].isArray()) {
+            for (const auto& info : resp.result["targetInfos"].asArray()) {
+                CDPTarget target;
+                target.id = info["targetId"].getString();
+                target.type = info["type"].getString();
+                target.title = info["title"].getString();
+                target.url = info["url"].getString();
+                targets.push_back(std::move(target));
+            }
+        }
+    } else {
+        targets = browserClient_.listTargets();
+    }
     std::vector<CDPTarget> pages;
     for (const auto& target : targets) {
         if (target.type == "page") {
@@ -1204,14 +1212,20 @@ std::vector<CDPTarget> QuickBrowser::listPages() {
 PageResult QuickBrowser::connectToPage(const CDPTarget& target) {
     PageResult result;
 
-    if (target.webSocketDebuggerUrl.empty()) {
+    if (!sessions_ && target.webSocketDebuggerUrl.empty()) {
         result.error = "Target has no WebSocket URL";
         return result;
     }
 
     
     auto pageClient = std::make_unique<CDPClient>(config_);
-    if (!pageClient->connect(target.webSocketDebuggerUrl)) {
+    if (sessions_) {
+        std::string error;
+        if (!attachPageClient(*pageClient, target.id, error)) {
+            result.error = "Failed to connect to target: " + error;
+            return result;
+        }
+    } else if (!pageClient->connect(target.webSocketDebuggerUrl)) {
         result.error = "Failed to connect to target: " + pageClient->lastError();
         return result;
     }
@@ -1393,29 +1407,38 @@ PageResult QuickBrowser::createPageInContext(const std::string& url, const std::
     }
 
     std::string targetId = createResp.result["targetId"].getString();
+    auto pageClient = std::make_unique<CDPClient>(config_);
 
-    
-    auto targets = browserClient_.listTargets();
-    std::string wsUrl;
-    for (const auto& target : targets) {
-        if (target.id == targetId) {
-            wsUrl = target.webSocketDebuggerUrl;
-            break;
+    if (sessions_) {
+        std::string error;
+        if (!attachPageClient(*pageClient, targetId, error)) {
+            browserClient_.Target.closeTarget(targetId);
+            result.error = "Failed to connect to new target: " + error;
+            return result;
+        }
+    } else {
+        
+        auto targets = browserClient_.listTargets();
+        std::string wsUrl;
+        for (const auto& target : targets) {
+            if (target.id == targetId) {
+                wsUrl = target.webSocketDebuggerUrl;
+                break;
+            }
         }
-    }
 
-    if (wsUrl.empty()) {
-        browserClient_.Target.closeTarget(targetId);
-        result.error = "Failed to find WebSocket URL for new target";
-        return result;
-    }
+        if (wsUrl.empty()) {
+            browserClient_.Target.closeTarget(targetId);
+            result.error = "Failed to find WebSocket URL for new target";
+            return result;
+        }
 
-    
-    auto pageClient = std::make_unique<CDPClient>(config_);
-    if (!pageClient->connect(wsUrl)) {
-        browserClient_.Target.closeTarget(targetId);
-        result.error = "Failed to connect to new target: " + pageClient->lastError();
-        return result;
+        
+        if (!pageClient->connect(wsUrl)) {
+            browserClient_.Target.closeTarget(targetId);
+            result.error = "Failed to connect to new target: " + pageClient->lastError();
+            return result;
+        }
     }
 
     auto page = std::unique_ptr<QuickPage>(new QuickPage(std::move(pageClient), targetId, this));
@@ -1456,6 +1479,22 @@ PageResult QuickBrowser::createPageInContext(const std::string& url, const std::
     return result;
 }
 
+bool QuickBrowser::attachPageClient(CDPClient& client, const std::string& targetId, std::string& error) {
+    auto resp = browserClient_.Target.attachToTarget(targetId, true);
+    if (resp.hasError) {
+        error = resp.errorMessage;
+        return false;
+    }
+    std::string sessionId = resp.result["sessionId"].getString();
+
+    auto transport = sessions_->open(sessionId);
+    if (!transport || !client.connectToTarget(std::move(transport))) {
+        browserClient_.Target.detachFromTarget(sessionId);
+        error = "Failed to attach session " + sessionId;
+        return false;
+    }
+    return true;
+}
 
 LaunchResult launch(const ChromeLaunchOptions& options) {
     LaunchResult result;
@@ -1473,13 +1512,19 @@ LaunchResult launch(const ChromeLaunchOptions& options) {
     config.port = launcher->debuggingPort();
 
     
+    auto pipe = launcher->options().remoteDebuggingPipe ? launcher->takePipeTransport() : nullptr;
     result.browser = std::unique_ptr<QuickBrowser>(new QuickBrowser(std::move(launcher), config));
 
     
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
-
-    
-    if (!result.browser->browserClient_.connectToBrowser()) {
+    if (pipe) {
+        auto sessions = SessionRouter::create(std::move(pipe));
+        if (!sessions || !result.browser->browserClient_.connect(sessions->open())) {
+            result.error = "Failed to connect to browser pipe";
+            result.browser.reset();
+            return result;
+        }
+        result.browser->sessions_ = std::move(sessions);
+    } else if (!result.browser->browserClient_.connectToBrowser()) {
         result.error = "Failed to connect to browser endpoint";
         result.browser.reset();
         return result;
@@ -1,11 +1,282 @@
 
 
 #include "cdp/core/Base64.hpp"
+#include <algorithm>
+#include <array>
+#include <fstream>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CDP_BASE64_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define CDP_BASE64_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CDP_BASE64_TARGET(x) __attribute__((target(x)))
+#else
+#define CDP_BASE64_TARGET(x)
+#endif
 
 namespace cdp {
 
 constexpr char Base64::ALPHABET[];
 
+namespace {
+
+constexpr char kAlphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+constexpr std::array<int8_t, 256> makeDecodeTable() {
+    std::array<int8_t, 256> table{};
+    for (auto& v : table) v = -1;
+    for (int i = 0; i < 64; ++i) {
+        table[static_cast<unsigned char>(kAlphabet[i])] = static_cast<int8_t>(i);
+    }
+    return table;
+}
+
+constexpr std::array<int8_t, 256> kDecodeTable = makeDecodeTable();
+
+constexpr size_t kSinkChunk = 16 * 1024;
+
+enum class SimdLevel { None, Ssse3, Avx2, Neon };
+
+#if defined(CDP_BASE64_X86)
+
+SimdLevel detectSimdLevel() {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::Avx2;
+    if (__builtin_cpu_supports("ssse3")) return SimdLevel::Ssse3;
+    return SimdLevel::None;
+#elif defined(_MSC_VER)
+    int info[4] = {0, 0, 0, 0};
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool ssse3 = (info[2] & (1 << 9)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (maxLeaf >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        if (info[1] & (1 << 5)) return SimdLevel::Avx2;
+    }
+    return ssse3 ? SimdLevel::Ssse3 : SimdLevel::None;
+#else
+    return SimdLevel::None;
+#endif
+}
+
+CDP_BASE64_TARGET("ssse3")
+size_t decodeBlocksSsse3(const uint8_t* in, size_t len, uint8_t* out, size_t& produced) {
+    const __m128i lutLo = _mm_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lutHi = _mm_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lutRoll = _mm_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71,
+        0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask2F = _mm_set1_epi8(0x2F);
+    const __m128i packShuffle = _mm_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    size_t consumed = 0;
+    produced = 0;
+    while (len - consumed >= 32) {
+        __m128i str = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + consumed));
+        __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask2F);
+        __m128i loNibbles = _mm_and_si128(str, mask2F);
+        __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+        __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xFFFF) {
+            break;
+        }
+
+        __m128i eq2F = _mm_cmpeq_epi8(str, mask2F);
+        __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eq2F, hiNibbles));
+        str = _mm_add_epi8(str, roll);
+
+        __m128i merged = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+        __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+        packed = _mm_shuffle_epi8(packed, packShuffle);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + produced), packed);
+
+        consumed += 16;
+        produced += 12;
+    }
+    return consumed;
+}
+
+CDP_BASE64_TARGET("avx2")
+size_t decodeBlocksAvx2(const uint8_t* in, size_t len, uint8_t* out, size_t& produced) {
+    const __m256i lutLo = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lutHi = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lutRoll = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71,
+        0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask2F = _mm256_set1_epi8(0x2F);
+    const __m256i packShuffle = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i packLanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+    size_t consumed = 0;
+    produced = 0;
+    while (len - consumed >= 64) {
+        __m256i str = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + consumed));
+        __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask2F);
+        __m256i loNibbles = _mm256_and_si256(str, mask2F);
+        __m256i hi = _mm256_shuffle_epi8(lutHi, hiNibbles);
+        __m256i lo = _mm256_shuffle_epi8(lutLo, loNibbles);
+        if (!_mm256_testz_si256(lo, hi)) break;
+
+        __m256i eq2F = _mm256_cmpeq_epi8(str, mask2F);
+        __m256i roll = _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(eq2F, hiNibbles));
+        str = _mm256_add_epi8(str, roll);
+
+        __m256i merged = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+        __m256i packed = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        packed = _mm256_shuffle_epi8(packed, packShuffle);
+        packed = _mm256_permutevar8x32_epi32(packed, packLanes);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + produced), packed);
+
+        consumed += 32;
+        produced += 24;
+    }
+    return consumed;
+}
+
+CDP_BASE64_TARGET("ssse3")
+size_t encodeBlocksSsse3(const uint8_t* in, size_t len, char* out) {
+    const __m128i reshuffle = _mm_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m128i shiftLut = _mm_setr_epi8(
+        65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+
+    size_t consumed = 0;
+    size_t produced = 0;
+    while (len - consumed >= 16) {
+        __m128i in16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + consumed));
+        in16 = _mm_shuffle_epi8(in16, reshuffle);
+
+        __m128i t0 = _mm_and_si128(in16, _mm_set1_epi32(0x0FC0FC00));
+        __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        __m128i t2 = _mm_and_si128(in16, _mm_set1_epi32(0x003F03F0));
+        __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        __m128i indices = _mm_or_si128(t1, t3);
+
+        __m128i lutIndex = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        __m128i above25 = _mm_cmpgt_epi8(indices, _mm_set1_epi8(25));
+        lutIndex = _mm_sub_epi8(lutIndex, above25);
+        __m128i chars = _mm_add_epi8(indices, _mm_shuffle_epi8(shiftLut, lutIndex));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + produced), chars);
+
+        consumed += 12;
+        produced += 16;
+    }
+    return consumed;
+}
+
+#elif defined(CDP_BASE64_NEON)
+
+SimdLevel detectSimdLevel() {
+    return SimdLevel::Neon;
+}
+
+inline uint8x16_t neonTranslate(uint8x16_t c, uint8x16_t& valid) {
+    uint8x16_t upper = vcltq_u8(vsubq_u8(c, vdupq_n_u8('A')), vdupq_n_u8(26));
+    uint8x16_t lower = vcltq_u8(vsubq_u8(c, vdupq_n_u8('a')), vdupq_n_u8(26));
+    uint8x16_t digit = vcltq_u8(vsubq_u8(c, vdupq_n_u8('0')), vdupq_n_u8(10));
+    uint8x16_t plus = vceqq_u8(c, vdupq_n_u8('+'));
+    uint8x16_t slash = vceqq_u8(c, vdupq_n_u8('/'));
+    valid = vandq_u8(valid, vorrq_u8(vorrq_u8(upper, lower), vorrq_u8(digit, vorrq_u8(plus, slash))));
+
+    uint8x16_t v = vbslq_u8(plus, vdupq_n_u8(62), vdupq_n_u8(63));
+    v = vbslq_u8(digit, vaddq_u8(c, vdupq_n_u8(4)), v);
+    v = vbslq_u8(lower, vsubq_u8(c, vdupq_n_u8(71)), v);
+    v = vbslq_u8(upper, vsubq_u8(c, vdupq_n_u8(65)), v);
+    return v;
+}
+
+size_t decodeBlocksNeon(const uint8_t* in, size_t len, uint8_t* out, size_t& produced) {
+    size_t consumed = 0;
+    produced = 0;
+    while (len - consumed >= 64) {
+        uint8x16x4_t str = vld4q_u8(in + consumed);
+        uint8x16_t valid = vdupq_n_u8(0xFF);
+        uint8x16_t a = neonTranslate(str.val[0], valid);
+        uint8x16_t b = neonTranslate(str.val[1], valid);
+        uint8x16_t c = neonTranslate(str.val[2], valid);
+        uint8x16_t d = neonTranslate(str.val[3], valid);
+        if (vminvq_u8(valid) == 0) break;
+
+        uint8x16x3_t bytes;
+        bytes.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+        bytes.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+        bytes.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+        vst3q_u8(out + produced, bytes);
+
+        consumed += 64;
+        produced += 48;
+    }
+    return consumed;
+}
+
+#else
+
+SimdLevel detectSimdLevel() {
+    return SimdLevel::None;
+}
+
+#endif
+
+SimdLevel simdLevel() {
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+size_t decodeBlocks(const uint8_t* in, size_t len, uint8_t* out, size_t& produced) {
+    produced = 0;
+#if defined(CDP_BASE64_X86)
+    switch (simdLevel()) {
+        case SimdLevel::Avx2: {
+            size_t consumed = decodeBlocksAvx2(in, len, out, produced);
+            size_t tail = 0;
+            consumed += decodeBlocksSsse3(in + consumed, len - consumed, out + produced, tail);
+            produced += tail;
+            return consumed;
+        }
+        case SimdLevel::Ssse3:
+            return decodeBlocksSsse3(in, len, out, produced);
+        default:
+            return 0;
+    }
+#elif defined(CDP_BASE64_NEON)
+    return decodeBlocksNeon(in, len, out, produced);
+#else
+    (void)in; (void)len; (void)out;
+    return 0;
+#endif
+}
+
+}
+
 std::string Base64::encode(const std::string& input) {
     return encode(reinterpret_cast<const uint8_t*>(input.data()), input.size());
 }
@@ -16,98 +287,150 @@ std::string Base64::encode(const std::vector<uint8_t>& data) {
 
 std::string Base64::encode(const uint8_t* data, size_t len) {
     std::string result;
-    result.reserve(((len + 2) / 3) * 4);
+    result.resize(((len + 2) / 3) * 4);
+    char* out = result.data();
 
     size_t i = 0;
+#if defined(CDP_BASE64_X86)
+    if (simdLevel() != SimdLevel::None) {
+        i = encodeBlocksSsse3(data, len, out);
+        out += (i / 3) * 4;
+    }
+#endif
+
     while (i + 2 < len) {
         uint32_t n = (static_cast<uint32_t>(data[i]) << 16) |
                      (static_cast<uint32_t>(data[i + 1]) << 8) |
                      static_cast<uint32_t>(data[i + 2]);
 
-        result += ALPHABET[(n >> 18) & 0x3F];
-        result += ALPHABET[(n >> 12) & 0x3F];
-        result += ALPHABET[(n >> 6) & 0x3F];
-        result += ALPHABET[n & 0x3F];
+        *out++ = ALPHABET[(n >> 18) & 0x3F];
+        *out++ = ALPHABET[(n >> 12) & 0x3F];
+        *out++ = ALPHABET[(n >> 6) & 0x3F];
+        *out++ = ALPHABET[n & 0x3F];
 
         i += 3;
     }
 
     if (i + 1 == len) {
         uint32_t n = static_cast<uint32_t>(data[i]) << 16;
-        result += ALPHABET[(n >> 18) & 0x3F];
-        result += ALPHABET[(n >> 12) & 0x3F];
-        result += PAD;
-        result += PAD;
+        *out++ = ALPHABET[(n >> 18) & 0x3F];
+        *out++ = ALPHABET[(n >> 12) & 0x3F];
+        *out++ = PAD;
+        *out++ = PAD;
     } else if (i + 2 == len) {
         uint32_t n = (static_cast<uint32_t>(data[i]) << 16) |
                      (static_cast<uint32_t>(data[i + 1]) << 8);
-        result += ALPHABET[(n >> 18) & 0x3F];
-        result += ALPHABET[(n >> 12) & 0x3F];
-        result += ALPHABET[(n >> 6) & 0x3F];
-        result += PAD;
+        *out++ = ALPHABET[(n >> 18) & 0x3F];
+        *out++ = ALPHABET[(n >> 12) & 0x3F];
+        *out++ = ALPHABET[(n >> 6) & 0x3F];
+        *out++ = PAD;
     }
 
     return result;
 }
 
 std::vector<uint8_t> Base64::decode(const std::string& input) {
-    std::vector<uint8_t> result;
-    result.reserve((input.size() / 4) * 3);
+    std::vector<uint8_t> result(decodedSizeBound(input.size()));
+    result.resize(decode(input.data(), input.size(), result.data()));
+    return result;
+}
 
-    
-    int decodeTable[256];
-    for (int i = 0; i < 256; ++i) decodeTable[i] = -1;
-    for (int i = 0; i < 64; ++i) {
-        decodeTable[static_cast<unsigned char>(ALPHABET[i])] = i;
-    }
+std::string Base64::decodeToString(const std::string& input) {
+    std::string result(decodedSizeBound(input.size()), '\0');
+    result.resize(decode(input.data(), input.size(), reinterpret_cast<uint8_t*>(result.data())));
+    return result;
+}
 
+size_t Base64::decode(const char* input, size_t len, uint8_t* out) {
+    Base64Decoder decoder;
+    size_t written = decoder.feed(input, len, out);
+    return written + decoder.finish(out + written);
+}
+
+bool Base64::decodeTo(const char* input, size_t len, const Sink& sink) {
+    Base64Decoder decoder;
+    if (!decoder.feed(input, len, sink)) return false;
+    return decoder.finish(sink);
+}
+
+bool Base64::decodeToFile(const std::string& input, const std::string& path) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    bool ok = decodeTo(input, [&file](const uint8_t* data, size_t length) {
+        file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(length));
+        return static_cast<bool>(file);
+    });
+    file.close();
+    return ok && !file.fail();
+}
+
+size_t Base64Decoder::feed(const char* input, size_t len, uint8_t* out) {
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(input);
+    size_t written = 0;
     size_t i = 0;
-    while (i < input.size()) {
-        
-        while (i < input.size() && (input[i] == ' ' || input[i] == '\n' ||
-                                     input[i] == '\r' || input[i] == '\t')) {
-            ++i;
-        }
-        if (i >= input.size()) break;
-
-        
-        int vals[4] = {0, 0, 0, 0};
-        int padCount = 0;
-
-        for (int j = 0; j < 4 && i < input.size(); ++j) {
-            char c = input[i++];
-            if (c == PAD) {
-                padCount++;
-                vals[j] = 0;
-            } else {
-                int v = decodeTable[static_cast<unsigned char>(c)];
-                if (v < 0) {
-                    
-                    --j;
-                    continue;
-                }
-                vals[j] = v;
-            }
-        }
 
-        
-        uint32_t n = (vals[0] << 18) | (vals[1] << 12) | (vals[2] << 6) | vals[3];
+    while (i < len) {
+        if (pendingCount_ == 0) {
+            size_t produced = 0;
+            i += decodeBlocks(in + i, len - i, out + written, produced);
+            written += produced;
+            if (i >= len) break;
+        }
 
-        result.push_back(static_cast<uint8_t>((n >> 16) & 0xFF));
-        if (padCount < 2) {
-            result.push_back(static_cast<uint8_t>((n >> 8) & 0xFF));
+        uint8_t c = in[i++];
+        int8_t v = kDecodeTable[c];
+        if (v < 0) {
+            if (c == '=') written += flushPartial(out + written);
+            continue;
         }
-        if (padCount < 1) {
-            result.push_back(static_cast<uint8_t>(n & 0xFF));
+
+        pending_ = (pending_ << 6) | static_cast<uint32_t>(v);
+        if (++pendingCount_ == 4) {
+            out[written++] = static_cast<uint8_t>((pending_ >> 16) & 0xFF);
+            out[written++] = static_cast<uint8_t>((pending_ >> 8) & 0xFF);
+            out[written++] = static_cast<uint8_t>(pending_ & 0xFF);
+            pending_ = 0;
+            pendingCount_ = 0;
         }
     }
 
-    return result;
+    return written;
 }
 
-std::string Base64::decodeToString(const std::string& input) {
-    auto bytes = decode(input);
-    return std::string(bytes.begin(), bytes.end());
+bool Base64Decoder::feed(const char* input, size_t len, const Base64::Sink& sink) {
+    uint8_t buffer[maxOutput(kSinkChunk)];
+    size_t offset = 0;
+    while (offset < len) {
+        size_t n = (std::min)(kSinkChunk, len - offset);
+        size_t written = feed(input + offset, n, buffer);
+        offset += n;
+        if (written > 0 && !sink(buffer, written)) return false;
+    }
+    return true;
 }
 
-} 
+size_t Base64Decoder::finish(uint8_t* out) {
+    return flushPartial(out);
+}
+
+bool Base64Decoder::finish(const Base64::Sink& sink) {
+    uint8_t tail[3];
+    size_t written = flushPartial(tail);
+    return written == 0 || sink(tail, written);
+}
+
+size_t Base64Decoder::flushPartial(uint8_t* out) {
+    size_t written = 0;
+    if (pendingCount_ == 2) {
+        out[written++] = static_cast<uint8_t>((pending_ >> 4) & 0xFF);
+    } else if (pendingCount_ == 3) {
+        out[written++] = static_cast<uint8_t>((pending_ >> 10) & 0xFF);
+        out[written++] = static_cast<uint8_t>((pending_ >> 2) & 0xFF);
+    }
+    pending_ = 0;
+    pendingCount_ = 0;
+    return written;
+}
+
+}
@@ -0,0 +1,454 @@
+
+
+#include "cdp/core/Cbor.hpp"
+#include "cdp/core/Base64.hpp"
+#include <cstring>
+#include <stdexcept>
+
+namespace cdp {
+
+namespace {
+
+constexpr uint8_t kMajorUnsigned = 0;
+constexpr uint8_t kMajorNegative = 1;
+constexpr uint8_t kMajorBytes = 2;
+constexpr uint8_t kMajorString = 3;
+constexpr uint8_t kMajorArray = 4;
+constexpr uint8_t kMajorMap = 5;
+constexpr uint8_t kMajorTag = 6;
+constexpr uint8_t kMajorSimple = 7;
+
+constexpr uint8_t kIndefiniteArray = 0x9f;
+constexpr uint8_t kIndefiniteMap = 0xbf;
+constexpr uint8_t kBreak = 0xff;
+constexpr uint8_t kFalse = 0xf4;
+constexpr uint8_t kTrue = 0xf5;
+constexpr uint8_t kNull = 0xf6;
+constexpr uint8_t kDouble = 0xfb;
+constexpr uint8_t kEnvelopeStart = 0xd8;
+constexpr uint8_t kEnvelopeLength = 0x5a;
+
+constexpr int kMaxDepth = 512;
+
+void writeHead(std::string& out, uint8_t major, uint64_t value) {
+    uint8_t base = static_cast<uint8_t>(major << 5);
+    if (value < 24) {
+        out.push_back(static_cast<char>(base | value));
+    } else if (value <= 0xff) {
+        out.push_back(static_cast<char>(base | 24));
+        out.push_back(static_cast<char>(value));
+    } else if (value <= 0xffff) {
+        out.push_back(static_cast<char>(base | 25));
+        out.push_back(static_cast<char>(value >> 8));
+        out.push_back(static_cast<char>(value));
+    } else if (value <= 0xffffffffULL) {
+        out.push_back(static_cast<char>(base | 26));
+        for (int shift = 24; shift >= 0; shift -= 8) out.push_back(static_cast<char>(value >> shift));
+    } else {
+        out.push_back(static_cast<char>(base | 27));
+        for (int shift = 56; shift >= 0; shift -= 8) out.push_back(static_cast<char>(value >> shift));
+    }
+}
+
+void writeDouble(std::string& out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    out.push_back(static_cast<char>(kDouble));
+    for (int shift = 56; shift >= 0; shift -= 8) out.push_back(static_cast<char>(bits >> shift));
+}
+
+void writeInteger(std::string& out, int64_t value) {
+    if (value < (std::numeric_limits<int32_t>::min)() || value > (std::numeric_limits<int32_t>::max)()) {
+        writeDouble(out, static_cast<double>(value));
+    } else if (value >= 0) {
+        writeHead(out, kMajorUnsigned, static_cast<uint64_t>(value));
+    } else {
+        writeHead(out, kMajorNegative, static_cast<uint64_t>(-1 - value));
+    }
+}
+
+size_t beginEnvelope(std::string& out) {
+    out.push_back(static_cast<char>(kEnvelopeStart));
+    out.push_back(static_cast<char>(Cbor::kEnvelopeTag));
+    out.push_back(static_cast<char>(kEnvelopeLength));
+    size_t at = out.size();
+    out.append(4, '\0');
+    return at;
+}
+
+void endEnvelope(std::string& out, size_t at) {
+    if (at == std::string::npos) return;
+    size_t length = out.size() - at - 4;
+    if (length > 0xffffffffULL) throw std::length_error("CBOR envelope exceeds 4 GiB");
+    for (size_t i = 0; i < 4; ++i) {
+        out[at + i] = static_cast<char>(length >> (24 - 8 * i));
+    }
+}
+
+bool isBase64(const std::string& s) {
+    if (s.empty() || s.size() % 4 != 0) return false;
+    size_t padding = 0;
+    for (size_t i = 0; i < s.size(); ++i) {
+        char c = s[i];
+        if (c == '=') {
+            if (i + 2 < s.size()) return false;
+            padding++;
+        } else if (padding > 0 || !((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+                                    (c >= '0' && c <= '9') || c == '+' || c == '/')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+class Encoder {
+public:
+    Encoder(std::string& out, const CborEncodeOptions& options) : out_(out), options_(options) {}
+
+    void value(const JsonValue& v, bool binary = false) {
+        if (v.isNull()) {
+            out_.push_back(static_cast<char>(kNull));
+        } else if (v.isBool()) {
+            out_.push_back(static_cast<char>(v.asBool() ? kTrue : kFalse));
+        } else if (v.isInt()) {
+            writeInteger(out_, v.asInt64());
+        } else if (v.isDouble()) {
+            double d = v.asDouble();
+            if (std::isfinite(d) && std::floor(d) == d &&
+                d >= (std::numeric_limits<int32_t>::min)() && d <= (std::numeric_limits<int32_t>::max)()) {
+                writeInteger(out_, static_cast<int64_t>(d));
+            } else {
+                writeDouble(out_, d);
+            }
+        } else if (v.isString()) {
+            string(v.asString(), binary);
+        } else if (v.isArray()) {
+            size_t envelope = beginEnvelope();
+            out_.push_back(static_cast<char>(kIndefiniteArray));
+            for (const auto& item : v.asArray()) value(item);
+            out_.push_back(static_cast<char>(kBreak));
+            endEnvelope(envelope);
+        } else if (v.isObject()) {
+            size_t envelope = beginEnvelope();
+            out_.push_back(static_cast<char>(kIndefiniteMap));
+            entries(v.asObject());
+            out_.push_back(static_cast<char>(kBreak));
+            endEnvelope(envelope);
+        }
+    }
+
+    void entries(const JsonObject& object) {
+        for (const auto& [key, item] : object) {
+            writeHead(out_, kMajorString, key.size());
+            out_.append(key);
+            value(item, !options_.binaryKeys.empty() && options_.binaryKeys.count(key) > 0);
+        }
+    }
+
+private:
+    void string(const std::string& s, bool binary) {
+        if (binary && isBase64(s)) {
+            std::string bytes(Base64::decodedSizeBound(s.size()), '\0');
+            size_t n = Base64::decode(s.data(), s.size(), reinterpret_cast<uint8_t*>(&bytes[0]));
+            out_.push_back(static_cast<char>((kMajorTag << 5) | Cbor::kBinaryTag));
+            writeHead(out_, kMajorBytes, n);
+            out_.append(bytes.data(), n);
+            return;
+        }
+        writeHead(out_, kMajorString, s.size());
+        out_.append(s);
+    }
+
+    size_t beginEnvelope() {
+        if (!options_.envelopes) return std::string::npos;
+        return ::cdp::beginEnvelope(out_);
+    }
+
+    void endEnvelope(size_t at) { ::cdp::endEnvelope(out_, at); }
+
+    std::string& out_;
+    const CborEncodeOptions& options_;
+};
+
+void appendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xc0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xe0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    } else {
+        out.push_back(static_cast<char>(0xf0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    }
+}
+
+std::string utf16ToUtf8(const uint8_t* data, size_t size) {
+    std::string out;
+    out.reserve(size / 2);
+    for (size_t i = 0; i + 1 < size; i += 2) {
+        uint32_t unit = data[i] | (static_cast<uint32_t>(data[i + 1]) << 8);
+        if (unit >= 0xd800 && unit < 0xdc00 && i + 3 < size) {
+            uint32_t low = data[i + 2] | (static_cast<uint32_t>(data[i + 3]) << 8);
+            if (low >= 0xdc00 && low < 0xe000) {
+                appendUtf8(out, 0x10000 + ((unit - 0xd800) << 10) + (low - 0xdc00));
+                i += 2;
+                continue;
+            }
+        }
+        appendUtf8(out, unit);
+    }
+    return out;
+}
+
+double halfToDouble(uint16_t half) {
+    int exponent = (half >> 10) & 0x1f;
+    int mantissa = half & 0x3ff;
+    double value;
+    if (exponent == 0) {
+        value = std::ldexp(mantissa, -24);
+    } else if (exponent != 31) {
+        value = std::ldexp(mantissa + 1024, exponent - 25);
+    } else {
+        value = mantissa == 0 ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+class Decoder {
+public:
+    Decoder(const uint8_t* data, size_t size) : pos_(data), end_(data + size) {}
+
+    JsonValue document() {
+        JsonValue v = value(0);
+        if (pos_ != end_) fail("trailing bytes after value");
+        return v;
+    }
+
+private:
+    [[noreturn]] void fail(const char* what) {
+        throw std::runtime_error(std::string("CBOR: ") + what);
+    }
+
+    uint8_t byte() {
+        if (pos_ >= end_) fail("unexpected end of input");
+        return *pos_++;
+    }
+
+    uint64_t argument(uint8_t info) {
+        if (info < 24) return info;
+        int bytes = info == 24 ? 1 : info == 25 ? 2 : info == 26 ? 4 : info == 27 ? 8 : 0;
+        if (bytes == 0) fail("invalid additional information");
+        if (end_ - pos_ < bytes) fail("unexpected end of input");
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i) v = (v << 8) | *pos_++;
+        return v;
+    }
+
+    const uint8_t* take(uint64_t length) {
+        if (static_cast<uint64_t>(end_ - pos_) < length) fail("length exceeds input");
+        const uint8_t* at = pos_;
+        pos_ += length;
+        return at;
+    }
+
+    std::string chunks(uint8_t major, uint8_t info) {
+        if (info != 31) {
+            const uint8_t* at = take(argument(info));
+            return std::string(reinterpret_cast<const char*>(at), static_cast<size_t>(pos_ - at));
+        }
+        std::string out;
+        while (true) {
+            uint8_t head = byte();
+            if (head == kBreak) return out;
+            if ((head >> 5) != major || (head & 0x1f) == 31) fail("invalid indefinite-length string chunk");
+            const uint8_t* at = take(argument(head & 0x1f));
+            out.append(reinterpret_cast<const char*>(at), static_cast<size_t>(pos_ - at));
+        }
+    }
+
+    JsonValue value(int depth) {
+        if (depth > kMaxDepth) fail("nesting too deep");
+        uint8_t head = byte();
+        uint8_t major = head >> 5;
+        uint8_t info = head & 0x1f;
+
+        switch (major) {
+            case kMajorUnsigned:
+                return JsonValue(argument(info));
+            case kMajorNegative: {
+                uint64_t n = argument(info);
+                if (n > static_cast<uint64_t>((std::numeric_limits<int64_t>::max)())) {
+                    return JsonValue(-1.0 - static_cast<double>(n));
+                }
+                return JsonValue(-1 - static_cast<int64_t>(n));
+            }
+            case kMajorBytes: {
+                std::string bytes = chunks(kMajorBytes, info);
+                return JsonValue(utf16ToUtf8(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()));
+            }
+            case kMajorString:
+                return JsonValue(chunks(kMajorString, info));
+            case kMajorArray: {
+                JsonArray arr;
+                if (info == 31) {
+                    while (pos_ < end_ && *pos_ != kBreak) arr.push_back(value(depth + 1));
+                    byte();
+                } else {
+                    uint64_t count = argument(info);
+                    if (count > static_cast<uint64_t>(end_ - pos_)) fail("array length exceeds input");
+                    arr.reserve(static_cast<size_t>(count));
+                    for (uint64_t i = 0; i < count; ++i) arr.push_back(value(depth + 1));
+                }
+                return JsonValue(std::move(arr));
+            }
+            case kMajorMap: {
+                JsonObject obj;
+                bool indefinite = info == 31;
+                uint64_t count = indefinite ? 0 : argument(info);
+                for (uint64_t i = 0; indefinite || i < count; ++i) {
+                    if (indefinite) {
+                        if (pos_ < end_ && *pos_ == kBreak) {
+                            ++pos_;
+                            break;
+                        }
+                    }
+                    JsonValue key = value(depth + 1);
+                    if (!key.isString()) fail("map key is not a string");
+                    JsonValue item = value(depth + 1);
+                    obj.emplace(key.asString(), std::move(item));
+                }
+                return JsonValue(std::move(obj));
+            }
+            case kMajorTag: {
+                uint64_t tag = argument(info);
+                if (tag == Cbor::kEnvelopeTag && pos_ < end_ && (*pos_ >> 5) == kMajorBytes) {
+                    return envelope(depth);
+                }
+                if (tag == Cbor::kBinaryTag && pos_ < end_ && (*pos_ >> 5) == kMajorBytes) {
+                    uint8_t inner = byte();
+                    std::string bytes = chunks(kMajorBytes, inner & 0x1f);
+                    return JsonValue(Base64::encode(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()));
+                }
+                return value(depth + 1);
+            }
+            case kMajorSimple:
+                switch (info) {
+                    case 20: return JsonValue(false);
+                    case 21: return JsonValue(true);
+                    case 22:
+                    case 23: return JsonValue(nullptr);
+                    case 25: {
+                        uint16_t half = static_cast<uint16_t>(argument(info));
+                        return JsonValue(halfToDouble(half));
+                    }
+                    case 26: {
+                        uint32_t bits = static_cast<uint32_t>(argument(info));
+                        float f;
+                        std::memcpy(&f, &bits, sizeof(f));
+                        return JsonValue(static_cast<double>(f));
+                    }
+                    case 27: {
+                        uint64_t bits = argument(info);
+                        double d;
+                        std::memcpy(&d, &bits, sizeof(d));
+                        return JsonValue(d);
+                    }
+                    default:
+                        fail("unsupported simple value");
+                }
+        }
+        fail("unsupported major type");
+    }
+
+    JsonValue envelope(int depth) {
+        uint8_t inner = byte();
+        const uint8_t* at = take(argument(inner & 0x1f));
+        const uint8_t* end = end_;
+        end_ = pos_;
+        pos_ = at;
+        JsonValue v = value(depth + 1);
+        if (pos_ != end_) fail("trailing bytes in envelope");
+        end_ = end;
+        return v;
+    }
+
+    const uint8_t* pos_;
+    const uint8_t* end_;
+};
+
+}
+
+std::string Cbor::encode(const JsonValue& value, const CborEncodeOptions& options) {
+    std::string out;
+    encode(value, out, options);
+    return out;
+}
+
+void Cbor::encode(const JsonValue& value, std::string& out, const CborEncodeOptions& options) {
+    Encoder(out, options).value(value);
+}
+
+const CborEncodeOptions& Cbor::commandOptions(std::string_view method) {
+    static const CborEncodeOptions plain;
+    static const CborEncodeOptions fulfill{true, {"body"}};
+    static const CborEncodeOptions continueRequest{true, {"postData"}};
+    if (method == "Fetch.fulfillRequest") return fulfill;
+    if (method == "Fetch.continueRequest") return continueRequest;
+    return plain;
+}
+
+size_t Cbor::beginMap(std::string& out, bool envelope) {
+    size_t at = envelope ? beginEnvelope(out) : std::string::npos;
+    out.push_back(static_cast<char>(kIndefiniteMap));
+    return at;
+}
+
+void Cbor::endMap(std::string& out, size_t envelopeAt) {
+    out.push_back(static_cast<char>(kBreak));
+    endEnvelope(out, envelopeAt);
+}
+
+void Cbor::appendString(std::string& out, std::string_view s) {
+    writeHead(out, kMajorString, s.size());
+    out.append(s.data(), s.size());
+}
+
+void Cbor::appendInteger(std::string& out, int64_t value) {
+    writeInteger(out, value);
+}
+
+void Cbor::encodeEntries(const JsonObject& entries, std::string& out, const CborEncodeOptions& options) {
+    Encoder(out, options).entries(entries);
+}
+
+JsonValue Cbor::decode(const std::string& data) {
+    return decode(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+JsonValue Cbor::decode(const uint8_t* data, size_t size) {
+    return Decoder(data, size).document();
+}
+
+int64_t Cbor::messageSize(const uint8_t* data, size_t available) {
+    if (available == 0) return 0;
+    if (data[0] != kEnvelopeStart) return -1;
+
+
+    if (available < 2) return 0;
+    if (data[1] != kEnvelopeTag) return -1;
+    if (available < 3) return 0;
+    if (data[2] != kEnvelopeLength) return -1;
+    if (available < 7) return 0;
+
+    uint32_t length = 0;
+    for (size_t i = 0; i < 4; ++i) length = (length << 8) | data[3 + i];
+    return static_cast<int64_t>(7 + static_cast<size_t>(length));
+}
+
+}
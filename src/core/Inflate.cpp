@@ -0,0 +1,444 @@
+
+
+#include "cdp/core/Inflate.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace cdp {
+
+namespace {
+
+constexpr size_t kWindowSize = 32768;
+constexpr size_t kWindowMask = kWindowSize - 1;
+
+constexpr uint16_t kLengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8_t kLengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint16_t kDistBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr uint8_t kDistExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr uint8_t kCodeLengthOrder[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+uint32_t reverseBits(uint32_t code, int length) {
+    uint32_t result = 0;
+    for (int i = 0; i < length; ++i) {
+        result = (result << 1) | (code & 1);
+        code >>= 1;
+    }
+    return result;
+}
+
+}
+
+Inflater::Inflater(bool zlibHeader)
+    : state_(zlibHeader ? State::ZlibHeader : State::BlockHeader),
+      zlibHeader_(zlibHeader),
+      window_(kWindowSize) {}
+
+void Inflater::addInput(const uint8_t* data, size_t len) {
+    if (len > 0) {
+        inputs_.emplace_back(data, len);
+    }
+}
+
+Inflater::Checkpoint Inflater::checkpoint() const {
+    return {inputIndex_, inputPos_, bitBuf_, bitCount_, finalBlock_};
+}
+
+void Inflater::rewind(const Checkpoint& cp) {
+    inputIndex_ = cp.inputIndex;
+    inputPos_ = cp.inputPos;
+    bitBuf_ = cp.bitBuf;
+    bitCount_ = cp.bitCount;
+    finalBlock_ = cp.finalBlock;
+}
+
+void Inflater::fail(const std::string& message) {
+    state_ = State::Error;
+    error_ = message;
+}
+
+bool Inflater::fill(int bits) {
+    while (bitCount_ <= 56 && inputIndex_ < inputs_.size()) {
+        const auto& input = inputs_[inputIndex_];
+        bitBuf_ |= static_cast<uint64_t>(input.first[inputPos_]) << bitCount_;
+        bitCount_ += 8;
+        if (++inputPos_ == input.second) {
+            ++inputIndex_;
+            inputPos_ = 0;
+        }
+    }
+    return bitCount_ >= bits;
+}
+
+uint32_t Inflater::getBits(int bits) {
+    if (bits == 0) return 0;
+    if (bitCount_ < bits && !fill(bits)) {
+        starved_ = true;
+        return 0;
+    }
+    uint32_t value = static_cast<uint32_t>(bitBuf_ & ((1ull << bits) - 1));
+    bitBuf_ >>= bits;
+    bitCount_ -= bits;
+    return value;
+}
+
+bool Inflater::build(Huffman& h, const uint8_t* lengths, int count) {
+    std::memset(h.counts, 0, sizeof(h.counts));
+    std::memset(h.fast, 0, sizeof(h.fast));
+    for (int i = 0; i < count; ++i) {
+        h.counts[lengths[i]]++;
+    }
+    h.counts[0] = 0;
+
+    int left = 1;
+    for (int len = 1; len < 16; ++len) {
+        left <<= 1;
+        left -= h.counts[len];
+        if (left < 0) return false;
+    }
+
+    uint16_t offsets[16];
+    offsets[1] = 0;
+    for (int len = 1; len < 15; ++len) {
+        offsets[len + 1] = static_cast<uint16_t>(offsets[len] + h.counts[len]);
+    }
+
+    uint32_t nextCode[16];
+    uint32_t code = 0;
+    for (int len = 1; len < 16; ++len) {
+        nextCode[len] = code;
+        code = (code + h.counts[len]) << 1;
+    }
+
+    for (int sym = 0; sym < count; ++sym) {
+        int len = lengths[sym];
+        if (len == 0) continue;
+        h.symbols[offsets[len]++] = static_cast<uint16_t>(sym);
+        uint32_t symCode = nextCode[len]++;
+        if (len <= kFastBits) {
+            uint32_t rev = reverseBits(symCode, len);
+            for (uint32_t j = rev; j < (1u << kFastBits); j += (1u << len)) {
+                h.fast[j] = static_cast<uint16_t>((sym << 4) | len);
+            }
+        }
+    }
+    return true;
+}
+
+int Inflater::decode(const Huffman& h) {
+    if (bitCount_ < 15) fill(15);
+
+    uint16_t entry = h.fast[bitBuf_ & ((1u << kFastBits) - 1)];
+    if (entry != 0 && (entry & 15) <= bitCount_) {
+        int len = entry & 15;
+        bitBuf_ >>= len;
+        bitCount_ -= len;
+        return entry >> 4;
+    }
+
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (int len = 1; len < 16; ++len) {
+        if (bitCount_ == 0) {
+            starved_ = true;
+            return -1;
+        }
+        code |= static_cast<int>(bitBuf_ & 1);
+        bitBuf_ >>= 1;
+        bitCount_--;
+        int count = h.counts[len];
+        if (code - count < first) {
+            return h.symbols[index + (code - first)];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    fail("Invalid Huffman code");
+    return -1;
+}
+
+bool Inflater::readDynamicTables() {
+    int nlen = static_cast<int>(getBits(5)) + 257;
+    int ndist = static_cast<int>(getBits(5)) + 1;
+    int ncode = static_cast<int>(getBits(4)) + 4;
+    if (starved_) return false;
+    if (nlen > 286 || ndist > 30) {
+        fail("Invalid dynamic block header");
+        return false;
+    }
+
+    uint8_t lengths[320] = {};
+    for (int i = 0; i < ncode; ++i) {
+        lengths[kCodeLengthOrder[i]] = static_cast<uint8_t>(getBits(3));
+    }
+    if (starved_) return false;
+
+    Huffman codeLengths;
+    if (!build(codeLengths, lengths, 19)) {
+        fail("Invalid code length table");
+        return false;
+    }
+
+    std::memset(lengths, 0, sizeof(lengths));
+    int index = 0;
+    while (index < nlen + ndist) {
+        int sym = decode(codeLengths);
+        if (sym < 0) return false;
+        if (sym < 16) {
+            lengths[index++] = static_cast<uint8_t>(sym);
+            continue;
+        }
+
+        uint8_t value = 0;
+        int repeat = 0;
+        if (sym == 16) {
+            if (index == 0) {
+                fail("Repeat with no previous length");
+                return false;
+            }
+            value = lengths[index - 1];
+            repeat = 3 + static_cast<int>(getBits(2));
+        } else if (sym == 17) {
+            repeat = 3 + static_cast<int>(getBits(3));
+        } else {
+            repeat = 11 + static_cast<int>(getBits(7));
+        }
+        if (starved_) return false;
+        if (index + repeat > nlen + ndist) {
+            fail("Code lengths overflow");
+            return false;
+        }
+        while (repeat-- > 0) lengths[index++] = value;
+    }
+
+    if (lengths[256] == 0) {
+        fail("Missing end-of-block code");
+        return false;
+    }
+    if (!build(lit_, lengths, nlen) || !build(dist_, lengths + nlen, ndist)) {
+        fail("Invalid literal/distance tables");
+        return false;
+    }
+    return true;
+}
+
+bool Inflater::readBlockHeader() {
+    if (finalBlock_) {
+        state_ = zlibHeader_ ? State::Trailer : State::Done;
+        return true;
+    }
+
+    finalBlock_ = getBits(1) != 0;
+    uint32_t type = getBits(2);
+    if (starved_) return false;
+
+    if (type == 0) {
+        int skip = bitCount_ & 7;
+        bitBuf_ >>= skip;
+        bitCount_ -= skip;
+        uint32_t len = getBits(16);
+        uint32_t nlen = getBits(16);
+        if (starved_) return false;
+        if ((len ^ 0xFFFF) != nlen) {
+            fail("Stored block length mismatch");
+            return false;
+        }
+        storedRemaining_ = len;
+        state_ = State::Stored;
+    } else if (type == 1) {
+        uint8_t lengths[320];
+        std::memset(lengths, 8, 144);
+        std::memset(lengths + 144, 9, 112);
+        std::memset(lengths + 256, 7, 24);
+        std::memset(lengths + 280, 8, 8);
+        std::memset(lengths + 288, 5, 30);
+        build(lit_, lengths, 288);
+        build(dist_, lengths + 288, 30);
+        state_ = State::Compressed;
+    } else if (type == 2) {
+        if (!readDynamicTables()) return false;
+        state_ = State::Compressed;
+    } else {
+        fail("Invalid block type");
+        return false;
+    }
+    return true;
+}
+
+bool Inflater::readTrailer() {
+    int skip = bitCount_ & 7;
+    bitBuf_ >>= skip;
+    bitCount_ -= skip;
+    uint32_t expected = 0;
+    for (int i = 0; i < 4; ++i) expected = (expected << 8) | getBits(8);
+    if (starved_) return false;
+    if (expected != ((adlerB_ << 16) | adlerA_)) {
+        fail("Adler-32 checksum mismatch");
+        return false;
+    }
+    state_ = State::Done;
+    return true;
+}
+
+void Inflater::updateAdler(const uint8_t* data, size_t len) {
+    constexpr uint32_t kAdlerMod = 65521;
+    constexpr size_t kAdlerBlock = 5552;
+    uint32_t a = adlerA_;
+    uint32_t b = adlerB_;
+    for (size_t i = 0; i < len;) {
+        size_t end = (std::min)(len, i + kAdlerBlock);
+        for (; i < end; ++i) {
+            a += data[i];
+            b += a;
+        }
+        a %= kAdlerMod;
+        b %= kAdlerMod;
+    }
+    adlerA_ = a;
+    adlerB_ = b;
+}
+
+size_t Inflater::read(uint8_t* out, size_t len) {
+    size_t produced = decompress(out, len);
+    if (!zlibHeader_) return produced;
+    updateAdler(out, produced);
+    if (state_ == State::Trailer && produced > 0 && produced < len) {
+        decompress(out + produced, len - produced);
+    }
+    return produced;
+}
+
+size_t Inflater::decompress(uint8_t* out, size_t len) {
+    uint8_t* window = window_.data();
+    size_t produced = 0;
+    starved_ = false;
+
+    while (produced < len) {
+        if (state_ == State::Done || state_ == State::Error) return produced;
+        Checkpoint cp = checkpoint();
+        if (matchLength_ > 0) {
+            while (matchLength_ > 0 && produced < len) {
+                uint8_t b = window[(totalOut_ - matchDistance_) & kWindowMask];
+                window[totalOut_ & kWindowMask] = b;
+                out[produced++] = b;
+                totalOut_++;
+                matchLength_--;
+            }
+            continue;
+        }
+
+        switch (state_) {
+            case State::ZlibHeader: {
+                uint32_t cmf = getBits(8);
+                uint32_t flg = getBits(8);
+                if (starved_) break;
+                if ((cmf & 0x0F) != 8 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20)) {
+                    fail("Invalid zlib header");
+                    return produced;
+                }
+                state_ = State::BlockHeader;
+                break;
+            }
+
+            case State::BlockHeader:
+                if (!readBlockHeader() && !starved_) return produced;
+                break;
+
+            case State::Stored: {
+                if (storedRemaining_ == 0) {
+                    state_ = State::BlockHeader;
+                    break;
+                }
+                uint8_t b = static_cast<uint8_t>(getBits(8));
+                if (starved_) break;
+                window[totalOut_ & kWindowMask] = b;
+                out[produced++] = b;
+                totalOut_++;
+                storedRemaining_--;
+                break;
+            }
+
+            case State::Compressed: {
+                int sym = decode(lit_);
+                if (starved_) break;
+                if (sym < 0) return produced;
+                if (sym < 256) {
+                    uint8_t b = static_cast<uint8_t>(sym);
+                    window[totalOut_ & kWindowMask] = b;
+                    out[produced++] = b;
+                    totalOut_++;
+                    break;
+                }
+                if (sym == 256) {
+                    state_ = State::BlockHeader;
+                    break;
+                }
+
+                sym -= 257;
+                if (sym >= 29) {
+                    fail("Invalid length symbol");
+                    return produced;
+                }
+                uint32_t length = kLengthBase[sym] + getBits(kLengthExtra[sym]);
+                int dsym = decode(dist_);
+                if (starved_) break;
+                if (dsym < 0) return produced;
+                if (dsym >= 30) {
+                    fail("Invalid distance symbol");
+                    return produced;
+                }
+                uint32_t distance = kDistBase[dsym] + getBits(kDistExtra[dsym]);
+                if (starved_) break;
+                if (distance > totalOut_ || distance > kWindowSize) {
+                    fail("Distance too far back");
+                    return produced;
+                }
+                matchLength_ = length;
+                matchDistance_ = distance;
+                break;
+            }
+
+            case State::Trailer:
+                if (produced > 0) return produced;
+                if (!readTrailer() && !starved_) return produced;
+                break;
+
+            case State::Done:
+            case State::Error:
+                return produced;
+        }
+
+        if (starved_) {
+            rewind(cp);
+            if (inputEnded_) fail("Unexpected end of compressed data");
+            return produced;
+        }
+    }
+    return produced;
+}
+
+bool Inflater::inflate(const uint8_t* data, size_t len, std::vector<uint8_t>& out, bool zlibHeader) {
+    Inflater inflater(zlibHeader);
+    inflater.addInput(data, len);
+    inflater.finish();
+    uint8_t buffer[16384];
+    while (true) {
+        size_t n = inflater.read(buffer, sizeof(buffer));
+        out.insert(out.end(), buffer, buffer + n);
+        if (n < sizeof(buffer)) break;
+    }
+    return inflater.done();
+}
+
+}
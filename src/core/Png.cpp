@@ -0,0 +1,314 @@
+
+
+#include "cdp/core/Png.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+namespace cdp {
+
+namespace {
+
+constexpr uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+uint32_t readBE32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+constexpr auto kCrcTable = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t n = 0; n < 256; ++n) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table[n] = c;
+    }
+    return table;
+}();
+
+uint32_t crc32(const uint8_t* data, size_t len) {
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; ++i) c = kCrcTable[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+uint16_t readBE16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+int channelsFor(int colorType) {
+    switch (colorType) {
+        case 0: return 1;
+        case 2: return 3;
+        case 3: return 1;
+        case 4: return 2;
+        case 6: return 4;
+        default: return 0;
+    }
+}
+
+bool validDepth(int colorType, int depth) {
+    switch (colorType) {
+        case 0: return depth == 1 || depth == 2 || depth == 4 || depth == 8 || depth == 16;
+        case 3: return depth == 1 || depth == 2 || depth == 4 || depth == 8;
+        case 2:
+        case 4:
+        case 6: return depth == 8 || depth == 16;
+        default: return false;
+    }
+}
+
+uint8_t paeth(uint8_t a, uint8_t b, uint8_t c) {
+    int p = static_cast<int>(a) + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    if (pb <= pc) return b;
+    return c;
+}
+
+}
+
+bool PngDecoder::fail(const std::string& message) {
+    error_ = message;
+    return false;
+}
+
+bool PngDecoder::open(const uint8_t* data, size_t len) {
+    inflater_ = Inflater();
+    error_.clear();
+    row_ = 0;
+    hasTransparentKey_ = false;
+    for (int i = 0; i < 256; ++i) {
+        palette_[i * 4 + 0] = 0;
+        palette_[i * 4 + 1] = 0;
+        palette_[i * 4 + 2] = 0;
+        palette_[i * 4 + 3] = 255;
+    }
+
+    if (len < 8 || std::memcmp(data, kSignature, 8) != 0) {
+        return fail("Not a PNG file");
+    }
+
+    bool haveHeader = false;
+    bool haveData = false;
+    int interlace = 0;
+    size_t pos = 8;
+    while (pos + 12 <= len) {
+        uint32_t chunkLen = readBE32(data + pos);
+        const uint8_t* type = data + pos + 4;
+        const uint8_t* body = data + pos + 8;
+        if (chunkLen > len - pos - 12) {
+            return fail("Truncated PNG chunk");
+        }
+        if (crc32(type, chunkLen + 4) != readBE32(body + chunkLen)) {
+            return fail("PNG chunk CRC mismatch");
+        }
+
+        if (std::memcmp(type, "IHDR", 4) == 0) {
+            if (chunkLen < 13) return fail("Invalid IHDR chunk");
+            width_ = static_cast<int>(readBE32(body));
+            height_ = static_cast<int>(readBE32(body + 4));
+            bitDepth_ = body[8];
+            colorType_ = body[9];
+            interlace = body[12];
+            haveHeader = true;
+        } else if (std::memcmp(type, "PLTE", 4) == 0) {
+            uint32_t entries = (std::min)(chunkLen / 3, 256u);
+            for (uint32_t i = 0; i < entries; ++i) {
+                palette_[i * 4 + 0] = body[i * 3 + 0];
+                palette_[i * 4 + 1] = body[i * 3 + 1];
+                palette_[i * 4 + 2] = body[i * 3 + 2];
+            }
+        } else if (std::memcmp(type, "tRNS", 4) == 0) {
+            if (colorType_ == 3) {
+                uint32_t entries = (std::min)(chunkLen, 256u);
+                for (uint32_t i = 0; i < entries; ++i) {
+                    palette_[i * 4 + 3] = body[i];
+                }
+            } else if (colorType_ == 0 && chunkLen >= 2) {
+                transparentKey_[0] = readBE16(body);
+                hasTransparentKey_ = true;
+            } else if (colorType_ == 2 && chunkLen >= 6) {
+                transparentKey_[0] = readBE16(body);
+                transparentKey_[1] = readBE16(body + 2);
+                transparentKey_[2] = readBE16(body + 4);
+                hasTransparentKey_ = true;
+            }
+        } else if (std::memcmp(type, "IDAT", 4) == 0) {
+            inflater_.addInput(body, chunkLen);
+            haveData = true;
+        } else if (std::memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+
+        pos += 12 + chunkLen;
+    }
+
+    inflater_.finish();
+    if (!haveHeader) return fail("Missing IHDR chunk");
+    if (!haveData) return fail("Missing IDAT chunk");
+    if (width_ <= 0 || height_ <= 0) return fail("Invalid image dimensions");
+    if (width_ > kMaxDimension || height_ > kMaxDimension ||
+        static_cast<uint64_t>(width_) * static_cast<uint64_t>(height_) > maxPixels_) {
+        return fail("Image too large");
+    }
+    if (!validDepth(colorType_, bitDepth_)) return fail("Unsupported color type / bit depth");
+    if (interlace != 0) return fail("Interlaced PNG is not supported");
+
+    channels_ = channelsFor(colorType_);
+    size_t bitsPerPixel = static_cast<size_t>(channels_) * static_cast<size_t>(bitDepth_);
+    rowBytes_ = (static_cast<size_t>(width_) * bitsPerPixel + 7) / 8;
+    filterBpp_ = static_cast<int>((std::max)(bitsPerPixel / 8, size_t(1)));
+
+    current_.assign(rowBytes_ + 1, 0);
+    previous_.assign(rowBytes_ + 1, 0);
+    return true;
+}
+
+void PngDecoder::unfilter(uint8_t filter) {
+    uint8_t* cur = current_.data() + 1;
+    const uint8_t* prev = previous_.data() + 1;
+    const size_t n = rowBytes_;
+    const size_t bpp = static_cast<size_t>(filterBpp_);
+
+    switch (filter) {
+        case 1:
+            for (size_t i = bpp; i < n; ++i) cur[i] = static_cast<uint8_t>(cur[i] + cur[i - bpp]);
+            break;
+        case 2:
+            for (size_t i = 0; i < n; ++i) cur[i] = static_cast<uint8_t>(cur[i] + prev[i]);
+            break;
+        case 3:
+            for (size_t i = 0; i < bpp && i < n; ++i) cur[i] = static_cast<uint8_t>(cur[i] + (prev[i] >> 1));
+            for (size_t i = bpp; i < n; ++i) {
+                cur[i] = static_cast<uint8_t>(cur[i] + ((cur[i - bpp] + prev[i]) >> 1));
+            }
+            break;
+        case 4:
+            for (size_t i = 0; i < bpp && i < n; ++i) cur[i] = static_cast<uint8_t>(cur[i] + prev[i]);
+            for (size_t i = bpp; i < n; ++i) {
+                cur[i] = static_cast<uint8_t>(cur[i] + paeth(cur[i - bpp], prev[i], prev[i - bpp]));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+uint32_t PngDecoder::sample(const uint8_t* row, int index) const {
+    switch (bitDepth_) {
+        case 16: return readBE16(row + index * 2);
+        case 8: return row[index];
+        default: {
+            int perByte = 8 / bitDepth_;
+            int shift = 8 - bitDepth_ * (1 + index % perByte);
+            return (row[index / perByte] >> shift) & ((1u << bitDepth_) - 1);
+        }
+    }
+}
+
+void PngDecoder::expandRow(uint8_t* rgba) const {
+    const uint8_t* row = current_.data() + 1;
+    const int w = width_;
+
+    if (colorType_ == 6 && bitDepth_ == 8) {
+        std::memcpy(rgba, row, static_cast<size_t>(w) * 4);
+        return;
+    }
+
+    auto to8 = [this](uint32_t v) -> uint8_t {
+        switch (bitDepth_) {
+            case 16: return static_cast<uint8_t>(v >> 8);
+            case 8: return static_cast<uint8_t>(v);
+            case 4: return static_cast<uint8_t>(v * 17);
+            case 2: return static_cast<uint8_t>(v * 85);
+            default: return static_cast<uint8_t>(v * 255);
+        }
+    };
+
+    for (int x = 0; x < w; ++x) {
+        uint8_t* px = rgba + static_cast<size_t>(x) * 4;
+        switch (colorType_) {
+            case 0: {
+                uint32_t g = sample(row, x);
+                px[0] = px[1] = px[2] = to8(g);
+                px[3] = (hasTransparentKey_ && g == transparentKey_[0]) ? 0 : 255;
+                break;
+            }
+            case 2: {
+                uint32_t r = sample(row, x * 3);
+                uint32_t g = sample(row, x * 3 + 1);
+                uint32_t b = sample(row, x * 3 + 2);
+                px[0] = to8(r);
+                px[1] = to8(g);
+                px[2] = to8(b);
+                px[3] = (hasTransparentKey_ && r == transparentKey_[0] &&
+                         g == transparentKey_[1] && b == transparentKey_[2]) ? 0 : 255;
+                break;
+            }
+            case 3: {
+                std::memcpy(px, palette_ + sample(row, x) * 4, 4);
+                break;
+            }
+            case 4: {
+                uint8_t g = to8(sample(row, x * 2));
+                px[0] = px[1] = px[2] = g;
+                px[3] = to8(sample(row, x * 2 + 1));
+                break;
+            }
+            case 6: {
+                px[0] = to8(sample(row, x * 4));
+                px[1] = to8(sample(row, x * 4 + 1));
+                px[2] = to8(sample(row, x * 4 + 2));
+                px[3] = to8(sample(row, x * 4 + 3));
+                break;
+            }
+        }
+    }
+}
+
+bool PngDecoder::readRow(uint8_t* rgba) {
+    if (row_ >= height_) return fail("No more rows");
+    if (!error_.empty()) return false;
+
+    current_.swap(previous_);
+    size_t got = 0;
+    while (got < current_.size()) {
+        size_t n = inflater_.read(current_.data() + got, current_.size() - got);
+        if (n == 0) {
+            return fail(inflater_.failed() ? inflater_.error() : "Truncated image data");
+        }
+        got += n;
+    }
+
+    uint8_t filter = current_[0];
+    if (filter > 4) return fail("Invalid filter type");
+    unfilter(filter);
+    expandRow(rgba);
+    row_++;
+    if (row_ == height_) {
+        uint8_t trailing = 0;
+        inflater_.read(&trailing, 1);
+        if (inflater_.failed()) return fail(inflater_.error());
+    }
+    return true;
+}
+
+bool PngDecoder::decode(const uint8_t* data, size_t len, std::vector<uint8_t>& rgba,
+                        int& width, int& height) {
+    PngDecoder decoder;
+    if (!decoder.open(data, len)) return false;
+    width = decoder.width();
+    height = decoder.height();
+    size_t stride = static_cast<size_t>(width) * 4;
+    rgba.resize(stride * static_cast<size_t>(height));
+    for (int y = 0; y < height; ++y) {
+        if (!decoder.readRow(rgba.data() + stride * static_cast<size_t>(y))) return false;
+    }
+    return true;
+}
+
+}
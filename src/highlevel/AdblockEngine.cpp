@@ -0,0 +1,795 @@
+
+
+#include "cdp/highlevel/AdblockEngine.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace cdp {
+namespace highlevel {
+
+namespace {
+
+constexpr char kMagic[8] = {'C', 'D', 'P', 'A', 'D', 'B', '\0', '\1'};
+constexpr uint32_t kByteOrder = 0x01020304;
+constexpr uint32_t kVersion = 2;
+
+enum FilterFlag : uint32_t {
+    FlagException = 1u << 0,
+    FlagImportant = 1u << 1,
+    FlagStartAnchor = 1u << 2,
+    FlagEndAnchor = 1u << 3,
+    FlagHostAnchor = 1u << 4,
+    FlagThirdParty = 1u << 5,
+    FlagFirstParty = 1u << 6,
+    FlagMatchCase = 1u << 7
+};
+
+enum TypeBit : uint32_t {
+    TypeScript = 1u << 0,
+    TypeImage = 1u << 1,
+    TypeStylesheet = 1u << 2,
+    TypeObject = 1u << 3,
+    TypeXhr = 1u << 4,
+    TypeSubdocument = 1u << 5,
+    TypeFont = 1u << 6,
+    TypeMedia = 1u << 7,
+    TypeWebSocket = 1u << 8,
+    TypePing = 1u << 9,
+    TypeOther = 1u << 10,
+    TypeAll = (1u << 11) - 1,
+    TypeDocument = 1u << 11
+};
+
+struct Header {
+    char magic[8];
+    uint32_t byteOrder;
+    uint32_t version;
+    uint32_t filterCount;
+    uint32_t filtersOffset;
+    uint32_t domainCount;
+    uint32_t domainsOffset;
+    uint32_t bucketCount;
+    uint32_t bucketsOffset;
+    uint32_t indexCount;
+    uint32_t indexOffset;
+    uint32_t untokenizedStart;
+    uint32_t untokenizedCount;
+    uint32_t stringsSize;
+    uint32_t stringsOffset;
+    uint32_t totalSize;
+    uint32_t exceptions;
+    uint32_t comments;
+    uint32_t cosmetic;
+    uint32_t unsupported;
+};
+
+struct FilterRecord {
+    uint32_t flags;
+    uint32_t typeMask;
+    uint32_t patternOffset;
+    uint32_t patternLength;
+    uint32_t domainsStart;
+    uint32_t domainsCount;
+    uint32_t rawOffset;
+    uint32_t rawLength;
+};
+
+struct DomainRecord {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t negated;
+};
+
+struct Bucket {
+    uint32_t hash;
+    uint32_t start;
+    uint32_t count;
+};
+
+struct ParsedFilter {
+    uint32_t flags = 0;
+    uint32_t typeMask = TypeAll;
+    std::string pattern;
+    std::string raw;
+    std::vector<std::pair<std::string, bool>> domains;
+    std::vector<std::string> tokens;
+};
+
+enum class LineKind { Empty, Comment, Cosmetic, Unsupported, Filter };
+
+bool isTokenChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '%';
+}
+
+bool isSeparator(char c) {
+    return !(std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-' || c == '.' || c == '%');
+}
+
+uint32_t tokenHash(const char* data, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<uint8_t>(std::tolower(static_cast<unsigned char>(data[i])));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+std::string toLower(std::string_view s) {
+    std::string out(s);
+    std::transform(out.begin(), out.end(), out.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return out;
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.remove_suffix(1);
+    return s;
+}
+
+uint32_t typeForOption(std::string_view name) {
+    if (name == "script") return TypeScript;
+    if (name == "image") return TypeImage;
+    if (name == "stylesheet" || name == "css") return TypeStylesheet;
+    if (name == "object") return TypeObject;
+    if (name == "xmlhttprequest" || name == "xhr") return TypeXhr;
+    if (name == "subdocument" || name == "frame") return TypeSubdocument;
+    if (name == "font") return TypeFont;
+    if (name == "media") return TypeMedia;
+    if (name == "websocket") return TypeWebSocket;
+    if (name == "ping") return TypePing;
+    if (name == "other") return TypeOther;
+    if (name == "document" || name == "doc") return TypeDocument;
+    return 0;
+}
+
+uint32_t typeForResource(std::string_view resourceType) {
+    if (resourceType.empty()) return TypeAll;
+    if (resourceType == "Script") return TypeScript;
+    if (resourceType == "Image") return TypeImage;
+    if (resourceType == "Stylesheet") return TypeStylesheet;
+    if (resourceType == "XHR" || resourceType == "Fetch" || resourceType == "EventSource") return TypeXhr;
+    if (resourceType == "Document") return TypeDocument;
+    if (resourceType == "Subdocument") return TypeSubdocument;
+    if (resourceType == "Font") return TypeFont;
+    if (resourceType == "Media") return TypeMedia;
+    if (resourceType == "WebSocket") return TypeWebSocket;
+    if (resourceType == "Ping" || resourceType == "CSPViolationReport") return TypePing;
+    return TypeOther;
+}
+
+bool parseOptions(std::string_view options, ParsedFilter& filter) {
+    uint32_t include = 0;
+    uint32_t exclude = 0;
+    size_t pos = 0;
+    while (pos <= options.size()) {
+        size_t comma = options.find(',', pos);
+        if (comma == std::string_view::npos) comma = options.size();
+        std::string option = toLower(trim(options.substr(pos, comma - pos)));
+        pos = comma + 1;
+        if (option.empty()) continue;
+
+        bool negated = option[0] == '~';
+        std::string_view name = negated ? std::string_view(option).substr(1) : std::string_view(option);
+
+        if (name == "third-party" || name == "3p") {
+            filter.flags |= negated ? FlagFirstParty : FlagThirdParty;
+        } else if (name == "first-party" || name == "1p") {
+            filter.flags |= negated ? FlagThirdParty : FlagFirstParty;
+        } else if (name == "match-case" && !negated) {
+            filter.flags |= FlagMatchCase;
+        } else if (name == "important" && !negated) {
+            filter.flags |= FlagImportant;
+        } else if (name == "all" && !negated) {
+            include |= TypeAll | TypeDocument;
+        } else if (name.substr(0, 7) == "domain=" && !negated) {
+            std::string_view list = name.substr(7);
+            size_t start = 0;
+            while (start <= list.size()) {
+                size_t bar = list.find('|', start);
+                if (bar == std::string_view::npos) bar = list.size();
+                std::string_view domain = list.substr(start, bar - start);
+                start = bar + 1;
+                bool negatedDomain = !domain.empty() && domain[0] == '~';
+                if (negatedDomain) domain.remove_prefix(1);
+                if (!domain.empty()) filter.domains.emplace_back(std::string(domain), negatedDomain);
+            }
+        } else if (uint32_t bit = typeForOption(name)) {
+            (negated ? exclude : include) |= bit;
+        } else {
+            return false;
+        }
+    }
+
+    filter.typeMask = (include ? include : TypeAll) & ~exclude;
+    return filter.typeMask != 0;
+}
+
+void extractTokens(ParsedFilter& filter) {
+    const std::string& p = filter.pattern;
+    bool anchoredStart = (filter.flags & (FlagStartAnchor | FlagHostAnchor)) != 0;
+    bool anchoredEnd = (filter.flags & FlagEndAnchor) != 0;
+    size_t i = 0;
+    while (i < p.size()) {
+        if (!isTokenChar(p[i])) {
+            ++i;
+            continue;
+        }
+        size_t start = i;
+        while (i < p.size() && isTokenChar(p[i])) ++i;
+        bool leftOk = start > 0 ? p[start - 1] != '*' : anchoredStart;
+        bool rightOk = i < p.size() ? p[i] != '*' : anchoredEnd;
+        if (leftOk && rightOk) filter.tokens.push_back(toLower(std::string_view(p).substr(start, i - start)));
+    }
+}
+
+LineKind parseLine(std::string_view line, ParsedFilter& filter) {
+    line = trim(line);
+    if (line.empty()) return LineKind::Empty;
+    if (line[0] == '!' || line[0] == '[') return LineKind::Comment;
+    for (const char* marker : {"##", "#@#", "#?#", "#$#", "#%#"}) {
+        if (line.find(marker) != std::string_view::npos) return LineKind::Cosmetic;
+    }
+
+    filter.raw = std::string(line);
+    std::string_view body = line;
+    if (body.substr(0, 2) == "@@") {
+        filter.flags |= FlagException;
+        body.remove_prefix(2);
+    }
+
+    size_t dollar = body.rfind('$');
+    if (dollar != std::string_view::npos) {
+        if (!parseOptions(body.substr(dollar + 1), filter)) return LineKind::Unsupported;
+        body = body.substr(0, dollar);
+    }
+
+    if (body.size() >= 2 && body.front() == '/' && body.back() == '/') return LineKind::Unsupported;
+
+    if (body.substr(0, 2) == "||") {
+        filter.flags |= FlagHostAnchor;
+        body.remove_prefix(2);
+        if (body.empty()) return LineKind::Unsupported;
+    } else if (!body.empty() && body.front() == '|') {
+        filter.flags |= FlagStartAnchor;
+        body.remove_prefix(1);
+    }
+    if (!body.empty() && body.back() == '|') {
+        filter.flags |= FlagEndAnchor;
+        body.remove_suffix(1);
+    }
+
+    std::string pattern;
+    pattern.reserve(body.size());
+    for (char c : body) {
+        if (c == '*' && !pattern.empty() && pattern.back() == '*') continue;
+        pattern.push_back(c);
+    }
+    if (!pattern.empty() && pattern.front() == '*') {
+        filter.flags &= ~(FlagStartAnchor | FlagHostAnchor);
+        pattern.erase(0, 1);
+    }
+    if (!pattern.empty() && pattern.back() == '*') {
+        filter.flags &= ~FlagEndAnchor;
+        pattern.pop_back();
+    }
+
+    filter.pattern = (filter.flags & FlagMatchCase) ? pattern : toLower(pattern);
+    extractTokens(filter);
+    return LineKind::Filter;
+}
+
+void hostRange(std::string_view url, size_t& start, size_t& length) {
+    start = 0;
+    length = 0;
+    size_t scheme = url.find("://");
+    if (scheme == std::string_view::npos) return;
+    size_t begin = scheme + 3;
+    size_t end = url.find_first_of("/?#", begin);
+    if (end == std::string_view::npos) end = url.size();
+
+    size_t at = url.rfind('@', end - 1);
+    if (at != std::string_view::npos && at >= begin) begin = at + 1;
+    if (begin < end && url[begin] == '[') {
+        size_t close = url.find(']', begin);
+        if (close != std::string_view::npos && close < end) end = close + 1;
+    } else {
+        size_t colon = url.find(':', begin);
+        if (colon != std::string_view::npos && colon < end) end = colon;
+    }
+    start = begin;
+    length = end - begin;
+}
+
+std::string_view hostOf(std::string_view url) {
+    size_t start;
+    size_t length;
+    hostRange(url, start, length);
+    return url.substr(start, length);
+}
+
+std::string_view baseDomain(std::string_view host) {
+    if (host.empty() || host.front() == '[') return host;
+    if (std::all_of(host.begin(), host.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) || c == '.'; })) {
+        return host;
+    }
+    size_t last = host.rfind('.');
+    if (last == std::string_view::npos || last == 0) return host;
+    size_t second = host.rfind('.', last - 1);
+    if (second == std::string_view::npos) return host;
+
+    std::string_view tld = host.substr(last + 1);
+    std::string_view sld = host.substr(second + 1, last - second - 1);
+    if (tld.size() == 2 && second > 0) {
+        for (const char* generic : {"co", "com", "net", "org", "gov", "edu", "ac", "or", "ne", "go"}) {
+            if (sld == generic) {
+                size_t third = host.rfind('.', second - 1);
+                return third == std::string_view::npos ? host : host.substr(third + 1);
+            }
+        }
+    }
+    return host.substr(second + 1);
+}
+
+bool hostMatches(std::string_view host, std::string_view domain) {
+    if (host.size() < domain.size()) return false;
+    if (host.substr(host.size() - domain.size()) != domain) return false;
+    return host.size() == domain.size() || host[host.size() - domain.size() - 1] == '.';
+}
+
+bool globMatch(std::string_view pattern, std::string_view text, size_t pos, bool anchored, bool anchoredEnd) {
+    const size_t npos = std::string_view::npos;
+    size_t p = 0;
+    size_t i = pos;
+    size_t starP = anchored ? npos : 0;
+    size_t starI = pos;
+
+    while (true) {
+        if (p == pattern.size()) {
+            if (!anchoredEnd || i == text.size()) return true;
+        } else if (pattern[p] == '*') {
+            starP = ++p;
+            starI = i;
+            continue;
+        } else if (i < text.size() && (pattern[p] == '^' ? isSeparator(text[i]) : pattern[p] == text[i])) {
+            ++p;
+            ++i;
+            continue;
+        } else if (i == text.size() && pattern[p] == '^') {
+            ++p;
+            continue;
+        }
+
+        if (starP == npos || starI >= text.size()) return false;
+        p = starP;
+        i = ++starI;
+    }
+}
+
+size_t align4(size_t n) {
+    return (n + 3) & ~static_cast<size_t>(3);
+}
+
+template <typename T>
+const T* section(const uint8_t* data, uint32_t offset) {
+    return reinterpret_cast<const T*>(data + offset);
+}
+
+bool sectionFits(size_t size, uint32_t offset, uint64_t count, size_t itemSize) {
+    return offset % 4 == 0 && static_cast<uint64_t>(offset) + count * itemSize <= size;
+}
+
+std::vector<uint8_t> build(const std::vector<ParsedFilter>& filters, const AdblockStats& stats) {
+    std::unordered_map<std::string, uint32_t> tokenUse;
+    for (const auto& filter : filters) {
+        for (const auto& token : filter.tokens) tokenUse[token]++;
+    }
+
+    std::unordered_map<uint32_t, std::vector<uint32_t>> buckets;
+    std::vector<uint32_t> untokenized;
+    for (uint32_t id = 0; id < filters.size(); ++id) {
+        const std::string* best = nullptr;
+        for (const auto& token : filters[id].tokens) {
+            if (!best) {
+                best = &token;
+                continue;
+            }
+            uint32_t use = tokenUse[token];
+            uint32_t bestUse = tokenUse[*best];
+            if (use < bestUse || (use == bestUse && token.size() > best->size())) best = &token;
+        }
+        if (best) {
+            buckets[tokenHash(best->data(), best->size())].push_back(id);
+        } else {
+            untokenized.push_back(id);
+        }
+    }
+
+    std::string strings;
+    std::vector<FilterRecord> records;
+    std::vector<DomainRecord> domains;
+    records.reserve(filters.size());
+    for (const auto& filter : filters) {
+        FilterRecord record{};
+        record.flags = filter.flags;
+        record.typeMask = filter.typeMask;
+        record.patternOffset = static_cast<uint32_t>(strings.size());
+        record.patternLength = static_cast<uint32_t>(filter.pattern.size());
+        strings += filter.pattern;
+        record.rawOffset = static_cast<uint32_t>(strings.size());
+        record.rawLength = static_cast<uint32_t>(filter.raw.size());
+        strings += filter.raw;
+        record.domainsStart = static_cast<uint32_t>(domains.size());
+        record.domainsCount = static_cast<uint32_t>(filter.domains.size());
+        for (const auto& [name, negated] : filter.domains) {
+            domains.push_back({static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(name.size()),
+                               negated ? 1u : 0u});
+            strings += name;
+        }
+        records.push_back(record);
+    }
+
+    uint32_t tableSize = 1;
+    while (tableSize < buckets.size() * 2) tableSize <<= 1;
+    std::vector<Bucket> table(tableSize, Bucket{0, 0, 0});
+    std::vector<uint32_t> index;
+    index.reserve(filters.size());
+    for (const auto& [hash, ids] : buckets) {
+        uint32_t slot = hash & (tableSize - 1);
+        while (table[slot].count != 0) slot = (slot + 1) & (tableSize - 1);
+        table[slot] = {hash, static_cast<uint32_t>(index.size()), static_cast<uint32_t>(ids.size())};
+        index.insert(index.end(), ids.begin(), ids.end());
+    }
+    uint32_t untokenizedStart = static_cast<uint32_t>(index.size());
+    index.insert(index.end(), untokenized.begin(), untokenized.end());
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.byteOrder = kByteOrder;
+    header.version = kVersion;
+    size_t offset = align4(sizeof(Header));
+    header.filterCount = static_cast<uint32_t>(records.size());
+    header.filtersOffset = static_cast<uint32_t>(offset);
+    offset = align4(offset + records.size() * sizeof(FilterRecord));
+    header.domainCount = static_cast<uint32_t>(domains.size());
+    header.domainsOffset = static_cast<uint32_t>(offset);
+    offset = align4(offset + domains.size() * sizeof(DomainRecord));
+    header.bucketCount = tableSize;
+    header.bucketsOffset = static_cast<uint32_t>(offset);
+    offset = align4(offset + table.size() * sizeof(Bucket));
+    header.indexCount = static_cast<uint32_t>(index.size());
+    header.indexOffset = static_cast<uint32_t>(offset);
+    offset = align4(offset + index.size() * sizeof(uint32_t));
+    header.untokenizedStart = untokenizedStart;
+    header.untokenizedCount = static_cast<uint32_t>(untokenized.size());
+    header.stringsSize = static_cast<uint32_t>(strings.size());
+    header.stringsOffset = static_cast<uint32_t>(offset);
+    offset = align4(offset + strings.size());
+    header.totalSize = static_cast<uint32_t>(offset);
+    header.exceptions = static_cast<uint32_t>(stats.exceptions);
+    header.comments = static_cast<uint32_t>(stats.comments);
+    header.cosmetic = static_cast<uint32_t>(stats.cosmetic);
+    header.unsupported = static_cast<uint32_t>(stats.unsupported);
+
+    std::vector<uint8_t> out(offset, 0);
+    std::memcpy(out.data(), &header, sizeof(header));
+    if (!records.empty()) {
+        std::memcpy(out.data() + header.filtersOffset, records.data(), records.size() * sizeof(FilterRecord));
+    }
+    if (!domains.empty()) {
+        std::memcpy(out.data() + header.domainsOffset, domains.data(), domains.size() * sizeof(DomainRecord));
+    }
+    std::memcpy(out.data() + header.bucketsOffset, table.data(), table.size() * sizeof(Bucket));
+    if (!index.empty()) {
+        std::memcpy(out.data() + header.indexOffset, index.data(), index.size() * sizeof(uint32_t));
+    }
+    if (!strings.empty()) {
+        std::memcpy(out.data() + header.stringsOffset, strings.data(), strings.size());
+    }
+    return out;
+}
+
+struct MatchContext {
+    const uint8_t* data;
+    const Header* header;
+    std::string_view url;
+    std::string_view lowerUrl;
+    uint32_t type;
+    std::string_view sourceHost;
+    int thirdParty;
+};
+
+bool filterMatches(const MatchContext& ctx, const FilterRecord& filter) {
+    if ((filter.typeMask & ctx.type) == 0) return false;
+    if (filter.flags & (FlagThirdParty | FlagFirstParty)) {
+        if (ctx.thirdParty < 0) return false;
+        if ((filter.flags & FlagThirdParty) && ctx.thirdParty == 0) return false;
+        if ((filter.flags & FlagFirstParty) && ctx.thirdParty == 1) return false;
+    }
+
+    const char* strings = section<char>(ctx.data, ctx.header->stringsOffset);
+    if (filter.domainsCount > 0) {
+        const DomainRecord* domains = section<DomainRecord>(ctx.data, ctx.header->domainsOffset) + filter.domainsStart;
+        bool anyInclude = false;
+        bool included = false;
+        for (uint32_t d = 0; d < filter.domainsCount; ++d) {
+            std::string_view domain(strings + domains[d].offset, domains[d].length);
+            bool hit = hostMatches(ctx.sourceHost, domain);
+            if (domains[d].negated) {
+                if (hit) return false;
+            } else {
+                anyInclude = true;
+                included = included || hit;
+            }
+        }
+        if (anyInclude && !included) return false;
+    }
+
+    std::string_view pattern(strings + filter.patternOffset, filter.patternLength);
+    std::string_view text = (filter.flags & FlagMatchCase) ? ctx.url : ctx.lowerUrl;
+    bool anchoredEnd = (filter.flags & FlagEndAnchor) != 0;
+
+    if (filter.flags & FlagHostAnchor) {
+        size_t start;
+        size_t length;
+        hostRange(text, start, length);
+        if (length == 0) return false;
+        for (size_t pos = start; pos < start + length; ++pos) {
+            if (pos != start && text[pos - 1] != '.') continue;
+            if (globMatch(pattern, text, pos, true, anchoredEnd)) return true;
+        }
+        return false;
+    }
+    return globMatch(pattern, text, 0, (filter.flags & FlagStartAnchor) != 0, anchoredEnd);
+}
+
+enum class Pass { Block, Exception, Important };
+
+int64_t findFilter(const MatchContext& ctx, const std::vector<uint32_t>& hashes, Pass pass) {
+    const FilterRecord* filters = section<FilterRecord>(ctx.data, ctx.header->filtersOffset);
+    const Bucket* table = section<Bucket>(ctx.data, ctx.header->bucketsOffset);
+    const uint32_t* index = section<uint32_t>(ctx.data, ctx.header->indexOffset);
+    uint32_t mask = ctx.header->bucketCount - 1;
+
+    auto scan = [&](uint32_t start, uint32_t count) -> int64_t {
+        for (uint32_t k = start; k < start + count; ++k) {
+            const FilterRecord& filter = filters[index[k]];
+            bool exception = (filter.flags & FlagException) != 0;
+            if (exception != (pass == Pass::Exception)) continue;
+            if (pass == Pass::Important && !(filter.flags & FlagImportant)) continue;
+            if (filterMatches(ctx, filter)) return index[k];
+        }
+        return -1;
+    };
+
+    for (uint32_t hash : hashes) {
+        uint32_t slot = hash & mask;
+        while (table[slot].count != 0) {
+            if (table[slot].hash == hash) {
+                int64_t found = scan(table[slot].start, table[slot].count);
+                if (found >= 0) return found;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+    return scan(ctx.header->untokenizedStart, ctx.header->untokenizedCount);
+}
+
+}
+
+Result<std::shared_ptr<AdblockEngine>> AdblockEngine::compile(std::string_view rules) {
+    std::vector<ParsedFilter> filters;
+    AdblockStats stats;
+
+    size_t pos = 0;
+    while (pos < rules.size()) {
+        size_t eol = rules.find('\n', pos);
+        if (eol == std::string_view::npos) eol = rules.size();
+        ParsedFilter filter;
+        switch (parseLine(rules.substr(pos, eol - pos), filter)) {
+            case LineKind::Empty: break;
+            case LineKind::Comment: stats.comments++; break;
+            case LineKind::Cosmetic: stats.cosmetic++; break;
+            case LineKind::Unsupported: stats.unsupported++; break;
+            case LineKind::Filter:
+                if (filter.flags & FlagException) stats.exceptions++;
+                filters.push_back(std::move(filter));
+                break;
+        }
+        pos = eol + 1;
+    }
+
+    std::shared_ptr<AdblockEngine> engine(new AdblockEngine());
+    engine->owned_ = build(filters, stats);
+    std::string error;
+    if (!engine->attach(engine->owned_.data(), engine->owned_.size(), error)) {
+        return Result<std::shared_ptr<AdblockEngine>>::failure(ErrorCode::Internal, error);
+    }
+    return engine;
+}
+
+Result<std::shared_ptr<AdblockEngine>> AdblockEngine::compileFiles(const std::vector<std::string>& paths) {
+    std::string rules;
+    for (const auto& path : paths) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return Result<std::shared_ptr<AdblockEngine>>::failure(ErrorCode::InvalidArgument,
+                                                                   "Failed to open filter list: " + path);
+        }
+        std::ostringstream content;
+        content << in.rdbuf();
+        rules += content.str();
+        rules += '\n';
+    }
+    return compile(rules);
+}
+
+Result<std::shared_ptr<AdblockEngine>> AdblockEngine::open(const std::string& path) {
+    std::shared_ptr<AdblockEngine> engine(new AdblockEngine());
+    if (!engine->mapped_.open(path)) {
+        return Result<std::shared_ptr<AdblockEngine>>::failure(ErrorCode::InvalidArgument,
+                                                               engine->mapped_.error());
+    }
+    std::string error;
+    if (!engine->attach(engine->mapped_.data(), engine->mapped_.size(), error)) {
+        return Result<std::shared_ptr<AdblockEngine>>::failure(ErrorCode::InvalidArgument,
+                                                               path + ": " + error);
+    }
+    return engine;
+}
+
+Result<void> AdblockEngine::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return Result<void>::failure(ErrorCode::InvalidArgument, "Failed to open file for writing: " + path);
+    }
+    out.write(reinterpret_cast<const char*>(data_), static_cast<std::streamsize>(size_));
+    if (!out) {
+        return Result<void>::failure(ErrorCode::Internal, "Failed to write filter index: " + path);
+    }
+    return Result<void>::success();
+}
+
+bool AdblockEngine::attach(const uint8_t* data, size_t size, std::string& error) {
+    if (size < sizeof(Header)) {
+        error = "Filter index is truncated";
+        return false;
+    }
+    const Header* header = reinterpret_cast<const Header*>(data);
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+        error = "Not a compiled filter index";
+        return false;
+    }
+    if (header->byteOrder != kByteOrder || header->version != kVersion) {
+        error = "Unsupported filter index version or byte order";
+        return false;
+    }
+    if (header->totalSize > size ||
+        !sectionFits(size, header->filtersOffset, header->filterCount, sizeof(FilterRecord)) ||
+        !sectionFits(size, header->domainsOffset, header->domainCount, sizeof(DomainRecord)) ||
+        !sectionFits(size, header->bucketsOffset, header->bucketCount, sizeof(Bucket)) ||
+        !sectionFits(size, header->indexOffset, header->indexCount, sizeof(uint32_t)) ||
+        static_cast<uint64_t>(header->stringsOffset) + header->stringsSize > size ||
+        header->bucketCount == 0 || (header->bucketCount & (header->bucketCount - 1)) != 0 ||
+        static_cast<uint64_t>(header->untokenizedStart) + header->untokenizedCount > header->indexCount) {
+        error = "Filter index sections are out of bounds";
+        return false;
+    }
+
+    const FilterRecord* filters = section<FilterRecord>(data, header->filtersOffset);
+    for (uint32_t i = 0; i < header->filterCount; ++i) {
+        const FilterRecord& f = filters[i];
+        if (static_cast<uint64_t>(f.patternOffset) + f.patternLength > header->stringsSize ||
+            static_cast<uint64_t>(f.rawOffset) + f.rawLength > header->stringsSize ||
+            static_cast<uint64_t>(f.domainsStart) + f.domainsCount > header->domainCount) {
+            error = "Filter record is out of bounds";
+            return false;
+        }
+    }
+    const DomainRecord* domains = section<DomainRecord>(data, header->domainsOffset);
+    for (uint32_t i = 0; i < header->domainCount; ++i) {
+        if (static_cast<uint64_t>(domains[i].offset) + domains[i].length > header->stringsSize) {
+            error = "Domain record is out of bounds";
+            return false;
+        }
+    }
+    const Bucket* table = section<Bucket>(data, header->bucketsOffset);
+    bool hasEmptySlot = false;
+    for (uint32_t i = 0; i < header->bucketCount; ++i) {
+        if (table[i].count == 0) hasEmptySlot = true;
+        if (static_cast<uint64_t>(table[i].start) + table[i].count > header->indexCount) {
+            error = "Filter bucket is out of bounds";
+            return false;
+        }
+    }
+    const uint32_t* index = section<uint32_t>(data, header->indexOffset);
+    for (uint32_t i = 0; i < header->indexCount; ++i) {
+        if (index[i] >= header->filterCount) {
+            error = "Filter index entry is out of bounds";
+            return false;
+        }
+    }
+    if (!hasEmptySlot) {
+        error = "Filter bucket table is full";
+        return false;
+    }
+
+    data_ = data;
+    size_ = size;
+    stats_.filters = header->filterCount;
+    stats_.exceptions = header->exceptions;
+    stats_.untokenized = header->untokenizedCount;
+    stats_.comments = header->comments;
+    stats_.cosmetic = header->cosmetic;
+    stats_.unsupported = header->unsupported;
+    return true;
+}
+
+AdblockMatch AdblockEngine::match(std::string_view url, std::string_view resourceType,
+                                  std::string_view sourceUrl) const {
+    AdblockMatch result;
+    if (!data_ || url.empty()) return result;
+
+    std::string lowerUrl = toLower(url);
+    std::string lowerSource = toLower(sourceUrl);
+
+    MatchContext ctx;
+    ctx.data = data_;
+    ctx.header = reinterpret_cast<const Header*>(data_);
+    ctx.url = url;
+    ctx.lowerUrl = lowerUrl;
+    ctx.type = typeForResource(resourceType);
+    ctx.sourceHost = hostOf(lowerSource);
+    ctx.thirdParty = -1;
+    std::string_view requestHost = hostOf(lowerUrl);
+    if (!ctx.sourceHost.empty() && !requestHost.empty()) {
+        ctx.thirdParty = baseDomain(requestHost) == baseDomain(ctx.sourceHost) ? 0 : 1;
+    }
+
+    std::vector<uint32_t> hashes;
+    hashes.reserve(32);
+    size_t i = 0;
+    while (i < lowerUrl.size()) {
+        if (!isTokenChar(lowerUrl[i])) {
+            ++i;
+            continue;
+        }
+        size_t start = i;
+        while (i < lowerUrl.size() && isTokenChar(lowerUrl[i])) ++i;
+        uint32_t hash = tokenHash(lowerUrl.data() + start, i - start);
+        if (std::find(hashes.begin(), hashes.end(), hash) == hashes.end()) hashes.push_back(hash);
+    }
+
+    const FilterRecord* filters = section<FilterRecord>(data_, ctx.header->filtersOffset);
+    const char* strings = section<char>(data_, ctx.header->stringsOffset);
+    auto rawText = [&](int64_t id) {
+        return std::string_view(strings + filters[id].rawOffset, filters[id].rawLength);
+    };
+
+    int64_t block = findFilter(ctx, hashes, Pass::Block);
+    if (block < 0) return result;
+
+    if (!(filters[block].flags & FlagImportant)) {
+        int64_t exception = findFilter(ctx, hashes, Pass::Exception);
+        if (exception >= 0) {
+            int64_t important = findFilter(ctx, hashes, Pass::Important);
+            if (important < 0) {
+                result.excepted = true;
+                result.filter = rawText(exception);
+                return result;
+            }
+            block = important;
+        }
+    }
+
+    result.blocked = true;
+    result.filter = rawText(block);
+    return result;
+}
+
+}
+}
@@ -23,7 +23,13 @@ ManagedPage::ManagedPage(ManagedPage&& other) noexcept
     : client_(std::move(other.client_))
     , page_(std::move(other.page_))
     , targetId_(std::move(other.targetId_))
-    , contextId_(std::move(other.contextId_)) {
+    , contextId_(std::move(other.contextId_))
+    , browser_(other.browser_)
+    , setup_(std::move(other.setup_))
+    , recyclePolicy_(other.recyclePolicy_)
+    , recycles_(other.recycles_)
+    , performanceEnabled_(other.performanceEnabled_)
+    , proxyAuthTokens_(std::move(other.proxyAuthTokens_)) {
 }
 
 ManagedPage& ManagedPage::operator=(ManagedPage&& other) noexcept {
@@ -32,6 +38,12 @@ ManagedPage& ManagedPage::operator=(ManagedPage&& other) noexcept {
         page_ = std::move(other.page_);
         targetId_ = std::move(other.targetId_);
         contextId_ = std::move(other.contextId_);
+        browser_ = other.browser_;
+        setup_ = std::move(other.setup_);
+        recyclePolicy_ = other.recyclePolicy_;
+        recycles_ = other.recycles_;
+        performanceEnabled_ = other.performanceEnabled_;
+        proxyAuthTokens_ = std::move(other.proxyAuthTokens_);
     }
     return *this;
 }
@@ -42,6 +54,12 @@ Result<void> ManagedPage::close() {
     }
 
     
+    if (isDead() && browser_) {
+        client_->disconnect();
+        return browser_->closeTarget(targetId_);
+    }
+
+    
     auto resp = client_->Target.closeTarget(targetId_);
     if (resp.hasError) {
         return Result<void>::failure(resp.errorCode, resp.errorMessage);
@@ -63,6 +81,188 @@ Result<void> ManagedPage::bringToFront() {
     return Result<void>::success();
 }
 
+Result<void> ManagedPage::setViewport(int width, int height, double deviceScaleFactor) {
+    setup_.hasViewport = true;
+    setup_.width = width;
+    setup_.height = height;
+    setup_.deviceScaleFactor = deviceScaleFactor;
+    return page_->setViewport(width, height, deviceScaleFactor);
+}
+
+Result<void> ManagedPage::setUserAgent(const std::string& userAgent) {
+    setup_.userAgent = userAgent;
+    return page_->setUserAgent(userAgent);
+}
+
+Result<void> ManagedPage::addInitScript(const std::string& source) {
+    setup_.initScripts.push_back(source);
+    auto resp = client_->Page.addScriptToEvaluateOnNewDocument(source);
+    if (resp.hasError) {
+        return Result<void>::failure(resp.errorCode, resp.errorMessage);
+    }
+    return Result<void>::success();
+}
+
+Result<void> ManagedPage::setCookies(const JsonArray& cookies) {
+    for (const auto& cookie : cookies) {
+        setup_.cookies.push_back(cookie);
+    }
+    auto resp = client_->Network.call("setCookies", Params().set("cookies", cookies));
+    if (resp.hasError) {
+        return Result<void>::failure(resp.errorCode, resp.errorMessage);
+    }
+    return Result<void>::success();
+}
+
+Result<void> ManagedPage::addSetupStep(PageSetupStep step) {
+    if (!step) {
+        return Result<void>::failure(ErrorCode::InvalidArgument, "Setup step is empty");
+    }
+    setup_.steps.push_back(step);
+    return step(*this);
+}
+
+void ManagedPage::clearSetup() {
+    setup_ = Setup{};
+}
+
+Result<void> ManagedPage::applySetup() {
+    if (setup_.hasViewport) {
+        auto r = page_->setViewport(setup_.width, setup_.height, setup_.deviceScaleFactor);
+        if (!r) return r;
+    }
+    if (!setup_.userAgent.empty()) {
+        auto r = page_->setUserAgent(setup_.userAgent);
+        if (!r) return r;
+    }
+    for (const auto& source : setup_.initScripts) {
+        auto resp = client_->Page.addScriptToEvaluateOnNewDocument(source);
+        if (resp.hasError) {
+            return Result<void>::failure(resp.errorCode, resp.errorMessage);
+        }
+    }
+    if (!setup_.cookies.empty()) {
+        auto resp = client_->Network.call("setCookies", Params().set("cookies", setup_.cookies));
+        if (resp.hasError) {
+            return Result<void>::failure(resp.errorCode, resp.errorMessage);
+        }
+    }
+    if (performanceEnabled_) {
+        auto resp = client_->Performance.enable();
+        if (resp.hasError) {
+            return Result<void>::failure(resp.errorCode, resp.errorMessage);
+        }
+    }
+    for (const auto& step : setup_.steps) {
+        auto r = step(*this);
+        if (!r) return r;
+    }
+    return Result<void>::success();
+}
+
+Result<uint64_t> ManagedPage::jsHeapUsedBytes() {
+    if (!client_ || !client_->isConnected()) {
+        return Result<uint64_t>::failure(ErrorCode::ConnectionClosed, "Page not connected");
+    }
+
+    auto resp = client_->Runtime.call("getHeapUsage");
+    if (!resp.hasError) {
+        return Result<uint64_t>(static_cast<uint64_t>(resp.result["usedSize"].getNumber()));
+    }
+
+    
+    if (!performanceEnabled_) {
+        auto enabled = client_->Performance.enable();
+        if (enabled.hasError) {
+            return Result<uint64_t>::failure(enabled.errorCode, enabled.errorMessage);
+        }
+        performanceEnabled_ = true;
+    }
+    auto metrics = client_->Performance.getMetrics();
+    if (metrics.hasError) {
+        return Result<uint64_t>::failure(metrics.errorCode, metrics.errorMessage);
+    }
+    const auto& list = metrics.result["metrics"];
+    for (size_t i = 0; i < list.size(); ++i) {
+        if (list[i]["name"].getString() == "JSHeapUsedSize") {
+            return Result<uint64_t>(static_cast<uint64_t>(list[i]["value"].getNumber()));
+        }
+    }
+    return Result<uint64_t>::failure(ErrorCode::NotSupported, "JS heap usage unavailable");
+}
+
+std::string ManagedPage::recycleReason() {
+    const auto& policy = recyclePolicy_;
+    if (!page_ || !policy.enabled()) return "";
+
+    if (policy.maxNavigations > 0 && page_->navigationCount() >= policy.maxNavigations) {
+        return "navigations";
+    }
+
+    if (policy.maxJsHeapBytes > 0) {
+        auto heap = jsHeapUsedBytes();
+        if (heap && heap.value() > policy.maxJsHeapBytes) {
+            return "jsHeap";
+        }
+    }
+
+    if (policy.maxRendererRssBytes > 0 && browser_ && browser_->processMonitor_) {
+        auto sample = browser_->processMonitor_->latest();
+        if (!sample) sample = browser_->processMonitor_->sampleNow();
+        if (sample->rssBytesOfType("renderer") > policy.maxRendererRssBytes) {
+            return "rendererRss";
+        }
+    }
+
+    return "";
+}
+
+Result<bool> ManagedPage::recycleIfNeeded() {
+    if (recycleReason().empty()) {
+        return Result<bool>(false);
+    }
+    auto r = recycle();
+    if (!r) return Result<bool>::failure(r.error());
+    return Result<bool>(true);
+}
+
+Result<void> ManagedPage::recycle() {
+    if (!browser_ || !client_ || !page_) {
+        return Result<void>::failure(ErrorCode::NotSupported, "Page is not owned by a Browser");
+    }
+
+    
+    auto created = browser_->createTarget("about:blank", 0, 0, contextId_, true);
+    if (!created) {
+        return Result<void>::failure(created.error());
+    }
+    std::string oldTargetId = targetId_;
+    std::string newTargetId = created.value();
+
+    auto attached = browser_->attachClient(*client_, newTargetId, true);
+    if (!attached) {
+        std::string error = attached.error().message;
+        browser_->closeTarget(newTargetId);
+        if (!browser_->attachClient(*client_, oldTargetId, true)) {
+            return Result<void>::failure(ErrorCode::ConnectionClosed, error);
+        }
+        page_->reattach();
+        auto restored = applySetup();
+        if (!restored) {
+            return Result<void>::failure(restored.error().code,
+                                         error + "; restoring page setup failed: " + restored.error().message);
+        }
+        return Result<void>::failure(ErrorCode::ConnectionFailed, error);
+    }
+
+    targetId_ = newTargetId;
+    browser_->closeTarget(oldTargetId);
+    page_->reattach();
+    recycles_++;
+
+    return applySetup();
+}
+
 
 BrowserContext::BrowserContext(Browser* browser, const std::string& contextId,
                                const BrowserContextOptions& options)
@@ -88,7 +288,10 @@ Result<ManagedPage*> BrowserContext::newPage(const NewPageOptions& options) {
 
     
     if (options_.proxyCredentials.has_value()) {
-        setupProxyAuth(page);
+        page->addSetupStep([this](ManagedPage& p) {
+            setupProxyAuth(&p);
+            return Result<void>::success();
+        });
     }
 
     return Result<ManagedPage*>(page);
@@ -107,30 +310,17 @@ void BrowserContext::setupProxyAuth(ManagedPage* page) {
     clientPtr->Fetch.enable({}, true);  
 
     
-    clientPtr->Fetch.onAuthRequired([clientPtr, creds](const std::string& requestId,
-                                                        const JsonValue&,
-                                                        const std::string&,
-                                                        const std::string&,
-                                                        const JsonValue&) {
-        
-        AuthChallengeResponse authResponse = AuthChallengeResponse::credentials(
-            creds.username, creds.password);
-        clientPtr->Fetch.continueWithAuthAsync(requestId, authResponse);
-    });
-
-    
-    clientPtr->Fetch.onRequestPaused([clientPtr](const std::string& requestId,
-                                                  const JsonValue&,
-                                                  const std::string&,
-                                                  const std::string&,
-                                                  const JsonValue&,
-                                                  int,
-                                                  const std::string&,
-                                                  const JsonValue&,
-                                                  const std::string&) {
-        
-        clientPtr->Fetch.continueRequestAsync(requestId);
-    });
+    page->proxyAuthTokens_.clear();
+    page->proxyAuthTokens_.push_back(clientPtr->Fetch.onScoped("authRequired",
+        [clientPtr, creds](const CDPEvent& event) {
+            AuthChallengeResponse authResponse = AuthChallengeResponse::credentials(
+                creds.username, creds.password);
+            clientPtr->Fetch.continueWithAuthAsync(event.params["requestId"].getString(), authResponse);
+        }));
+    page->proxyAuthTokens_.push_back(clientPtr->Fetch.onScoped("requestPaused",
+        [clientPtr](const CDPEvent& event) {
+            clientPtr->Fetch.continueRequestAsync(event.params["requestId"].getString());
+        }));
 }
 
 std::vector<ManagedPage*> BrowserContext::pages() {
@@ -144,6 +334,21 @@ std::vector<ManagedPage*> BrowserContext::pages() {
     return result;
 }
 
+Result<void> BrowserContext::closePage(ManagedPage* page) {
+    std::unique_ptr<ManagedPage> owned;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find_if(pages_.begin(), pages_.end(),
+                               [page](const std::unique_ptr<ManagedPage>& p) { return p.get() == page; });
+        if (it == pages_.end()) {
+            return Result<void>::failure("Page does not belong to this context");
+        }
+        owned = std::move(*it);
+        pages_.erase(it);
+    }
+    return owned->close();
+}
+
 Result<void> BrowserContext::close() {
     
     {
@@ -192,6 +397,30 @@ Result<void> Browser::connect() {
     
     defaultContext_ = std::make_unique<BrowserContext>(this, "");
 
+    trackTargets();
+
+    connected_ = true;
+    return Result<void>::success();
+}
+
+Result<void> Browser::connect(std::unique_ptr<Transport> transport) {
+    if (connected_) {
+        return Result<void>::success();
+    }
+
+    auto sessions = SessionRouter::create(std::move(transport));
+    if (!sessions || !sessions->isConnected()) {
+        return Result<void>::failure(ErrorCode::ConnectionFailed, "Transport is not connected");
+    }
+    if (!browserClient_.connect(sessions->open())) {
+        return Result<void>::failure(ErrorCode::ConnectionFailed, browserClient_.lastError());
+    }
+    sessions_ = std::move(sessions);
+
+    defaultContext_ = std::make_unique<BrowserContext>(this, "");
+
+    trackTargets();
+
     connected_ = true;
     return Result<void>::success();
 }
@@ -219,6 +448,68 @@ void Browser::disconnect() {
 
     browserClient_.disconnect();
     connected_ = false;
+    if (sessions_) {
+        sessions_->close();
+        sessions_.reset();
+    }
+
+    std::lock_guard<std::mutex> targetsLock(targetsMutex_);
+    targets_.clear();
+    pageSessions_.clear();
+}
+
+void Browser::trackTargets() {
+    browserClient_.Target.onTargetCreated([this](const TargetInfo& info) {
+        std::lock_guard<std::mutex> lock(targetsMutex_);
+        targets_[info.targetId] = info;
+    });
+    browserClient_.Target.onTargetInfoChanged([this](const TargetInfo& info) {
+        std::lock_guard<std::mutex> lock(targetsMutex_);
+        targets_[info.targetId] = info;
+    });
+    browserClient_.Target.onTargetDestroyed([this](const std::string& targetId) {
+        std::lock_guard<std::mutex> lock(targetsMutex_);
+        targets_.erase(targetId);
+        pageSessions_.erase(targetId);
+    });
+
+    
+    browserClient_.Target.setDiscoverTargets(true);
+}
+
+std::vector<TargetInfo> Browser::targets() const {
+    std::lock_guard<std::mutex> lock(targetsMutex_);
+    std::vector<TargetInfo> result;
+    result.reserve(targets_.size());
+    for (const auto& [id, info] : targets_) {
+        result.push_back(info);
+    }
+    return result;
+}
+
+std::optional<TargetInfo> Browser::findTarget(const std::string& targetId) const {
+    std::lock_guard<std::mutex> lock(targetsMutex_);
+    auto it = targets_.find(targetId);
+    if (it == targets_.end()) return std::nullopt;
+    return it->second;
+}
+
+size_t Browser::targetCount() const {
+    std::lock_guard<std::mutex> lock(targetsMutex_);
+    return targets_.size();
+}
+
+void Browser::attachProcessMonitor(ProcessMonitor& monitor) {
+    processMonitor_ = &monitor;
+    monitor.setProcessInfoProvider([this]() -> JsonValue {
+        if (!browserClient_.isConnected()) return JsonValue();
+        auto resp = browserClient_.SystemInfo.getProcessInfo();
+        return resp.hasError ? JsonValue() : resp.result;
+    });
+}
+
+std::string Browser::pageWebSocketUrl(const std::string& targetId) const {
+    return "ws://" + config_.host + ":" + std::to_string(config_.port) + "/devtools/page/" + targetId;
 }
 
 bool Browser::isConnected() const {
@@ -279,6 +570,25 @@ std::vector<BrowserContext*> Browser::contexts() {
     return result;
 }
 
+Result<void> Browser::closeContext(BrowserContext* context) {
+    if (!context || context == defaultContext_.get()) {
+        return Result<void>::failure("The default context cannot be closed");
+    }
+
+    std::unique_ptr<BrowserContext> owned;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find_if(incognitoContexts_.begin(), incognitoContexts_.end(),
+                               [context](const std::unique_ptr<BrowserContext>& c) { return c.get() == context; });
+        if (it == incognitoContexts_.end()) {
+            return Result<void>::failure("Context does not belong to this browser");
+        }
+        owned = std::move(*it);
+        incognitoContexts_.erase(it);
+    }
+    return owned->close();
+}
+
 Result<ManagedPage*> Browser::newPage(const NewPageOptions& options) {
     return defaultContext_->newPage(options);
 }
@@ -323,6 +633,32 @@ Result<std::unique_ptr<ManagedPage>> Browser::createPage(const std::string& url,
         return Result<std::unique_ptr<ManagedPage>>::failure("Browser not connected");
     }
 
+    auto created = createTarget(url, width, height, browserContextId, background);
+    if (!created) {
+        return Result<std::unique_ptr<ManagedPage>>::failure(created.error());
+    }
+    std::string targetId = created.value();
+
+    
+    auto pageClient = std::make_unique<CDPClient>(config_);
+    auto attached = attachClient(*pageClient, targetId, false);
+    if (!attached) {
+        browserClient_.Target.closeTarget(targetId);
+        return Result<std::unique_ptr<ManagedPage>>::failure(
+            attached.error().code, "Failed to connect to new target: " + attached.error().message);
+    }
+
+    auto managedPage = std::make_unique<ManagedPage>(
+        std::move(pageClient), targetId, browserContextId);
+    managedPage->browser_ = this;
+
+    return Result<std::unique_ptr<ManagedPage>>(std::move(managedPage));
+}
+
+Result<std::string> Browser::createTarget(const std::string& url,
+                                          int width, int height,
+                                          const std::string& browserContextId,
+                                          bool background) {
     
     auto createResp = browserClient_.Target.createTarget(
         url.empty() ? "about:blank" : url,
@@ -335,48 +671,77 @@ Result<std::unique_ptr<ManagedPage>> Browser::createPage(const std::string& url,
     );
 
     if (createResp.hasError) {
-        return Result<std::unique_ptr<ManagedPage>>::failure(
+        return Result<std::string>::failure(
             createResp.errorCode, createResp.errorMessage);
     }
 
     std::string targetId = createResp.result["targetId"].getString();
+    if (targetId.empty()) {
+        return Result<std::string>::failure(
+            "Target.createTarget returned no targetId");
+    }
 
-    
-    auto targets = browserClient_.listTargets();
-    std::string wsUrl;
-    for (const auto& target : targets) {
-        if (target.id == targetId) {
-            wsUrl = target.webSocketDebuggerUrl;
-            break;
+    {
+        std::lock_guard<std::mutex> lock(targetsMutex_);
+        auto& info = targets_[targetId];
+        if (info.targetId.empty()) {
+            info.targetId = targetId;
+            info.type = "page";
+            info.url = url.empty() ? "about:blank" : url;
+            info.browserContextId = browserContextId;
         }
     }
 
-    if (wsUrl.empty()) {
-        
-        browserClient_.Target.closeTarget(targetId);
-        return Result<std::unique_ptr<ManagedPage>>::failure(
-            "Failed to find WebSocket URL for new target");
-    }
+    return Result<std::string>(targetId);
+}
 
-    
-    auto pageClient = std::make_unique<CDPClient>(config_);
-    if (!pageClient->connect(wsUrl)) {
-        browserClient_.Target.closeTarget(targetId);
-        return Result<std::unique_ptr<ManagedPage>>::failure(
-            "Failed to connect to new target");
+Result<void> Browser::closeTarget(const std::string& targetId) {
+    auto resp = browserClient_.Target.closeTarget(targetId);
+    if (resp.hasError) {
+        return Result<void>::failure(resp.errorCode, resp.errorMessage);
     }
+    return Result<void>::success();
+}
 
-    auto managedPage = std::make_unique<ManagedPage>(
-        std::move(pageClient), targetId, browserContextId);
+Result<void> Browser::attachClient(CDPClient& client, const std::string& targetId, bool retarget) {
+    if (!sessions_) {
+        std::string wsUrl = pageWebSocketUrl(targetId);
+        bool attached = retarget ? client.retarget(wsUrl) : client.connect(wsUrl);
+        if (!attached) {
+            return Result<void>::failure(ErrorCode::ConnectionFailed, client.lastError());
+        }
+        return Result<void>::success();
+    }
 
-    return Result<std::unique_ptr<ManagedPage>>(std::move(managedPage));
-}
+    std::string previous;
+    {
+        std::lock_guard<std::mutex> lock(targetsMutex_);
+        auto it = pageSessions_.find(targetId);
+        if (it != pageSessions_.end()) previous = it->second;
+    }
+    if (!previous.empty()) {
+        browserClient_.Target.detachFromTarget(previous);
+    }
 
-Result<void> Browser::closeTarget(const std::string& targetId) {
-    auto resp = browserClient_.Target.closeTarget(targetId);
+    auto resp = browserClient_.Target.attachToTarget(targetId, true);
     if (resp.hasError) {
         return Result<void>::failure(resp.errorCode, resp.errorMessage);
     }
+    std::string sessionId = resp.result["sessionId"].getString();
+
+    auto transport = sessions_->open(sessionId);
+    bool opened = transport != nullptr;
+    bool attached = opened && (retarget ? client.retarget(std::move(transport))
+                                        : client.connectToTarget(std::move(transport)));
+    if (!attached) {
+        browserClient_.Target.detachFromTarget(sessionId);
+        std::string error = "Failed to attach session " + sessionId + " to target " + targetId;
+        if (opened && !client.lastError().empty()) error += ": " + client.lastError();
+        return Result<void>::failure(ErrorCode::ConnectionFailed, error);
+    }
+
+    std::lock_guard<std::mutex> lock(targetsMutex_);
+    pageSessions_[targetId] = sessionId;
     return Result<void>::success();
 }
 
@@ -0,0 +1,459 @@
+
+
+#include "cdp/highlevel/BrowserFleet.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace cdp {
+namespace highlevel {
+
+namespace {
+
+uint64_t treeMemoryBytes(uint32_t pid) {
+    if (pid == 0) return 0;
+    
+    ProcessTreeSample sample = ProcessMonitor::sampleTree(pid, true, false);
+    return sample.pssBytes > 0 ? sample.pssBytes : sample.rssBytes;
+}
+
+}
+
+BrowserFleet::BrowserFleet(const BrowserFleetOptions& options)
+    : options_(options) {
+    options_.browsers = (std::max)(options_.browsers, static_cast<size_t>(1));
+    options_.maxPagesPerBrowser = (std::max)(options_.maxPagesPerBrowser, static_cast<size_t>(1));
+    options_.maxAttempts = (std::max)(options_.maxAttempts, 1);
+}
+
+BrowserFleet::~BrowserFleet() {
+    shutdown();
+}
+
+Result<void> BrowserFleet::start() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) return Result<void>::success();
+        running_ = true;
+        stats_ = BrowserFleetStats{};
+        members_.clear();
+        for (size_t i = 0; i < options_.browsers; ++i) {
+            auto member = std::make_unique<Member>();
+            member->index = i;
+            member->stats.index = i;
+            member->state = FleetBrowserState::Starting;
+            members_.push_back(std::move(member));
+        }
+    }
+
+
+    for (auto& member : members_) {
+        auto launched = launchMember(*member);
+        if (!launched) {
+            shutdown();
+            return launched;
+        }
+    }
+
+    for (auto& member : members_) {
+        Member* raw = member.get();
+        for (size_t i = 0; i < options_.maxPagesPerBrowser; ++i) {
+            raw->workers.emplace_back([this, raw] { workerLoop(*raw); });
+        }
+    }
+    healthThread_ = std::thread([this] { healthLoop(); });
+    return Result<void>::success();
+}
+
+void BrowserFleet::shutdown() {
+    std::deque<Job> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+        abandoned.swap(queue_);
+        for (auto& member : members_) {
+            for (auto& job : member->queue) abandoned.push_back(std::move(job));
+            member->queue.clear();
+            member->wake.notify_all();
+            member->idle.notify_all();
+        }
+    }
+    healthWake_.notify_all();
+
+    if (healthThread_.joinable()) healthThread_.join();
+    for (auto& member : members_) {
+        if (member->restarter.joinable()) member->restarter.join();
+        for (auto& worker : member->workers) {
+            if (worker.joinable()) worker.join();
+        }
+        member->workers.clear();
+    }
+
+    for (auto& member : members_) {
+        member->browser.reset();
+        if (member->launcher) member->launcher->kill();
+        member->launcher.reset();
+        member->state = FleetBrowserState::Stopped;
+    }
+
+    for (auto& job : abandoned) {
+        job.promise->set_value(Result<void>::failure(ErrorCode::Cancelled, "Browser fleet shut down"));
+    }
+}
+
+bool BrowserFleet::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+std::future<Result<void>> BrowserFleet::submit(FleetTask task) {
+    Job job;
+    job.task = std::move(task);
+    job.promise = std::make_shared<std::promise<Result<void>>>();
+    auto future = job.promise->get_future();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) {
+        job.promise->set_value(Result<void>::failure(ErrorCode::Cancelled, "Browser fleet is not running"));
+        return future;
+    }
+    stats_.submitted++;
+    queue_.push_back(std::move(job));
+    dispatchLocked();
+    return future;
+}
+
+Result<void> BrowserFleet::drain(size_t index) {
+    Member* member = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_ || index >= members_.size()) {
+            return Result<void>::failure(ErrorCode::InvalidArgument,
+                                         "No running fleet browser at index " + std::to_string(index));
+        }
+        member = members_[index].get();
+        if (!beginCycleLocked(*member)) {
+            return Result<void>::failure(ErrorCode::Cancelled,
+                                         "Fleet browser " + std::to_string(index) + " is already restarting");
+        }
+    }
+    cycleMember(*member, false, false);
+    return Result<void>::success();
+}
+
+Result<void> BrowserFleet::restart(size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_ || index >= members_.size()) {
+        return Result<void>::failure(ErrorCode::InvalidArgument,
+                                     "No running fleet browser at index " + std::to_string(index));
+    }
+    Member& member = *members_[index];
+    if (member.cycling) {
+        return Result<void>::failure(ErrorCode::Cancelled,
+                                     "Fleet browser " + std::to_string(index) + " is already restarting");
+    }
+    member.parked = false;
+    scheduleRestartLocked(member, false);
+    return Result<void>::success();
+}
+
+void BrowserFleet::checkHealth() {
+    std::vector<Member*> members;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        for (auto& member : members_) {
+            if (member->cycling || member->parked) continue;
+            if (member->state == FleetBrowserState::Ready) {
+                members.push_back(member.get());
+            } else if (member->state == FleetBrowserState::Restarting) {
+                scheduleRestartLocked(*member, true);
+            }
+        }
+    }
+    for (Member* member : members) probeMember(*member);
+}
+
+BrowserFleetStats BrowserFleet::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    BrowserFleetStats result = stats_;
+    result.queued = queue_.size();
+    for (const auto& member : members_) {
+        FleetBrowserStats browser = member->stats;
+        browser.state = member->state;
+        browser.activePages = member->active;
+        browser.queued = member->queue.size();
+        browser.load = loadLocked(*member);
+        result.queued += member->queue.size();
+        result.browsers.push_back(browser);
+    }
+    return result;
+}
+
+Result<void> BrowserFleet::launchMember(Member& member) {
+    std::unique_ptr<ChromeLauncher> launcher;
+    std::unique_ptr<Browser> browser;
+    if (options_.browserFactory) {
+        auto created = options_.browserFactory(member.index);
+        if (!created) return Result<void>::failure(created.error());
+        browser = std::move(created.value());
+    } else {
+        ChromeLaunchOptions launch = options_.launch;
+        launch.debuggingPort = 0;
+
+        launcher = std::make_unique<ChromeLauncher>();
+        if (!launcher->launch(launch)) {
+            return Result<void>::failure(ErrorCode::ConnectionFailed,
+                                         "Fleet browser " + std::to_string(member.index) + ": " + launcher->lastError());
+        }
+
+        CDPClientConfig config;
+        config.host = launcher->options().host;
+        config.port = launcher->debuggingPort();
+        browser = std::make_unique<Browser>(config);
+        auto connected = launch.remoteDebuggingPipe ? browser->connect(launcher->takePipeTransport())
+                                                    : browser->connect();
+        if (!connected) {
+            launcher->kill();
+            return connected;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    member.stats.port = browser->config().port;
+    member.stats.pid = launcher ? launcher->getProcessId() : 0;
+    member.stats.failedChecks = 0;
+    member.stats.lastLatencyMs = 0;
+    member.stats.pendingCommands = 0;
+    member.stats.memoryBytes = treeMemoryBytes(member.stats.pid);
+    member.launcher = std::move(launcher);
+    member.browser = std::move(browser);
+    member.state = FleetBrowserState::Ready;
+    dispatchLocked();
+    return Result<void>::success();
+}
+
+void BrowserFleet::workerLoop(Member& member) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        member.wake.wait(lock, [this, &member] {
+            return !running_ || (member.state == FleetBrowserState::Ready && !member.queue.empty());
+        });
+        if (!running_) return;
+
+        Job job = std::move(member.queue.front());
+        member.queue.pop_front();
+        member.active++;
+        Browser* browser = member.browser.get();
+
+        lock.unlock();
+        runJob(member, browser, std::move(job));
+        lock.lock();
+
+        member.active--;
+        if (member.active == 0 && member.probes == 0) member.idle.notify_all();
+        dispatchLocked();
+    }
+}
+
+void BrowserFleet::runJob(Member& member, Browser* browser, Job job) {
+    Result<void> result;
+    auto page = browser->newPage(options_.pageOptions);
+    if (!page) {
+        result = Result<void>::failure(page.error());
+    } else {
+        try {
+            result = job.task(*page.value());
+        } catch (const std::exception& e) {
+            result = Result<void>::failure(ErrorCode::Internal, e.what());
+        }
+        browser->defaultContext().closePage(page.value());
+    }
+
+    bool browserLost = !browser->isConnected() || browser->browserClient().connection().isTargetDead();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!result && (browserLost || !page) && running_ && ++job.attempts < options_.maxAttempts) {
+        member.stats.requeued++;
+        stats_.requeued++;
+        queue_.push_front(std::move(job));
+        if (browserLost) {
+            scheduleRestartLocked(member, true);
+        } else {
+            dispatchLocked();
+        }
+        return;
+    }
+    if (browserLost && running_) scheduleRestartLocked(member, true);
+
+    if (result) {
+        member.stats.completed++;
+        stats_.completed++;
+    } else {
+        member.stats.failed++;
+        stats_.failed++;
+    }
+    job.promise->set_value(std::move(result));
+}
+
+bool BrowserFleet::beginCycleLocked(Member& member) {
+    if (member.cycling) return false;
+    member.cycling = true;
+    if (member.state != FleetBrowserState::Restarting) member.state = FleetBrowserState::Draining;
+
+
+    for (auto it = member.queue.rbegin(); it != member.queue.rend(); ++it) {
+        queue_.push_front(std::move(*it));
+    }
+    member.queue.clear();
+    dispatchLocked();
+    return true;
+}
+
+void BrowserFleet::scheduleRestartLocked(Member& member, bool kill) {
+    if (!running_ || !beginCycleLocked(member)) return;
+    if (member.restarter.joinable()) member.restarter.join();
+    Member* raw = &member;
+    member.restarter = std::thread([this, raw, kill] { cycleMember(*raw, kill, true); });
+}
+
+void BrowserFleet::cycleMember(Member& member, bool kill, bool relaunch) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto drained = [this, &member] { return !running_ || (member.active == 0 && member.probes == 0); };
+        if (!kill && !member.idle.wait_for(lock, std::chrono::milliseconds(options_.drainTimeoutMs), drained)) {
+            kill = true;
+        }
+        if (!running_) {
+            member.cycling = false;
+            return;
+        }
+        member.state = FleetBrowserState::Restarting;
+    }
+
+
+    if (kill && member.launcher) member.launcher->kill();
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        member.idle.wait(lock, [this, &member] {
+            return !running_ || (member.active == 0 && member.probes == 0);
+        });
+        if (!running_) {
+            member.cycling = false;
+            return;
+        }
+    }
+
+    if (!kill && member.browser) member.browser->close();
+    member.browser.reset();
+    member.launcher.reset();
+
+    Result<void> launched;
+    if (relaunch) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            member.stats.restarts++;
+            stats_.restarts++;
+        }
+        launched = launchMember(member);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    member.cycling = false;
+    if (!relaunch) {
+        member.parked = true;
+        member.state = FleetBrowserState::Stopped;
+    } else if (!launched) {
+        member.state = FleetBrowserState::Restarting;
+    }
+    dispatchLocked();
+}
+
+void BrowserFleet::probeMember(Member& member) {
+    Browser* browser = nullptr;
+    ChromeLauncher* launcher = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_ || member.cycling || member.state != FleetBrowserState::Ready) return;
+        member.probes++;
+        browser = member.browser.get();
+        launcher = member.launcher.get();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto resp = browser->browserClient().connection().sendCommandSync("Browser.getVersion",
+                                                                      options_.healthCheckTimeoutMs);
+    double latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    size_t pending = browser->browserClient().connection().pendingCommandCount();
+    for (ManagedPage* page : browser->pages()) {
+        pending += page->client().connection().pendingCommandCount();
+    }
+    bool alive = (!launcher || launcher->isRunning()) && browser->isConnected();
+    uint64_t memory = launcher ? treeMemoryBytes(launcher->getProcessId()) : 0;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    member.probes--;
+    if (member.active == 0 && member.probes == 0) member.idle.notify_all();
+
+    member.stats.lastLatencyMs = latencyMs;
+    member.stats.pendingCommands = pending;
+    member.stats.memoryBytes = memory;
+
+    bool healthy = !resp.hasError && latencyMs <= options_.maxHealthyLatencyMs &&
+                   (options_.maxMemoryBytes == 0 || memory <= options_.maxMemoryBytes);
+    member.stats.failedChecks = healthy ? 0 : member.stats.failedChecks + 1;
+
+    if (!alive) {
+        scheduleRestartLocked(member, true);
+    } else if (member.stats.failedChecks >= options_.maxFailedChecks) {
+        scheduleRestartLocked(member, false);
+    } else {
+        dispatchLocked();
+    }
+}
+
+void BrowserFleet::healthLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        healthWake_.wait_for(lock, std::chrono::milliseconds((std::max)(options_.healthCheckIntervalMs, 1)),
+                             [this] { return !running_; });
+        if (!running_) return;
+        lock.unlock();
+        checkHealth();
+        lock.lock();
+    }
+}
+
+void BrowserFleet::dispatchLocked() {
+    while (!queue_.empty()) {
+        Member* best = nullptr;
+        double bestLoad = (std::numeric_limits<double>::max)();
+        for (auto& member : members_) {
+            if (member->state != FleetBrowserState::Ready || member->cycling) continue;
+            if (member->active + member->queue.size() >= options_.maxPagesPerBrowser) continue;
+            double load = loadLocked(*member);
+            if (load < bestLoad) {
+                bestLoad = load;
+                best = member.get();
+            }
+        }
+        if (!best) return;
+
+        best->queue.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+        best->wake.notify_one();
+    }
+}
+
+double BrowserFleet::loadLocked(const Member& member) const {
+    double pages = static_cast<double>(member.active + member.queue.size());
+    double gigabytes = static_cast<double>(member.stats.memoryBytes) / (1024.0 * 1024.0 * 1024.0);
+    return options_.pageWeight * pages +
+           options_.pendingCommandWeight * static_cast<double>(member.stats.pendingCommands) +
+           options_.memoryWeightPerGB * gigabytes;
+}
+
+}
+}
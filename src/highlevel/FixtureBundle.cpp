@@ -0,0 +1,238 @@
+
+
+#include "cdp/highlevel/FixtureBundle.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+
+namespace cdp {
+namespace highlevel {
+
+namespace {
+
+constexpr size_t kTarBlock = 512;
+
+uint64_t parseOctal(const uint8_t* field, size_t len) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t c = field[i];
+        if (c == 0 || c == ' ') {
+            if (value > 0) break;
+            continue;
+        }
+        if (c < '0' || c > '7') break;
+        value = (value << 3) | static_cast<uint64_t>(c - '0');
+    }
+    return value;
+}
+
+std::string fieldString(const uint8_t* field, size_t len) {
+    const void* end = std::memchr(field, 0, len);
+    size_t n = end ? static_cast<size_t>(static_cast<const uint8_t*>(end) - field) : len;
+    return std::string(reinterpret_cast<const char*>(field), n);
+}
+
+std::string paxPath(const uint8_t* data, size_t len) {
+    size_t pos = 0;
+    while (pos < len) {
+        size_t space = pos;
+        while (space < len && data[space] != ' ') ++space;
+        if (space >= len) break;
+        size_t recordLen = std::strtoul(std::string(reinterpret_cast<const char*>(data + pos), space - pos).c_str(),
+                                        nullptr, 10);
+        if (recordLen == 0 || pos + recordLen > len) break;
+        std::string record(reinterpret_cast<const char*>(data + space + 1), recordLen - (space + 1 - pos) - 1);
+        if (record.rfind("path=", 0) == 0) return record.substr(5);
+        pos += recordLen;
+    }
+    return {};
+}
+
+std::string normalizeKey(std::string name) {
+    std::replace(name.begin(), name.end(), '\\', '/');
+    while (name.rfind("./", 0) == 0) name.erase(0, 2);
+    while (!name.empty() && name.front() == '/') name.erase(0, 1);
+    return name;
+}
+
+}
+
+Result<std::shared_ptr<FixtureBundle>> FixtureBundle::open(const std::string& path) {
+    std::shared_ptr<FixtureBundle> bundle(new FixtureBundle());
+    std::string error;
+
+    std::error_code ec;
+    if (std::filesystem::is_directory(path, ec)) {
+        if (!bundle->indexDirectory(path, error)) {
+            return Result<std::shared_ptr<FixtureBundle>>::failure(ErrorCode::InvalidArgument, error);
+        }
+        return bundle;
+    }
+
+    if (!bundle->archive_.open(path)) {
+        return Result<std::shared_ptr<FixtureBundle>>::failure(ErrorCode::InvalidArgument,
+                                                               bundle->archive_.error());
+    }
+    if (!bundle->indexArchive(error)) {
+        return Result<std::shared_ptr<FixtureBundle>>::failure(ErrorCode::InvalidArgument, error);
+    }
+    return bundle;
+}
+
+bool FixtureBundle::indexDirectory(const std::string& root, std::string& error) {
+    std::error_code ec;
+    std::filesystem::path base(root);
+    for (auto it = std::filesystem::recursive_directory_iterator(base, ec);
+         !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        std::string key = normalizeKey(std::filesystem::relative(it->path(), base, ec).generic_string());
+        if (key.empty()) continue;
+        Entry& entry = entries_[key];
+        entry.filePath = it->path().string();
+    }
+    if (ec) {
+        error = "Failed to scan fixture directory: " + ec.message();
+        return false;
+    }
+    return true;
+}
+
+bool FixtureBundle::indexArchive(std::string& error) {
+    const uint8_t* data = archive_.data();
+    const size_t size = archive_.size();
+    std::string longName;
+
+    size_t pos = 0;
+    while (pos + kTarBlock <= size) {
+        const uint8_t* header = data + pos;
+        if (header[0] == 0) break;
+
+        uint64_t entrySize = parseOctal(header + 124, 12);
+        char type = static_cast<char>(header[156]);
+        size_t bodyPos = pos + kTarBlock;
+        if (entrySize > size - bodyPos) {
+            error = "Truncated fixture archive";
+            return false;
+        }
+
+        if (type == 'L') {
+            longName = fieldString(data + bodyPos, static_cast<size_t>(entrySize));
+        } else if (type == 'x') {
+            longName = paxPath(data + bodyPos, static_cast<size_t>(entrySize));
+        } else {
+            std::string name = longName;
+            if (name.empty()) {
+                name = fieldString(header, 100);
+                if (std::memcmp(header + 257, "ustar", 5) == 0) {
+                    std::string prefix = fieldString(header + 345, 155);
+                    if (!prefix.empty()) name = prefix + "/" + name;
+                }
+            }
+            longName.clear();
+
+            if (type == '0' || type == '\0') {
+                std::string key = normalizeKey(name);
+                if (!key.empty()) {
+                    Entry& entry = entries_[key];
+                    entry.data = data + bodyPos;
+                    entry.size = static_cast<size_t>(entrySize);
+                }
+            }
+        }
+
+        pos = bodyPos + ((static_cast<size_t>(entrySize) + kTarBlock - 1) / kTarBlock) * kTarBlock;
+    }
+
+    if (entries_.empty()) {
+        error = "Fixture archive contains no files";
+        return false;
+    }
+    return true;
+}
+
+std::string FixtureBundle::keyForUrl(const std::string& url) {
+    size_t start = url.find("://");
+    start = (start == std::string::npos) ? 0 : start + 3;
+    size_t end = url.find_first_of("?#", start);
+    if (end == std::string::npos) end = url.size();
+
+    std::string key = url.substr(start, end - start);
+    size_t slash = key.find('/');
+    size_t hostEnd = slash == std::string::npos ? key.size() : slash;
+    std::transform(key.begin(), key.begin() + static_cast<std::ptrdiff_t>(hostEnd), key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (slash == std::string::npos) key += '/';
+    if (key.back() == '/') key += "index.html";
+    return key;
+}
+
+std::string FixtureBundle::contentTypeFor(const std::string& key) {
+    static const std::unordered_map<std::string, std::string> types = {
+        {"html", "text/html"}, {"htm", "text/html"}, {"js", "application/javascript"},
+        {"mjs", "application/javascript"}, {"css", "text/css"}, {"json", "application/json"},
+        {"map", "application/json"}, {"txt", "text/plain"}, {"xml", "application/xml"},
+        {"svg", "image/svg+xml"}, {"png", "image/png"}, {"jpg", "image/jpeg"},
+        {"jpeg", "image/jpeg"}, {"gif", "image/gif"}, {"webp", "image/webp"},
+        {"ico", "image/x-icon"}, {"woff", "font/woff"}, {"woff2", "font/woff2"},
+        {"ttf", "font/ttf"}, {"otf", "font/otf"}, {"wasm", "application/wasm"},
+        {"mp4", "video/mp4"}, {"webm", "video/webm"}, {"mp3", "audio/mpeg"},
+    };
+
+    size_t slash = key.rfind('/');
+    size_t dot = key.rfind('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return "application/octet-stream";
+    }
+    std::string ext = key.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    auto it = types.find(ext);
+    return it != types.end() ? it->second : "application/octet-stream";
+}
+
+std::shared_ptr<const MockResponse> FixtureBundle::load(const std::string& key, const Entry& entry) const {
+    std::map<std::string, std::string> headers;
+    headers["Content-Type"] = contentTypeFor(key);
+
+    if (entry.filePath.empty()) {
+        return std::make_shared<const MockResponse>(
+            MockResponse::preEncoded(entry.data, entry.size, headers));
+    }
+
+    MappedFile file;
+    if (!file.open(entry.filePath)) return nullptr;
+    return std::make_shared<const MockResponse>(
+        MockResponse::preEncoded(file.data(), file.size(), headers));
+}
+
+std::shared_ptr<const MockResponse> FixtureBundle::find(const std::string& url) const {
+    std::string key = keyForUrl(url);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return nullptr;
+
+    auto& slot = it->second.response;
+    auto cached = slot.load(std::memory_order_acquire);
+    if (cached) return cached;
+
+    auto loaded = load(key, it->second);
+    if (!loaded) return nullptr;
+    if (slot.compare_exchange_strong(cached, loaded, std::memory_order_acq_rel)) return loaded;
+    return cached;
+}
+
+bool FixtureBundle::contains(const std::string& url) const {
+    return entries_.count(keyForUrl(url)) > 0;
+}
+
+std::vector<std::string> FixtureBundle::keys() const {
+    std::vector<std::string> out;
+    out.reserve(entries_.size());
+    for (const auto& [key, entry] : entries_) out.push_back(key);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+}
+}
@@ -0,0 +1,199 @@
+
+
+#include "cdp/highlevel/HarReplayer.hpp"
+#include "cdp/core/Base64.hpp"
+#include "cdp/core/SHA1.hpp"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+namespace cdp {
+namespace highlevel {
+
+namespace {
+
+std::string lowerCase(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+bool skippedHeader(const std::string& name) {
+    std::string lower = lowerCase(name);
+    return lower == "content-encoding" || lower == "content-length" || lower == "transfer-encoding" ||
+           lower.empty() || lower[0] == ':';
+}
+
+}
+
+Result<std::shared_ptr<HarReplayer>> HarReplayer::open(const std::string& path, const HarReplayOptions& options) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return Result<std::shared_ptr<HarReplayer>>::failure(ErrorCode::InvalidArgument,
+                                                             "Failed to open HAR file: " + path);
+    }
+    std::ostringstream content;
+    content << in.rdbuf();
+
+    JsonValue har;
+    try {
+        har = JsonValue::parse(content.str());
+    } catch (const std::exception& e) {
+        return Result<std::shared_ptr<HarReplayer>>::failure(ErrorCode::InvalidArgument,
+                                                             path + ": " + e.what());
+    }
+    return load(har, options);
+}
+
+Result<std::shared_ptr<HarReplayer>> HarReplayer::load(const JsonValue& har, const HarReplayOptions& options) {
+    const JsonValue* entries = har.getPath("log/entries");
+    if (!entries || !entries->isArray()) {
+        return Result<std::shared_ptr<HarReplayer>>::failure(ErrorCode::InvalidArgument,
+                                                             "HAR document has no log.entries array");
+    }
+
+    std::shared_ptr<HarReplayer> replayer(new HarReplayer(options));
+    for (const auto& entry : entries->asArray()) {
+        if (replayer->addEntry(entry)) {
+            replayer->stats_.entries++;
+        } else {
+            replayer->stats_.skipped++;
+        }
+    }
+    return replayer;
+}
+
+bool HarReplayer::addEntry(const JsonValue& entry) {
+    std::string method = entry.getStringAt("request/method");
+    std::string url = entry.getStringAt("request/url");
+    int status = entry.getIntAt("response/status");
+    if (method.empty() || url.empty() || status <= 0) return false;
+
+    std::vector<HeaderEntry> headers;
+    const JsonValue* headerList = entry.getPath("response/headers");
+    if (headerList && headerList->isArray()) {
+        for (const auto& header : headerList->asArray()) {
+            std::string name = header.getStringAt("name");
+            if (skippedHeader(name)) continue;
+            headers.push_back({name, header.getStringAt("value")});
+        }
+    }
+
+    std::string text = entry.getStringAt("response/content/text");
+    if (text.empty() && entry.getInt64At("response/content/size") > 0) return false;
+
+    std::vector<uint8_t> body;
+    if (entry.getStringAt("response/content/encoding") == "base64") {
+        body = Base64::decode(text);
+    } else {
+        body.assign(text.begin(), text.end());
+    }
+
+    std::string postData = entry.getStringAt("request/postData/text");
+    auto response = std::make_shared<const MockResponse>(
+        MockResponse::preEncoded(body.data(), body.size(), headers, status));
+    index_[requestKey(method, url, postData)].responses.push_back(std::move(response));
+    return true;
+}
+
+std::shared_ptr<const MockResponse> HarReplayer::find(const std::string& method, const std::string& url,
+                                                      const std::string& postData) {
+    std::string key = requestKey(method, url, postData);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        stats_.misses++;
+        return nullptr;
+    }
+
+    Slot& slot = it->second;
+    size_t pick = (std::min)(slot.next, slot.responses.size() - 1);
+    if (slot.next < slot.responses.size()) slot.next++;
+    stats_.hits++;
+    return slot.responses[pick];
+}
+
+void HarReplayer::rewind() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [key, slot] : index_) slot.next = 0;
+    stats_.hits = 0;
+    stats_.misses = 0;
+}
+
+HarReplayStats HarReplayer::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::string HarReplayer::requestKey(const std::string& method, const std::string& url,
+                                    const std::string& postData) const {
+    std::string key;
+    key.reserve(method.size() + url.size() + 42);
+    for (char c : method) key.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+    key += ' ';
+    key += normalizeUrl(url, options_.sortQuery, options_.ignoredQueryParams);
+    if (options_.matchPostData && !postData.empty()) {
+        key += ' ';
+        key += SHA1::hashHex(postData);
+    }
+    return key;
+}
+
+std::string HarReplayer::normalizeUrl(const std::string& url, bool sortQuery,
+                                      const std::vector<std::string>& ignoredQueryParams) {
+    std::string base = url.substr(0, url.find('#'));
+    std::string query;
+    size_t question = base.find('?');
+    if (question != std::string::npos) {
+        query = base.substr(question + 1);
+        base.resize(question);
+    }
+
+    size_t scheme = base.find("://");
+    if (scheme != std::string::npos) {
+        size_t hostStart = scheme + 3;
+        size_t pathStart = base.find('/', hostStart);
+        if (pathStart == std::string::npos) {
+            pathStart = base.size();
+            base += '/';
+        }
+        std::string authority = lowerCase(base.substr(0, pathStart));
+        std::string schemeName = authority.substr(0, scheme);
+        if ((schemeName == "http" && authority.size() > 3 && authority.compare(authority.size() - 3, 3, ":80") == 0) ||
+            (schemeName == "https" && authority.size() > 4 && authority.compare(authority.size() - 4, 4, ":443") == 0)) {
+            authority.resize(authority.rfind(':'));
+        }
+        base = authority + base.substr(pathStart);
+    }
+
+    if (query.empty()) return base;
+
+    std::vector<std::string> params;
+    size_t pos = 0;
+    while (pos <= query.size()) {
+        size_t amp = query.find('&', pos);
+        if (amp == std::string::npos) amp = query.size();
+        std::string param = query.substr(pos, amp - pos);
+        pos = amp + 1;
+        if (param.empty()) continue;
+        std::string name = param.substr(0, param.find('='));
+        if (std::find(ignoredQueryParams.begin(), ignoredQueryParams.end(), name) != ignoredQueryParams.end()) {
+            continue;
+        }
+        params.push_back(std::move(param));
+    }
+    if (sortQuery) std::stable_sort(params.begin(), params.end());
+    if (params.empty()) return base;
+
+    base += '?';
+    for (size_t i = 0; i < params.size(); ++i) {
+        if (i > 0) base += '&';
+        base += params[i];
+    }
+    return base;
+}
+
+}
+}
@@ -0,0 +1,278 @@
+
+
+#include "cdp/highlevel/ImageDiff.hpp"
+#include "cdp/core/Png.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CDP_DIFF_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define CDP_DIFF_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace cdp {
+namespace highlevel {
+
+namespace {
+
+constexpr double kMaxYiqDelta = 35215.0;
+
+double blend(uint8_t c, double alpha) {
+    return 255.0 + (c - 255.0) * alpha;
+}
+
+double yiqDelta(const uint8_t* a, const uint8_t* b, bool ignoreAlpha) {
+    double aa = ignoreAlpha ? 1.0 : a[3] / 255.0;
+    double ab = ignoreAlpha ? 1.0 : b[3] / 255.0;
+
+    double r1 = blend(a[0], aa), g1 = blend(a[1], aa), b1 = blend(a[2], aa);
+    double r2 = blend(b[0], ab), g2 = blend(b[1], ab), b2 = blend(b[2], ab);
+
+    double y = (r1 - r2) * 0.29889531 + (g1 - g2) * 0.58662247 + (b1 - b2) * 0.11448223;
+    double i = (r1 - r2) * 0.59597799 - (g1 - g2) * 0.27417610 - (b1 - b2) * 0.32180189;
+    double q = (r1 - r2) * 0.21147017 - (g1 - g2) * 0.52261711 + (b1 - b2) * 0.31114694;
+    return 0.5053 * y * y + 0.299 * i * i + 0.1957 * q * q;
+}
+
+
+struct OpenRegion {
+    DiffRegion box;
+    int lastY = 0;
+};
+
+class RegionTracker {
+public:
+    explicit RegionTracker(int gap) : gap_((std::max)(gap, 0)) {}
+
+    void addRun(int x0, int x1, int y, int64_t pixels) {
+        OpenRegion* target = nullptr;
+        for (auto it = open_.begin(); it != open_.end();) {
+            const auto& box = it->box;
+            bool near = y - it->lastY <= gap_ + 1 &&
+                        x0 <= box.x + box.width - 1 + gap_ + 1 &&
+                        x1 >= box.x - gap_ - 1;
+            if (!near) {
+                ++it;
+                continue;
+            }
+            if (!target) {
+                target = &*it;
+                ++it;
+                continue;
+            }
+            merge(*target, *it);
+            it = open_.erase(it);
+        }
+
+        if (!target) {
+            OpenRegion region;
+            region.box = DiffRegion{x0, y, x1 - x0 + 1, 1, 0};
+            region.lastY = y;
+            open_.push_back(region);
+            target = &open_.back();
+        }
+        extend(*target, x0, x1, y, pixels);
+    }
+
+    void endRow(int y) {
+        for (auto it = open_.begin(); it != open_.end();) {
+            if (y - it->lastY > gap_) {
+                closed_.push_back(it->box);
+                it = open_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    std::vector<DiffRegion> finish() {
+        for (const auto& region : open_) closed_.push_back(region.box);
+        open_.clear();
+        std::sort(closed_.begin(), closed_.end(), [](const DiffRegion& a, const DiffRegion& b) {
+            return a.y != b.y ? a.y < b.y : a.x < b.x;
+        });
+        return std::move(closed_);
+    }
+
+private:
+    static void extend(OpenRegion& region, int x0, int x1, int y, int64_t pixels) {
+        auto& box = region.box;
+        int right = (std::max)(box.x + box.width - 1, x1);
+        int bottom = (std::max)(box.y + box.height - 1, y);
+        box.x = (std::min)(box.x, x0);
+        box.y = (std::min)(box.y, y);
+        box.width = right - box.x + 1;
+        box.height = bottom - box.y + 1;
+        box.pixels += pixels;
+        region.lastY = (std::max)(region.lastY, y);
+    }
+
+    static void merge(OpenRegion& into, const OpenRegion& from) {
+        const auto& box = from.box;
+        extend(into, box.x, box.x + box.width - 1, box.y, box.pixels);
+        extend(into, box.x, box.x + box.width - 1, box.y + box.height - 1, 0);
+        into.lastY = (std::max)(into.lastY, from.lastY);
+    }
+
+    int gap_;
+    std::vector<OpenRegion> open_;
+    std::vector<DiffRegion> closed_;
+};
+
+}
+
+int ImageDiff::changedPixels(const uint8_t* rowA, const uint8_t* rowB, int width, uint8_t* changed) {
+    int count = 0;
+    int x = 0;
+
+#if defined(CDP_DIFF_SSE2)
+    for (; x + 4 <= width; x += 4) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowA + x * 4));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowB + x * 4));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)));
+        if (mask == 0xF) {
+            std::memset(changed + x, 0, 4);
+            continue;
+        }
+        for (int k = 0; k < 4; ++k) {
+            uint8_t c = (mask & (1 << k)) ? 0 : 1;
+            changed[x + k] = c;
+            count += c;
+        }
+    }
+#elif defined(CDP_DIFF_NEON)
+    for (; x + 4 <= width; x += 4) {
+        uint32x4_t a = vld1q_u32(reinterpret_cast<const uint32_t*>(rowA + x * 4));
+        uint32x4_t b = vld1q_u32(reinterpret_cast<const uint32_t*>(rowB + x * 4));
+        uint32x4_t eq = vceqq_u32(a, b);
+        if (vminvq_u32(eq) == 0xFFFFFFFFu) {
+            std::memset(changed + x, 0, 4);
+            continue;
+        }
+        uint32_t lanes[4];
+        vst1q_u32(lanes, eq);
+        for (int k = 0; k < 4; ++k) {
+            uint8_t c = lanes[k] ? 0 : 1;
+            changed[x + k] = c;
+            count += c;
+        }
+    }
+#endif
+
+    for (; x < width; ++x) {
+        uint8_t c = std::memcmp(rowA + x * 4, rowB + x * 4, 4) != 0 ? 1 : 0;
+        changed[x] = c;
+        count += c;
+    }
+    return count;
+}
+
+Result<ImageDiffResult> ImageDiff::compare(const uint8_t* pngA, size_t lenA,
+                                           const uint8_t* pngB, size_t lenB,
+                                           const ImageDiffOptions& options) {
+    PngDecoder decoderA;
+    PngDecoder decoderB;
+    if (!decoderA.open(pngA, lenA)) {
+        return Result<ImageDiffResult>::failure(ErrorCode::InvalidArgument, "First image: " + decoderA.error());
+    }
+    if (!decoderB.open(pngB, lenB)) {
+        return Result<ImageDiffResult>::failure(ErrorCode::InvalidArgument, "Second image: " + decoderB.error());
+    }
+
+    ImageDiffResult result;
+    if (decoderA.width() != decoderB.width() || decoderA.height() != decoderB.height()) {
+        result.width = (std::max)(decoderA.width(), decoderB.width());
+        result.height = (std::max)(decoderA.height(), decoderB.height());
+        result.totalPixels = static_cast<int64_t>(result.width) * result.height;
+        result.diffPixels = result.totalPixels;
+        result.diffRatio = 1.0;
+        result.maxDelta = 1.0;
+        result.sizeMismatch = true;
+        return result;
+    }
+
+    const int width = decoderA.width();
+    const int height = decoderA.height();
+    result.width = width;
+    result.height = height;
+    result.totalPixels = static_cast<int64_t>(width) * height;
+
+    const double threshold = (std::clamp)(options.threshold, 0.0, 1.0);
+    const double maxDelta = kMaxYiqDelta * threshold * threshold;
+    const bool wantMask = options.collectMask || options.maskRowCallback;
+    if (options.collectMask) {
+        result.mask.assign(static_cast<size_t>(result.totalPixels), 0);
+    }
+
+    std::vector<uint8_t> rowA(static_cast<size_t>(width) * 4);
+    std::vector<uint8_t> rowB(static_cast<size_t>(width) * 4);
+    std::vector<uint8_t> changed(static_cast<size_t>(width));
+    std::vector<uint8_t> maskRow(wantMask ? static_cast<size_t>(width) : 0);
+    RegionTracker regions(options.regionGap);
+    double worstDelta = 0;
+
+    for (int y = 0; y < height; ++y) {
+        if (!decoderA.readRow(rowA.data())) {
+            return Result<ImageDiffResult>::failure(ErrorCode::InvalidArgument, "First image: " + decoderA.error());
+        }
+        if (!decoderB.readRow(rowB.data())) {
+            return Result<ImageDiffResult>::failure(ErrorCode::InvalidArgument, "Second image: " + decoderB.error());
+        }
+
+        if (wantMask) std::fill(maskRow.begin(), maskRow.end(), 0);
+
+        int candidates = changedPixels(rowA.data(), rowB.data(), width, changed.data());
+        if (candidates > 0) {
+            int runStart = -1;
+            int runEnd = -1;
+            int64_t runPixels = 0;
+
+            for (int x = 0; x < width; ++x) {
+                size_t ux = static_cast<size_t>(x);
+                if (!changed[ux]) continue;
+                const uint8_t* pa = rowA.data() + ux * 4;
+                const uint8_t* pb = rowB.data() + ux * 4;
+                if (options.ignoreAlpha && std::memcmp(pa, pb, 3) == 0) continue;
+
+                double delta = yiqDelta(pa, pb, options.ignoreAlpha);
+                worstDelta = (std::max)(worstDelta, delta);
+                if (delta <= maxDelta && threshold > 0) continue;
+
+                result.diffPixels++;
+                if (wantMask) maskRow[ux] = 255;
+
+                if (runStart >= 0 && x - runEnd <= options.regionGap + 1) {
+                    runEnd = x;
+                    runPixels++;
+                } else {
+                    if (runStart >= 0) regions.addRun(runStart, runEnd, y, runPixels);
+                    runStart = runEnd = x;
+                    runPixels = 1;
+                }
+            }
+            if (runStart >= 0) regions.addRun(runStart, runEnd, y, runPixels);
+        }
+        regions.endRow(y);
+
+        if (options.collectMask) {
+            std::memcpy(result.mask.data() + static_cast<size_t>(y) * static_cast<size_t>(width), maskRow.data(), maskRow.size());
+        }
+        if (options.maskRowCallback) {
+            options.maskRowCallback(y, maskRow.data());
+        }
+    }
+
+    result.regions = regions.finish();
+    result.diffRatio = result.totalPixels > 0
+        ? static_cast<double>(result.diffPixels) / static_cast<double>(result.totalPixels)
+        : 0.0;
+    result.maxDelta = std::sqrt(worstDelta / kMaxYiqDelta);
+    return result;
+}
+
+}
+}
@@ -0,0 +1,411 @@
+
+
+#include "cdp/highlevel/NetworkCapture.hpp"
+#include <algorithm>
+#include <fstream>
+
+namespace cdp {
+namespace highlevel {
+
+namespace {
+
+float phaseMs(const JsonValue& timing, const char* start, const char* end) {
+    double s = timing.getDoubleAt(start, -1);
+    double e = timing.getDoubleAt(end, -1);
+    if (s < 0 || e < 0) return -1.0f;
+    return static_cast<float>(e - s);
+}
+
+template <typename T>
+size_t columnBytes(const std::vector<T>& column) {
+    return column.capacity() * sizeof(T);
+}
+
+}
+
+uint32_t NetworkCapture::StringPool::intern(std::string_view value) {
+    auto it = ids_.find(value);
+    if (it != ids_.end()) return it->second;
+    uint32_t id = static_cast<uint32_t>(strings_.size());
+    strings_.emplace_back(value);
+    ids_.emplace(strings_.back(), id);
+    bytes_ += value.size();
+    return id;
+}
+
+void NetworkCapture::StringPool::clear() {
+    ids_.clear();
+    strings_.clear();
+    bytes_ = 0;
+}
+
+NetworkCapture::NetworkCapture(CDPConnection& conn, const NetworkCaptureOptions& options)
+    : connection_(conn), options_(options) {
+    pool_.intern("");
+}
+
+NetworkCapture::~NetworkCapture() {
+    stop();
+}
+
+Result<void> NetworkCapture::start() {
+    if (recording_) return {};
+
+    auto r = connection_.sendCommandSync("Network.enable");
+    if (r.hasError) return Error::fromCDPResponse(r);
+
+    for (const char* method : {"Network.requestWillBeSent", "Network.responseReceived",
+                               "Network.loadingFinished", "Network.loadingFailed"}) {
+        std::string name = method;
+        tokens_.push_back(connection_.onEventScoped(name, [this, name](const CDPEvent& evt) {
+            recordEvent(name, evt.params);
+        }));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    recording_ = true;
+    return {};
+}
+
+void NetworkCapture::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        recording_ = false;
+    }
+    tokens_.clear();
+}
+
+bool NetworkCapture::isRecording() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return recording_;
+}
+
+void NetworkCapture::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pool_.clear();
+    pool_.intern("");
+    text_.clear();
+    inflight_.clear();
+    urlOffset_.clear();
+    urlLength_.clear();
+    host_.clear();
+    method_.clear();
+    type_.clear();
+    mime_.clear();
+    statusText_.clear();
+    error_.clear();
+    status_.clear();
+    state_.clear();
+    wallTime_.clear();
+    startTs_.clear();
+    endTs_.clear();
+    bytes_.clear();
+    dns_.clear();
+    connect_.clear();
+    ssl_.clear();
+    send_.clear();
+    wait_.clear();
+    requestHeaderStart_.clear();
+    requestHeaderCount_.clear();
+    responseHeaderStart_.clear();
+    responseHeaderCount_.clear();
+    headerName_.clear();
+    headerValueOffset_.clear();
+    headerValueLength_.clear();
+}
+
+void NetworkCapture::recordEvent(const std::string& method, const JsonValue& params) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (method == "Network.requestWillBeSent") {
+        onRequest(params);
+    } else if (method == "Network.responseReceived") {
+        auto it = inflight_.find(params.getStringAt("requestId"));
+        if (it == inflight_.end()) return;
+        uint32_t row = it->second;
+        if (const JsonValue* type = params.find("type")) type_[row] = pool_.intern(type->getString());
+        if (const JsonValue* response = params.find("response")) onResponse(row, *response);
+    } else if (method == "Network.loadingFinished") {
+        onFinished(params);
+    } else if (method == "Network.loadingFailed") {
+        onFailed(params);
+    }
+}
+
+void NetworkCapture::onRequest(const JsonValue& params) {
+    std::string requestId = params.getStringAt("requestId");
+    double timestamp = params.getDoubleAt("timestamp", 0);
+
+    auto previous = inflight_.find(requestId);
+    if (previous != inflight_.end()) {
+        uint32_t row = previous->second;
+        if (const JsonValue* redirect = params.find("redirectResponse")) onResponse(row, *redirect);
+        endTs_[row] = timestamp;
+        state_[row] = Finished;
+        inflight_.erase(previous);
+    }
+
+    std::string url = params.getStringAt("request/url");
+    uint32_t row = static_cast<uint32_t>(state_.size());
+    uint64_t offset = 0;
+    urlLength_.push_back(appendText(url, offset));
+    urlOffset_.push_back(offset);
+    host_.push_back(pool_.intern(hostOf(url)));
+    method_.push_back(pool_.intern(params.getStringAt("request/method")));
+    type_.push_back(pool_.intern(params.getStringAt("type")));
+    mime_.push_back(0);
+    statusText_.push_back(0);
+    error_.push_back(0);
+    status_.push_back(0);
+    state_.push_back(Pending);
+    wallTime_.push_back(params.getDoubleAt("wallTime", 0));
+    startTs_.push_back(timestamp);
+    endTs_.push_back(0);
+    bytes_.push_back(0);
+    dns_.push_back(-1.0f);
+    connect_.push_back(-1.0f);
+    ssl_.push_back(-1.0f);
+    send_.push_back(-1.0f);
+    wait_.push_back(-1.0f);
+
+    uint32_t start = 0;
+    uint32_t count = 0;
+    appendHeaders(params.getPath("request/headers"), start, count);
+    requestHeaderStart_.push_back(start);
+    requestHeaderCount_.push_back(count);
+    responseHeaderStart_.push_back(0);
+    responseHeaderCount_.push_back(0);
+
+    inflight_[requestId] = row;
+}
+
+void NetworkCapture::onResponse(uint32_t row, const JsonValue& response) {
+    status_[row] = response.getIntAt("status");
+    statusText_[row] = pool_.intern(response.getStringAt("statusText"));
+    mime_[row] = pool_.intern(response.getStringAt("mimeType"));
+    appendHeaders(response.find("headers"), responseHeaderStart_[row], responseHeaderCount_[row]);
+
+    const JsonValue* timing = response.find("timing");
+    if (timing && timing->isObject()) {
+        dns_[row] = phaseMs(*timing, "dnsStart", "dnsEnd");
+        connect_[row] = phaseMs(*timing, "connectStart", "connectEnd");
+        ssl_[row] = phaseMs(*timing, "sslStart", "sslEnd");
+        send_[row] = phaseMs(*timing, "sendStart", "sendEnd");
+        wait_[row] = phaseMs(*timing, "sendEnd", "receiveHeadersEnd");
+    }
+}
+
+void NetworkCapture::onFinished(const JsonValue& params) {
+    auto it = inflight_.find(params.getStringAt("requestId"));
+    if (it == inflight_.end()) return;
+    uint32_t row = it->second;
+    bytes_[row] = params.getInt64At("encodedDataLength");
+    endTs_[row] = params.getDoubleAt("timestamp", 0);
+    state_[row] = Finished;
+    inflight_.erase(it);
+}
+
+void NetworkCapture::onFailed(const JsonValue& params) {
+    auto it = inflight_.find(params.getStringAt("requestId"));
+    if (it == inflight_.end()) return;
+    uint32_t row = it->second;
+    if (const JsonValue* type = params.find("type")) type_[row] = pool_.intern(type->getString());
+    error_[row] = pool_.intern(params.getStringAt("errorText"));
+    endTs_[row] = params.getDoubleAt("timestamp", 0);
+    state_[row] = Failed;
+    inflight_.erase(it);
+}
+
+uint32_t NetworkCapture::appendText(std::string_view value, uint64_t& offset) {
+    offset = text_.size();
+    text_.append(value);
+    return static_cast<uint32_t>(value.size());
+}
+
+std::string_view NetworkCapture::text(uint64_t offset, uint32_t length) const {
+    return std::string_view(text_).substr(offset, length);
+}
+
+void NetworkCapture::appendHeaders(const JsonValue* headers, uint32_t& start, uint32_t& count) {
+    start = static_cast<uint32_t>(headerName_.size());
+    count = 0;
+    if (!options_.captureHeaders || !headers || !headers->isObject()) return;
+    for (const auto& [name, value] : headers->asObject()) {
+        uint64_t offset = 0;
+        headerName_.push_back(pool_.intern(name));
+        headerValueLength_.push_back(appendText(value.getString(), offset));
+        headerValueOffset_.push_back(offset);
+        count++;
+    }
+}
+
+std::string_view NetworkCapture::hostOf(std::string_view url) const {
+    size_t scheme = url.find("://");
+    if (scheme == std::string_view::npos) return {};
+    size_t begin = scheme + 3;
+    size_t end = url.find_first_of("/?#", begin);
+    if (end == std::string_view::npos) end = url.size();
+    return url.substr(begin, end - begin);
+}
+
+double NetworkCapture::durationMs(size_t row) const {
+    if (startTs_[row] <= 0 || endTs_[row] <= 0) return 0;
+    return (endTs_[row] - startTs_[row]) * 1000;
+}
+
+bool NetworkCapture::exported(size_t row) const {
+    return options_.includePending || state_[row] != Pending;
+}
+
+HAREntry NetworkCapture::materialize(size_t row) const {
+    HAREntry e;
+    e.url = std::string(text(urlOffset_[row], urlLength_[row]));
+    e.method = std::string(pool_.get(method_[row]));
+    e.status = status_[row];
+    e.statusText = std::string(pool_.get(statusText_[row]));
+    e.mimeType = std::string(pool_.get(mime_[row]));
+    e.responseSize = bytes_[row];
+    e.startTime = wallTime_[row];
+    e.duration = durationMs(row);
+    e.resourceType = std::string(pool_.get(type_[row]));
+    e.errorText = std::string(pool_.get(error_[row]));
+    e.dns = dns_[row];
+    e.connect = connect_[row];
+    e.ssl = ssl_[row];
+    e.send = send_[row];
+    e.wait = wait_[row];
+
+    for (uint32_t h = requestHeaderStart_[row]; h < requestHeaderStart_[row] + requestHeaderCount_[row]; ++h) {
+        e.requestHeaders[std::string(pool_.get(headerName_[h]))] =
+            std::string(text(headerValueOffset_[h], headerValueLength_[h]));
+    }
+    for (uint32_t h = responseHeaderStart_[row]; h < responseHeaderStart_[row] + responseHeaderCount_[row]; ++h) {
+        e.responseHeaders[std::string(pool_.get(headerName_[h]))] =
+            std::string(text(headerValueOffset_[h], headerValueLength_[h]));
+    }
+    return e;
+}
+
+size_t NetworkCapture::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_.size();
+}
+
+size_t NetworkCapture::pendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inflight_.size();
+}
+
+size_t NetworkCapture::failedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(std::count(state_.begin(), state_.end(), static_cast<uint8_t>(Failed)));
+}
+
+int64_t NetworkCapture::totalBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t total = 0;
+    for (int64_t b : bytes_) total += b;
+    return total;
+}
+
+std::map<std::string, int64_t> NetworkCapture::bytesByType() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<int64_t> totals(pool_.size(), 0);
+    std::vector<bool> seen(pool_.size(), false);
+    for (size_t row = 0; row < type_.size(); ++row) {
+        totals[type_[row]] += bytes_[row];
+        seen[type_[row]] = true;
+    }
+    std::map<std::string, int64_t> result;
+    for (uint32_t id = 0; id < totals.size(); ++id) {
+        if (seen[id]) result[std::string(pool_.get(id))] = totals[id];
+    }
+    return result;
+}
+
+std::map<std::string, int64_t> NetworkCapture::bytesByHost() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<int64_t> totals(pool_.size(), 0);
+    std::vector<bool> seen(pool_.size(), false);
+    for (size_t row = 0; row < host_.size(); ++row) {
+        totals[host_[row]] += bytes_[row];
+        seen[host_[row]] = true;
+    }
+    std::map<std::string, int64_t> result;
+    for (uint32_t id = 0; id < totals.size(); ++id) {
+        if (seen[id]) result[std::string(pool_.get(id))] = totals[id];
+    }
+    return result;
+}
+
+std::map<std::string, size_t> NetworkCapture::requestsByHost() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<size_t> counts(pool_.size(), 0);
+    for (uint32_t host : host_) counts[host]++;
+    std::map<std::string, size_t> result;
+    for (uint32_t id = 0; id < counts.size(); ++id) {
+        if (counts[id] > 0) result[std::string(pool_.get(id))] = counts[id];
+    }
+    return result;
+}
+
+std::vector<HAREntry> NetworkCapture::slowest(size_t n) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<uint32_t> rows;
+    rows.reserve(state_.size());
+    for (uint32_t row = 0; row < state_.size(); ++row) {
+        if (state_[row] != Pending) rows.push_back(row);
+    }
+    n = (std::min)(n, rows.size());
+    std::partial_sort(rows.begin(), rows.begin() + static_cast<std::ptrdiff_t>(n), rows.end(), [this](uint32_t a, uint32_t b) {
+        return durationMs(a) > durationMs(b);
+    });
+
+    std::vector<HAREntry> result;
+    result.reserve(n);
+    for (size_t i = 0; i < n; ++i) result.push_back(materialize(rows[i]));
+    return result;
+}
+
+HAREntry NetworkCapture::entry(size_t index) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= state_.size()) return HAREntry{};
+    return materialize(index);
+}
+
+Result<void> NetworkCapture::writeHAR(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HARExporter::writePrologue(out);
+    bool first = true;
+    for (size_t row = 0; row < state_.size(); ++row) {
+        if (!exported(row)) continue;
+        HARExporter::writeEntry(out, materialize(row), first);
+        first = false;
+    }
+    HARExporter::writeEpilogue(out);
+    if (!out) return Error(ErrorCode::Internal, "Failed to write HAR output");
+    return {};
+}
+
+Result<void> NetworkCapture::saveHAR(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return Error(ErrorCode::Internal, "Failed to open HAR file: " + path);
+    }
+    return writeHAR(file);
+}
+
+size_t NetworkCapture::memoryUsage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return text_.capacity() + pool_.bytes() + pool_.size() * (sizeof(std::string) + 2 * sizeof(void*)) +
+           columnBytes(urlOffset_) + columnBytes(urlLength_) + columnBytes(host_) + columnBytes(method_) +
+           columnBytes(type_) + columnBytes(mime_) + columnBytes(statusText_) + columnBytes(error_) +
+           columnBytes(status_) + columnBytes(state_) + columnBytes(wallTime_) + columnBytes(startTs_) +
+           columnBytes(endTs_) + columnBytes(bytes_) + columnBytes(dns_) + columnBytes(connect_) +
+           columnBytes(ssl_) + columnBytes(send_) + columnBytes(wait_) + columnBytes(requestHeaderStart_) +
+           columnBytes(requestHeaderCount_) + columnBytes(responseHeaderStart_) +
+           columnBytes(responseHeaderCount_) + columnBytes(headerName_) + columnBytes(headerValueOffset_) +
+           columnBytes(headerValueLength_);
+}
+
+}
+}
@@ -1,15 +1,152 @@
 
 
 #include "cdp/highlevel/NetworkInterceptor.hpp"
+#include "cdp/highlevel/FixtureBundle.hpp"
+#include "cdp/highlevel/AdblockEngine.hpp"
+#include "cdp/highlevel/HarReplayer.hpp"
 #include "cdp/core/Base64.hpp"
+#include "cdp/core/Cbor.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <set>
 #include <sstream>
 
 namespace cdp {
 namespace highlevel {
 
+namespace {
 
-InterceptorHandle::InterceptorHandle(NetworkInterceptor* interceptor, uint64_t id)
-    : interceptor_(interceptor), id_(id), active_(true) {}
+constexpr int kPatternUpdateTimeoutMs = 30000;
+
+bool matchesAnyUrl(const std::string& pattern) {
+    return pattern.find_first_not_of('*') == std::string::npos;
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+std::string toFetchUrlPattern(const std::string& pattern) {
+    std::string out;
+    out.reserve(pattern.size() + 2);
+    if (pattern.front() != '*') out += '*';
+    for (char c : pattern) {
+        if (c == '\\') out += '\\';
+        out += c;
+    }
+    if (pattern.back() != '*') out += '*';
+    return out;
+}
+
+bool isAsciiLetter(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+std::string asciiLower(std::string s) {
+    for (auto& c : s) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return s;
+}
+
+size_t hostEnd(const std::string& pattern) {
+    size_t scheme = pattern.find("://");
+    if (scheme == std::string::npos) return 0;
+    bool schemeChars = std::all_of(pattern.begin(), pattern.begin() + static_cast<std::ptrdiff_t>(scheme), [](char c) {
+        return isAsciiLetter(c) || (c >= '0' && c <= '9') || c == '+' || c == '-' || c == '.' || c == '*';
+    });
+    if (!schemeChars) return 0;
+    size_t end = pattern.find('/', scheme + 3);
+    return end == std::string::npos ? pattern.size() : end;
+}
+
+std::string fetchUrlPattern(const std::string& pattern, bool caseSensitive) {
+    if (matchesAnyUrl(pattern)) return "";
+    if (caseSensitive) return toFetchUrlPattern(pattern);
+
+    size_t host = hostEnd(pattern);
+    if (std::none_of(pattern.begin() + static_cast<std::ptrdiff_t>(host), pattern.end(), isAsciiLetter)) {
+        return toFetchUrlPattern(asciiLower(pattern));
+    }
+    if (host == 0) return "";
+    return toFetchUrlPattern(asciiLower(pattern.substr(0, host)) + "/*");
+}
+
+template <typename Headers>
+std::shared_ptr<const FulfillParams> encodeFulfillParams(int status, const Headers& headers,
+                                                       const uint8_t* body, size_t len) {
+    std::string params = ",\"responseCode\":" + std::to_string(status);
+    if (!headers.empty()) {
+        params += ",\"responseHeaders\":[";
+        bool first = true;
+        for (const auto& [name, value] : headers) {
+            if (!first) params += ',';
+            first = false;
+            params += "{\"name\":" + JsonValue(name).serialize() +
+                      ",\"value\":" + JsonValue(value).serialize() + "}";
+        }
+        params += ']';
+    }
+    if (len > 0) {
+        std::string encoded = Base64::encode(body, len);
+        params.reserve(params.size() + encoded.size() + 10);
+        params += ",\"body\":\"";
+        params += encoded;
+        params += '"';
+    }
+    return std::make_shared<const FulfillParams>(std::move(params));
+}
+
+}
+
+
+const std::string& FulfillParams::cbor() const {
+    std::call_once(cborOnce_, [this]() {
+        std::string object = "{" + json_.substr(json_.empty() ? 0 : 1) + "}";
+        Cbor::encodeEntries(JsonValue::parse(object).asObject(), cbor_, Cbor::commandOptions("Fetch.fulfillRequest"));
+    });
+    return cbor_;
+}
+
+
+MockResponse& MockResponse::prepare() {
+    prepared_ = encodeFulfillParams(statusCode, headers, reinterpret_cast<const uint8_t*>(body.data()), body.size());
+    return *this;
+}
+
+std::shared_ptr<const FulfillParams> MockResponse::fulfillParams() const {
+    if (prepared_) return prepared_;
+    return encodeFulfillParams(statusCode, headers, reinterpret_cast<const uint8_t*>(body.data()), body.size());
+}
+
+MockResponse MockResponse::preEncoded(const uint8_t* data, size_t len,
+                                      const std::map<std::string, std::string>& headers, int status) {
+    MockResponse r;
+    r.statusCode = status;
+    r.headers = headers;
+    r.prepared_ = encodeFulfillParams(status, headers, data, len);
+    return r;
+}
+
+MockResponse MockResponse::preEncoded(const uint8_t* data, size_t len,
+                                      const std::vector<HeaderEntry>& headers, int status) {
+    MockResponse r;
+    r.statusCode = status;
+    for (const auto& [name, value] : headers) {
+        std::string& joined = r.headers[name];
+        joined = joined.empty() ? value : joined + ", " + value;
+    }
+    r.prepared_ = encodeFulfillParams(status, headers, data, len);
+    return r;
+}
+
+
+InterceptorHandle::InterceptorHandle(NetworkInterceptor* interceptor, uint64_t id, Result<void> applied)
+    : interceptor_(interceptor), id_(id), active_(true), applied_(std::move(applied)) {}
 
 InterceptorHandle::~InterceptorHandle() {
     if (active_ && interceptor_) {
@@ -18,7 +155,8 @@ InterceptorHandle::~InterceptorHandle() {
 }
 
 InterceptorHandle::InterceptorHandle(InterceptorHandle&& other) noexcept
-    : interceptor_(other.interceptor_), id_(other.id_), active_(other.active_) {
+    : interceptor_(other.interceptor_), id_(other.id_), active_(other.active_),
+      applied_(std::move(other.applied_)) {
     other.active_ = false;
     other.interceptor_ = nullptr;
 }
@@ -31,6 +169,7 @@ InterceptorHandle& InterceptorHandle::operator=(InterceptorHandle&& other) noexc
         interceptor_ = other.interceptor_;
         id_ = other.id_;
         active_ = other.active_;
+        applied_ = std::move(other.applied_);
         other.active_ = false;
         other.interceptor_ = nullptr;
     }
@@ -45,8 +184,8 @@ void InterceptorHandle::remove() {
 }
 
 
-NetworkInterceptor::NetworkInterceptor(CDPClient& client)
-    : client_(client) {}
+NetworkInterceptor::NetworkInterceptor(CDPClient& client, const InterceptorOptions& options)
+    : client_(client), options_(options) {}
 
 NetworkInterceptor::~NetworkInterceptor() {
     if (enabled_) {
@@ -60,17 +199,67 @@ Result<void> NetworkInterceptor::enable() {
     }
 
     
-    auto resp = client_.Fetch.enable({}, true);  
-    if (resp.hasError) {
-        return Result<void>::failure(resp.errorCode, resp.errorMessage);
-    }
+    auto info = client_.Target.getTargetInfo();
+    mainFrameId_ = info.hasError ? std::string() : info.result["targetInfo"]["targetId"].getString();
 
-    
+    bodyOps_ = std::make_shared<BodyOps>();
+    startWorkers();
     requestPausedToken_ = client_.Fetch.onScoped("requestPaused", [this](const CDPEvent& event) {
         handleRequestPaused(event.params);
     });
+    trackFrames();
+
+    
+    std::future<CDPResponse> update;
+    {
+        std::lock_guard<std::mutex> lock(rulesMutex_);
+        issuedPatterns_ = derivePatterns();
+        enabled_ = true;
+        client_.Fetch.requireAuthHandling(true);
+        update = sendPatterns(issuedPatterns_);
+    }
+
+    auto applied = awaitPatterns(std::move(update));
+    if (!applied) {
+        std::lock_guard<std::mutex> lock(rulesMutex_);
+        enabled_ = false;
+        issuedPatterns_.clear();
+        requestPausedToken_.release();
+        frameTokens_.clear();
+        stopWorkers();
+        return applied;
+    }
+
+    retargetHook_ = client_.addRetargetHook([this](std::string& error) {
+        auto reapplied = reapply();
+        if (!reapplied) error = reapplied.error().message;
+        return static_cast<bool>(reapplied);
+    });
+    return Result<void>::success();
+}
+
+Result<void> NetworkInterceptor::reapply() {
+    std::vector<RequestPattern> patterns;
+    {
+        std::lock_guard<std::mutex> lock(rulesMutex_);
+        if (!enabled_) {
+            return Result<void>::success();
+        }
+        patterns = issuedPatterns_;
+    }
 
-    enabled_ = true;
+    auto info = client_.Target.getTargetInfo();
+    {
+        std::lock_guard<std::mutex> lock(framesMutex_);
+        mainFrameId_ = info.hasError ? std::string() : info.result["targetInfo"]["targetId"].getString();
+        frames_.clear();
+    }
+
+    client_.Fetch.requireAuthHandling(true);
+    auto resp = client_.Fetch.setPatterns(patterns);
+    if (resp.hasError) {
+        return Result<void>::failure(resp.errorCode, resp.errorMessage);
+    }
     return Result<void>::success();
 }
 
@@ -80,7 +269,17 @@ Result<void> NetworkInterceptor::disable() {
     }
 
     
+    client_.removeRetargetHook(retargetHook_);
+    retargetHook_ = 0;
     requestPausedToken_.release();
+    frameTokens_.clear();
+    drainBodyOps();
+    stopWorkers();
+    {
+        std::lock_guard<std::mutex> lock(rulesMutex_);
+        enabled_ = false;
+        issuedPatterns_.clear();
+    }
 
     
     auto resp = client_.Fetch.disable();
@@ -88,13 +287,31 @@ Result<void> NetworkInterceptor::disable() {
         return Result<void>::failure(resp.errorCode, resp.errorMessage);
     }
 
-    enabled_ = false;
     return Result<void>::success();
 }
 
 InterceptorHandle NetworkInterceptor::mockRequest(const std::string& urlPattern, const MockResponse& response) {
-    return intercept(urlPattern, [response](const InterceptedRequest&) {
-        return InterceptAction::fulfill(response);
+    auto prepared = std::make_shared<const MockResponse>(MockResponse(response).prepare());
+    return intercept(urlPattern, [prepared](const InterceptedRequest&) {
+        return InterceptAction::fulfill(prepared);
+    });
+}
+
+InterceptorHandle NetworkInterceptor::serveFixtures(const std::string& urlPattern,
+                                                    std::shared_ptr<const FixtureBundle> bundle) {
+    return intercept(urlPattern, [bundle](const InterceptedRequest& req) {
+        auto response = bundle->find(req.url);
+        if (!response) return InterceptAction::defer();
+        return InterceptAction::fulfill(std::move(response));
+    });
+}
+
+InterceptorHandle NetworkInterceptor::serveHar(std::shared_ptr<HarReplayer> replayer) {
+    bool failMisses = replayer->options().onMiss == HarMissPolicy::Fail;
+    return intercept(replayer->options().urlPattern, [replayer, failMisses](const InterceptedRequest& req) {
+        auto response = replayer->find(req.method, req.url, req.postData);
+        if (response) return InterceptAction::fulfill(std::move(response));
+        return failMisses ? InterceptAction::fail("InternetDisconnected") : InterceptAction::defer();
     });
 }
 
@@ -104,6 +321,19 @@ InterceptorHandle NetworkInterceptor::blockResource(const std::string& urlPatter
     });
 }
 
+InterceptorHandle NetworkInterceptor::blockWithFilters(std::shared_ptr<const AdblockEngine> engine) {
+    return intercept("*", [this, engine](const InterceptedRequest& req) {
+        std::string source = sourceUrlFor(req);
+        std::string_view type = req.resourceType;
+        if (type == "Document") {
+            std::lock_guard<std::mutex> lock(framesMutex_);
+            if (!mainFrameId_.empty() && req.frameId != mainFrameId_) type = "Subdocument";
+        }
+        if (!engine->shouldBlock(req.url, type, source)) return InterceptAction::defer();
+        return InterceptAction::fail("Blocked");
+    });
+}
+
 InterceptorHandle NetworkInterceptor::modifyRequestHeaders(const std::string& urlPattern,
                                                            const std::map<std::string, std::string>& headers) {
     return intercept(urlPattern, [headers](const InterceptedRequest&) {
@@ -112,114 +342,307 @@ InterceptorHandle NetworkInterceptor::modifyRequestHeaders(const std::string& ur
 }
 
 InterceptorHandle NetworkInterceptor::blockResourceType(const std::string& resourceType) {
-    return intercept("*", [resourceType](const InterceptedRequest& req) {
-        if (req.resourceType == resourceType) {
-            return InterceptAction::fail("Blocked by resource type");
-        }
-        return InterceptAction::defer();
+    return intercept("*", resourceType, [](const InterceptedRequest&) {
+        return InterceptAction::fail("Blocked by resource type");
     });
 }
 
 InterceptorHandle NetworkInterceptor::intercept(const std::string& urlPattern, InterceptCallback callback) {
-    std::lock_guard<std::mutex> lock(rulesMutex_);
+    return intercept(urlPattern, "", std::move(callback));
+}
 
+InterceptorHandle NetworkInterceptor::intercept(const std::string& urlPattern, const std::string& resourceType,
+                                                InterceptCallback callback) {
     InterceptRule rule;
-    rule.id = nextRuleId_++;
     rule.pattern = urlPattern;
-    rule.regex = patternToRegex(urlPattern);
+    rule.resourceType = resourceType;
     rule.callback = std::move(callback);
     rule.isObserver = false;
-
-    rules_.push_back(std::move(rule));
-
-    return InterceptorHandle(this, rule.id);
+    return addRule(std::move(rule));
 }
 
 InterceptorHandle NetworkInterceptor::observe(const std::string& urlPattern, ObserveCallback callback) {
-    std::lock_guard<std::mutex> lock(rulesMutex_);
-
     InterceptRule rule;
-    rule.id = nextRuleId_++;
     rule.pattern = urlPattern;
-    rule.regex = patternToRegex(urlPattern);
     rule.callback = [callback](const InterceptedRequest& req) {
         callback(req);
         return InterceptAction::defer();
     };
     rule.isObserver = true;
+    return addRule(std::move(rule));
+}
 
-    rules_.push_back(std::move(rule));
+InterceptorHandle NetworkInterceptor::interceptResponse(const std::string& urlPattern, InterceptCallback callback) {
+    InterceptRule rule;
+    rule.pattern = urlPattern;
+    rule.stage = "Response";
+    rule.callback = std::move(callback);
+    return addRule(std::move(rule));
+}
 
-    return InterceptorHandle(this, rule.id);
+InterceptorHandle NetworkInterceptor::captureResponseBody(const std::string& urlPattern,
+                                                          ResponseBodyCallback callback,
+                                                          RequestFilter filter) {
+    InterceptRule rule;
+    rule.pattern = urlPattern;
+    rule.stage = "Response";
+    rule.bodyCallback = std::move(callback);
+    rule.filter = std::move(filter);
+    rule.isObserver = true;
+    return addRule(std::move(rule));
 }
 
-void NetworkInterceptor::clear() {
-    std::lock_guard<std::mutex> lock(rulesMutex_);
-    rules_.clear();
+InterceptorHandle NetworkInterceptor::streamResponseBody(const std::string& urlPattern,
+                                                         ResponseSinkFactory sinkFactory,
+                                                         const ResponseStreamOptions& options) {
+    InterceptRule rule;
+    rule.pattern = urlPattern;
+    rule.stage = "Response";
+    rule.sinkFactory = std::move(sinkFactory);
+    rule.streamOptions = std::make_shared<const ResponseStreamOptions>(options);
+    rule.filter = options.filter;
+    rule.isObserver = true;
+    return addRule(std::move(rule));
 }
 
-void NetworkInterceptor::removeRule(uint64_t id) {
-    std::lock_guard<std::mutex> lock(rulesMutex_);
-    rules_.erase(
-        std::remove_if(rules_.begin(), rules_.end(),
-            [id](const InterceptRule& rule) { return rule.id == id; }),
-        rules_.end());
+InterceptorHandle NetworkInterceptor::streamResponseToFile(const std::string& urlPattern,
+                                                           std::function<std::string(const InterceptedRequest&)> pathFor,
+                                                           const ResponseStreamOptions& options) {
+    return streamResponseBody(urlPattern, [pathFor](const InterceptedRequest& req) -> StreamSink {
+        std::string path = pathFor(req);
+        if (path.empty()) return nullptr;
+        auto file = std::make_shared<std::ofstream>(path, std::ios::binary | std::ios::trunc);
+        if (!*file) return nullptr;
+        return [file](const uint8_t* data, size_t length) {
+            file->write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(length));
+            return static_cast<bool>(*file);
+        };
+    }, options);
 }
 
-std::regex NetworkInterceptor::patternToRegex(const std::string& pattern) {
-    
-    
-    std::string regexStr;
-    regexStr.reserve(pattern.size() * 2);
+InterceptorHandle NetworkInterceptor::addRule(InterceptRule rule) {
+    std::future<CDPResponse> update;
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(rulesMutex_);
+        rule.id = nextRuleId_++;
+        id = rule.id;
+        rules_.push_back(std::move(rule));
+        update = publishRules();
+    }
+    return InterceptorHandle(this, id, awaitPatterns(std::move(update)));
+}
 
-    for (char c : pattern) {
-        switch (c) {
-            case '*':
-                regexStr += ".*";
-                break;
-            case '?':
-                regexStr += ".";
-                break;
-            case '.':
-            case '+':
-            case '^':
-            case '$':
-            case '(':
-            case ')':
-            case '[':
-            case ']':
-            case '{':
-            case '}':
-            case '|':
-            case '\\':
-                regexStr += '\\';
-                regexStr += c;
-                break;
-            default:
-                regexStr += c;
-                break;
+Result<void> NetworkInterceptor::clear() {
+    std::future<CDPResponse> update;
+    {
+        std::lock_guard<std::mutex> lock(rulesMutex_);
+        rules_.clear();
+        update = publishRules();
+    }
+    return awaitPatterns(std::move(update));
+}
+
+Result<void> NetworkInterceptor::removeRule(uint64_t id) {
+    std::future<CDPResponse> update;
+    {
+        std::lock_guard<std::mutex> lock(rulesMutex_);
+        auto it = std::remove_if(rules_.begin(), rules_.end(),
+            [id](const InterceptRule& rule) { return rule.id == id; });
+        if (it == rules_.end()) return Result<void>::success();
+        rules_.erase(it, rules_.end());
+        update = publishRules();
+    }
+    return awaitPatterns(std::move(update));
+}
+
+std::future<CDPResponse> NetworkInterceptor::publishRules() {
+    auto ruleSet = std::make_shared<RuleSet>();
+    ruleSet->matcher = UrlMatcher(options_.caseSensitivePatterns);
+    ruleSet->rules = rules_;
+    for (const auto& rule : ruleSet->rules) {
+        ruleSet->matcher.add(rule.id, rule.pattern);
+    }
+    ruleSet->matcher.build();
+    ruleSet_ = std::move(ruleSet);
+
+    if (!enabled_) return {};
+    auto patterns = derivePatterns();
+    if (patterns == issuedPatterns_) return {};
+    issuedPatterns_ = patterns;
+    return sendPatterns(patterns);
+}
+
+std::future<CDPResponse> NetworkInterceptor::sendPatterns(const std::vector<RequestPattern>& patterns) {
+    auto done = std::make_shared<std::promise<CDPResponse>>();
+    auto update = done->get_future();
+    auto record = commandCallback();
+    client_.Fetch.setPatternsAsync(patterns, [done, record](const CDPResponse& resp) {
+        record(resp);
+        done->set_value(resp);
+    });
+    return update;
+}
+
+Result<void> NetworkInterceptor::awaitPatterns(std::future<CDPResponse> update) {
+    auto& connection = client_.connection();
+    if (!update.valid() || connection.isMessageThread()) {
+        return Result<void>::success();
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kPatternUpdateTimeoutMs);
+    bool ready = false;
+    if (connection.isMessageThreadRunning()) {
+        ready = update.wait_until(deadline) == std::future_status::ready;
+    } else {
+        while (!(ready = update.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) &&
+               std::chrono::steady_clock::now() < deadline) {
+            connection.poll(10);
+        }
+    }
+    if (!ready) {
+        const std::string message = "Timed out waiting for Fetch.enable";
+        counters_->commandErrors++;
+        std::lock_guard<std::mutex> lock(counters_->errorMutex);
+        counters_->lastCommandError = message;
+        return Result<void>::failure(ErrorCode::Timeout, message);
+    }
+    auto resp = update.get();
+    if (resp.hasError) {
+        return Result<void>::failure(resp.errorCode, resp.errorMessage);
+    }
+    return Result<void>::success();
+}
+
+std::vector<RequestPattern> NetworkInterceptor::derivePatterns() const {
+    std::vector<RequestPattern> patterns;
+    for (const char* stage : {"Request", "Response"}) {
+        bool used = false;
+        bool catchAll = !patternFiltering_;
+        std::set<std::string> anyUrlTypes;
+        for (const auto& rule : rules_) {
+            if (rule.stage != stage) continue;
+            used = true;
+            if (!fetchUrlPattern(rule.pattern, options_.caseSensitivePatterns).empty()) continue;
+            if (rule.resourceType.empty()) catchAll = true;
+            anyUrlTypes.insert(rule.resourceType);
+        }
+        bool requestStage = std::string_view(stage) == "Request";
+        if (!used && (patternFiltering_ || !requestStage)) continue;
+
+        
+        if (catchAll) {
+            patterns.push_back({"*", "", stage});
+            continue;
+        }
+
+        std::set<std::pair<std::string, std::string>> seen;
+        for (const auto& rule : rules_) {
+            if (rule.stage != stage) continue;
+            std::string urlPattern = fetchUrlPattern(rule.pattern, options_.caseSensitivePatterns);
+            bool anyUrl = urlPattern.empty();
+            if (!anyUrl && !rule.resourceType.empty() && anyUrlTypes.count(rule.resourceType)) continue;
+            if (anyUrl) urlPattern = "*";
+            if (seen.emplace(urlPattern, rule.resourceType).second) {
+                patterns.push_back({urlPattern, rule.resourceType, stage});
+            }
         }
     }
+    return patterns;
+}
+
+std::vector<RequestPattern> NetworkInterceptor::requestPatterns() {
+    std::lock_guard<std::mutex> lock(rulesMutex_);
+    return derivePatterns();
+}
+
+Result<void> NetworkInterceptor::setPatternFiltering(bool enabled) {
+    std::future<CDPResponse> update;
+    {
+        std::lock_guard<std::mutex> lock(rulesMutex_);
+        if (patternFiltering_ == enabled) return Result<void>::success();
+        patternFiltering_ = enabled;
+        update = publishRules();
+    }
+    return awaitPatterns(std::move(update));
+}
 
-    return std::regex(regexStr, std::regex::icase);
+std::shared_ptr<const NetworkInterceptor::RuleSet> NetworkInterceptor::currentRules() {
+    std::lock_guard<std::mutex> lock(rulesMutex_);
+    return ruleSet_;
 }
 
-bool NetworkInterceptor::urlMatches(const std::string& url, const std::regex& regex) {
-    return std::regex_search(url, regex);
+InterceptorStats NetworkInterceptor::stats() const {
+    InterceptorStats stats;
+    stats.paused = counters_->paused.load();
+    stats.continued = counters_->continued.load();
+    stats.fulfilled = counters_->fulfilled.load();
+    stats.failed = counters_->failed.load();
+    stats.timedOut = counters_->timedOut.load();
+    stats.callbackErrors = counters_->callbackErrors.load();
+    stats.commandErrors = counters_->commandErrors.load();
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex_);
+        stats.pendingDeadlines = deadlines_.size();
+    }
+    std::lock_guard<std::mutex> lock(counters_->errorMutex);
+    stats.lastCommandError = counters_->lastCommandError;
+    return stats;
+}
+
+void NetworkInterceptor::trackFrames() {
+    {
+        std::lock_guard<std::mutex> lock(framesMutex_);
+        frames_.clear();
+    }
+    frameTokens_.clear();
+    frameTokens_.push_back(client_.Page.onScoped("frameAttached", [this](const CDPEvent& event) {
+        std::lock_guard<std::mutex> lock(framesMutex_);
+        frames_[event.params["frameId"].getString()].parentId = event.params["parentFrameId"].getString();
+    }));
+    frameTokens_.push_back(client_.Page.onScoped("frameNavigated", [this](const CDPEvent& event) {
+        const auto& frame = event.params["frame"];
+        std::lock_guard<std::mutex> lock(framesMutex_);
+        auto& info = frames_[frame["id"].getString()];
+        info.url = frame["url"].getString();
+        info.parentId = frame["parentId"].getString();
+    }));
+    frameTokens_.push_back(client_.Page.onScoped("frameDetached", [this](const CDPEvent& event) {
+        std::lock_guard<std::mutex> lock(framesMutex_);
+        frames_.erase(event.params["frameId"].getString());
+    }));
+}
+
+std::string NetworkInterceptor::sourceUrlFor(const InterceptedRequest& request) {
+    {
+        std::lock_guard<std::mutex> lock(framesMutex_);
+        auto frame = frames_.find(request.frameId);
+        if (request.resourceType == "Document") {
+            if (request.frameId == mainFrameId_) return {};
+            if (frame != frames_.end() && !frame->second.parentId.empty()) {
+                auto parent = frames_.find(frame->second.parentId);
+                if (parent != frames_.end() && !parent->second.url.empty()) return parent->second.url;
+            }
+        } else if (frame != frames_.end() && !frame->second.url.empty()) {
+            return frame->second.url;
+        }
+    }
+    for (const auto& [name, value] : request.headers) {
+        if (equalsIgnoreCase(name, "referer")) return value;
+    }
+    return {};
 }
 
 void NetworkInterceptor::handleRequestPaused(const JsonValue& params) {
-    std::string requestId = params["requestId"].getString();
-    std::string url = params["request"]["url"].getString();
-    std::string method = params["request"]["method"].getString();
-    std::string resourceType = params["resourceType"].getString();
+    counters_->paused++;
 
-    
-    InterceptedRequest req;
-    req.requestId = requestId;
-    req.url = url;
-    req.method = method;
-    req.resourceType = resourceType;
+    auto pending = std::make_shared<PendingDecision>();
+    InterceptedRequest& req = pending->request;
+    req.requestId = params["requestId"].getString();
+    req.url = params["request"]["url"].getString();
+    req.method = params["request"]["method"].getString();
+    req.resourceType = params["resourceType"].getString();
+    req.frameId = params["frameId"].getString();
 
     
     const auto& headersObj = params["request"]["headers"];
@@ -235,80 +658,496 @@ void NetworkInterceptor::handleRequestPaused(const JsonValue& params) {
     }
 
     
-    std::vector<InterceptCallback> matchingCallbacks;
+    if (params.contains("responseStatusCode") || params.contains("responseErrorReason")) {
+        req.responseStage = true;
+        req.responseStatusCode = params["responseStatusCode"].getInt();
+        req.responseErrorReason = params["responseErrorReason"].getString();
+        const auto& responseHeaders = params["responseHeaders"];
+        if (responseHeaders.isArray()) {
+            for (const auto& header : responseHeaders.asArray()) {
+                req.responseHeaders.push_back({header["name"].getString(), header["value"].getString()});
+            }
+        }
+    }
+
+    
+    pending->ruleSet = currentRules();
+    std::vector<uint32_t> matches;
+    pending->ruleSet->matcher.matchIndices(req.url, matches);
+    const char* stage = req.responseStage ? "Response" : "Request";
+    for (uint32_t index : matches) {
+        const auto& rule = pending->ruleSet->rules[index];
+        if (rule.stage != stage) continue;
+        if (!rule.resourceType.empty() && rule.resourceType != req.resourceType) continue;
+        if (rule.filter && !rule.filter(req)) continue;
+        if (rule.sinkFactory) {
+            pending->streams.push_back(index);
+        } else {
+            (rule.bodyCallback ? pending->captures : pending->matches).push_back(index);
+        }
+    }
+
+    
+    bool redirect = req.responseStatusCode >= 300 && req.responseStatusCode < 400;
+    bool hasBody = req.responseErrorReason.empty() && !redirect;
+    if (!pending->streams.empty() && hasBody && streamBody(pending)) {
+        return;
+    }
+    if (!pending->captures.empty() && hasBody) {
+        captureBody(pending);
+        return;
+    }
+
+    dispatch(pending);
+}
+
+NetworkInterceptor::BodyOpScope::BodyOpScope(BodyOps& ops) : ops_(ops) {
+    std::lock_guard<std::mutex> lock(ops_.mutex);
+    entered_ = !ops_.closed;
+    if (entered_) ops_.running++;
+}
+
+NetworkInterceptor::BodyOpScope::~BodyOpScope() {
+    if (!entered_) return;
+    std::lock_guard<std::mutex> lock(ops_.mutex);
+    ops_.running--;
+    ops_.cv.notify_all();
+}
+
+std::shared_ptr<void> NetworkInterceptor::beginBodyOp() {
+    auto ops = bodyOps_;
     {
-        std::lock_guard<std::mutex> lock(rulesMutex_);
-        for (const auto& rule : rules_) {
-            if (urlMatches(url, rule.regex)) {
-                matchingCallbacks.push_back(rule.callback);
+        std::lock_guard<std::mutex> lock(ops->mutex);
+        ops->inflight++;
+    }
+    return std::shared_ptr<void>(nullptr, [ops](void*) {
+        std::lock_guard<std::mutex> lock(ops->mutex);
+        ops->inflight--;
+        ops->cv.notify_all();
+    });
+}
+
+void NetworkInterceptor::drainBodyOps() {
+    auto ops = bodyOps_;
+    auto& connection = client_.connection();
+    bool onMessageThread = connection.isMessageThread();
+
+    std::unique_lock<std::mutex> lock(ops->mutex);
+    if (!onMessageThread) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kPatternUpdateTimeoutMs);
+        while (ops->inflight > 0 && std::chrono::steady_clock::now() < deadline) {
+            if (connection.isMessageThreadRunning()) {
+                ops->cv.wait_until(lock, deadline);
+            } else {
+                lock.unlock();
+                connection.poll(10);
+                lock.lock();
+            }
+        }
+    }
+    ops->closed = true;
+    if (!onMessageThread) {
+        ops->cv.wait(lock, [&ops] { return ops->running == 0; });
+    }
+}
+
+void NetworkInterceptor::captureBody(const PendingPtr& pending) {
+    auto counters = counters_;
+    client_.Fetch.getResponseBodyAsync(pending->request.requestId,
+        [this, pending, counters, ops = bodyOps_, op = beginBodyOp()](const CDPResponse& resp) {
+            BodyOpScope scope(*ops);
+            if (!scope) return;
+            if (resp.hasError) {
+                counters->commandErrors++;
+                std::lock_guard<std::mutex> lock(counters->errorMutex);
+                counters->lastCommandError = resp.errorMessage;
+            } else {
+                const std::string& body = resp.result["body"].asString();
+                std::vector<uint8_t> decoded;
+                const uint8_t* data = reinterpret_cast<const uint8_t*>(body.data());
+                size_t len = body.size();
+                if (resp.result["base64Encoded"].getBool(false)) {
+                    decoded.resize(Base64::decodedSizeBound(body.size()));
+                    len = Base64::decode(body.data(), body.size(), decoded.data());
+                    data = decoded.data();
+                }
+                runCaptures(*pending, data, len);
             }
+            dispatch(pending);
+        });
+}
+
+void NetworkInterceptor::runCaptures(const PendingDecision& pending, const uint8_t* data, size_t len) {
+    for (uint32_t index : pending.captures) {
+        try {
+            pending.ruleSet->rules[index].bodyCallback(pending.request, data, len);
+        } catch (const std::exception&) {
+            counters_->callbackErrors++;
+        }
+    }
+}
+
+bool NetworkInterceptor::streamBody(const PendingPtr& pending) {
+    const InterceptedRequest& request = pending->request;
+
+    int64_t contentLength = -1;
+    for (const auto& [name, value] : request.responseHeaders) {
+        if (equalsIgnoreCase(name, "content-length")) {
+            contentLength = std::strtoll(value.c_str(), nullptr, 10);
+            break;
         }
     }
 
+    struct Target {
+        StreamSink sink;
+        std::shared_ptr<const ResponseStreamOptions> options;
+        bool active = true;
+    };
+    struct StreamState {
+        std::vector<Target> targets;
+        std::vector<uint8_t> body;
+        size_t limit = 0;
+        bool buffer = false;
+        bool replay = false;
+        bool overflow = false;
+    };
+    auto state = std::make_shared<StreamState>();
+
+    for (uint32_t index : pending->streams) {
+        const auto& rule = pending->ruleSet->rules[index];
+        const auto& options = rule.streamOptions;
+        if (options->replayToPage && contentLength >= 0 &&
+            static_cast<uint64_t>(contentLength) > options->maxReplayBytes) {
+            if (options->onComplete) {
+                options->onComplete(request, Error(ErrorCode::InvalidArgument,
+                    "Response exceeds maxReplayBytes; not streamed"));
+            }
+            continue;
+        }
+        StreamSink sink;
+        try {
+            sink = rule.sinkFactory(request);
+        } catch (const std::exception&) {
+            counters_->callbackErrors++;
+        }
+        if (!sink) continue;
+        state->replay = state->replay || options->replayToPage;
+        state->limit = (std::max)(state->limit, options->maxReplayBytes);
+        state->targets.push_back({std::move(sink), options});
+    }
+    if (state->targets.empty()) return false;
+    state->buffer = state->replay || !pending->captures.empty();
+
+    StreamSink tee = [state](const uint8_t* data, size_t length) {
+        bool wanted = false;
+        for (auto& target : state->targets) {
+            if (!target.active) continue;
+            target.active = target.sink(data, length);
+            wanted = wanted || target.active;
+        }
+        if (state->buffer && !state->overflow) {
+            if (state->body.size() + length > state->limit) {
+                state->overflow = true;
+                std::vector<uint8_t>().swap(state->body);
+            } else {
+                state->body.insert(state->body.end(), data, data + length);
+            }
+        }
+        return wanted || (state->replay && !state->overflow);
+    };
+
+    auto counters = counters_;
+    client_.Fetch.takeResponseBodyAsStreamAsync(request.requestId,
+        [this, pending, state, counters, tee, ops = bodyOps_, op = beginBodyOp()](const CDPResponse& resp) {
+            BodyOpScope scope(*ops);
+            if (!scope) return;
+            const InterceptedRequest& req = pending->request;
+            if (resp.hasError) {
+                counters->commandErrors++;
+                {
+                    std::lock_guard<std::mutex> lock(counters->errorMutex);
+                    counters->lastCommandError = resp.errorMessage;
+                }
+                for (const auto& target : state->targets) {
+                    if (!target.options->onComplete) continue;
+                    target.options->onComplete(req, Error(ErrorCode::ProtocolError,
+                        "Fetch.takeResponseBodyAsStream failed: " + resp.errorMessage));
+                }
+                if (!pending->captures.empty()) {
+                    captureBody(pending);
+                } else {
+                    dispatch(pending);
+                }
+                return;
+            }
+
+            pending->bodyTaken = true;
+            std::string handle = resp.result["stream"].getString();
+            StreamReader reader(client_.connection());
+            reader.readAsync(handle, tee, state->targets.front().options->read,
+                [this, pending, state, ops, op](const Result<int64_t>& result) {
+                    BodyOpScope scope(*ops);
+                    if (!scope) return;
+                    const InterceptedRequest& req = pending->request;
+                    for (const auto& target : state->targets) {
+                        if (!target.options->onComplete) continue;
+                        if (result && !target.active) {
+                            target.options->onComplete(req, Error(ErrorCode::Cancelled, "Sink stopped reading"));
+                        } else if (result && state->overflow && target.options->replayToPage) {
+                            target.options->onComplete(req, Error(ErrorCode::InvalidArgument,
+                                "Response exceeds maxReplayBytes; request aborted"));
+                        } else {
+                            target.options->onComplete(req, result);
+                        }
+                    }
+
+                    if (!result || (state->replay && state->overflow)) {
+                        resolve(*pending, InterceptAction::fail("Aborted"));
+                        return;
+                    }
+                    if (state->buffer && !state->overflow) {
+                        runCaptures(*pending, state->body.data(), state->body.size());
+                    }
+                    if (state->replay) {
+                        pending->streamedBody = std::make_shared<const std::vector<uint8_t>>(std::move(state->body));
+                    }
+                    dispatch(pending);
+                });
+        });
+    return true;
+}
+
+void NetworkInterceptor::dispatch(const PendingPtr& pending) {
+    if (pending->matches.empty()) {
+        resolve(*pending, InterceptAction::continueRequest());
+        return;
+    }
+
     
-    InterceptAction finalAction = InterceptAction::continueRequest();
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex_);
+        if (workersRunning_) {
+            jobs_.push_back(pending);
+            if (options_.decisionTimeoutMs > 0) {
+                auto deadline = std::chrono::steady_clock::now() +
+                                std::chrono::milliseconds(options_.decisionTimeoutMs);
+                bool earliest = deadlines_.empty() || deadline < deadlines_.begin()->first;
+                pending->deadline = deadlines_.emplace(deadline, pending);
+                if (earliest) deadlineCv_.notify_one();
+            }
+            jobsCv_.notify_one();
+            return;
+        }
+    }
+
+    resolve(*pending, decide(*pending));
+}
 
-    for (const auto& callback : matchingCallbacks) {
+InterceptAction NetworkInterceptor::decide(const PendingDecision& pending) {
+    for (uint32_t index : pending.matches) {
         try {
-            InterceptAction action = callback(req);
+            InterceptAction action = pending.ruleSet->rules[index].callback(pending.request);
             if (action.type() != InterceptAction::Type::Defer) {
-                finalAction = action;
-                break;
+                return action;
             }
         } catch (const std::exception&) {
-            
+            counters_->callbackErrors++;
         }
     }
+    return InterceptAction::continueRequest();
+}
 
-    
-    switch (finalAction.type()) {
+bool NetworkInterceptor::resolve(PendingDecision& pending, const InterceptAction& action) {
+    if (pending.resolved.exchange(true)) return false;
+    if (options_.decisionTimeoutMs > 0) {
+        std::lock_guard<std::mutex> lock(jobsMutex_);
+        if (pending.deadline) {
+            deadlines_.erase(*pending.deadline);
+            pending.deadline.reset();
+        }
+    }
+    if (pending.bodyTaken) {
+        releaseStreamed(pending, action);
+    } else {
+        applyAction(pending.request, action);
+    }
+    return true;
+}
+
+void NetworkInterceptor::releaseStreamed(const PendingDecision& pending, const InterceptAction& action) {
+    bool passThrough = action.type() == InterceptAction::Type::Continue ||
+                       action.type() == InterceptAction::Type::Defer;
+    if (!passThrough) {
+        applyAction(pending.request, action);
+        return;
+    }
+
+    const InterceptedRequest& req = pending.request;
+    if (!pending.streamedBody) {
+        failRequest(req.requestId, "Aborted");
+        return;
+    }
+
+    std::vector<HeaderEntry> headers;
+    for (const auto& header : req.responseHeaders) {
+        if (equalsIgnoreCase(header.name, "content-encoding") || equalsIgnoreCase(header.name, "content-length")) continue;
+        headers.push_back(header);
+    }
+    const auto& body = *pending.streamedBody;
+    fulfillRequest(req.requestId, MockResponse::preEncoded(body.data(), body.size(), headers,
+                                                           req.responseStatusCode));
+}
+
+void NetworkInterceptor::applyAction(const InterceptedRequest& request, const InterceptAction& action) {
+    switch (action.type()) {
         case InterceptAction::Type::Continue:
-            if (!finalAction.modifiedHeaders().empty()) {
-                continueRequest(requestId, &finalAction.modifiedHeaders());
-            } else {
-                continueRequest(requestId);
-            }
+            continueRequest(request, &action.modifiedHeaders());
             break;
 
         case InterceptAction::Type::Fulfill:
-            fulfillRequest(requestId, finalAction.mockResponse());
+            fulfillRequest(request.requestId, action.mockResponse());
             break;
 
         case InterceptAction::Type::Fail:
-            failRequest(requestId, finalAction.failReason());
+            failRequest(request.requestId, action.failReason());
             break;
 
         case InterceptAction::Type::Defer:
-            
-            continueRequest(requestId);
+            continueRequest(request);
             break;
     }
 }
 
-void NetworkInterceptor::fulfillRequest(const std::string& requestId, const MockResponse& response) {
-    
-    std::vector<HeaderEntry> headers;
-    for (const auto& [name, value] : response.headers) {
-        headers.push_back({name, value});
+ResponseCallback NetworkInterceptor::commandCallback() const {
+    auto counters = counters_;
+    return [counters](const CDPResponse& resp) {
+        if (!resp.hasError) return;
+        counters->commandErrors++;
+        std::lock_guard<std::mutex> lock(counters->errorMutex);
+        counters->lastCommandError = resp.errorMessage;
+    };
+}
+
+void NetworkInterceptor::startWorkers() {
+    std::lock_guard<std::mutex> lock(jobsMutex_);
+    if (workersRunning_ || options_.workerThreads == 0) return;
+    workersRunning_ = true;
+    for (size_t i = 0; i < options_.workerThreads; ++i) {
+        workers_.emplace_back([this]() { workerLoop(); });
+    }
+    if (options_.decisionTimeoutMs > 0) {
+        deadlineThread_ = std::thread([this]() { deadlineLoop(); });
     }
+}
+
+void NetworkInterceptor::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex_);
+        if (!workersRunning_) return;
+        workersRunning_ = false;
+    }
+    jobsCv_.notify_all();
+    deadlineCv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+    workers_.clear();
+    if (deadlineThread_.joinable()) deadlineThread_.join();
 
     
-    std::string bodyBase64 = Base64::encode(
-        std::vector<uint8_t>(response.body.begin(), response.body.end()));
+    std::deque<PendingPtr> leftover;
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex_);
+        leftover.swap(jobs_);
+        for (auto& [deadline, pending] : deadlines_) pending->deadline.reset();
+        deadlines_.clear();
+    }
+    for (auto& pending : leftover) {
+        resolve(*pending, InterceptAction::continueRequest());
+    }
+}
+
+void NetworkInterceptor::workerLoop() {
+    while (true) {
+        PendingPtr pending;
+        {
+            std::unique_lock<std::mutex> lock(jobsMutex_);
+            jobsCv_.wait(lock, [this]() { return !jobs_.empty() || !workersRunning_; });
+            if (!workersRunning_) return;
+            pending = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
 
-    client_.Fetch.fulfillRequest(requestId, response.statusCode, headers, bodyBase64);
+        if (pending->resolved.load()) continue;
+        InterceptAction action = decide(*pending);
+        resolve(*pending, action);
+    }
 }
 
-void NetworkInterceptor::continueRequest(const std::string& requestId,
+void NetworkInterceptor::deadlineLoop() {
+    std::unique_lock<std::mutex> lock(jobsMutex_);
+    while (workersRunning_) {
+        if (deadlines_.empty()) {
+            deadlineCv_.wait(lock);
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        auto first = deadlines_.begin();
+        if (first->first > now) {
+            deadlineCv_.wait_until(lock, first->first);
+            continue;
+        }
+
+        std::vector<PendingPtr> expired;
+        while (!deadlines_.empty() && deadlines_.begin()->first <= now) {
+            expired.push_back(std::move(deadlines_.begin()->second));
+            expired.back()->deadline.reset();
+            deadlines_.erase(deadlines_.begin());
+        }
+
+        lock.unlock();
+        for (auto& pending : expired) {
+            if (resolve(*pending, InterceptAction::continueRequest())) counters_->timedOut++;
+        }
+        lock.lock();
+    }
+}
+
+void NetworkInterceptor::fulfillRequest(const std::string& requestId, const MockResponse& response) {
+    auto params = response.fulfillParams();
+
+    counters_->fulfilled++;
+    auto& connection = client_.connection();
+    if (connection.cborWire()) {
+        std::string idEntry;
+        Cbor::appendString(idEntry, "requestId");
+        Cbor::appendString(idEntry, requestId);
+        connection.sendCommandRawCbor("Fetch.fulfillRequest", {idEntry, params->cbor()}, commandCallback());
+        return;
+    }
+    std::string id = JsonValue(requestId).serialize();
+    connection.sendCommandRaw("Fetch.fulfillRequest",
+                              {"{\"requestId\":", id, params->json(), "}"},
+                              commandCallback());
+}
+
+void NetworkInterceptor::continueRequest(const InterceptedRequest& request,
                                          const std::map<std::string, std::string>* modifiedHeaders) {
-    if (modifiedHeaders && !modifiedHeaders->empty()) {
-        std::vector<HeaderEntry> headers;
+    counters_->continued++;
+    std::vector<HeaderEntry> headers;
+    if (modifiedHeaders) {
         for (const auto& [name, value] : *modifiedHeaders) {
             headers.push_back({name, value});
         }
-        client_.Fetch.continueRequest(requestId, "", "", "", headers);
+    }
+
+    if (request.responseStage) {
+        client_.Fetch.continueResponseAsync(request.requestId, 0, "", headers, "", commandCallback());
+    } else if (!headers.empty()) {
+        client_.Fetch.continueRequestAsync(request.requestId, headers, "", "", "", commandCallback());
     } else {
-        client_.Fetch.continueRequest(requestId);
+        client_.Fetch.continueRequestAsync(request.requestId, commandCallback());
     }
 }
 
@@ -321,9 +1160,14 @@ void NetworkInterceptor::failRequest(const std::string& requestId, const std::st
         errorReason = "AccessDenied";
     } else if (reason == "ConnectionRefused") {
         errorReason = "ConnectionRefused";
+    } else if (reason == "Aborted") {
+        errorReason = "Aborted";
+    } else if (reason == "InternetDisconnected") {
+        errorReason = "InternetDisconnected";
     }
 
-    client_.Fetch.failRequest(requestId, errorReason);
+    counters_->failed++;
+    client_.Fetch.failRequestAsync(requestId, errorReason, commandCallback());
 }
 
 } 
@@ -23,6 +23,9 @@ Page::Page(CDPClient& client) : client_(client) {
     if (!client_.Input.isEnabled()) {
         
     }
+    if (client_.config().detectCrashes) {
+        enableCrashDetection();
+    }
 
     domainEnabled_ = true;
 }
@@ -31,6 +34,32 @@ Page::~Page() {
     
 }
 
+void Page::reattach() {
+    client_.Page.enable();
+    client_.DOM.enable();
+    client_.Runtime.enable();
+    if (crashDetection_) {
+        client_.Inspector.enable();
+    }
+
+    frameId_.clear();
+    rootNodeId_ = 0;
+    navigations_ = 0;
+    inflightRequests_ = 0;
+}
+
+Result<void> Page::enableCrashDetection() {
+    if (crashDetection_) {
+        return Result<void>::success();
+    }
+    auto resp = client_.Inspector.enable();
+    if (resp.hasError) {
+        return Result<void>::failure(resp.errorCode, resp.errorMessage);
+    }
+    crashDetection_ = true;
+    return Result<void>::success();
+}
+
 
 Result<void> Page::navigate(const std::string& url, int timeoutMs) {
     NavigateOptions options;
@@ -74,6 +103,7 @@ Result<void> Page::navigate(const std::string& url, const NavigateOptions& optio
     }
 
     frameId_ = resp.result["frameId"].getString();
+    navigations_++;
 
     
     switch (options.waitUntil) {
@@ -135,6 +165,7 @@ Result<void> Page::navigateNoWait(const std::string& url) {
     }
     frameId_ = resp.result["frameId"].getString();
     rootNodeId_ = 0;
+    navigations_++;
     return Result<void>::success();
 }
 
@@ -167,6 +198,7 @@ Result<void> Page::reload(const NavigateOptions& options) {
     if (resp.hasError) {
         return Result<void>::failure(resp.errorCode, resp.errorMessage);
     }
+    navigations_++;
 
     switch (options.waitUntil) {
         case WaitUntil::Load: {
@@ -221,6 +253,7 @@ Result<void> Page::goBack(int timeoutMs) {
     if (resp.hasError) {
         return Result<void>::failure(resp.errorCode, resp.errorMessage);
     }
+    navigations_++;
 
     auto status = loadFuture.wait_for(std::chrono::milliseconds(timeoutMs));
     if (status != std::future_status::ready) {
@@ -253,6 +286,7 @@ Result<void> Page::goForward(int timeoutMs) {
     if (resp.hasError) {
         return Result<void>::failure(resp.errorCode, resp.errorMessage);
     }
+    navigations_++;
 
     auto status = loadFuture.wait_for(std::chrono::milliseconds(timeoutMs));
     if (status != std::future_status::ready) {
@@ -877,7 +911,7 @@ Result<bool> Page::evaluateBool(const std::string& expression) {
 }
 
 
-Result<std::vector<uint8_t>> Page::screenshot(const ScreenshotOptions& options) {
+Result<CDPResponse> Page::captureScreenshotResponse(const ScreenshotOptions& options) {
     cdp::Viewport viewport;
     cdp::Viewport* clipPtr = nullptr;
 
@@ -900,57 +934,82 @@ Result<std::vector<uint8_t>> Page::screenshot(const ScreenshotOptions& options)
         options.timeoutMs          
     );
     if (resp.hasError) {
-        return Result<std::vector<uint8_t>>::failure(resp.errorCode, resp.errorMessage);
+        return Result<CDPResponse>::failure(resp.errorCode, resp.errorMessage);
+    }
+    if (!resp.result["data"].isString()) {
+        return Result<CDPResponse>::failure("Screenshot response has no data");
     }
+    return Result<CDPResponse>(std::move(resp));
+}
 
-    std::string base64Data = resp.result["data"].getString();
-    return Result<std::vector<uint8_t>>(Base64::decode(base64Data));
+Result<std::vector<uint8_t>> Page::screenshot(const ScreenshotOptions& options) {
+    auto resp = captureScreenshotResponse(options);
+    if (!resp) return Result<std::vector<uint8_t>>::failure(resp.error());
+    return Result<std::vector<uint8_t>>(Base64::decode(resp->result["data"].asString()));
 }
 
 Result<void> Page::screenshotToFile(const std::string& path, const ScreenshotOptions& options) {
-    auto dataResult = screenshot(options);
-    if (!dataResult) return Result<void>::failure(dataResult.error());
+    auto resp = captureScreenshotResponse(options);
+    if (!resp) return Result<void>::failure(resp.error());
 
-    std::ofstream file(path, std::ios::binary);
-    if (!file) {
-        return Result<void>::failure("Failed to open file for writing: " + path);
-    }
-
-    file.write(reinterpret_cast<const char*>(dataResult->data()), dataResult->size());
-    if (!file) {
+    if (!Base64::decodeToFile(resp->result["data"].asString(), path)) {
         return Result<void>::failure("Failed to write file: " + path);
     }
 
     return Result<void>::success();
 }
 
-Result<std::vector<uint8_t>> Page::pdf() {
-    auto resp = client_.Page.printToPDF();
+Result<ImageDiffResult> Page::compareScreenshot(const std::vector<uint8_t>& baselinePng,
+                                                const ImageDiffOptions& diffOptions,
+                                                const ScreenshotOptions& options) {
+    if (options.format != "png") {
+        return Result<ImageDiffResult>::failure(ErrorCode::InvalidArgument,
+                                                "compareScreenshot requires png format");
+    }
+    auto current = screenshot(options);
+    if (!current) return Result<ImageDiffResult>::failure(current.error());
+    return ImageDiff::compare(baselinePng, current.value(), diffOptions);
+}
+
+Result<std::string> Page::openPdfStream() {
+    auto resp = client_.Page.printToPDF(false, false, false, 1.0, 8.5, 11.0,
+                                        0.4, 0.4, 0.4, 0.4, "", "", "", false,
+                                        "ReturnAsStream");
     if (resp.hasError) {
-        return Result<std::vector<uint8_t>>::failure(resp.errorCode, resp.errorMessage);
+        return Result<std::string>::failure(resp.errorCode, resp.errorMessage);
     }
 
-    std::string base64Data = resp.result["data"].getString();
-    return Result<std::vector<uint8_t>>(Base64::decode(base64Data));
+    std::string handle = resp.result["stream"].getString();
+    if (handle.empty()) {
+        return Result<std::string>::failure("printToPDF did not return a stream handle");
+    }
+    return Result<std::string>(handle);
 }
 
-Result<void> Page::pdfToFile(const std::string& path) {
-    auto dataResult = pdf();
-    if (!dataResult) return Result<void>::failure(dataResult.error());
+Result<std::vector<uint8_t>> Page::pdf() {
+    auto handle = openPdfStream();
+    if (!handle) return Result<std::vector<uint8_t>>::failure(handle.error());
 
-    std::ofstream file(path, std::ios::binary);
-    if (!file) {
-        return Result<void>::failure("Failed to open file for writing: " + path);
-    }
+    return StreamReader(client_.connection()).readToBytes(handle.value());
+}
 
-    file.write(reinterpret_cast<const char*>(dataResult->data()), dataResult->size());
-    if (!file) {
-        return Result<void>::failure("Failed to write file: " + path);
-    }
+Result<void> Page::pdfToFile(const std::string& path) {
+    auto handle = openPdfStream();
+    if (!handle) return Result<void>::failure(handle.error());
+
+    auto written = StreamReader(client_.connection()).readToFile(handle.value(), path);
+    if (!written) return Result<void>::failure(written.error());
 
     return Result<void>::success();
 }
 
+Result<int64_t> Page::pdfToSink(const StreamSink& sink, const StreamReadOptions& options) {
+    auto handle = openPdfStream();
+    if (!handle) return Result<int64_t>::failure(handle.error());
+
+    return StreamReader(client_.connection()).read(handle.value(), sink, options);
+}
+
 
 Result<void> Page::setViewport(int width, int height, double deviceScaleFactor) {
     auto resp = client_.Emulation.setDeviceMetricsOverride(width, height, deviceScaleFactor, false);
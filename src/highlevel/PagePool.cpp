@@ -0,0 +1,397 @@
+
+
+#include "cdp/highlevel/PagePool.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace cdp {
+namespace highlevel {
+
+PagePool::PagePool(Browser& browser, const PagePoolOptions& options)
+    : browser_(browser), options_(options) {
+    options_.contexts = (std::max)(options_.contexts, static_cast<size_t>(1));
+    options_.pagesPerContext = (std::max)(options_.pagesPerContext, static_cast<size_t>(1));
+    if (!options_.isolateContexts) options_.contexts = 1;
+}
+
+PagePool::~PagePool() {
+    shutdown();
+    std::unique_lock<std::mutex> lock(mutex_);
+    available_.wait(lock, [this] { return stats_.leased == 0; });
+}
+
+Result<void> PagePool::start() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) return Result<void>::success();
+        if (stats_.leased > 0) {
+            return Result<void>::failure(ErrorCode::InvalidArgument,
+                                         "Page pool still has " + std::to_string(stats_.leased) + " leased pages");
+        }
+        running_ = true;
+        idle_.clear();
+        broken_.clear();
+        pages_.clear();
+        contexts_.clear();
+        stats_ = PagePoolStats{};
+    }
+
+    for (size_t i = 0; i < options_.contexts; ++i) {
+        auto r = addContext();
+        if (!r) {
+            shutdown();
+            return r;
+        }
+    }
+    return Result<void>::success();
+}
+
+void PagePool::shutdown() {
+    std::vector<PageSlot*> pages;
+    std::vector<ContextSlot*> contexts;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+        idle_.clear();
+        broken_.clear();
+        for (auto& slot : pages_) {
+            if (!slot->leased) pages.push_back(slot.get());
+        }
+        for (auto& context : contexts_) {
+            if (context->leased == 0) contexts.push_back(context.get());
+        }
+        stats_.capacity = 0;
+        stats_.idle = 0;
+    }
+    available_.notify_all();
+
+    
+    for (PageSlot* slot : pages) {
+        if (slot->page) slot->context->context->closePage(slot->page);
+        slot->page = nullptr;
+    }
+    for (ContextSlot* context : contexts) {
+        if (context->context && !context->context->isDefault()) browser_.closeContext(context->context);
+        context->context = nullptr;
+    }
+}
+
+Result<PageLease> PagePool::lease(int timeoutMs) {
+    auto start = std::chrono::steady_clock::now();
+    retryBroken();
+
+    auto deadline = start + std::chrono::milliseconds((std::max)(timeoutMs, 0));
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    PageSlot* slot = nullptr;
+    while (!slot) {
+        stats_.waiting++;
+        bool ready = available_.wait_until(lock, deadline, [this] { return !running_ || !idle_.empty(); });
+        stats_.waiting--;
+
+        if (!running_) {
+            return Result<PageLease>::failure(ErrorCode::Cancelled, "Page pool is not running");
+        }
+        if (!ready) {
+            stats_.leaseTimeouts++;
+            return Result<PageLease>::failure(ErrorCode::Timeout,
+                                              "Timed out waiting for a pooled page after " +
+                                              std::to_string(timeoutMs) + "ms");
+        }
+
+        slot = idle_.front();
+        idle_.pop_front();
+
+        
+        if (slot->page && slot->page->isDead()) {
+            stats_.crashedPages++;
+            stats_.idle = idle_.size();
+            lock.unlock();
+            replacePage(slot);
+            lock.lock();
+            slot = nullptr;
+        }
+    }
+    slot->leased = true;
+
+    ContextSlot* context = slot->context;
+    context->leased++;
+    context->uses++;
+    if (options_.maxUsesPerContext > 0 && context->uses >= options_.maxUsesPerContext && !context->retiring) {
+        context->retiring = true;
+        idle_.erase(std::remove_if(idle_.begin(), idle_.end(),
+                                   [context](PageSlot* s) { return s->context == context; }),
+                    idle_.end());
+    }
+
+    double waitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    stats_.leases++;
+    stats_.totalWaitMs += waitMs;
+    stats_.maxWaitMs = (std::max)(stats_.maxWaitMs, waitMs);
+    stats_.leased++;
+    stats_.idle = idle_.size();
+
+    return Result<PageLease>(PageLease(this, slot));
+}
+
+PagePoolStats PagePool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+Result<void> PagePool::addContext() {
+    BrowserContext* context = &browser_.defaultContext();
+    if (options_.isolateContexts) {
+        auto created = browser_.createIncognitoContext(options_.contextOptions);
+        if (!created) return Result<void>::failure(created.error());
+        context = created.value();
+    }
+
+    auto slot = std::make_unique<ContextSlot>();
+    slot->context = context;
+    ContextSlot* raw = slot.get();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        contexts_.push_back(std::move(slot));
+    }
+    return fillContext(raw, options_.pagesPerContext);
+}
+
+Result<void> PagePool::fillContext(ContextSlot* context, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        auto slot = std::make_unique<PageSlot>();
+        slot->context = context;
+        auto page = createPage(context);
+        if (!page) return Result<void>::failure(page.error());
+        slot->page = page.value();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle_.push_back(slot.get());
+            pages_.push_back(std::move(slot));
+            stats_.capacity = pages_.size();
+            stats_.idle = idle_.size();
+        }
+        available_.notify_one();
+    }
+    return Result<void>::success();
+}
+
+Result<ManagedPage*> PagePool::createPage(ContextSlot* context) {
+    auto page = context->context->newPage(options_.pageOptions);
+    if (!page) return page;
+    page.value()->page().enableCrashDetection();
+    page.value()->setRecyclePolicy(options_.recyclePolicy);
+    return page;
+}
+
+bool PagePool::recyclePage(PageSlot* slot) {
+    ManagedPage* page = slot->page;
+    if (!page || !page->isConnected()) return false;
+
+    auto recycled = page->recycleIfNeeded();
+    if (!recycled) return false;
+    if (recycled.value()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.recycledPages++;
+    }
+    return true;
+}
+
+bool PagePool::resetPage(PageSlot* slot) {
+    ManagedPage* page = slot->page;
+    if (!page || !page->isConnected()) return false;
+
+    CDPClient& client = page->client();
+    client.connection().removeUnscopedEventHandlers();
+
+    std::string origin;
+    if (options_.clearStorage) {
+        auto resp = client.sendCommand("Runtime.evaluate",
+            Params().set("expression", "location.origin").set("returnByValue", true).build());
+        if (!resp.hasError) origin = resp.result.getStringAt("result/value");
+    }
+
+    auto navigated = page->page().navigate("about:blank", options_.resetTimeoutMs);
+    if (!navigated) return false;
+
+    if (options_.clearStorage) {
+        if (!origin.empty() && origin != "null") {
+            client.Storage.clearDataForOrigin(origin, "all");
+        }
+        if (slot->context->context->isDefault()) {
+            client.Network.clearBrowserCookies();
+        } else {
+            browser_.browserClient().Storage.clearCookies(slot->context->context->id());
+        }
+    }
+    return true;
+}
+
+void PagePool::giveBack(PageSlot* slot, bool broken) {
+    bool running = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running = running_;
+    }
+    if (!running) {
+        closeReturned(slot);
+        return;
+    }
+    bool crashed = slot->page && slot->page->isDead();
+    bool healthy = !broken && !crashed && recyclePage(slot) && resetPage(slot);
+
+    ContextSlot* recycle = nullptr;
+    bool replace = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!running_) {
+            lock.unlock();
+            closeReturned(slot);
+            return;
+        }
+
+        ContextSlot* context = slot->context;
+        slot->leased = false;
+        context->leased--;
+        stats_.returns++;
+        stats_.leased--;
+        if (crashed) stats_.crashedPages++;
+
+        if (context->retiring) {
+            if (context->leased == 0) recycle = context;
+        } else if (healthy) {
+            idle_.push_back(slot);
+            stats_.idle = idle_.size();
+        } else {
+            replace = true;
+        }
+    }
+
+    if (recycle) {
+        recycleContext(recycle);
+    } else if (replace) {
+        replacePage(slot);
+    } else {
+        available_.notify_one();
+    }
+    retryBroken();
+}
+
+void PagePool::closeReturned(PageSlot* slot) {
+    ContextSlot* context = slot->context;
+    if (slot->page && context->context) context->context->closePage(slot->page);
+    slot->page = nullptr;
+
+    bool lastInContext = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slot->leased = false;
+        lastInContext = --context->leased == 0;
+    }
+    if (lastInContext && context->context && !context->context->isDefault()) {
+        browser_.closeContext(context->context);
+        context->context = nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.returns++;
+        stats_.leased--;
+    }
+    available_.notify_all();
+}
+
+void PagePool::replacePage(PageSlot* slot) {
+    slot->context->context->closePage(slot->page);
+    slot->page = nullptr;
+
+    if (restorePage(slot)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.replacedPages++;
+    }
+}
+
+bool PagePool::restorePage(PageSlot* slot) {
+    ContextSlot* context = slot->context;
+    if (!context->context) {
+        auto created = browser_.createIncognitoContext(options_.contextOptions);
+        if (!created) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) return false;
+            stats_.failedContexts++;
+            broken_.push_back(slot);
+            stats_.broken = broken_.size();
+            return false;
+        }
+        context->context = created.value();
+    }
+
+    auto page = createPage(context);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) return false;
+    if (page) {
+        slot->page = page.value();
+        idle_.push_back(slot);
+    } else {
+        stats_.failedPages++;
+        broken_.push_back(slot);
+    }
+    stats_.idle = idle_.size();
+    stats_.broken = broken_.size();
+    available_.notify_one();
+    return static_cast<bool>(page);
+}
+
+void PagePool::retryBroken() {
+    std::unique_lock<std::mutex> retry(retryMutex_, std::try_to_lock);
+    if (!retry) return;
+
+    PageSlot* slot = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_ || broken_.empty()) return;
+        slot = broken_.front();
+        broken_.pop_front();
+        stats_.broken = broken_.size();
+    }
+    restorePage(slot);
+}
+
+void PagePool::recycleContext(ContextSlot* context) {
+    std::vector<PageSlot*> retired;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& slot : pages_) {
+            if (slot->context == context) retired.push_back(slot.get());
+        }
+    }
+
+    if (context->context->isDefault()) {
+        for (PageSlot* slot : retired) context->context->closePage(slot->page);
+    } else {
+        browser_.closeContext(context->context);
+        auto created = browser_.createIncognitoContext(options_.contextOptions);
+        context->context = created ? created.value() : nullptr;
+    }
+    for (PageSlot* slot : retired) slot->page = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        context->uses = 0;
+        context->retiring = false;
+        if (!context->context) {
+            stats_.failedContexts++;
+            broken_.insert(broken_.end(), retired.begin(), retired.end());
+            stats_.broken = broken_.size();
+            return;
+        }
+        stats_.recycledContexts++;
+    }
+    for (PageSlot* slot : retired) restorePage(slot);
+}
+
+}
+}
@@ -0,0 +1,552 @@
+
+
+#include "cdp/highlevel/ResponseCache.hpp"
+#include "cdp/core/MappedFile.hpp"
+#include "cdp/core/SHA1.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+namespace cdp {
+namespace highlevel {
+
+namespace {
+
+std::string lowerCase(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+std::string trim(const std::string& s) {
+    size_t start = s.find_first_not_of(" \t");
+    if (start == std::string::npos) return {};
+    size_t end = s.find_last_not_of(" \t");
+    return s.substr(start, end - start + 1);
+}
+
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> out;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item = trim(item);
+        if (!item.empty()) out.push_back(item);
+    }
+    return out;
+}
+
+template <typename Headers>
+const std::string* findHeader(const Headers& headers, const std::string& lowerName) {
+    for (const auto& [name, value] : headers) {
+        if (lowerCase(name) == lowerName) return &value;
+    }
+    return nullptr;
+}
+
+bool isHopHeader(const std::string& lowerName) {
+    static const std::set<std::string> skipped = {
+        "content-encoding", "content-length", "transfer-encoding", "connection",
+        "keep-alive", "set-cookie", "set-cookie2"};
+    return skipped.count(lowerName) > 0;
+}
+
+std::string baseKey(const std::string& method, const std::string& url) {
+    size_t hash = url.find('#');
+    return method + " " + (hash == std::string::npos ? url : url.substr(0, hash));
+}
+
+int64_t nowSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+}
+
+
+class ResponseCache::State {
+public:
+    struct Entry {
+        std::string key;
+        std::string base;
+        int status = 200;
+        std::map<std::string, std::string> headers;
+        std::vector<std::string> vary;
+        std::string blob;
+        uint64_t size = 0;
+        int64_t storedAt = 0;
+        int64_t expiresAt = 0;
+        std::list<std::string>::iterator lru;
+    };
+
+    explicit State(const ResponseCacheOptions& opts) : options(opts) {
+        for (auto& name : options.varyHeaders) name = lowerCase(name);
+    }
+
+    ResponseCacheOptions options;
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> lru;
+    std::unordered_map<std::string, std::vector<std::string>> varyByBase;
+    std::unordered_map<std::string, uint32_t> blobRefs;
+    ResponseCacheStats stats;
+    bool dirty = false;
+    std::atomic<uint64_t> tempCounter{0};
+
+    std::filesystem::path blobPath(const std::string& blob) const {
+        return std::filesystem::path(options.directory) / "blobs" / blob.substr(0, 2) / blob.substr(2);
+    }
+
+    std::filesystem::path indexPath() const {
+        return std::filesystem::path(options.directory) / "index.json";
+    }
+
+    std::vector<std::string> varyFor(const std::string& base) const {
+        std::vector<std::string> names = options.varyHeaders;
+        auto it = varyByBase.find(base);
+        if (it != varyByBase.end()) names.insert(names.end(), it->second.begin(), it->second.end());
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+        return names;
+    }
+
+    void touch(Entry& entry) {
+        lru.splice(lru.begin(), lru, entry.lru);
+    }
+
+    void insert(Entry entry) {
+        if (blobRefs[entry.blob]++ == 0) {
+            stats.bytes += entry.size;
+        }
+        auto existing = entries.find(entry.key);
+        if (existing != entries.end()) remove(existing);
+
+        if (!entry.vary.empty()) varyByBase[entry.base] = entry.vary;
+        lru.push_front(entry.key);
+        entry.lru = lru.begin();
+        std::string key = entry.key;
+        entries.emplace(std::move(key), std::move(entry));
+        stats.entries = entries.size();
+        dirty = true;
+    }
+
+    void remove(std::unordered_map<std::string, Entry>::iterator it) {
+        Entry& entry = it->second;
+        auto ref = blobRefs.find(entry.blob);
+        if (ref != blobRefs.end() && --ref->second == 0) {
+            blobRefs.erase(ref);
+            stats.bytes -= (std::min)(stats.bytes, entry.size);
+            std::error_code ec;
+            std::filesystem::remove(blobPath(entry.blob), ec);
+        }
+        lru.erase(entry.lru);
+        entries.erase(it);
+        stats.entries = entries.size();
+        dirty = true;
+    }
+
+    void evict() {
+        while (!lru.empty() && (entries.size() > options.maxEntries || stats.bytes > options.maxBytes)) {
+            auto it = entries.find(lru.back());
+            if (it == entries.end()) {
+                lru.pop_back();
+                continue;
+            }
+            remove(it);
+            stats.evictions++;
+        }
+    }
+
+    int64_t freshnessLifetime(const std::vector<HeaderEntry>& headers, bool& cacheable) const {
+        cacheable = true;
+        int64_t ttl = options.defaultTtlSeconds;
+
+        if (options.honorCacheControl) {
+            if (const std::string* cc = findHeader(headers, "cache-control")) {
+                for (const auto& directive : splitList(lowerCase(*cc))) {
+                    if (directive == "no-store" || directive == "no-cache") {
+                        cacheable = false;
+                    } else if (directive.rfind("max-age=", 0) == 0) {
+                        ttl = std::strtoll(directive.c_str() + 8, nullptr, 10);
+                    }
+                }
+            }
+            if (const std::string* vary = findHeader(headers, "vary")) {
+                if (trim(*vary) == "*") cacheable = false;
+            }
+        }
+
+        if (options.maxTtlSeconds > 0) ttl = (std::min)(ttl, options.maxTtlSeconds);
+        if (ttl <= 0) cacheable = false;
+        return ttl;
+    }
+
+    std::filesystem::path writeTemp(const std::string& blob, const uint8_t* body, size_t len) {
+        auto path = blobPath(blob);
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+        auto temp = path;
+        temp += "." + std::to_string(tempCounter++) + ".tmp";
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (out) out.write(reinterpret_cast<const char*>(body), static_cast<std::streamsize>(len));
+        if (out) return temp;
+        out.close();
+        std::filesystem::remove(temp, ec);
+        return {};
+    }
+
+    bool publishBlob(const std::string& blob, const std::filesystem::path& temp) {
+        std::error_code ec;
+        if (temp.empty()) return blobRefs.count(blob) > 0;
+        auto path = blobPath(blob);
+        if (blobRefs.count(blob) > 0 || std::filesystem::exists(path, ec)) {
+            std::filesystem::remove(temp, ec);
+            return true;
+        }
+        std::filesystem::rename(temp, path, ec);
+        if (!ec) return true;
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+
+    size_t removeOrphans() {
+        std::error_code ec;
+        std::vector<std::filesystem::path> orphans;
+        auto root = std::filesystem::path(options.directory) / "blobs";
+        for (auto it = std::filesystem::recursive_directory_iterator(root, ec);
+             !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+            if (!it->is_regular_file(ec)) continue;
+            auto relative = std::filesystem::relative(it->path(), root, ec);
+            std::string blob = relative.parent_path().generic_string() + relative.filename().generic_string();
+            if (relative.parent_path().generic_string().size() != 2 || blobRefs.count(blob) == 0) {
+                orphans.push_back(it->path());
+            }
+        }
+        for (const auto& path : orphans) std::filesystem::remove(path, ec);
+        return orphans.size();
+    }
+
+    JsonValue toJson() const {
+        JsonArray list;
+        for (const auto& key : lru) {
+            auto it = entries.find(key);
+            if (it == entries.end()) continue;
+            const Entry& entry = it->second;
+
+            JsonObject headers;
+            for (const auto& [name, value] : entry.headers) headers[name] = value;
+            JsonArray vary;
+            for (const auto& name : entry.vary) vary.push_back(name);
+
+            JsonObject obj;
+            obj["key"] = entry.key;
+            obj["base"] = entry.base;
+            obj["status"] = entry.status;
+            obj["headers"] = headers;
+            obj["vary"] = vary;
+            obj["blob"] = entry.blob;
+            obj["size"] = static_cast<int64_t>(entry.size);
+            obj["storedAt"] = entry.storedAt;
+            obj["expiresAt"] = entry.expiresAt;
+            list.push_back(obj);
+        }
+        JsonObject root;
+        root["version"] = 1;
+        root["entries"] = list;
+        return root;
+    }
+
+    void load(const JsonValue& root) {
+        const auto* list = root.find("entries");
+        if (!list || !list->isArray()) return;
+
+        const auto& items = list->asArray();
+        for (auto it = items.rbegin(); it != items.rend(); ++it) {
+            const JsonValue& obj = *it;
+            Entry entry;
+            entry.key = obj["key"].getString();
+            entry.base = obj["base"].getString();
+            entry.status = obj["status"].getInt();
+            entry.blob = obj["blob"].getString();
+            entry.size = static_cast<uint64_t>(obj["size"].getNumber(0));
+            entry.storedAt = static_cast<int64_t>(obj["storedAt"].getNumber(0));
+            entry.expiresAt = static_cast<int64_t>(obj["expiresAt"].getNumber(0));
+            if (obj["headers"].isObject()) {
+                for (const auto& [name, value] : obj["headers"].asObject()) {
+                    entry.headers[name] = value.getString();
+                }
+            }
+            if (obj["vary"].isArray()) {
+                for (const auto& name : obj["vary"].asArray()) entry.vary.push_back(name.getString());
+            }
+
+            std::error_code ec;
+            if (entry.key.empty() || entry.blob.size() < 3 || !std::filesystem::exists(blobPath(entry.blob), ec)) {
+                continue;
+            }
+            insert(std::move(entry));
+        }
+        dirty = false;
+    }
+};
+
+
+std::shared_ptr<const MockResponse> lookupIn(ResponseCache::State& state, const InterceptedRequest& request) {
+    std::map<std::string, std::string> headers;
+    int status = 200;
+    std::string blob;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        std::string base = baseKey(request.method, request.url);
+        std::string key = ResponseCache::cacheKey(request.method, request.url, request.headers, state.varyFor(base));
+
+        auto it = state.entries.find(key);
+        if (it == state.entries.end()) {
+            state.stats.misses++;
+            return nullptr;
+        }
+
+        auto& entry = it->second;
+        if (entry.expiresAt <= nowSeconds() && !state.options.serveStale) {
+            state.stats.expired++;
+            state.stats.misses++;
+            return nullptr;
+        }
+
+        state.touch(entry);
+        headers = entry.headers;
+        status = entry.status;
+        blob = entry.blob;
+    }
+
+    MappedFile file;
+    if (!file.open(state.blobPath(blob).string())) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.stats.errors++;
+        state.stats.misses++;
+        return nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.stats.hits++;
+    }
+    return std::make_shared<const MockResponse>(
+        MockResponse::preEncoded(file.data(), file.size(), headers, status));
+}
+
+bool storeIn(ResponseCache::State& state, const InterceptedRequest& response, const uint8_t* body, size_t len) {
+    bool cacheable = true;
+    int64_t ttl = state.freshnessLifetime(response.responseHeaders, cacheable);
+    if (const std::string* cc = findHeader(response.headers, "cache-control")) {
+        if (state.options.honorCacheControl && lowerCase(*cc).find("no-store") != std::string::npos) {
+            cacheable = false;
+        }
+    }
+    if (!cacheable || len > state.options.maxBytes) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.stats.skipped++;
+        return false;
+    }
+
+    ResponseCache::State::Entry entry;
+    entry.base = baseKey(response.method, response.url);
+    entry.status = response.responseStatusCode;
+    entry.size = len;
+    entry.storedAt = nowSeconds();
+    entry.expiresAt = entry.storedAt + ttl;
+    for (const auto& [name, value] : response.responseHeaders) {
+        if (isHopHeader(lowerCase(name))) continue;
+        std::string& joined = entry.headers[name];
+        joined = joined.empty() ? value : joined + ", " + value;
+    }
+    if (const std::string* vary = findHeader(response.responseHeaders, "vary")) {
+        for (const auto& name : splitList(*vary)) entry.vary.push_back(lowerCase(name));
+        std::sort(entry.vary.begin(), entry.vary.end());
+    }
+
+    SHA1 sha;
+    sha.update(body, len);
+    entry.blob = sha.finalizeHex();
+
+    bool known = false;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        known = state.blobRefs.count(entry.blob) > 0;
+    }
+    std::filesystem::path temp;
+    if (!known) {
+        temp = state.writeTemp(entry.blob, body, len);
+        if (temp.empty()) {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.stats.errors++;
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.publishBlob(entry.blob, temp)) {
+        state.stats.errors++;
+        return false;
+    }
+
+    std::vector<std::string> names = state.options.varyHeaders;
+    names.insert(names.end(), entry.vary.begin(), entry.vary.end());
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    entry.key = ResponseCache::cacheKey(response.method, response.url, response.headers, names);
+
+    state.insert(std::move(entry));
+    state.stats.stores++;
+    state.evict();
+    return true;
+}
+
+
+ResponseCache::ResponseCache(const ResponseCacheOptions& options)
+    : state_(std::make_shared<State>(options)) {}
+
+ResponseCache::~ResponseCache() {
+    detach();
+    flush();
+}
+
+Result<void> ResponseCache::open() {
+    if (state_->options.directory.empty()) {
+        return Result<void>::failure(ErrorCode::InvalidArgument, "Response cache directory is not set");
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(state_->options.directory) / "blobs", ec);
+    if (ec) {
+        return Result<void>::failure(ErrorCode::InvalidArgument,
+                                     "Failed to create response cache directory: " + ec.message());
+    }
+
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    std::ifstream in(state_->indexPath(), std::ios::binary);
+    if (in) {
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        try {
+            state_->load(JsonValue::parse(buffer.str()));
+        } catch (const std::exception& e) {
+            return Result<void>::failure(ErrorCode::InvalidArgument,
+                                         std::string("Corrupt response cache index: ") + e.what());
+        }
+    }
+    state_->evict();
+    state_->removeOrphans();
+    return Result<void>::success();
+}
+
+Result<void> ResponseCache::flush() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (!state_->dirty || state_->options.directory.empty()) return Result<void>::success();
+
+    auto path = state_->indexPath();
+    auto temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return Result<void>::failure(ErrorCode::Internal, "Failed to write response cache index");
+        }
+        out << state_->toJson().serialize();
+        if (!out) {
+            return Result<void>::failure(ErrorCode::Internal, "Failed to write response cache index");
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    if (ec) {
+        return Result<void>::failure(ErrorCode::Internal, "Failed to replace response cache index: " + ec.message());
+    }
+    state_->dirty = false;
+    return Result<void>::success();
+}
+
+void ResponseCache::clear() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    while (!state_->entries.empty()) {
+        state_->remove(state_->entries.begin());
+    }
+    state_->varyByBase.clear();
+}
+
+Result<void> ResponseCache::attach(NetworkInterceptor& interceptor) {
+    detach();
+
+    std::weak_ptr<State> weak = state_;
+    auto methodAllowed = [weak](const InterceptedRequest& req) {
+        auto state = weak.lock();
+        if (!state) return false;
+        const auto& methods = state->options.methods;
+        return std::find(methods.begin(), methods.end(), req.method) != methods.end();
+    };
+
+    requestRule_ = interceptor.intercept(state_->options.urlPattern,
+        [weak, methodAllowed](const InterceptedRequest& req) {
+            auto state = weak.lock();
+            if (!state || !methodAllowed(req)) return InterceptAction::defer();
+            auto response = lookupIn(*state, req);
+            if (!response) return InterceptAction::defer();
+            return InterceptAction::fulfill(std::move(response));
+        });
+
+    responseRule_ = interceptor.captureResponseBody(state_->options.urlPattern,
+        [weak](const InterceptedRequest& req, const uint8_t* data, size_t len) {
+            if (auto state = weak.lock()) storeIn(*state, req, data, len);
+        },
+        [weak, methodAllowed](const InterceptedRequest& req) {
+            auto state = weak.lock();
+            if (!state || !methodAllowed(req)) return false;
+            const auto& status = state->options.cacheableStatus;
+            return std::find(status.begin(), status.end(), req.responseStatusCode) != status.end();
+        });
+
+    if (!requestRule_.applied()) return requestRule_.applied();
+    return responseRule_.applied();
+}
+
+void ResponseCache::detach() {
+    requestRule_.remove();
+    responseRule_.remove();
+}
+
+std::string ResponseCache::cacheKey(const std::string& method, const std::string& url,
+                                    const std::map<std::string, std::string>& requestHeaders,
+                                    const std::vector<std::string>& varyHeaders) {
+    std::string key = baseKey(method, url);
+    for (const auto& name : varyHeaders) {
+        const std::string* value = findHeader(requestHeaders, name);
+        key += "\n" + name + ":" + (value ? *value : std::string());
+    }
+    return key;
+}
+
+std::shared_ptr<const MockResponse> ResponseCache::lookup(const InterceptedRequest& request) {
+    return lookupIn(*state_, request);
+}
+
+bool ResponseCache::store(const InterceptedRequest& response, const uint8_t* body, size_t len) {
+    return storeIn(*state_, response, body, len);
+}
+
+ResponseCacheStats ResponseCache::stats() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->stats;
+}
+
+}
+}
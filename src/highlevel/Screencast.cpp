@@ -0,0 +1,266 @@
+
+
+#include "cdp/highlevel/Screencast.hpp"
+#include "cdp/core/Base64.hpp"
+#include <algorithm>
+
+namespace cdp {
+namespace highlevel {
+
+namespace {
+
+constexpr size_t kFpsWindow = 30;
+
+double elapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+}
+
+ScreencastRecorder::ScreencastRecorder(CDPClient& client)
+    : client_(client) {}
+
+ScreencastRecorder::~ScreencastRecorder() {
+    if (recording_) {
+        stop();
+    }
+}
+
+Result<void> ScreencastRecorder::start(const ScreencastOptions& options) {
+    if (recording_) {
+        return Result<void>::success();
+    }
+
+    options_ = options;
+    options_.bufferFrames = (std::max)(options_.bufferFrames, size_t(1));
+    options_.maxPendingFrames = (std::max)(options_.maxPendingFrames, size_t(1));
+
+    {
+        std::lock_guard<std::mutex> lock(ringMutex_);
+        ring_.assign(options_.bufferFrames, nullptr);
+        ringHead_ = 0;
+        ringSize_ = 0;
+        recentDecodes_.clear();
+        framesDecoded_ = 0;
+        captureLatencyTotalMs_ = 0;
+        decodeLatencyTotalMs_ = 0;
+        decodeLatencyMaxMs_ = 0;
+    }
+    framesReceived_ = 0;
+    framesDropped_ = 0;
+    framesEvicted_ = 0;
+    *ackErrors_ = 0;
+
+    recording_ = true;
+    decoder_ = std::thread(&ScreencastRecorder::decodeLoop, this);
+
+    frameToken_ = client_.connection().onEventScoped("Page.screencastFrame", [this](const CDPEvent& event) {
+        handleFrame(event);
+    });
+
+    auto resp = client_.Page.startScreencast(options_.format, options_.quality,
+                                             options_.maxWidth, options_.maxHeight,
+                                             options_.everyNthFrame);
+    if (resp.hasError) {
+        stop();
+        return Result<void>::failure(resp.errorCode, resp.errorMessage);
+    }
+
+    return Result<void>::success();
+}
+
+Result<void> ScreencastRecorder::stop() {
+    if (!recording_) {
+        return Result<void>::success();
+    }
+
+    CDPResponse resp;
+    if (client_.isConnected()) {
+        resp = client_.Page.stopScreencast();
+    }
+    frameToken_.release();
+
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        recording_ = false;
+    }
+    pendingCv_.notify_all();
+    if (decoder_.joinable()) {
+        decoder_.join();
+    }
+
+    if (resp.hasError) {
+        return Result<void>::failure(resp.errorCode, resp.errorMessage);
+    }
+    return Result<void>::success();
+}
+
+void ScreencastRecorder::onFrame(FrameCallback callback) {
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    callback_ = std::move(callback);
+}
+
+void ScreencastRecorder::handleFrame(const CDPEvent& event) {
+    auto receivedAt = std::chrono::steady_clock::now();
+
+    JsonObject ackParams;
+    ackParams["sessionId"] = event.params["sessionId"].getInt();
+    auto ackErrors = ackErrors_;
+    client_.connection().sendCommand("Page.screencastFrameAck", JsonValue(ackParams),
+        [ackErrors](const CDPResponse& resp) {
+            if (resp.hasError) (*ackErrors)++;
+        });
+
+    framesReceived_++;
+    if (!recording_) return;
+
+    PendingFrame frame;
+    if (const auto* data = event.params.find("data"); data && data->isString()) {
+        frame.base64 = data->asString();
+    }
+    frame.metadata = event.params["metadata"];
+    frame.receivedAt = receivedAt;
+    frame.receivedWall = std::chrono::system_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        while (pending_.size() >= options_.maxPendingFrames) {
+            pending_.pop_front();
+            framesDropped_++;
+        }
+        pending_.push_back(std::move(frame));
+    }
+    pendingCv_.notify_one();
+}
+
+void ScreencastRecorder::decodeLoop() {
+    while (true) {
+        PendingFrame pending;
+        {
+            std::unique_lock<std::mutex> lock(pendingMutex_);
+            pendingCv_.wait(lock, [this]() { return !pending_.empty() || !recording_; });
+            if (pending_.empty()) break;
+            pending = std::move(pending_.front());
+            pending_.pop_front();
+        }
+
+        auto frame = std::make_shared<ScreencastFrame>();
+        frame->data = Base64::decode(pending.base64);
+        frame->timestamp = pending.metadata["timestamp"].getNumber();
+        frame->offsetTop = pending.metadata["offsetTop"].getNumber();
+        frame->pageScaleFactor = pending.metadata["pageScaleFactor"].getNumber(1.0);
+        frame->deviceWidth = pending.metadata["deviceWidth"].getNumber();
+        frame->deviceHeight = pending.metadata["deviceHeight"].getNumber();
+        frame->scrollOffsetX = pending.metadata["scrollOffsetX"].getNumber();
+        frame->scrollOffsetY = pending.metadata["scrollOffsetY"].getNumber();
+        frame->receivedAt = pending.receivedAt;
+        frame->decodedAt = std::chrono::steady_clock::now();
+
+        double captureLatencyMs = 0;
+        if (frame->timestamp > 0) {
+            double receivedSec = std::chrono::duration<double>(
+                pending.receivedWall.time_since_epoch()).count();
+            captureLatencyMs = (std::max)(0.0, (receivedSec - frame->timestamp) * 1000.0);
+        }
+
+        store(std::move(frame), captureLatencyMs);
+    }
+}
+
+void ScreencastRecorder::store(std::shared_ptr<ScreencastFrame> frame, double captureLatencyMs) {
+    FrameCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(ringMutex_);
+        frame->sequence = nextSequence_++;
+
+        size_t slot = (ringHead_ + ringSize_) % ring_.size();
+        if (ringSize_ == ring_.size()) {
+            ringHead_ = (ringHead_ + 1) % ring_.size();
+            framesEvicted_++;
+        } else {
+            ringSize_++;
+        }
+        ring_[slot] = frame;
+
+        double latency = elapsedMs(frame->receivedAt, frame->decodedAt);
+        framesDecoded_++;
+        decodeLatencyTotalMs_ += latency;
+        captureLatencyTotalMs_ += captureLatencyMs;
+        decodeLatencyMaxMs_ = (std::max)(decodeLatencyMaxMs_, latency);
+
+        recentDecodes_.push_back(frame->decodedAt);
+        if (recentDecodes_.size() > kFpsWindow) {
+            recentDecodes_.pop_front();
+        }
+        callback = callback_;
+    }
+    ringCv_.notify_all();
+
+    if (callback) {
+        callback(ScreencastFramePtr(frame));
+    }
+}
+
+ScreencastFramePtr ScreencastRecorder::latestFrame() const {
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    if (ringSize_ == 0) return nullptr;
+    return ring_[(ringHead_ + ringSize_ - 1) % ring_.size()];
+}
+
+ScreencastFramePtr ScreencastRecorder::waitForFrame(uint64_t afterSequence, int timeoutMs) const {
+    std::unique_lock<std::mutex> lock(ringMutex_);
+    auto newest = [this]() -> ScreencastFramePtr {
+        if (ringSize_ == 0) return nullptr;
+        return ring_[(ringHead_ + ringSize_ - 1) % ring_.size()];
+    };
+    ringCv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&]() {
+        auto frame = newest();
+        return frame && frame->sequence > afterSequence;
+    });
+    auto frame = newest();
+    if (frame && frame->sequence > afterSequence) return frame;
+    return nullptr;
+}
+
+std::vector<ScreencastFramePtr> ScreencastRecorder::frames() const {
+    return framesSince(0);
+}
+
+std::vector<ScreencastFramePtr> ScreencastRecorder::framesSince(uint64_t sequence) const {
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    std::vector<ScreencastFramePtr> result;
+    result.reserve(ringSize_);
+    for (size_t i = 0; i < ringSize_; ++i) {
+        const auto& frame = ring_[(ringHead_ + i) % ring_.size()];
+        if (frame->sequence > sequence) {
+            result.push_back(frame);
+        }
+    }
+    return result;
+}
+
+ScreencastStats ScreencastRecorder::stats() const {
+    ScreencastStats s;
+    s.framesReceived = framesReceived_;
+    s.framesDropped = framesDropped_;
+    s.framesEvicted = framesEvicted_;
+    s.ackErrors = *ackErrors_;
+
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    s.framesDecoded = framesDecoded_;
+    if (framesDecoded_ > 0) {
+        s.avgCaptureLatencyMs = captureLatencyTotalMs_ / static_cast<double>(framesDecoded_);
+        s.avgDecodeLatencyMs = decodeLatencyTotalMs_ / static_cast<double>(framesDecoded_);
+        s.maxDecodeLatencyMs = decodeLatencyMaxMs_;
+    }
+    if (recentDecodes_.size() >= 2) {
+        double spanMs = elapsedMs(recentDecodes_.front(), recentDecodes_.back());
+        if (spanMs > 0) {
+            s.fps = static_cast<double>(recentDecodes_.size() - 1) * 1000.0 / spanMs;
+        }
+    }
+    return s;
+}
+
+}
+}
@@ -0,0 +1,319 @@
+
+
+#include "cdp/highlevel/StreamReader.hpp"
+#include "cdp/core/Base64.hpp"
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+namespace cdp {
+namespace highlevel {
+
+namespace {
+
+struct StreamChunk {
+    std::string data;
+    bool base64Encoded = false;
+    bool eof = false;
+    bool failed = false;
+    std::string errorMessage;
+};
+
+
+struct StreamReadState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::map<int64_t, StreamChunk> completed;
+};
+
+
+struct AsyncStreamState {
+    CDPConnection* connection = nullptr;
+    std::string handle;
+    StreamSink sink;
+    StreamDoneCallback done;
+    StreamReadOptions options;
+
+    std::mutex mutex;
+    std::map<int64_t, StreamChunk> completed;
+    int64_t nextSeq = 0;
+    int64_t nextToWrite = 0;
+    int64_t totalBytes = 0;
+    bool eofSeen = false;
+    bool finished = false;
+};
+
+void finishAsync(const std::shared_ptr<AsyncStreamState>& state, const Result<int64_t>& result) {
+    if (state->options.closeWhenDone) {
+        JsonObject params;
+        params["handle"] = state->handle;
+        state->connection->sendCommand("IO.close", JsonValue(params));
+    }
+    if (state->done) state->done(result);
+}
+
+void issueAsyncReads(const std::shared_ptr<AsyncStreamState>& state);
+
+void drainAsync(const std::shared_ptr<AsyncStreamState>& state) {
+    while (true) {
+        StreamChunk chunk;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->finished) return;
+            auto it = state->completed.find(state->nextToWrite);
+            if (it == state->completed.end()) break;
+            chunk = std::move(it->second);
+            state->completed.erase(it);
+            state->nextToWrite++;
+        }
+
+        std::optional<Error> failure;
+        if (chunk.failed) {
+            failure = Error(ErrorCode::ProtocolError, "IO.read failed: " + chunk.errorMessage);
+        } else if (!chunk.data.empty()) {
+            bool accepted = true;
+            if (chunk.base64Encoded) {
+                accepted = Base64::decodeTo(chunk.data, [&](const uint8_t* data, size_t length) {
+                    state->totalBytes += static_cast<int64_t>(length);
+                    return state->sink(data, length);
+                });
+            } else {
+                state->totalBytes += static_cast<int64_t>(chunk.data.size());
+                accepted = state->sink(reinterpret_cast<const uint8_t*>(chunk.data.data()), chunk.data.size());
+            }
+            if (!accepted) failure = Error::cancelled();
+        }
+
+        if (failure || chunk.eof) {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finished = true;
+                state->completed.clear();
+            }
+            if (failure) {
+                finishAsync(state, *failure);
+            } else {
+                finishAsync(state, state->totalBytes);
+            }
+            return;
+        }
+    }
+    issueAsyncReads(state);
+}
+
+void issueAsyncReads(const std::shared_ptr<AsyncStreamState>& state) {
+    const int maxInFlight = (std::max)(state->options.maxInFlight, 1);
+    const int chunkSize = (std::max)(state->options.chunkSize, 4096);
+
+    std::vector<int64_t> toIssue;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->finished || state->eofSeen) return;
+        while (state->nextSeq - state->nextToWrite < maxInFlight) {
+            toIssue.push_back(state->nextSeq++);
+        }
+    }
+
+    for (int64_t seq : toIssue) {
+        JsonObject params;
+        params["handle"] = state->handle;
+        params["size"] = chunkSize;
+        state->connection->sendCommand("IO.read", JsonValue(params), [state, seq](const CDPResponse& resp) {
+            StreamChunk chunk;
+            if (resp.hasError) {
+                chunk.failed = true;
+                chunk.errorMessage = resp.errorMessage;
+            } else {
+                if (auto* data = resp.result.find("data"); data && data->isString()) {
+                    chunk.data = data->asString();
+                }
+                chunk.base64Encoded = resp.result["base64Encoded"].getBool(false);
+                chunk.eof = resp.result["eof"].getBool(false);
+            }
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (chunk.eof) state->eofSeen = true;
+                state->completed.emplace(seq, std::move(chunk));
+            }
+            drainAsync(state);
+        });
+    }
+}
+
+}
+
+Result<int64_t> StreamReader::read(const std::string& handle, const StreamSink& sink,
+                                   const StreamReadOptions& options) {
+    if (handle.empty()) {
+        return Error(ErrorCode::InvalidArgument, "Stream handle is empty");
+    }
+    if (connection_.isMessageThread()) {
+        return Error(ErrorCode::Internal,
+                     "StreamReader::read() called from message thread - would deadlock");
+    }
+
+    const int maxInFlight = (std::max)(options.maxInFlight, 1);
+    const int chunkSize = (std::max)(options.chunkSize, 4096);
+    auto state = std::make_shared<StreamReadState>();
+
+    int64_t nextSeq = 0;
+    int64_t nextToWrite = 0;
+    int64_t totalBytes = 0;
+    std::optional<Error> failure;
+
+    auto issueRead = [&]() {
+        int64_t seq = nextSeq++;
+        JsonObject params;
+        params["handle"] = handle;
+        params["size"] = chunkSize;
+        connection_.sendCommand("IO.read", JsonValue(params), [state, seq](const CDPResponse& resp) {
+            StreamChunk chunk;
+            if (resp.hasError) {
+                chunk.failed = true;
+                chunk.errorMessage = resp.errorMessage;
+            } else {
+                if (auto* data = resp.result.find("data"); data && data->isString()) {
+                    chunk.data = data->asString();
+                }
+                chunk.base64Encoded = resp.result["base64Encoded"].getBool(false);
+                chunk.eof = resp.result["eof"].getBool(false);
+            }
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->completed.emplace(seq, std::move(chunk));
+            }
+            state->cv.notify_all();
+        });
+    };
+
+    while (true) {
+        while (nextSeq - nextToWrite < maxInFlight) {
+            issueRead();
+        }
+
+        StreamChunk chunk;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options.timeoutMs);
+        bool gotChunk = false;
+        while (!gotChunk) {
+            {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                auto ready = [&]() { return state->completed.count(nextToWrite) > 0; };
+                if (connection_.isMessageThreadRunning()) {
+                    state->cv.wait_until(lock, deadline, ready);
+                }
+                if (ready()) {
+                    auto it = state->completed.find(nextToWrite);
+                    chunk = std::move(it->second);
+                    state->completed.erase(it);
+                    gotChunk = true;
+                    break;
+                }
+            }
+            if (std::chrono::steady_clock::now() >= deadline) break;
+            if (!connection_.isMessageThreadRunning()) {
+                connection_.poll(10);
+            }
+        }
+
+        if (!gotChunk) {
+            failure = Error::timeout("IO.read", options.timeoutMs);
+            break;
+        }
+        if (chunk.failed) {
+            failure = Error(ErrorCode::ProtocolError, "IO.read failed: " + chunk.errorMessage);
+            break;
+        }
+
+        if (!chunk.data.empty()) {
+            bool accepted = true;
+            if (chunk.base64Encoded) {
+                accepted = Base64::decodeTo(chunk.data, [&](const uint8_t* data, size_t length) {
+                    totalBytes += static_cast<int64_t>(length);
+                    return sink(data, length);
+                });
+            } else {
+                totalBytes += static_cast<int64_t>(chunk.data.size());
+                accepted = sink(reinterpret_cast<const uint8_t*>(chunk.data.data()), chunk.data.size());
+            }
+            if (!accepted) {
+                failure = Error::cancelled();
+                break;
+            }
+        }
+
+        ++nextToWrite;
+        if (chunk.eof) break;
+    }
+
+    if (options.closeWhenDone) {
+        JsonObject params;
+        params["handle"] = handle;
+        connection_.sendCommand("IO.close", JsonValue(params));
+    }
+
+    if (failure) return *failure;
+    return totalBytes;
+}
+
+void StreamReader::readAsync(const std::string& handle, StreamSink sink, const StreamReadOptions& options,
+                             StreamDoneCallback done) {
+    if (handle.empty()) {
+        if (done) done(Error(ErrorCode::InvalidArgument, "Stream handle is empty"));
+        return;
+    }
+
+    auto state = std::make_shared<AsyncStreamState>();
+    state->connection = &connection_;
+    state->handle = handle;
+    state->sink = std::move(sink);
+    state->done = std::move(done);
+    state->options = options;
+    issueAsyncReads(state);
+}
+
+Result<int64_t> StreamReader::readToFile(const std::string& handle, const std::string& path,
+                                         const StreamReadOptions& options) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return Error(ErrorCode::Internal, "Failed to open file for writing: " + path);
+    }
+
+    auto result = read(handle, [&file](const uint8_t* data, size_t length) {
+        file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(length));
+        return static_cast<bool>(file);
+    }, options);
+
+    if (!result) return result;
+    if (!file) {
+        return Error(ErrorCode::Internal, "Failed to write file: " + path);
+    }
+    return result;
+}
+
+Result<std::vector<uint8_t>> StreamReader::readToBytes(const std::string& handle,
+                                                       const StreamReadOptions& options) {
+    std::vector<uint8_t> bytes;
+    auto result = read(handle, [&bytes](const uint8_t* data, size_t length) {
+        bytes.insert(bytes.end(), data, data + length);
+        return true;
+    }, options);
+    if (!result) return result.error();
+    return bytes;
+}
+
+Result<std::string> StreamReader::readToString(const std::string& handle,
+                                               const StreamReadOptions& options) {
+    std::string text;
+    auto result = read(handle, [&text](const uint8_t* data, size_t length) {
+        text.append(reinterpret_cast<const char*>(data), length);
+        return true;
+    }, options);
+    if (!result) return result.error();
+    return text;
+}
+
+}
+}
@@ -0,0 +1,229 @@
+
+
+#include "cdp/highlevel/UrlMatcher.hpp"
+#include <algorithm>
+#include <queue>
+
+namespace cdp {
+namespace highlevel {
+
+namespace {
+
+constexpr std::array<uint8_t, 256> makeLowerTable() {
+    std::array<uint8_t, 256> table{};
+    for (size_t i = 0; i < 256; ++i) {
+        table[i] = static_cast<uint8_t>((i >= 'A' && i <= 'Z') ? i + 32 : i);
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> makeIdentityTable() {
+    std::array<uint8_t, 256> table{};
+    for (size_t i = 0; i < 256; ++i) {
+        table[i] = static_cast<uint8_t>(i);
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> kLower = makeLowerTable();
+constexpr std::array<uint8_t, 256> kIdentity = makeIdentityTable();
+
+std::string folded(std::string_view s, const std::array<uint8_t, 256>& fold) {
+    std::string out(s.size(), '\0');
+    for (size_t i = 0; i < s.size(); ++i) {
+        out[i] = static_cast<char>(fold[static_cast<uint8_t>(s[i])]);
+    }
+    return out;
+}
+
+inline char foldChar(char c, const std::array<uint8_t, 256>& fold) {
+    return static_cast<char>(fold[static_cast<uint8_t>(c)]);
+}
+
+bool fragmentAt(std::string_view text, size_t pos, const std::string& fragment,
+                const std::array<uint8_t, 256>& fold) {
+    for (size_t i = 0; i < fragment.size(); ++i) {
+        if (fragment[i] != '?' && fragment[i] != foldChar(text[pos + i], fold)) return false;
+    }
+    return true;
+}
+
+size_t findFragment(std::string_view text, size_t from, const std::string& fragment,
+                    const std::array<uint8_t, 256>& fold) {
+    if (fragment.size() > text.size()) return std::string_view::npos;
+    for (size_t pos = from; pos + fragment.size() <= text.size(); ++pos) {
+        if (fragmentAt(text, pos, fragment, fold)) return pos;
+    }
+    return std::string_view::npos;
+}
+
+}
+
+UrlMatcher::UrlMatcher(bool caseSensitive)
+    : caseSensitive_(caseSensitive), fold_(caseSensitive ? kIdentity : kLower) {}
+
+void UrlMatcher::add(uint64_t id, const std::string& pattern) {
+    CompiledPattern compiled;
+    compiled.id = id;
+    compiled.source = pattern;
+
+    std::string current;
+    for (char c : folded(pattern, fold_)) {
+        if (c == '*') {
+            if (!current.empty()) compiled.fragments.push_back(std::move(current));
+            current.clear();
+        } else {
+            current += c;
+        }
+    }
+    if (!current.empty()) compiled.fragments.push_back(std::move(current));
+
+    for (const auto& fragment : compiled.fragments) {
+        size_t start = 0;
+        while (start < fragment.size()) {
+            size_t end = fragment.find('?', start);
+            if (end == std::string::npos) end = fragment.size();
+            if (end - start > compiled.anchor.size()) {
+                compiled.anchor = fragment.substr(start, end - start);
+            }
+            start = end + 1;
+        }
+    }
+
+    patterns_.push_back(std::move(compiled));
+    built_ = false;
+}
+
+void UrlMatcher::clear() {
+    patterns_.clear();
+    alwaysCheck_.clear();
+    transitions_.clear();
+    outputs_.clear();
+    classOf_.fill(0);
+    classCount_ = 1;
+    built_ = false;
+}
+
+void UrlMatcher::build() {
+    alwaysCheck_.clear();
+    classOf_.fill(0);
+    classCount_ = 1;
+
+    for (uint32_t i = 0; i < patterns_.size(); ++i) {
+        const auto& anchor = patterns_[i].anchor;
+        if (anchor.empty()) {
+            alwaysCheck_.push_back(i);
+            continue;
+        }
+        for (char c : anchor) {
+            uint8_t u = static_cast<uint8_t>(c);
+            if (classOf_[u] == 0) {
+                classOf_[u] = static_cast<uint16_t>(classCount_++);
+            }
+        }
+    }
+
+    std::vector<std::vector<int32_t>> trie(1, std::vector<int32_t>(classCount_, -1));
+    outputs_.assign(1, {});
+    for (uint32_t i = 0; i < patterns_.size(); ++i) {
+        const auto& anchor = patterns_[i].anchor;
+        if (anchor.empty()) continue;
+        size_t node = 0;
+        for (char c : anchor) {
+            size_t cls = classOf_[static_cast<uint8_t>(c)];
+            if (trie[node][cls] < 0) {
+                trie[node][cls] = static_cast<int32_t>(trie.size());
+                trie.emplace_back(classCount_, -1);
+                outputs_.emplace_back();
+            }
+            node = static_cast<size_t>(trie[node][cls]);
+        }
+        outputs_[node].push_back(i);
+    }
+
+    std::vector<size_t> fail(trie.size(), 0);
+    std::queue<size_t> queue;
+    for (size_t cls = 0; cls < classCount_; ++cls) {
+        int32_t next = trie[0][cls];
+        if (next < 0) {
+            trie[0][cls] = 0;
+        } else {
+            fail[static_cast<size_t>(next)] = 0;
+            queue.push(static_cast<size_t>(next));
+        }
+    }
+    while (!queue.empty()) {
+        size_t node = queue.front();
+        queue.pop();
+        const auto& inherited = outputs_[fail[node]];
+        outputs_[node].insert(outputs_[node].end(), inherited.begin(), inherited.end());
+        for (size_t cls = 0; cls < classCount_; ++cls) {
+            int32_t next = trie[node][cls];
+            if (next < 0) {
+                trie[node][cls] = trie[fail[node]][cls];
+            } else {
+                fail[static_cast<size_t>(next)] = static_cast<size_t>(trie[fail[node]][cls]);
+                queue.push(static_cast<size_t>(next));
+            }
+        }
+    }
+
+    transitions_.assign(trie.size() * classCount_, 0);
+    for (size_t node = 0; node < trie.size(); ++node) {
+        std::copy(trie[node].begin(), trie[node].end(),
+                  transitions_.begin() + static_cast<std::ptrdiff_t>(node * classCount_));
+    }
+    built_ = true;
+}
+
+bool UrlMatcher::verify(const CompiledPattern& pattern, std::string_view text, const FoldTable& fold) {
+    size_t pos = 0;
+    for (const auto& fragment : pattern.fragments) {
+        size_t found = findFragment(text, pos, fragment, fold);
+        if (found == std::string_view::npos) return false;
+        pos = found + fragment.size();
+    }
+    return true;
+}
+
+void UrlMatcher::matchIndices(std::string_view url, std::vector<uint32_t>& indices) const {
+    indices.clear();
+    if (patterns_.empty()) return;
+
+    if (built_ && !transitions_.empty()) {
+        indices.assign(alwaysCheck_.begin(), alwaysCheck_.end());
+        size_t state = 0;
+        for (char c : url) {
+            size_t cls = classOf_[fold_[static_cast<uint8_t>(c)]];
+            state = static_cast<size_t>(transitions_[state * classCount_ + cls]);
+            const auto& hits = outputs_[state];
+            indices.insert(indices.end(), hits.begin(), hits.end());
+        }
+        std::sort(indices.begin(), indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    } else {
+        for (uint32_t i = 0; i < patterns_.size(); ++i) indices.push_back(i);
+    }
+
+    indices.erase(std::remove_if(indices.begin(), indices.end(),
+                                 [&](uint32_t index) { return !verify(patterns_[index], url, fold_); }),
+                  indices.end());
+}
+
+std::vector<uint64_t> UrlMatcher::match(std::string_view url) const {
+    std::vector<uint32_t> indices;
+    matchIndices(url, indices);
+    std::vector<uint64_t> ids;
+    ids.reserve(indices.size());
+    for (uint32_t index : indices) ids.push_back(patterns_[index].id);
+    return ids;
+}
+
+bool UrlMatcher::globMatch(std::string_view pattern, std::string_view url) {
+    UrlMatcher matcher;
+    matcher.add(0, std::string(pattern));
+    return verify(matcher.patterns_[0], url, kLower);
+}
+
+}
+}
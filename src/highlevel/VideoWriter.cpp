@@ -0,0 +1,355 @@
+
+
+#include "cdp/highlevel/VideoWriter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace cdp {
+namespace highlevel {
+
+namespace {
+
+constexpr uint32_t kAvifHasIndex = 0x10;
+constexpr uint32_t kAviifKeyframe = 0x10;
+
+constexpr uint64_t kRiffSizeOffset = 4;
+constexpr uint64_t kAvihOffset = 32;
+constexpr uint64_t kStrhOffset = 108;
+constexpr uint64_t kStrfOffset = 172;
+constexpr uint64_t kMoviSizeOffset = 216;
+constexpr uint64_t kMoviFourccOffset = 220;
+constexpr uint64_t kHeaderSize = 224;
+
+void put16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+void putFourcc(uint8_t* p, const char* fourcc) {
+    std::memcpy(p, fourcc, 4);
+}
+
+void write32At(std::ofstream& file, uint64_t offset, uint32_t value) {
+    uint8_t buf[4];
+    put32(buf, value);
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(reinterpret_cast<const char*>(buf), 4);
+}
+
+bool jpegDimensions(const uint8_t* data, size_t length, int& width, int& height) {
+    if (length < 4 || data[0] != 0xFF || data[1] != 0xD8) return false;
+    size_t pos = 2;
+    while (pos + 4 <= length) {
+        if (data[pos] != 0xFF) return false;
+        uint8_t marker = data[pos + 1];
+        if (marker == 0xFF) {
+            ++pos;
+            continue;
+        }
+        uint16_t segmentLength = static_cast<uint16_t>((data[pos + 2] << 8) | data[pos + 3]);
+        bool isSof = marker >= 0xC0 && marker <= 0xCF &&
+                     marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+        if (isSof) {
+            if (pos + 9 > length) return false;
+            height = (data[pos + 5] << 8) | data[pos + 6];
+            width = (data[pos + 7] << 8) | data[pos + 8];
+            return width > 0 && height > 0;
+        }
+        pos += 2 + segmentLength;
+    }
+    return false;
+}
+
+}
+
+MjpegAviWriter::~MjpegAviWriter() {
+    if (isOpen()) {
+        close();
+    }
+}
+
+Result<void> MjpegAviWriter::open(const std::string& path, const VideoWriterOptions& options) {
+    if (isOpen()) {
+        return Result<void>::failure(ErrorCode::InvalidArgument, "Video writer is already open");
+    }
+    if (options.fps <= 0) {
+        return Result<void>::failure(ErrorCode::InvalidArgument, "fps must be positive");
+    }
+
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+        return Result<void>::failure("Failed to open file for writing: " + path);
+    }
+
+    indexPath_ = path + ".idx.tmp";
+    index_.open(indexPath_, std::ios::binary | std::ios::trunc);
+    if (!index_) {
+        file_.close();
+        return Result<void>::failure("Failed to open index file: " + indexPath_);
+    }
+
+    path_ = path;
+    options_ = options;
+    width_ = options.width;
+    height_ = options.height;
+    position_ = 0;
+    totalChunks_ = 0;
+    framesWritten_ = 0;
+    framesSkipped_ = 0;
+    maxChunkSize_ = 0;
+    firstTimestamp_ = -1;
+    lastSlot_ = -1;
+
+    writeHeader();
+    return Result<void>::success();
+}
+
+void MjpegAviWriter::writeHeader() {
+    uint8_t header[kHeaderSize] = {};
+
+    putFourcc(header + 0, "RIFF");
+    putFourcc(header + 8, "AVI ");
+    putFourcc(header + 12, "LIST");
+    put32(header + 16, 192);
+    putFourcc(header + 20, "hdrl");
+    putFourcc(header + 24, "avih");
+    put32(header + 28, 56);
+
+    uint8_t* avih = header + kAvihOffset;
+    put32(avih + 0, static_cast<uint32_t>(1000000 / options_.fps));
+    put32(avih + 12, kAvifHasIndex);
+    put32(avih + 24, 1);
+
+    putFourcc(header + 88, "LIST");
+    put32(header + 92, 116);
+    putFourcc(header + 96, "strl");
+    putFourcc(header + 100, "strh");
+    put32(header + 104, 56);
+
+    uint8_t* strh = header + kStrhOffset;
+    putFourcc(strh + 0, "vids");
+    putFourcc(strh + 4, "MJPG");
+    put32(strh + 20, 1);
+    put32(strh + 24, static_cast<uint32_t>(options_.fps));
+    put32(strh + 40, 0xFFFFFFFFu);
+
+    putFourcc(header + 164, "strf");
+    put32(header + 168, 40);
+
+    uint8_t* strf = header + kStrfOffset;
+    put32(strf + 0, 40);
+    put16(strf + 12, 1);
+    put16(strf + 14, 24);
+    putFourcc(strf + 16, "MJPG");
+
+    putFourcc(header + 212, "LIST");
+    putFourcc(header + kMoviFourccOffset, "movi");
+
+    file_.write(reinterpret_cast<const char*>(header), sizeof(header));
+    position_ = kHeaderSize;
+}
+
+Result<void> MjpegAviWriter::writeChunk(const uint8_t* data, uint32_t length) {
+    uint64_t padded = length + (length & 1u);
+    if (static_cast<int64_t>(position_ + 8 + padded + 16ull * (totalChunks_ + 1)) > options_.maxFileBytes) {
+        return Result<void>::failure(ErrorCode::InvalidArgument, "Video file size limit reached");
+    }
+
+    uint8_t chunkHeader[8];
+    putFourcc(chunkHeader, "00dc");
+    put32(chunkHeader + 4, length);
+    file_.write(reinterpret_cast<const char*>(chunkHeader), 8);
+    if (length > 0) {
+        file_.write(reinterpret_cast<const char*>(data), length);
+        if (length & 1u) file_.put('\0');
+    }
+
+    uint8_t entry[16];
+    putFourcc(entry, "00dc");
+    put32(entry + 4, length > 0 ? kAviifKeyframe : 0);
+    put32(entry + 8, static_cast<uint32_t>(position_ - kMoviFourccOffset));
+    put32(entry + 12, length);
+    index_.write(reinterpret_cast<const char*>(entry), sizeof(entry));
+
+    position_ += 8 + padded;
+    totalChunks_++;
+    maxChunkSize_ = (std::max)(maxChunkSize_, length);
+
+    if (!file_ || !index_) {
+        return Result<void>::failure("Failed to write video frame to " + path_);
+    }
+    return Result<void>::success();
+}
+
+Result<void> MjpegAviWriter::writeFrame(const uint8_t* jpeg, size_t length, double timestamp) {
+    if (!isOpen()) {
+        return Result<void>::failure(ErrorCode::InvalidArgument, "Video writer is not open");
+    }
+    if (length == 0 || length > 0xFFFFFFF0u) {
+        return Result<void>::failure(ErrorCode::InvalidArgument, "Invalid frame size");
+    }
+
+    if (width_ <= 0 || height_ <= 0) {
+        int w = 0;
+        int h = 0;
+        if (!jpegDimensions(jpeg, length, w, h)) {
+            return Result<void>::failure(ErrorCode::InvalidArgument, "Frame is not a baseline/progressive JPEG");
+        }
+        width_ = w;
+        height_ = h;
+    }
+
+    int64_t slot = lastSlot_ + 1;
+    if (options_.honorTimestamps && timestamp > 0) {
+        if (firstTimestamp_ < 0) firstTimestamp_ = timestamp;
+        slot = std::llround((timestamp - firstTimestamp_) * options_.fps);
+        if (slot <= lastSlot_) {
+            framesSkipped_++;
+            return Result<void>::success();
+        }
+    }
+
+    while (lastSlot_ >= 0 && lastSlot_ + 1 < slot) {
+        auto repeat = writeChunk(nullptr, 0);
+        if (!repeat) return repeat;
+        lastSlot_++;
+    }
+
+    auto result = writeChunk(jpeg, static_cast<uint32_t>(length));
+    if (!result) return result;
+    lastSlot_ = slot;
+    framesWritten_++;
+    return Result<void>::success();
+}
+
+void MjpegAviWriter::patchHeader() {
+    uint64_t moviEnd = position_;
+    write32At(file_, kMoviSizeOffset, static_cast<uint32_t>(moviEnd - kMoviFourccOffset));
+
+    double seconds = static_cast<double>(totalChunks_) / options_.fps;
+    uint32_t bytesPerSec = seconds > 0
+        ? static_cast<uint32_t>(static_cast<double>(moviEnd - kHeaderSize) / seconds)
+        : 0;
+
+    write32At(file_, kAvihOffset + 4, bytesPerSec);
+    write32At(file_, kAvihOffset + 16, totalChunks_);
+    write32At(file_, kAvihOffset + 28, maxChunkSize_);
+    write32At(file_, kAvihOffset + 32, static_cast<uint32_t>(width_));
+    write32At(file_, kAvihOffset + 36, static_cast<uint32_t>(height_));
+
+    write32At(file_, kStrhOffset + 32, totalChunks_);
+    write32At(file_, kStrhOffset + 36, maxChunkSize_);
+    uint8_t rect[8];
+    put16(rect + 0, 0);
+    put16(rect + 2, 0);
+    put16(rect + 4, static_cast<uint16_t>(width_));
+    put16(rect + 6, static_cast<uint16_t>(height_));
+    file_.seekp(static_cast<std::streamoff>(kStrhOffset + 48));
+    file_.write(reinterpret_cast<const char*>(rect), sizeof(rect));
+
+    write32At(file_, kStrfOffset + 4, static_cast<uint32_t>(width_));
+    write32At(file_, kStrfOffset + 8, static_cast<uint32_t>(height_));
+    write32At(file_, kStrfOffset + 20, static_cast<uint32_t>(width_) * static_cast<uint32_t>(height_) * 3);
+}
+
+Result<void> MjpegAviWriter::close() {
+    if (!isOpen()) {
+        return Result<void>::success();
+    }
+
+    index_.close();
+
+    uint8_t idxHeader[8];
+    putFourcc(idxHeader, "idx1");
+    put32(idxHeader + 4, totalChunks_ * 16);
+    file_.write(reinterpret_cast<const char*>(idxHeader), 8);
+
+    std::ifstream index(indexPath_, std::ios::binary);
+    std::vector<char> buffer(64 * 1024);
+    while (index) {
+        index.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        auto got = index.gcount();
+        if (got > 0) file_.write(buffer.data(), got);
+    }
+    index.close();
+    std::remove(indexPath_.c_str());
+
+    uint64_t fileEnd = position_ + 8 + static_cast<uint64_t>(totalChunks_) * 16;
+    write32At(file_, kRiffSizeOffset, static_cast<uint32_t>(fileEnd - 8));
+    patchHeader();
+
+    bool ok = static_cast<bool>(file_);
+    file_.close();
+    if (!ok) {
+        return Result<void>::failure("Failed to finalize video file: " + path_);
+    }
+    return Result<void>::success();
+}
+
+
+ScreencastVideoRecorder::~ScreencastVideoRecorder() {
+    stop();
+}
+
+Result<void> ScreencastVideoRecorder::start(const std::string& path,
+                                            const VideoWriterOptions& videoOptions,
+                                            const ScreencastOptions& screencastOptions) {
+    if (screencastOptions.format != "jpeg") {
+        return Result<void>::failure(ErrorCode::InvalidArgument, "Video recording requires jpeg screencast frames");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        auto opened = writer_.open(path, videoOptions);
+        if (!opened) return opened;
+        lastError_.clear();
+    }
+
+    recorder_.onFrame([this](const ScreencastFramePtr& frame) {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        if (!writer_.isOpen()) return;
+        auto result = writer_.writeFrame(frame->data.data(), frame->data.size(), frame->timestamp);
+        if (!result) lastError_ = result.error().message;
+    });
+
+    auto started = recorder_.start(screencastOptions);
+    if (!started) {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        writer_.close();
+        return started;
+    }
+    return Result<void>::success();
+}
+
+Result<void> ScreencastVideoRecorder::stop() {
+    auto stopped = recorder_.stop();
+    recorder_.onFrame(nullptr);
+
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    auto closed = writer_.close();
+    if (!stopped) return stopped;
+    return closed;
+}
+
+uint32_t ScreencastVideoRecorder::framesWritten() const {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    return writer_.framesWritten();
+}
+
+std::string ScreencastVideoRecorder::lastError() const {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    return lastError_;
+}
+
+}
+}
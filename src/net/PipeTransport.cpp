@@ -0,0 +1,201 @@
+
+
+#include "cdp/net/PipeTransport.hpp"
+#include "cdp/core/Cbor.hpp"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/uio.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace cdp {
+
+#if !defined(_WIN32)
+
+namespace {
+
+
+void ignoreSigpipe() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        struct sigaction current {};
+        if (sigaction(SIGPIPE, nullptr, &current) == 0 && current.sa_handler == SIG_DFL) {
+            signal(SIGPIPE, SIG_IGN);
+        }
+    });
+}
+
+}
+
+PipeTransport::PipeTransport(int readFd, int writeFd, WireFormat format)
+    : readFd_(readFd), writeFd_(writeFd), format_(format) {
+    ignoreSigpipe();
+    if (readFd_ >= 0) {
+        fcntl(readFd_, F_SETFL, fcntl(readFd_, F_GETFL) | O_NONBLOCK);
+    }
+    connected_ = readFd_ >= 0 && writeFd_ >= 0;
+}
+
+PipeTransport::~PipeTransport() {
+    close();
+}
+
+bool PipeTransport::send(const std::string& message) {
+    if (!connected_.load()) return false;
+
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    char terminator = '\0';
+    iovec parts[2];
+    parts[0].iov_base = const_cast<char*>(message.data());
+    parts[0].iov_len = message.size();
+    parts[1].iov_base = &terminator;
+    parts[1].iov_len = 1;
+
+    iovec* next = parts;
+    int remaining = format_ == WireFormat::Cbor ? 1 : 2;
+    while (remaining > 0) {
+        ssize_t n = ::writev(writeFd_, next, remaining);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            fail(std::string("Pipe write failed: ") + std::strerror(errno));
+            return false;
+        }
+
+        size_t advanced = static_cast<size_t>(n);
+        while (remaining > 0 && advanced >= next->iov_len) {
+            advanced -= next->iov_len;
+            ++next;
+            --remaining;
+        }
+        if (remaining > 0) {
+            next->iov_base = static_cast<char*>(next->iov_base) + advanced;
+            next->iov_len -= advanced;
+        }
+    }
+    return true;
+}
+
+int PipeTransport::pollAll(int timeoutMs) {
+    if (!connected_.load()) return 0;
+
+    std::lock_guard<std::mutex> lock(recvMutex_);
+    pollfd pfd{readFd_, POLLIN, 0};
+    int ready = ::poll(&pfd, 1, timeoutMs);
+    if (ready <= 0) return 0;
+
+    bool closed = false;
+    char chunk[64 * 1024];
+    while (true) {
+        ssize_t n = ::read(readFd_, chunk, sizeof(chunk));
+        if (n > 0) {
+            buffer_.append(chunk, static_cast<size_t>(n));
+            if (static_cast<size_t>(n) < sizeof(chunk)) break;
+        } else if (n == 0) {
+            closed = true;
+            break;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            fail(std::string("Pipe read failed: ") + std::strerror(errno));
+            return 0;
+        }
+    }
+    int count = dispatchFrames();
+    if (count < 0) {
+        fail("Malformed CBOR envelope on pipe");
+        return 0;
+    }
+
+    if (buffer_.size() > maxMessageSize_) {
+        fail("Pipe message exceeds maximum size");
+    } else if (closed) {
+        fail("Pipe closed by browser");
+    }
+    return count;
+}
+
+int PipeTransport::dispatchFrames() {
+    int count = 0;
+    size_t start = 0;
+
+    if (format_ == WireFormat::Cbor) {
+        
+        while (start < buffer_.size()) {
+            int64_t size = Cbor::messageSize(reinterpret_cast<const uint8_t*>(buffer_.data()) + start,
+                                             buffer_.size() - start);
+            if (size < 0) return -1;
+            if (size == 0 || static_cast<size_t>(size) > buffer_.size() - start) break;
+            emitMessage(buffer_.substr(start, static_cast<size_t>(size)));
+            start += static_cast<size_t>(size);
+            count++;
+        }
+    } else {
+        size_t end;
+        while ((end = buffer_.find('\0', (std::max)(start, scanned_))) != std::string::npos) {
+            emitMessage(buffer_.substr(start, end - start));
+            start = end + 1;
+            count++;
+        }
+    }
+
+    buffer_.erase(0, start);
+    scanned_ = buffer_.size();
+    return count;
+}
+
+void PipeTransport::close() {
+    connected_ = false;
+    std::scoped_lock lock(sendMutex_, recvMutex_);
+    if (readFd_ >= 0) {
+        ::close(readFd_);
+        readFd_ = -1;
+    }
+    if (writeFd_ >= 0) {
+        ::close(writeFd_);
+        writeFd_ = -1;
+    }
+    buffer_.clear();
+    scanned_ = 0;
+}
+
+void PipeTransport::fail(const std::string& reason) {
+    if (connected_.exchange(false)) {
+        emitClose(reason);
+    }
+}
+
+#else
+
+PipeTransport::PipeTransport(int readFd, int writeFd, WireFormat format)
+    : readFd_(readFd), writeFd_(writeFd), format_(format) {}
+
+PipeTransport::~PipeTransport() = default;
+
+bool PipeTransport::send(const std::string&) {
+    return false;
+}
+
+int PipeTransport::pollAll(int) {
+    return 0;
+}
+
+void PipeTransport::close() {
+    connected_ = false;
+}
+
+void PipeTransport::fail(const std::string& reason) {
+    if (connected_.exchange(false)) {
+        emitClose(reason);
+    }
+}
+
+#endif
+
+}
@@ -0,0 +1,304 @@
+
+
+#include "cdp/net/SessionTransport.hpp"
+#include "cdp/core/Cbor.hpp"
+#include "cdp/core/Json.hpp"
+#include <algorithm>
+#include <chrono>
+#include <string_view>
+
+namespace cdp {
+
+namespace {
+
+const std::string kSessionKey = "sessionId";
+
+std::string jsonSessionId(const std::string& message) {
+    static const std::string key = "\"sessionId\":\"";
+    size_t end = message.find_last_not_of(" \t\r\n");
+    if (end == std::string::npos || end < 2 || message[end] != '}' || message[end - 1] != '"') return "";
+    size_t at = message.rfind(key, end);
+    if (at == std::string::npos || at == 0) return "";
+    size_t before = message.find_last_not_of(" \t\r\n", at - 1);
+    if (before == std::string::npos || (message[before] != ',' && message[before] != '{')) return "";
+    size_t begin = at + key.size();
+    if (begin > end - 1) return "";
+    std::string_view id(message.data() + begin, end - 1 - begin);
+    if (id.find('"') != std::string_view::npos || id.find('\\') != std::string_view::npos) return "";
+    return std::string(id);
+}
+
+std::string cborSessionId(const std::string& message) {
+    static const std::string key = std::string(1, '\x69') + kSessionKey;
+    if (message.size() < key.size() + 2 || static_cast<uint8_t>(message.back()) != 0xff) return "";
+    size_t at = message.rfind(key);
+    if (at == std::string::npos) return "";
+
+    size_t head = at + key.size();
+    uint8_t initial = static_cast<uint8_t>(message[head]);
+    if ((initial & 0xe0) != 0x60) return "";
+    size_t length = initial & 0x1f;
+    size_t begin = head + 1;
+    if (length == 24) {
+        if (begin >= message.size()) return "";
+        length = static_cast<uint8_t>(message[begin]);
+        begin++;
+    } else if (length > 24) {
+        return "";
+    }
+    if (begin + length != message.size() - 1) return "";
+    return message.substr(begin, length);
+}
+
+std::string detachedSessionId(const std::string& message, WireFormat format) {
+    if (message.find("Target.detachedFromTarget") == std::string::npos) return "";
+    try {
+        JsonValue json = format == WireFormat::Cbor ? Cbor::decode(message) : JsonValue::parse(message);
+        if (json["method"].getString() != "Target.detachedFromTarget") return "";
+        return json["params"]["sessionId"].getString();
+    } catch (const std::exception&) {
+        return "";
+    }
+}
+
+}
+
+std::shared_ptr<SessionRouter> SessionRouter::create(std::unique_ptr<Transport> root) {
+    if (!root) return nullptr;
+    std::shared_ptr<SessionRouter> router(new SessionRouter(std::move(root)));
+    std::weak_ptr<SessionRouter> weak = router;
+
+    TransportCallbacks callbacks;
+    callbacks.onMessage = [weak](const std::string& message) {
+        if (auto self = weak.lock()) self->route(message);
+    };
+    callbacks.onClose = [weak](const std::string& reason) {
+        if (auto self = weak.lock()) self->closeAll(reason);
+    };
+    router->root_->setCallbacks(callbacks);
+    return router;
+}
+
+SessionRouter::~SessionRouter() {
+    root_->setCallbacks(TransportCallbacks{});
+    root_->close();
+}
+
+std::unique_ptr<Transport> SessionRouter::open(const std::string& sessionId) {
+    if (!root_->isConnected()) return nullptr;
+
+    auto channel = std::make_shared<Channel>();
+    {
+        std::lock_guard<std::mutex> lock(channelsMutex_);
+        auto& slot = channels_[sessionId];
+        if (slot) return nullptr;
+        slot = channel;
+    }
+    return std::unique_ptr<Transport>(new SessionTransport(shared_from_this(), sessionId, std::move(channel)));
+}
+
+size_t SessionRouter::sessionCount() const {
+    std::lock_guard<std::mutex> lock(channelsMutex_);
+    return channels_.size();
+}
+
+void SessionRouter::close() {
+    closeAll("Transport closed");
+    root_->close();
+}
+
+std::string SessionRouter::sessionIdOf(const std::string& message, WireFormat format) {
+    return format == WireFormat::Cbor ? cborSessionId(message) : jsonSessionId(message);
+}
+
+std::string SessionRouter::withSessionId(const std::string& message, const std::string& sessionId,
+                                         WireFormat format) {
+    if (sessionId.empty()) return message;
+
+    if (format == WireFormat::Cbor) {
+        bool framed = message.size() >= 9 && message.compare(0, 3, "\xd8\x18\x5a") == 0 &&
+                      static_cast<uint8_t>(message[7]) == 0xbf && static_cast<uint8_t>(message.back()) == 0xff;
+        if (!framed) {
+            JsonValue json = Cbor::decode(message);
+            json.asObject()[kSessionKey] = JsonValue(sessionId);
+            return Cbor::encode(json, Cbor::commandOptions(json.getStringAt("method")));
+        }
+        std::string out;
+        out.reserve(message.size() + sessionId.size() + 16);
+        out.append(message, 0, message.size() - 1);
+        Cbor::appendString(out, kSessionKey);
+        Cbor::appendString(out, sessionId);
+        out.push_back(static_cast<char>(0xff));
+        size_t length = out.size() - 7;
+        for (size_t i = 0; i < 4; ++i) {
+            out[3 + i] = static_cast<char>(length >> (24 - 8 * i));
+        }
+        return out;
+    }
+
+    size_t end = message.find_last_of('}');
+    if (end == std::string::npos) return message;
+    size_t last = message.find_last_not_of(" \t\r\n", end == 0 ? 0 : end - 1);
+    bool empty = last == std::string::npos || message[last] == '{';
+    std::string out;
+    out.reserve(message.size() + sessionId.size() + 16);
+    out.append(message, 0, end);
+    out += empty ? "\"sessionId\":" : ",\"sessionId\":";
+    out += JsonValue(sessionId).serialize();
+    out += '}';
+    return out;
+}
+
+void SessionRouter::route(const std::string& message) {
+    WireFormat format = root_->wireFormat();
+    std::string sessionId = sessionIdOf(message, format);
+
+    std::shared_ptr<Channel> channel;
+    {
+        std::lock_guard<std::mutex> lock(channelsMutex_);
+        auto it = channels_.find(sessionId);
+        if (it != channels_.end()) channel = it->second;
+    }
+    if (channel) {
+        std::lock_guard<std::mutex> lock(channel->mutex);
+        channel->queue.push_back(message);
+        channel->cv.notify_all();
+    }
+
+    if (sessionId.empty()) {
+        std::string detached = detachedSessionId(message, format);
+        if (!detached.empty()) closeChannel(detached, "Session detached");
+    }
+}
+
+void SessionRouter::closeChannel(const std::string& sessionId, const std::string& reason) {
+    std::shared_ptr<Channel> channel;
+    {
+        std::lock_guard<std::mutex> lock(channelsMutex_);
+        auto it = channels_.find(sessionId);
+        if (it == channels_.end()) return;
+        channel = std::move(it->second);
+        channels_.erase(it);
+    }
+    std::lock_guard<std::mutex> lock(channel->mutex);
+    channel->closed = true;
+    channel->closeReason = reason;
+    channel->cv.notify_all();
+}
+
+void SessionRouter::closeAll(const std::string& reason) {
+    std::map<std::string, std::shared_ptr<Channel>> channels;
+    {
+        std::lock_guard<std::mutex> lock(channelsMutex_);
+        channels.swap(channels_);
+    }
+    for (auto& [id, channel] : channels) {
+        std::lock_guard<std::mutex> lock(channel->mutex);
+        channel->closed = true;
+        channel->closeReason = reason;
+        channel->cv.notify_all();
+    }
+}
+
+void SessionRouter::detach(const std::string& sessionId, const std::shared_ptr<Channel>& channel) {
+    {
+        std::lock_guard<std::mutex> lock(channelsMutex_);
+        auto it = channels_.find(sessionId);
+        if (it != channels_.end() && it->second == channel) channels_.erase(it);
+    }
+    std::lock_guard<std::mutex> lock(channel->mutex);
+    channel->closed = true;
+    channel->queue.clear();
+    channel->cv.notify_all();
+}
+
+bool SessionRouter::pump(int timeoutMs) {
+    std::unique_lock<std::mutex> lock(pumpMutex_, std::try_to_lock);
+    if (!lock) return false;
+    if (!root_->isConnected()) {
+        lock.unlock();
+        closeAll("Transport closed");
+        return true;
+    }
+    root_->pollAll(timeoutMs);
+    return true;
+}
+
+
+SessionTransport::~SessionTransport() {
+    close();
+}
+
+bool SessionTransport::isConnected() const {
+    if (!open_.load() || !router_->isConnected()) return false;
+    std::lock_guard<std::mutex> lock(channel_->mutex);
+    return !channel_->closed || !channel_->queue.empty();
+}
+
+bool SessionTransport::send(const std::string& message) {
+    if (!isConnected()) return false;
+    try {
+        return router_->root_->send(SessionRouter::withSessionId(message, sessionId_, wireFormat()));
+    } catch (const std::exception& e) {
+        emitError(std::string("Failed to add session id: ") + e.what());
+        return false;
+    }
+}
+
+int SessionTransport::pollAll(int timeoutMs) {
+    if (!open_.load()) return 0;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds((std::max)(timeoutMs, 0));
+    while (true) {
+        int count = drain();
+        if (count > 0 || !open_.load()) return count;
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        int slice = static_cast<int>(std::clamp<int64_t>(remaining, 0, 10));
+        if (!router_->pump(slice)) {
+            std::unique_lock<std::mutex> lock(channel_->mutex);
+            channel_->cv.wait_for(lock, std::chrono::milliseconds(slice),
+                                  [this] { return !channel_->queue.empty() || channel_->closed; });
+        }
+        if (std::chrono::steady_clock::now() >= deadline) return drain();
+    }
+}
+
+int SessionTransport::drain() {
+    size_t pending;
+    {
+        std::lock_guard<std::mutex> lock(channel_->mutex);
+        pending = channel_->queue.size();
+    }
+
+    int count = 0;
+    for (; pending > 0; --pending) {
+        std::string message;
+        {
+            std::lock_guard<std::mutex> lock(channel_->mutex);
+            if (channel_->queue.empty()) break;
+            message = std::move(channel_->queue.front());
+            channel_->queue.pop_front();
+        }
+        emitMessage(message);
+        count++;
+    }
+
+    std::string reason;
+    {
+        std::lock_guard<std::mutex> lock(channel_->mutex);
+        if (!channel_->closed || !channel_->queue.empty()) return count;
+        reason = channel_->closeReason;
+    }
+    if (open_.exchange(false)) emitClose(reason);
+    return count;
+}
+
+void SessionTransport::close() {
+    if (open_.exchange(false)) {
+        router_->detach(sessionId_, channel_);
+    }
+}
+
+}
@@ -26,6 +26,14 @@ CDPClient::CDPClient(const CDPClientConfig& config) : config_(config) {
     reconnectSettings.enableHeartbeat = config_.enableHeartbeat;
     reconnectSettings.heartbeatIntervalMs = config_.heartbeatIntervalMs;
     connection_.setReconnectSettings(reconnectSettings);
+
+    WatchdogSettings watchdogSettings;
+    watchdogSettings.enabled = config_.enableWatchdog;
+    watchdogSettings.intervalMs = config_.watchdogIntervalMs;
+    watchdogSettings.deadlineMs = config_.watchdogDeadlineMs;
+    watchdogSettings.missedProbes = config_.watchdogMissedProbes;
+    watchdogSettings.reviveOnLateReply = config_.watchdogReviveOnLateReply;
+    connection_.setWatchdogSettings(watchdogSettings);
 }
 
 CDPClient::~CDPClient() {
@@ -41,7 +49,8 @@ void CDPClient::enableDomains() {
     Network.enable();
 
     
-    Page.onLoadEventFired([this](double) {
+    loadEventToken_.release();
+    loadEventToken_ = Page.onScoped("loadEventFired", [this](const CDPEvent&) {
         pageLoaded_.store(true);
     });
 }
@@ -115,6 +124,87 @@ bool CDPClient::connect(const std::string& webSocketUrl) {
     return true;
 }
 
+bool CDPClient::retarget(const std::string& webSocketUrl) {
+    lastError_.clear();
+
+    if (!connection_.retarget(webSocketUrl)) {
+        lastError_ = "Failed to retarget to WebSocket URL: " + webSocketUrl;
+        return false;
+    }
+
+    pageLoaded_.store(false);
+    enableDomains();
+    return runRetargetHooks();
+}
+
+bool CDPClient::connect(std::unique_ptr<Transport> transport) {
+    lastError_.clear();
+
+    if (!transport || !transport->isConnected()) {
+        lastError_ = "Transport is not connected";
+        return false;
+    }
+
+    if (!connection_.connect(std::move(transport))) {
+        lastError_ = "Failed to attach transport";
+        return false;
+    }
+
+    if (config_.useBackgroundThread) {
+        connection_.startMessageThread();
+    }
+    return true;
+}
+
+bool CDPClient::connectToTarget(std::unique_ptr<Transport> transport) {
+    if (!connect(std::move(transport))) {
+        return false;
+    }
+    enableDomains();
+    return true;
+}
+
+bool CDPClient::retarget(std::unique_ptr<Transport> transport) {
+    lastError_.clear();
+
+    if (!connection_.retarget(std::move(transport))) {
+        lastError_ = "Failed to retarget to transport";
+        return false;
+    }
+
+    pageLoaded_.store(false);
+    enableDomains();
+    return runRetargetHooks();
+}
+
+uint64_t CDPClient::addRetargetHook(RetargetHook hook) {
+    std::lock_guard<std::mutex> lock(retargetHooksMutex_);
+    uint64_t id = nextRetargetHook_++;
+    retargetHooks_[id] = std::move(hook);
+    return id;
+}
+
+void CDPClient::removeRetargetHook(uint64_t id) {
+    std::lock_guard<std::mutex> lock(retargetHooksMutex_);
+    retargetHooks_.erase(id);
+}
+
+bool CDPClient::runRetargetHooks() {
+    std::vector<RetargetHook> hooks;
+    {
+        std::lock_guard<std::mutex> lock(retargetHooksMutex_);
+        for (const auto& [id, hook] : retargetHooks_) hooks.push_back(hook);
+    }
+    for (const auto& hook : hooks) {
+        std::string error;
+        if (!hook(error)) {
+            lastError_ = "Retarget hook failed: " + error;
+            return false;
+        }
+    }
+    return true;
+}
+
 bool CDPClient::connectToTarget(const CDPTarget& target) {
     lastError_.clear();
 
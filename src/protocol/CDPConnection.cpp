@@ -1,7 +1,9 @@
 
 
 #include "cdp/protocol/CDPConnection.hpp"
+#include "cdp/core/Cbor.hpp"
 #include <sstream>
+#include <memory>
 
 namespace cdp {
 
@@ -109,6 +111,7 @@ CDPConnection::CDPConnection() {
 CDPConnection::~CDPConnection() {
     intentionalDisconnect_ = true;  
     stopReconnectThread();  
+    stopWatchdogThread();
     stopHeartbeatThread();
     stopMessageThread();
     disconnect();
@@ -188,6 +191,7 @@ std::string CDPConnection::getBrowserWebSocketUrl(const std::string& host, int p
 bool CDPConnection::connect(const std::string& wsUrl) {
     intentionalDisconnect_ = false;
     connectionState_ = ConnectionState::Connecting;
+    transport_.reset();
 
     if (!ws_.connect(wsUrl)) {
         connectionState_ = ConnectionState::Disconnected;
@@ -198,6 +202,14 @@ bool CDPConnection::connect(const std::string& wsUrl) {
     lastWsUrl_ = wsUrl;
     connectionState_ = ConnectionState::Connected;
     reconnectAttempts_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        targetDead_ = false;
+        deadReason_.clear();
+        watchdogProbeId_ = -1;
+    }
+    dialogOpen_ = false;
+    debuggerPaused_ = false;
 
     
     if (reconnectSettings_.enableHeartbeat && !heartbeatThreadRunning_.load()) {
@@ -205,6 +217,7 @@ bool CDPConnection::connect(const std::string& wsUrl) {
         heartbeatThreadRunning_ = true;
         heartbeatThread_ = std::thread(&CDPConnection::heartbeatThreadFunc, this);
     }
+    startWatchdogThread();
 
     
     {
@@ -246,6 +259,7 @@ bool CDPConnection::connect(const std::string& host, int port, const CDPTarget&
         }
     }
 
+    transport_.reset();
     return ws_.connect(wsUrl);
 }
 
@@ -288,6 +302,61 @@ bool CDPConnection::connectToBrowser(const std::string& host, int port) {
     return connect(wsUrl);  
 }
 
+bool CDPConnection::connect(std::unique_ptr<Transport> transport) {
+    if (!transport || !transport->isConnected()) {
+        return false;
+    }
+    intentionalDisconnect_ = false;
+
+    TransportCallbacks callbacks;
+    callbacks.onMessage = [this](const std::string& message) {
+        {
+            std::lock_guard<std::mutex> lock(activityMutex_);
+            lastActivity_ = std::chrono::steady_clock::now();
+        }
+        handleMessage(message);
+    };
+    callbacks.onClose = [this](const std::string&) {
+        connectionState_ = ConnectionState::Disconnected;
+        std::function<void()> cb;
+        {
+            std::lock_guard<std::mutex> lock(errorCallbackMutex_);
+            cb = disconnectCallback_;
+        }
+        if (cb) cb();
+    };
+    callbacks.onError = [this](const std::string& error) {
+        std::function<void(const std::string&)> cb;
+        {
+            std::lock_guard<std::mutex> lock(errorCallbackMutex_);
+            cb = errorCallback_;
+        }
+        if (cb) cb(error);
+    };
+    transport->setCallbacks(callbacks);
+
+    
+    transport_ = std::move(transport);
+    lastWsUrl_.clear();
+    connectionState_ = ConnectionState::Connected;
+    reconnectAttempts_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        targetDead_ = false;
+        deadReason_.clear();
+        watchdogProbeId_ = -1;
+    }
+    dialogOpen_ = false;
+    debuggerPaused_ = false;
+    startWatchdogThread();
+
+    {
+        std::lock_guard<std::mutex> lock(activityMutex_);
+        lastActivity_ = std::chrono::steady_clock::now();
+    }
+    return true;
+}
+
 void CDPConnection::disconnect() {
     
     intentionalDisconnect_ = true;
@@ -309,9 +378,14 @@ void CDPConnection::disconnect() {
         return;
     }
 
+    stopWatchdogThread();
     stopHeartbeatThread();
     stopMessageThread();
-    ws_.close();
+    if (transport_) {
+        transport_->close();
+    } else {
+        ws_.close();
+    }
 
     
     {
@@ -334,10 +408,66 @@ void CDPConnection::disconnect() {
     {
         std::unique_lock<std::shared_mutex> lock(eventMutex_);
         eventHandlers_.clear();
+        scopedEventHandlers_.clear();
         anyEventHandler_ = nullptr;
     }
 }
 
+bool CDPConnection::retarget(const std::string& wsUrl) {
+    if (transport_ || isMessageThread()) {
+        return false;
+    }
+
+    
+    bool threaded = messageThreadRunning_.load();
+    intentionalDisconnect_ = true;
+    connectionState_ = ConnectionState::Disconnected;
+    stopReconnectThread();
+    stopWatchdogThread();
+    stopHeartbeatThread();
+    stopMessageThread();
+    ws_.close();
+
+    failPendingCommands("Target replaced");
+
+    if (!connect(wsUrl)) {
+        return false;
+    }
+    if (threaded) {
+        startMessageThread();
+    }
+    return true;
+}
+
+bool CDPConnection::retarget(std::unique_ptr<Transport> transport) {
+    if (!transport || isMessageThread()) {
+        return false;
+    }
+
+    bool threaded = messageThreadRunning_.load();
+    intentionalDisconnect_ = true;
+    connectionState_ = ConnectionState::Disconnected;
+    stopReconnectThread();
+    stopWatchdogThread();
+    stopHeartbeatThread();
+    stopMessageThread();
+    if (transport_) {
+        transport_->close();
+    } else {
+        ws_.close();
+    }
+
+    failPendingCommands("Target replaced");
+
+    if (!connect(std::move(transport))) {
+        return false;
+    }
+    if (threaded) {
+        startMessageThread();
+    }
+    return true;
+}
+
 void CDPConnection::startMessageThread() {
     if (messageThreadRunning_.load()) return;
 
@@ -373,7 +503,7 @@ void CDPConnection::messageThreadFunc() {
     while (!stopMessageThread_.load()) {
         if (isConnected()) {
             
-            int processed = ws_.pollAll(pollTimeoutMs);
+            int processed = transport_ ? transport_->pollAll(pollTimeoutMs) : ws_.pollAll(pollTimeoutMs);
 
             if (processed > 0) {
                 
@@ -399,6 +529,24 @@ void CDPConnection::stopHeartbeatThread() {
     heartbeatThreadRunning_ = false;
 }
 
+void CDPConnection::startWatchdogThread() {
+    if (!watchdogSettings_.enabled || watchdogThreadRunning_.load()) return;
+
+    stopWatchdogThread_ = false;
+    watchdogThreadRunning_ = true;
+    watchdogThread_ = std::thread(&CDPConnection::watchdogThreadFunc, this);
+}
+
+void CDPConnection::stopWatchdogThread() {
+    if (!watchdogThreadRunning_.load()) return;
+
+    stopWatchdogThread_ = true;
+    if (watchdogThread_.joinable()) {
+        watchdogThread_.join();
+    }
+    watchdogThreadRunning_ = false;
+}
+
 void CDPConnection::stopReconnectThread() {
     
     
@@ -439,7 +587,11 @@ void CDPConnection::heartbeatThreadFunc() {
         
         if (idleMs >= reconnectSettings_.heartbeatIntervalMs / 2) {
             
-            ws_.ping("heartbeat");
+            if (transport_) {
+                transport_->ping();
+            } else {
+                ws_.ping("heartbeat");
+            }
 
             
             {
@@ -450,6 +602,60 @@ void CDPConnection::heartbeatThreadFunc() {
     }
 }
 
+void CDPConnection::watchdogThreadFunc() {
+    JsonObject params;
+    params["expression"] = "0";
+    params["returnByValue"] = true;
+    JsonValue probeParams(params);
+
+    int64_t probeId = -1;
+    std::future<void> probe;
+    int missed = 0;
+
+    while (!stopWatchdogThread_.load()) {
+        int sleepRemaining = watchdogSettings_.intervalMs;
+        const int sleepChunk = 50;
+
+        while (sleepRemaining > 0 && !stopWatchdogThread_.load()) {
+            int sleepTime = (std::min)(sleepRemaining, sleepChunk);
+            std::this_thread::sleep_for(std::chrono::milliseconds(sleepTime));
+            sleepRemaining -= sleepTime;
+        }
+
+        if (stopWatchdogThread_.load()) break;
+
+        
+        if (!isConnected() || !messageThreadRunning_.load() || targetDead_.load() || probingSuspended()) {
+            missed = 0;
+            if (!isConnected() || targetDead_.load()) probeId = -1;
+            continue;
+        }
+
+        if (probeId < 0) {
+            auto answered = std::make_shared<std::promise<void>>();
+            probe = answered->get_future();
+            probeId = sendCommand("Runtime.evaluate", probeParams, [answered](const CDPResponse&) {
+                answered->set_value();
+            });
+            if (probeId < 0) continue;
+        }
+
+        if (probe.wait_for(std::chrono::milliseconds(watchdogSettings_.deadlineMs)) == std::future_status::ready) {
+            probeId = -1;
+            missed = 0;
+            continue;
+        }
+
+        if (stopWatchdogThread_.load() || !isConnected() || probingSuspended()) continue;
+        if (++missed < (std::max)(watchdogSettings_.missedProbes, 1)) continue;
+
+        failTarget("Target unresponsive: no reply to probe after " + std::to_string(missed) +
+                   " deadlines of " + std::to_string(watchdogSettings_.deadlineMs) + "ms", probeId);
+        probeId = -1;
+        missed = 0;
+    }
+}
+
 void CDPConnection::attemptReconnect() {
     int attempt = 0;
     int delayMs = reconnectSettings_.reconnectDelayMs;
@@ -558,13 +764,108 @@ int64_t CDPConnection::sendCommand(const std::string& method, const JsonValue& p
     request.method = method;
     request.params = params;
 
-    if (callback) {
+    return dispatchCommand(id, encodeRequest(request), std::move(callback));
+}
+
+int64_t CDPConnection::sendCommandRaw(const std::string& method,
+                                       std::initializer_list<std::string_view> paramsJson,
+                                       ResponseCallback callback) {
+    if (!isConnected()) {
+        if (callback) {
+            CDPResponse errorResponse;
+            errorResponse.hasError = true;
+            errorResponse.errorMessage = "Not connected";
+            callback(errorResponse);
+        }
+        return -1;
+    }
+
+    int64_t id = nextMessageId();
+
+    std::string prefix = "{\"id\":" + std::to_string(id) + ",\"method\":" + JsonValue(method).serialize() +
+                         ",\"params\":";
+    size_t total = prefix.size() + 1;
+    for (auto part : paramsJson) total += part.size();
+
+    std::string message;
+    message.reserve(total);
+    message += prefix;
+    for (auto part : paramsJson) message.append(part.data(), part.size());
+    message += '}';
+
+    if (cborWire()) {
+        try {
+            message = Cbor::encode(JsonValue::parse(message), Cbor::commandOptions(method));
+        } catch (const std::exception& e) {
+            if (callback) {
+                CDPResponse errorResponse;
+                errorResponse.hasError = true;
+                errorResponse.errorMessage = std::string("Failed to encode message: ") + e.what();
+                callback(errorResponse);
+            }
+            return -1;
+        }
+    }
+
+    return dispatchCommand(id, message, std::move(callback));
+}
+
+int64_t CDPConnection::sendCommandRawCbor(const std::string& method,
+                                           std::initializer_list<std::string_view> paramsCbor,
+                                           ResponseCallback callback) {
+    if (!isConnected()) {
+        if (callback) {
+            CDPResponse errorResponse;
+            errorResponse.hasError = true;
+            errorResponse.errorMessage = "Not connected";
+            callback(errorResponse);
+        }
+        return -1;
+    }
+
+    int64_t id = nextMessageId();
+
+    size_t total = method.size() + 64;
+    for (auto part : paramsCbor) total += part.size();
+
+    std::string message;
+    message.reserve(total);
+    size_t outer = Cbor::beginMap(message);
+    Cbor::appendString(message, "id");
+    Cbor::appendInteger(message, id);
+    Cbor::appendString(message, "method");
+    Cbor::appendString(message, method);
+    Cbor::appendString(message, "params");
+    size_t params = Cbor::beginMap(message);
+    for (auto part : paramsCbor) message.append(part.data(), part.size());
+    Cbor::endMap(message, params);
+    Cbor::endMap(message, outer);
+
+    return dispatchCommand(id, message, std::move(callback));
+}
+
+int64_t CDPConnection::dispatchCommand(int64_t id, const std::string& message, ResponseCallback callback) {
+    std::string deadReason;
+    {
         std::lock_guard<std::mutex> lock(callbackMutex_);
-        pendingCallbacks_[id] = callback;
+        if (targetDead_.load()) {
+            deadReason = deadReason_;
+        } else if (callback) {
+            pendingCallbacks_[id] = callback;
+        }
+    }
+    if (!deadReason.empty()) {
+        if (callback) {
+            CDPResponse errorResponse;
+            errorResponse.hasError = true;
+            errorResponse.errorCode = CDPResponse::TargetCrashedCode;
+            errorResponse.errorMessage = deadReason;
+            callback(errorResponse);
+        }
+        return -1;
     }
 
-    std::string message = request.serialize();
-    if (!ws_.send(message)) {
+    if (!sendMessage(message)) {
         std::lock_guard<std::mutex> lock(callbackMutex_);
         pendingCallbacks_.erase(id);
         if (callback) {
@@ -614,11 +915,18 @@ CDPResponse CDPConnection::sendCommandSync(const std::string& method, const Json
 
     {
         std::lock_guard<std::mutex> lock(callbackMutex_);
+        if (targetDead_.load()) {
+            CDPResponse errorResponse;
+            errorResponse.hasError = true;
+            errorResponse.errorCode = CDPResponse::TargetCrashedCode;
+            errorResponse.errorMessage = deadReason_;
+            return errorResponse;
+        }
         pendingPromises_[id] = std::move(promise);
     }
 
-    std::string message = request.serialize();
-    if (!ws_.send(message)) {
+    std::string message = encodeRequest(request);
+    if (!sendMessage(message)) {
         std::lock_guard<std::mutex> lock(callbackMutex_);
         pendingPromises_.erase(id);
         CDPResponse errorResponse;
@@ -670,6 +978,14 @@ CDPResponse CDPConnection::sendCommandSync(const std::string& method, const Json
 void CDPConnection::onEvent(const std::string& method, EventCallback callback) {
     std::unique_lock<std::shared_mutex> lock(eventMutex_);
     eventHandlers_[method] = callback;
+    scopedEventHandlers_.erase(method);
+}
+
+CDPConnection::EventToken CDPConnection::onEventScoped(const std::string& method, EventCallback callback) {
+    std::unique_lock<std::shared_mutex> lock(eventMutex_);
+    eventHandlers_[method] = std::move(callback);
+    scopedEventHandlers_.insert(method);
+    return EventToken(this, method);
 }
 
 void CDPConnection::onAnyEvent(EventCallback callback) {
@@ -680,12 +996,14 @@ void CDPConnection::onAnyEvent(EventCallback callback) {
 void CDPConnection::removeEventHandler(const std::string& method) {
     std::unique_lock<std::shared_mutex> lock(eventMutex_);
     eventHandlers_.erase(method);
+    scopedEventHandlers_.erase(method);
 }
 
 void CDPConnection::removeEventHandlersByPrefix(const std::string& prefix) {
     std::unique_lock<std::shared_mutex> lock(eventMutex_);
     for (auto it = eventHandlers_.begin(); it != eventHandlers_.end(); ) {
         if (it->first.rfind(prefix, 0) == 0) {  
+            scopedEventHandlers_.erase(it->first);
             it = eventHandlers_.erase(it);
         } else {
             ++it;
@@ -693,7 +1011,102 @@ void CDPConnection::removeEventHandlersByPrefix(const std::string& prefix) {
     }
 }
 
+void CDPConnection::removeUnscopedEventHandlers() {
+    std::unique_lock<std::shared_mutex> lock(eventMutex_);
+    for (auto it = eventHandlers_.begin(); it != eventHandlers_.end(); ) {
+        if (scopedEventHandlers_.count(it->first) == 0) {
+            it = eventHandlers_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    anyEventHandler_ = nullptr;
+}
+
+std::vector<std::string> CDPConnection::eventHandlerMethods() const {
+    std::shared_lock<std::shared_mutex> lock(eventMutex_);
+    std::vector<std::string> methods;
+    methods.reserve(eventHandlers_.size());
+    for (const auto& [method, handler] : eventHandlers_) {
+        methods.push_back(method);
+    }
+    return methods;
+}
+
+size_t CDPConnection::pendingCommandCount() const {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    return pendingCallbacks_.size() + pendingPromises_.size();
+}
+
+void CDPConnection::failTarget(const std::string& reason) {
+    failTarget(reason, -1);
+}
+
+void CDPConnection::failTarget(const std::string& reason, int64_t probeId) {
+    {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        if (targetDead_.load()) {
+            watchdogProbeId_ = -1;
+            return;
+        }
+        if (probeId >= 0 && pendingCallbacks_.erase(probeId) == 0) return;
+        deadReason_ = reason;
+        targetDead_ = true;
+        watchdogProbeId_ = watchdogSettings_.reviveOnLateReply ? probeId : -1;
+    }
+
+    failPendingCommands(reason, CDPResponse::TargetCrashedCode);
+
+    std::function<void(const std::string&)> cb;
+    {
+        std::lock_guard<std::mutex> lock(errorCallbackMutex_);
+        cb = targetDeadCallback_;
+    }
+    if (cb) cb(reason);
+}
+
+std::string CDPConnection::deadReason() const {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    return deadReason_;
+}
+
+void CDPConnection::failPendingCommands(const std::string& message, int errorCode) {
+    std::map<int64_t, ResponseCallback> callbacks;
+    std::map<int64_t, std::promise<CDPResponse>> promises;
+    {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        callbacks.swap(pendingCallbacks_);
+        promises.swap(pendingPromises_);
+    }
+
+    for (auto& [id, promise] : promises) {
+        CDPResponse errorResponse;
+        errorResponse.id = id;
+        errorResponse.hasError = true;
+        errorResponse.errorCode = errorCode;
+        errorResponse.errorMessage = message;
+        try {
+            promise.set_value(errorResponse);
+        } catch (const std::future_error&) {
+            
+        }
+    }
+    for (auto& [id, callback] : callbacks) {
+        if (!callback) continue;
+        CDPResponse errorResponse;
+        errorResponse.id = id;
+        errorResponse.hasError = true;
+        errorResponse.errorCode = errorCode;
+        errorResponse.errorMessage = message;
+        callback(errorResponse);
+    }
+}
+
 void CDPConnection::poll(int timeoutMs) {
+    if (transport_) {
+        transport_->pollAll(timeoutMs);
+        return;
+    }
     ws_.poll(timeoutMs);
 }
 
@@ -708,9 +1121,21 @@ void CDPConnection::processMessages(int timeoutMs) {
     }
 }
 
+std::string CDPConnection::encodeRequest(const CDPRequest& request) const {
+    if (!cborWire()) return request.serialize();
+
+    JsonObject obj;
+    obj["id"] = static_cast<double>(request.id);
+    obj["method"] = request.method;
+    if (!request.params.isNull()) {
+        obj["params"] = request.params;
+    }
+    return Cbor::encode(JsonValue(obj), Cbor::commandOptions(request.method));
+}
+
 void CDPConnection::handleMessage(const std::string& message) {
     try {
-        JsonValue json = JsonValue::parse(message);
+        JsonValue json = cborWire() ? Cbor::decode(message) : JsonValue::parse(message);
 
         if (json.contains("id")) {
             handleResponse(json);
@@ -760,6 +1185,11 @@ void CDPConnection::handleResponse(const JsonValue& json) {
             if (callbackIt != pendingCallbacks_.end()) {
                 callback = std::move(callbackIt->second);
                 pendingCallbacks_.erase(callbackIt);
+            } else if (id == watchdogProbeId_) {
+                watchdogProbeId_ = -1;
+                targetDead_ = false;
+                deadReason_.clear();
+                return;
             }
         }
     }
@@ -801,6 +1231,22 @@ void CDPConnection::handleEvent(const JsonValue& json) {
     event.method = json["method"].asString();
     event.params = json["params"];
 
+    
+    if (event.method == "Inspector.targetCrashed") {
+        failTarget("Target crashed");
+    } else if (event.method == "Inspector.detached" &&
+               event.params["reason"].getString().find("Render process gone") != std::string::npos) {
+        failTarget("Target crashed");
+    } else if (event.method == "Page.javascriptDialogOpening") {
+        dialogOpen_ = true;
+    } else if (event.method == "Page.javascriptDialogClosed") {
+        dialogOpen_ = false;
+    } else if (event.method == "Debugger.paused") {
+        debuggerPaused_ = true;
+    } else if (event.method == "Debugger.resumed") {
+        debuggerPaused_ = false;
+    }
+
     EventCallback specificHandler;
     EventCallback anyHandler;
 
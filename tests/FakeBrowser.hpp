@@ -0,0 +1,168 @@
+// Scripted transport for tests that drive a CDPClient without Chrome.
+// Each command is answered by the responder; pushed events are delivered on
+// the next poll. FakeChrome answers enough of Target/Page for Browser pages.
+
+#pragma once
+
+#include <cdp/net/Transport.hpp>
+#include <cdp/core/Json.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cdptest {
+
+struct Command {
+    int64_t id = 0;
+    std::string method;
+    cdp::JsonValue params;
+    std::string sessionId;
+};
+
+class ScriptedTransport : public cdp::Transport {
+public:
+    // Returns the reply body, e.g. "\"result\":{}"; an empty string sends no reply.
+    using Responder = std::function<std::string(const Command&)>;
+
+    explicit ScriptedTransport(Responder responder = nullptr) : responder_(std::move(responder)) {}
+
+    static std::string result(const std::string& json = "{}") { return "\"result\":" + json; }
+    static std::string error(const std::string& message, int code = -32000) {
+        return "\"error\":{\"code\":" + std::to_string(code) + ",\"message\":\"" + message + "\"}";
+    }
+
+    bool isConnected() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return connected_;
+    }
+
+    bool send(const std::string& message) override {
+        cdp::JsonValue parsed = cdp::JsonValue::parse(message);
+        Command command;
+        command.id = parsed["id"].getInt64();
+        command.method = parsed["method"].getString();
+        command.params = parsed["params"];
+        command.sessionId = parsed["sessionId"].getString();
+
+        std::string body = responder_ ? responder_(command) : result();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!connected_) return false;
+        commands_.push_back(command);
+        if (!body.empty()) {
+            std::string reply = "{\"id\":" + std::to_string(command.id) + "," + body;
+            if (!command.sessionId.empty()) reply += ",\"sessionId\":\"" + command.sessionId + "\"";
+            inbox_.push_back(reply + "}");
+        }
+        ready_.notify_all();
+        return true;
+    }
+
+    int pollAll(int timeoutMs) override {
+        std::deque<std::string> batch;
+        bool hungUp = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                            [this] { return !inbox_.empty() || hangUp_; });
+            batch.swap(inbox_);
+            hungUp = hangUp_;
+            hangUp_ = false;
+        }
+        for (const auto& message : batch) emitMessage(message);
+        if (hungUp) emitClose("Connection lost");
+        return static_cast<int>(batch.size());
+    }
+
+    void close() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connected_ = false;
+    }
+
+    void push(const std::string& message) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        inbox_.push_back(message);
+        ready_.notify_all();
+    }
+
+    void hangUp() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connected_ = false;
+        hangUp_ = true;
+        ready_.notify_all();
+    }
+
+    std::vector<Command> commands() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return commands_;
+    }
+
+    size_t count(const std::string& method) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t n = 0;
+        for (const auto& command : commands_) n += command.method == method;
+        return n;
+    }
+
+private:
+    Responder responder_;
+    mutable std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::string> inbox_;
+    std::vector<Command> commands_;
+    bool connected_ = true;
+    bool hangUp_ = false;
+};
+
+struct FakeChrome {
+    explicit FakeChrome(std::string prefix = "") : prefix(std::move(prefix)) {}
+
+    std::string prefix;
+    ScriptedTransport* transport = nullptr;
+    std::atomic<int> nextId{1};
+    std::atomic<bool> failCreateTarget{false};
+    // Consulted first; a non-empty reply overrides the default answer.
+    ScriptedTransport::Responder script;
+
+    std::unique_ptr<ScriptedTransport> create() {
+        auto owned = std::make_unique<ScriptedTransport>([this](const Command& command) {
+            return respond(command);
+        });
+        transport = owned.get();
+        return owned;
+    }
+
+    std::string respond(const Command& command) {
+        if (script) {
+            std::string body = script(command);
+            if (!body.empty()) return body;
+        }
+        std::string id = prefix + std::to_string(nextId++);
+        if (command.method == "Target.createBrowserContext") {
+            return ScriptedTransport::result(R"({"browserContextId":"ctx)" + id + "\"}");
+        }
+        if (command.method == "Target.createTarget") {
+            if (failCreateTarget) return ScriptedTransport::error("Target creation failed");
+            return ScriptedTransport::result(R"({"targetId":"T)" + id + "\"}");
+        }
+        if (command.method == "Target.attachToTarget") {
+            return ScriptedTransport::result(R"({"sessionId":"S)" + id + "\"}");
+        }
+        if (command.method == "Runtime.evaluate") {
+            return ScriptedTransport::result(R"({"result":{"type":"string","value":"null"}})");
+        }
+        if (command.method == "Page.navigate") {
+            transport->push(R"({"method":"Page.loadEventFired","params":{"timestamp":1},"sessionId":")" +
+                            command.sessionId + "\"}");
+            return ScriptedTransport::result(R"({"frameId":"F)" + id + "\"}");
+        }
+        return ScriptedTransport::result();
+    }
+};
+
+}
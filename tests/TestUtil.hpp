@@ -0,0 +1,35 @@
+// Minimal assertion helpers for the self-contained unit tests.
+// These tests need no browser; each executable returns non-zero on failure.
+
+#pragma once
+
+#include <iostream>
+#include <string>
+
+namespace cdptest {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline void check(bool condition, const std::string& what, const char* file, int line) {
+    if (!condition) {
+        std::cout << "[FAIL] " << what << " (" << file << ":" << line << ")\n";
+        failures()++;
+    }
+}
+
+inline int finish(const std::string& suite) {
+    if (failures() == 0) {
+        std::cout << "[PASS] " << suite << "\n";
+        return 0;
+    }
+    std::cout << "[FAIL] " << suite << ": " << failures() << " check(s) failed\n";
+    return 1;
+}
+
+}
+
+#define CDP_CHECK(cond) ::cdptest::check((cond), #cond, __FILE__, __LINE__)
+#define CDP_CHECK_MSG(cond, msg) ::cdptest::check((cond), std::string(#cond) + " -- " + (msg), __FILE__, __LINE__)
@@ -0,0 +1,200 @@
+// AdblockEngine tests: filter parsing, matching semantics and the on-disk
+// index round trip. Expectations follow Adblock Plus filter syntax.
+
+#include "TestUtil.hpp"
+#include <cdp/highlevel/AdblockEngine.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+using cdp::highlevel::AdblockEngine;
+
+namespace {
+
+std::shared_ptr<AdblockEngine> compile(const std::string& rules) {
+    auto engine = AdblockEngine::compile(rules);
+    CDP_CHECK_MSG(engine.ok(), rules);
+    return engine.ok() ? engine.value() : nullptr;
+}
+
+void testParserStats() {
+    auto engine = compile(
+        "[Adblock Plus 2.0]\n"
+        "! comment\n"
+        "\n"
+        "||ads.example^\n"
+        "@@||ads.example/allowed^\n"
+        "example.com##.banner\n"
+        "/regex-[0-9]+/\n"
+        "foo$unknown-option\n"
+        "*\n");
+    if (!engine) return;
+    const auto& stats = engine->stats();
+    CDP_CHECK(stats.filters == 3);
+    CDP_CHECK(stats.exceptions == 1);
+    CDP_CHECK(stats.comments == 2);
+    CDP_CHECK(stats.cosmetic == 1);
+    CDP_CHECK(stats.unsupported == 2);
+    CDP_CHECK(stats.untokenized == 1);
+}
+
+void testAnchors() {
+    auto engine = compile(
+        "||ads.example^\n"
+        "|https://start.example/\n"
+        "/banner.gif|\n"
+        "middle\n");
+    if (!engine) return;
+
+    // Host anchor: the domain or any subdomain, not a suffix of another label.
+    CDP_CHECK(engine->shouldBlock("https://ads.example/x.js", "Script"));
+    CDP_CHECK(engine->shouldBlock("http://cdn.ads.example/x.js", "Script"));
+    CDP_CHECK(!engine->shouldBlock("https://badads.example/x.js", "Script"));
+    CDP_CHECK(!engine->shouldBlock("https://ads.example.org/x.js", "Script"));
+
+    // Start and end anchors.
+    CDP_CHECK(engine->shouldBlock("https://start.example/page", "Image"));
+    CDP_CHECK(!engine->shouldBlock("https://other.example/?u=https://start.example/", "Image"));
+    CDP_CHECK(engine->shouldBlock("https://x.example/img/banner.gif", "Image"));
+    CDP_CHECK(!engine->shouldBlock("https://x.example/img/banner.gif?v=2", "Image"));
+
+    // Unanchored substring, case-insensitive by default.
+    CDP_CHECK(engine->shouldBlock("https://x.example/a/MIDDLE/b", "Script"));
+    CDP_CHECK(!engine->shouldBlock("https://x.example/a/b", "Script"));
+}
+
+void testSeparator() {
+    auto engine = compile("||track.example^\n");
+    if (!engine) return;
+    CDP_CHECK(engine->shouldBlock("https://track.example/pixel", "Image"));
+    CDP_CHECK(engine->shouldBlock("https://track.example:8080/pixel", "Image"));
+    CDP_CHECK(engine->shouldBlock("https://track.example", "Image"));
+    CDP_CHECK(!engine->shouldBlock("https://track.example-cdn.net/pixel", "Image"));
+    CDP_CHECK(!engine->shouldBlock("https://track.examples/pixel", "Image"));
+}
+
+void testExceptionsAndImportant() {
+    auto engine = compile(
+        "||ads.example^\n"
+        "@@||ads.example/allowed^\n"
+        "||tracker.example^$important\n"
+        "@@||tracker.example^\n");
+    if (!engine) return;
+
+    auto excepted = engine->match("https://ads.example/allowed/x.js", "Script");
+    CDP_CHECK(!excepted.blocked);
+    CDP_CHECK(excepted.excepted);
+    CDP_CHECK(excepted.filter == "@@||ads.example/allowed^");
+
+    auto blocked = engine->match("https://ads.example/banner.js", "Script");
+    CDP_CHECK(blocked.blocked);
+    CDP_CHECK(blocked.filter == "||ads.example^");
+
+    auto important = engine->match("https://tracker.example/t.js", "Script");
+    CDP_CHECK(important.blocked);
+    CDP_CHECK(!important.excepted);
+    CDP_CHECK(important.filter == "||tracker.example^$important");
+
+    CDP_CHECK(!engine->match("https://clean.example/", "Script").blocked);
+}
+
+void testOptions() {
+    auto engine = compile(
+        "||scripts.example^$script\n"
+        "||media.example^$~image\n"
+        "||tp.example^$third-party\n"
+        "||scoped.example^$domain=news.example|~sports.news.example\n"
+        "||casesensitive.example/Path$match-case\n");
+    if (!engine) return;
+
+    CDP_CHECK(engine->shouldBlock("https://scripts.example/a.js", "Script"));
+    CDP_CHECK(!engine->shouldBlock("https://scripts.example/a.png", "Image"));
+
+    CDP_CHECK(engine->shouldBlock("https://media.example/a.mp4", "Media"));
+    CDP_CHECK(!engine->shouldBlock("https://media.example/a.png", "Image"));
+
+    CDP_CHECK(engine->shouldBlock("https://tp.example/x", "Script", "https://www.site.example/"));
+    CDP_CHECK(!engine->shouldBlock("https://tp.example/x", "Script", "https://www.tp.example/"));
+    CDP_CHECK(!engine->shouldBlock("https://tp.example/x", "Script"));
+
+    CDP_CHECK(engine->shouldBlock("https://scoped.example/x", "Script", "https://news.example/"));
+    CDP_CHECK(engine->shouldBlock("https://scoped.example/x", "Script", "https://world.news.example/"));
+    CDP_CHECK(!engine->shouldBlock("https://scoped.example/x", "Script", "https://sports.news.example/"));
+    CDP_CHECK(!engine->shouldBlock("https://scoped.example/x", "Script", "https://other.example/"));
+
+    CDP_CHECK(engine->shouldBlock("https://casesensitive.example/Path", "Script"));
+    CDP_CHECK(!engine->shouldBlock("https://casesensitive.example/path", "Script"));
+}
+
+void testDocumentType() {
+    auto engine = compile(
+        "||ads.example^\n"
+        "||phishing.example^$document\n"
+        "||everything.example^$all\n");
+    if (!engine) return;
+
+    // Typeless filters cover subframes but not top-level navigations.
+    CDP_CHECK(engine->shouldBlock("https://ads.example/frame.html", "Subdocument"));
+    CDP_CHECK(!engine->shouldBlock("https://ads.example/", "Document"));
+
+    CDP_CHECK(engine->shouldBlock("https://phishing.example/login", "Document"));
+    CDP_CHECK(!engine->shouldBlock("https://phishing.example/a.js", "Script"));
+
+    CDP_CHECK(engine->shouldBlock("https://everything.example/", "Document"));
+    CDP_CHECK(engine->shouldBlock("https://everything.example/a.js", "Script"));
+}
+
+void testSaveOpenRoundTrip() {
+    auto engine = compile(
+        "||ads.example^\n"
+        "@@||ads.example/allowed^\n"
+        "||scripts.example^$script,domain=news.example\n");
+    if (!engine) return;
+
+    auto path = (std::filesystem::temp_directory_path() / "cdp_adblock_test.idx").string();
+    CDP_CHECK(engine->save(path).ok());
+
+    auto reopened = AdblockEngine::open(path);
+    CDP_CHECK(reopened.ok());
+    if (reopened.ok()) {
+        auto loaded = reopened.value();
+        CDP_CHECK(loaded->sizeBytes() == engine->sizeBytes());
+        CDP_CHECK(loaded->stats().filters == engine->stats().filters);
+        CDP_CHECK(loaded->stats().exceptions == engine->stats().exceptions);
+        for (const char* url : {"https://ads.example/x.js", "https://ads.example/allowed/x.js",
+                                "https://scripts.example/a.js", "https://clean.example/"}) {
+            auto a = engine->match(url, "Script", "https://news.example/");
+            auto b = loaded->match(url, "Script", "https://news.example/");
+            CDP_CHECK_MSG(a.blocked == b.blocked && a.excepted == b.excepted && a.filter == b.filter, url);
+        }
+    }
+
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(0);
+        file.put('X');
+    }
+    CDP_CHECK(!AdblockEngine::open(path).ok());
+
+    {
+        std::ofstream truncated(path, std::ios::binary | std::ios::trunc);
+        truncated << "CDPADB";
+    }
+    CDP_CHECK(!AdblockEngine::open(path).ok());
+    std::remove(path.c_str());
+}
+
+}
+
+int main() {
+    testParserStats();
+    testAnchors();
+    testSeparator();
+    testExceptionsAndImportant();
+    testOptions();
+    testDocumentType();
+    testSaveOpenRoundTrip();
+    return cdptest::finish("adblock_test");
+}
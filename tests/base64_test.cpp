@@ -0,0 +1,206 @@
+// Base64 encoder/decoder tests.
+// The library picks SSSE3/AVX2/NEON blocks at runtime; every result is checked
+// against a plain scalar reference so the vector paths and the byte-at-a-time
+// tail agree on all inputs.
+
+#include "TestUtil.hpp"
+#include <cdp/core/Base64.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using cdp::Base64;
+using cdp::Base64Decoder;
+
+namespace {
+
+const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+std::string referenceEncode(const std::vector<uint8_t>& data) {
+    std::string out;
+    size_t i = 0;
+    for (; i + 2 < data.size(); i += 3) {
+        uint32_t n = (uint32_t{data[i]} << 16) | (uint32_t{data[i + 1]} << 8) | data[i + 2];
+        out += kAlphabet[(n >> 18) & 0x3f];
+        out += kAlphabet[(n >> 12) & 0x3f];
+        out += kAlphabet[(n >> 6) & 0x3f];
+        out += kAlphabet[n & 0x3f];
+    }
+    if (data.size() - i == 1) {
+        uint32_t n = uint32_t{data[i]} << 16;
+        out += kAlphabet[(n >> 18) & 0x3f];
+        out += kAlphabet[(n >> 12) & 0x3f];
+        out += "==";
+    } else if (data.size() - i == 2) {
+        uint32_t n = (uint32_t{data[i]} << 16) | (uint32_t{data[i + 1]} << 8);
+        out += kAlphabet[(n >> 18) & 0x3f];
+        out += kAlphabet[(n >> 12) & 0x3f];
+        out += kAlphabet[(n >> 6) & 0x3f];
+        out += '=';
+    }
+    return out;
+}
+
+int referenceValue(char c) {
+    for (int i = 0; i < 64; ++i) {
+        if (kAlphabet[i] == c) return i;
+    }
+    return -1;
+}
+
+// Same leniency as the library: characters outside the alphabet are skipped
+// and '=' flushes a partial quantum.
+std::vector<uint8_t> referenceDecode(const std::string& text) {
+    std::vector<uint8_t> out;
+    uint32_t pending = 0;
+    int count = 0;
+    auto flush = [&] {
+        if (count == 2) {
+            out.push_back(static_cast<uint8_t>(pending >> 4));
+        } else if (count == 3) {
+            out.push_back(static_cast<uint8_t>(pending >> 10));
+            out.push_back(static_cast<uint8_t>(pending >> 2));
+        }
+        pending = 0;
+        count = 0;
+    };
+    for (char c : text) {
+        int v = referenceValue(c);
+        if (v < 0) {
+            if (c == '=') flush();
+            continue;
+        }
+        pending = (pending << 6) | static_cast<uint32_t>(v);
+        if (++count == 4) {
+            out.push_back(static_cast<uint8_t>(pending >> 16));
+            out.push_back(static_cast<uint8_t>(pending >> 8));
+            out.push_back(static_cast<uint8_t>(pending));
+            pending = 0;
+            count = 0;
+        }
+    }
+    flush();
+    return out;
+}
+
+std::vector<uint8_t> randomBytes(std::mt19937& rng, size_t size) {
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::vector<uint8_t> data(size);
+    for (auto& b : data) b = static_cast<uint8_t>(byte(rng));
+    return data;
+}
+
+std::vector<uint8_t> decodeWithSink(const std::string& text) {
+    std::vector<uint8_t> out;
+    bool ok = Base64::decodeTo(text, [&out](const uint8_t* data, size_t length) {
+        out.insert(out.end(), data, data + length);
+        return true;
+    });
+    CDP_CHECK(ok);
+    return out;
+}
+
+std::vector<uint8_t> decodeSplit(const std::string& text, size_t at) {
+    Base64Decoder decoder;
+    std::vector<uint8_t> out(Base64Decoder::maxOutput(text.size()) + 3);
+    size_t written = decoder.feed(text.data(), at, out.data());
+    written += decoder.feed(text.data() + at, text.size() - at, out.data() + written);
+    written += decoder.finish(out.data() + written);
+    out.resize(written);
+    return out;
+}
+
+void testRoundTrip() {
+    std::mt19937 rng(1234);
+    for (size_t size = 0; size <= 100; ++size) {
+        auto data = randomBytes(rng, size);
+        std::string encoded = Base64::encode(data);
+        CDP_CHECK_MSG(encoded == referenceEncode(data), "encode length " + std::to_string(size));
+        CDP_CHECK_MSG(Base64::decode(encoded) == data, "decode length " + std::to_string(size));
+        CDP_CHECK_MSG(decodeWithSink(encoded) == data, "sink length " + std::to_string(size));
+    }
+
+    auto large = randomBytes(rng, 100000);
+    std::string encoded = Base64::encode(large);
+    CDP_CHECK(encoded == referenceEncode(large));
+    CDP_CHECK(Base64::decode(encoded) == large);
+    CDP_CHECK(decodeWithSink(encoded) == large);
+}
+
+void testPadding() {
+    const std::vector<std::string> inputs = {
+        "", "=", "==", "Q", "QQ", "QQ=", "QQ==", "QUI", "QUI=", "QUJD", "QUJD=",
+        "QQ==QUJD", "QUI=QQ==", "QQ==QQ==QQ==QQ==QQ==QQ==QQ==QQ==QQ==QQ==",
+        "QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVo=QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVo=",
+    };
+    for (const auto& text : inputs) {
+        CDP_CHECK_MSG(Base64::decode(text) == referenceDecode(text), text);
+    }
+    CDP_CHECK(Base64::decodeToString("QQ==") == "A");
+    CDP_CHECK(Base64::decodeToString("QUI=") == "AB");
+    CDP_CHECK(Base64::decodeToString("QUJD") == "ABC");
+}
+
+void testInvalidCharacters() {
+    std::mt19937 rng(99);
+    const std::string noise = "\n\r\t -*.!\x80\xff";
+    for (size_t size = 0; size <= 100; ++size) {
+        std::string text = referenceEncode(randomBytes(rng, size));
+        std::uniform_int_distribution<size_t> where(0, text.size());
+        for (char c : noise) {
+            std::string dirty = text;
+            dirty.insert(where(rng), 1, c);
+            CDP_CHECK_MSG(Base64::decode(dirty) == referenceDecode(dirty),
+                          "length " + std::to_string(size) + " noise " + std::to_string(static_cast<uint8_t>(c)));
+        }
+    }
+
+    std::string wrapped;
+    auto data = randomBytes(rng, 3000);
+    std::string encoded = referenceEncode(data);
+    for (size_t i = 0; i < encoded.size(); i += 76) {
+        wrapped += encoded.substr(i, 76);
+        wrapped += "\r\n";
+    }
+    CDP_CHECK(Base64::decode(wrapped) == data);
+}
+
+void testSplitFeed() {
+    std::mt19937 rng(7);
+    for (size_t size : {size_t{0}, size_t{1}, size_t{2}, size_t{47}, size_t{48}, size_t{100}}) {
+        std::string text = referenceEncode(randomBytes(rng, size));
+        std::vector<uint8_t> expected = referenceDecode(text);
+        for (size_t at = 0; at <= text.size(); ++at) {
+            CDP_CHECK_MSG(decodeSplit(text, at) == expected,
+                          "length " + std::to_string(size) + " split " + std::to_string(at));
+        }
+    }
+
+    std::string padded = referenceEncode(randomBytes(rng, 40)) + referenceEncode(randomBytes(rng, 41));
+    padded.insert(20, "\n");
+    std::vector<uint8_t> expected = referenceDecode(padded);
+    for (size_t at = 0; at <= padded.size(); ++at) {
+        CDP_CHECK_MSG(decodeSplit(padded, at) == expected, "padded split " + std::to_string(at));
+    }
+
+    Base64Decoder decoder;
+    std::string text = referenceEncode(randomBytes(rng, 200));
+    std::vector<uint8_t> out(Base64Decoder::maxOutput(text.size()) + 3);
+    size_t written = 0;
+    for (char c : text) written += decoder.feed(&c, 1, out.data() + written);
+    written += decoder.finish(out.data() + written);
+    out.resize(written);
+    CDP_CHECK(out == referenceDecode(text));
+}
+
+}
+
+int main() {
+    testRoundTrip();
+    testPadding();
+    testInvalidCharacters();
+    testSplitFeed();
+    return cdptest::finish("base64_test");
+}
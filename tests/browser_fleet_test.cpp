@@ -0,0 +1,165 @@
+// BrowserFleet scheduling and restart tests.
+// Browsers come from browserFactory and talk to scripted transports, so a
+// lost browser is simulated by hanging up its transport.
+
+#include "TestUtil.hpp"
+#include "FakeBrowser.hpp"
+#include <cdp/highlevel/BrowserFleet.hpp>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cdp::highlevel::Browser;
+using cdp::highlevel::BrowserFleet;
+using cdp::highlevel::BrowserFleetOptions;
+using cdp::highlevel::ManagedPage;
+using cdp::highlevel::Result;
+
+namespace {
+
+struct FakeFleet {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<cdptest::FakeChrome>> chromes;
+    bool failPages = false;
+
+    BrowserFleetOptions options(size_t browsers, size_t pages) {
+        BrowserFleetOptions options;
+        options.browsers = browsers;
+        options.maxPagesPerBrowser = pages;
+        options.healthCheckIntervalMs = 60000;
+        options.browserFactory = [this](size_t index) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto chrome = std::make_unique<cdptest::FakeChrome>("b" + std::to_string(index) + "-");
+            chrome->failCreateTarget = failPages;
+            auto browser = std::make_unique<Browser>();
+            auto connected = browser->connect(chrome->create());
+            chromes.push_back(std::move(chrome));
+            if (!connected) return Result<std::unique_ptr<Browser>>::failure(connected.error());
+            return Result<std::unique_ptr<Browser>>(std::move(browser));
+        };
+        return options;
+    }
+
+    size_t launches() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return chromes.size();
+    }
+
+    cdptest::FakeChrome& chrome(size_t i) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return *chromes[i];
+    }
+};
+
+bool ready(std::future<Result<void>>& future) {
+    return future.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+}
+
+void testJobsSpreadAcrossBrowsers() {
+    FakeFleet fake;
+    BrowserFleet fleet(fake.options(2, 1));
+    auto started = fleet.start();
+    CDP_CHECK_MSG(started.ok(), started.ok() ? "" : started.error().message);
+    if (!started) return;
+
+    std::mutex mutex;
+    std::set<std::string> browsers;
+    std::vector<std::future<Result<void>>> futures;
+    for (int i = 0; i < 4; ++i) {
+        futures.push_back(fleet.submit([&](ManagedPage& page) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            std::lock_guard<std::mutex> lock(mutex);
+            browsers.insert(page.targetId().substr(1, 2));
+            return Result<void>();
+        }));
+    }
+    for (auto& future : futures) CDP_CHECK(ready(future) && future.get().ok());
+
+    CDP_CHECK(browsers.size() == 2);
+    auto stats = fleet.stats();
+    CDP_CHECK(stats.submitted == 4 && stats.completed == 4 && stats.failed == 0);
+    CDP_CHECK(stats.browsers.size() == 2);
+    CDP_CHECK(stats.browsers[0].completed > 0 && stats.browsers[1].completed > 0);
+    fleet.shutdown();
+}
+
+void testLostBrowserRequeuesAndRestarts() {
+    FakeFleet fake;
+    BrowserFleet fleet(fake.options(1, 1));
+    CDP_CHECK(fleet.start().ok());
+
+    int calls = 0;
+    auto future = fleet.submit([&](ManagedPage&) {
+        if (++calls == 1) {
+            fake.chrome(0).transport->hangUp();
+            return Result<void>::failure("connection lost");
+        }
+        return Result<void>();
+    });
+    CDP_CHECK(ready(future));
+    CDP_CHECK(future.get().ok());
+    CDP_CHECK(calls == 2);
+    CDP_CHECK(fake.launches() == 2);
+
+    auto stats = fleet.stats();
+    CDP_CHECK(stats.requeued == 1 && stats.restarts == 1 && stats.completed == 1);
+    fleet.shutdown();
+}
+
+void testTaskFailureIsNotRetried() {
+    FakeFleet fake;
+    BrowserFleet fleet(fake.options(1, 1));
+    CDP_CHECK(fleet.start().ok());
+
+    int calls = 0;
+    auto future = fleet.submit([&](ManagedPage&) {
+        calls++;
+        return Result<void>::failure("assertion failed");
+    });
+    CDP_CHECK(ready(future));
+    CDP_CHECK(!future.get().ok());
+    CDP_CHECK(calls == 1);
+
+    auto stats = fleet.stats();
+    CDP_CHECK(stats.requeued == 0 && stats.restarts == 0 && stats.failed == 1);
+    fleet.shutdown();
+}
+
+void testPageFailuresUseRetryBudget() {
+    FakeFleet fake;
+    fake.failPages = true;
+    auto options = fake.options(1, 1);
+    options.maxAttempts = 3;
+    BrowserFleet fleet(options);
+    CDP_CHECK(fleet.start().ok());
+
+    bool ran = false;
+    auto future = fleet.submit([&](ManagedPage&) {
+        ran = true;
+        return Result<void>();
+    });
+    CDP_CHECK(ready(future));
+    auto result = future.get();
+    CDP_CHECK(!result.ok() && result.error().message.find("Target creation failed") != std::string::npos);
+    CDP_CHECK(!ran);
+    CDP_CHECK(fake.chrome(0).transport->count("Target.createTarget") == 3);
+
+    auto stats = fleet.stats();
+    CDP_CHECK(stats.requeued == 2 && stats.restarts == 0 && stats.failed == 1);
+    fleet.shutdown();
+}
+
+}
+
+int main() {
+    testJobsSpreadAcrossBrowsers();
+    testLostBrowserRequeuesAndRestarts();
+    testTaskFailureIsNotRetried();
+    testPageFailuresUseRetryBudget();
+    return cdptest::finish("browser_fleet_test");
+}
@@ -0,0 +1,81 @@
+// Browser target registry tests.
+// Target discovery events come from a scripted transport behind the
+// session router; no Chrome process is involved.
+
+#include "TestUtil.hpp"
+#include "FakeBrowser.hpp"
+#include <cdp/highlevel/Browser.hpp>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+using cdp::CDPClientConfig;
+using cdp::highlevel::Browser;
+
+namespace {
+
+bool waitFor(const std::function<bool()>& condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+std::string targetEvent(const std::string& event, const std::string& id, const std::string& url) {
+    return R"({"method":"Target.)" + event + R"(","params":{"targetInfo":{"targetId":")" + id +
+           R"(","type":"page","title":"","url":")" + url + R"(","attached":false}}})";
+}
+
+void testTargetRegistry() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>();
+    auto* transport = owned.get();
+    Browser browser;
+    auto connected = browser.connect(std::move(owned));
+    CDP_CHECK_MSG(connected.ok(), connected.ok() ? "" : connected.error().message);
+    if (!connected) return;
+    CDP_CHECK(waitFor([&] { return transport->count("Target.setDiscoverTargets") == 1; }));
+
+    transport->push(targetEvent("targetCreated", "A1", "about:blank"));
+    transport->push(targetEvent("targetCreated", "B2", "https://b.test/"));
+    CDP_CHECK(waitFor([&] { return browser.targetCount() == 2; }));
+
+    transport->push(targetEvent("targetInfoChanged", "A1", "https://a.test/"));
+    CDP_CHECK(waitFor([&] {
+        auto target = browser.findTarget("A1");
+        return target && target->url == "https://a.test/";
+    }));
+
+    transport->push(R"({"method":"Target.targetDestroyed","params":{"targetId":"B2"}})");
+    CDP_CHECK(waitFor([&] { return browser.targetCount() == 1; }));
+    CDP_CHECK(!browser.findTarget("B2"));
+    auto targets = browser.targets();
+    CDP_CHECK(targets.size() == 1 && targets[0].targetId == "A1");
+
+    browser.disconnect();
+    CDP_CHECK(browser.targetCount() == 0);
+}
+
+void testConfigDerivedSettings() {
+    CDPClientConfig config;
+    config.host = "10.0.0.7";
+    config.port = 9333;
+    config.enableWatchdog = true;
+    config.watchdogIntervalMs = 750;
+    Browser browser(config);
+
+    CDP_CHECK(browser.pageWebSocketUrl("ABC") == "ws://10.0.0.7:9333/devtools/page/ABC");
+    const auto& watchdog = browser.browserClient().connection().watchdogSettings();
+    CDP_CHECK(watchdog.enabled && watchdog.intervalMs == 750);
+}
+
+}
+
+int main() {
+    testTargetRegistry();
+    testConfigDerivedSettings();
+    return cdptest::finish("browser_targets_test");
+}
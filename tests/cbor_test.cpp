@@ -0,0 +1,194 @@
+// CBOR wire encoding tests.
+// Values are compared through their JSON serialization after a round trip,
+// which is what the connection layer relies on.
+
+#include "TestUtil.hpp"
+#include <cdp/core/Cbor.hpp>
+#include <cdp/core/Json.hpp>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using cdp::Cbor;
+using cdp::CborEncodeOptions;
+using cdp::JsonArray;
+using cdp::JsonObject;
+using cdp::JsonValue;
+
+namespace {
+
+const uint8_t* bytesOf(const std::string& s) {
+    return reinterpret_cast<const uint8_t*>(s.data());
+}
+
+bool roundTrips(const JsonValue& value, const CborEncodeOptions& options = {}) {
+    JsonValue decoded = Cbor::decode(Cbor::encode(value, options));
+    return decoded.serialize() == value.serialize();
+}
+
+bool decodeThrows(const std::string& data) {
+    try {
+        Cbor::decode(data);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+void testScalars() {
+    CDP_CHECK(roundTrips(JsonValue(nullptr)));
+    CDP_CHECK(roundTrips(JsonValue(true)));
+    CDP_CHECK(roundTrips(JsonValue(false)));
+
+    for (int64_t n : {int64_t{0}, int64_t{23}, int64_t{24}, int64_t{255}, int64_t{256},
+                      int64_t{65535}, int64_t{65536}, int64_t{-1}, int64_t{-24}, int64_t{-25},
+                      int64_t{-65537}, int64_t{(std::numeric_limits<int32_t>::max)()},
+                      int64_t{(std::numeric_limits<int32_t>::min)()}}) {
+        CDP_CHECK_MSG(roundTrips(JsonValue(n)), std::to_string(n));
+    }
+
+    // Integers outside int32 travel as doubles, matching Chrome's encoder.
+    JsonValue big = Cbor::decode(Cbor::encode(JsonValue(int64_t{1} << 40)));
+    CDP_CHECK(big.isNumber());
+    CDP_CHECK(big.asNumber() == 1099511627776.0);
+
+    for (double d : {0.5, -1.25, 3.141592653589793, 1e300}) {
+        JsonValue decoded = Cbor::decode(Cbor::encode(JsonValue(d)));
+        CDP_CHECK(decoded.isNumber() && decoded.asNumber() == d);
+    }
+
+    CDP_CHECK(roundTrips(JsonValue("")));
+    CDP_CHECK(roundTrips(JsonValue("Page.navigate")));
+    CDP_CHECK(roundTrips(JsonValue("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80")));
+}
+
+void testContainers() {
+    JsonObject params;
+    params["url"] = JsonValue("https://example.com/?q=1");
+    params["frameId"] = JsonValue("ABCDEF");
+    params["depth"] = JsonValue(-3);
+
+    JsonArray list;
+    list.push_back(JsonValue(1));
+    list.push_back(JsonValue("two"));
+    list.push_back(JsonValue(JsonObject{}));
+    list.push_back(JsonValue(JsonArray{}));
+    params["list"] = JsonValue(std::move(list));
+
+    JsonObject message;
+    message["id"] = JsonValue(42);
+    message["method"] = JsonValue("Page.navigate");
+    message["params"] = JsonValue(std::move(params));
+
+    CDP_CHECK(roundTrips(JsonValue(message)));
+
+    CborEncodeOptions flat;
+    flat.envelopes = false;
+    CDP_CHECK(roundTrips(JsonValue(message), flat));
+}
+
+void testBinaryKeys() {
+    JsonObject params;
+    params["body"] = JsonValue("SGVsbG8sIHdvcmxkIQ==");
+    params["note"] = JsonValue("SGVsbG8sIHdvcmxkIQ==");
+
+    CborEncodeOptions options;
+    options.binaryKeys = {"body"};
+    std::string encoded = Cbor::encode(JsonValue(params), options);
+
+    // Tag 22 marks base64 payloads sent as raw bytes.
+    CDP_CHECK(encoded.find(std::string("\xd6\x4d", 2)) != std::string::npos);
+    CDP_CHECK(roundTrips(JsonValue(params), options));
+}
+
+void testCommandOptions() {
+    JsonObject params;
+    params["requestId"] = JsonValue("interception-1");
+    params["body"] = JsonValue("SGVsbG8sIHdvcmxkIQ==");
+    params["postData"] = JsonValue("SGVsbG8sIHdvcmxkIQ==");
+    const std::string tagged("\xd6\x4d", 2);
+
+    std::string fulfill = Cbor::encode(JsonValue(params), Cbor::commandOptions("Fetch.fulfillRequest"));
+    CDP_CHECK(fulfill.find(tagged) != std::string::npos);
+    CDP_CHECK(fulfill.find(tagged) == fulfill.rfind(tagged));
+
+    std::string proceed = Cbor::encode(JsonValue(params), Cbor::commandOptions("Fetch.continueRequest"));
+    CDP_CHECK(proceed.find(tagged) != std::string::npos);
+    CDP_CHECK(proceed.find(tagged) == proceed.rfind(tagged));
+
+    std::string other = Cbor::encode(JsonValue(params), Cbor::commandOptions("Runtime.evaluate"));
+    CDP_CHECK(other.find(tagged) == std::string::npos);
+    CDP_CHECK(Cbor::commandOptions("Runtime.evaluate").binaryKeys.empty());
+}
+
+void testSplicedMap() {
+    std::string out;
+    size_t at = Cbor::beginMap(out);
+    Cbor::appendString(out, "id");
+    Cbor::appendInteger(out, 7);
+    Cbor::appendString(out, "method");
+    Cbor::appendString(out, "Fetch.fulfillRequest");
+    JsonObject entries;
+    entries["responseCode"] = JsonValue(200);
+    Cbor::encodeEntries(entries, out);
+    Cbor::endMap(out, at);
+
+    JsonValue decoded = Cbor::decode(out);
+    CDP_CHECK(decoded.isObject());
+    CDP_CHECK(decoded["id"].asInt() == 7);
+    CDP_CHECK(decoded["method"].asString() == "Fetch.fulfillRequest");
+    CDP_CHECK(decoded["responseCode"].asInt() == 200);
+    CDP_CHECK(Cbor::messageSize(bytesOf(out), out.size()) == static_cast<int64_t>(out.size()));
+}
+
+void testMessageSize() {
+    JsonObject message;
+    message["id"] = JsonValue(1);
+    message["result"] = JsonValue(JsonObject{});
+    std::string encoded = Cbor::encode(JsonValue(message));
+    int64_t size = static_cast<int64_t>(encoded.size());
+
+    CDP_CHECK(Cbor::messageSize(bytesOf(encoded), encoded.size()) == size);
+    std::string stream = encoded + encoded;
+    CDP_CHECK(Cbor::messageSize(bytesOf(stream), stream.size()) == size);
+    for (size_t partial = 0; partial < 7; ++partial) {
+        CDP_CHECK_MSG(Cbor::messageSize(bytesOf(encoded), partial) == 0, std::to_string(partial));
+    }
+
+    // Tag 90 (0xd8 0x5a) is not an envelope, nor is a bare byte string.
+    std::string tag90("\xd8\x5a\x00\x00\x00\x01\xa0", 7);
+    CDP_CHECK(Cbor::messageSize(bytesOf(tag90), tag90.size()) == -1);
+    std::string wrongHead("\xa0", 1);
+    CDP_CHECK(Cbor::messageSize(bytesOf(wrongHead), wrongHead.size()) == -1);
+    std::string notLength("\xd8\x18\x41\x00\x00\x00\x00", 7);
+    CDP_CHECK(Cbor::messageSize(bytesOf(notLength), notLength.size()) == -1);
+}
+
+void testTags() {
+    // An unknown tag is skipped and its content decoded, even when the tag
+    // number happens to share a byte with the envelope header.
+    JsonValue tagged = Cbor::decode(std::string("\xd8\x5a\x05", 3));
+    CDP_CHECK(tagged.isInt() && tagged.asInt() == 5);
+
+    JsonValue taggedMap = Cbor::decode(std::string("\xd8\x5a\xa1\x61\x61\x01", 6));
+    CDP_CHECK(taggedMap.isObject() && taggedMap["a"].asInt() == 1);
+
+    CDP_CHECK(decodeThrows(std::string("\xd8\x18\x5a\x00\x00\x00\x05\xa0", 8)));
+    CDP_CHECK(decodeThrows(std::string("\x82\x01", 2)));
+    CDP_CHECK(decodeThrows(std::string("\x01\x02", 2)));
+}
+
+}
+
+int main() {
+    testScalars();
+    testContainers();
+    testBinaryKeys();
+    testCommandOptions();
+    testSplicedMap();
+    testMessageSize();
+    testTags();
+    return cdptest::finish("cbor_test");
+}
@@ -0,0 +1,62 @@
+// ChromeLauncher stderr scanning tests.
+// Chrome's stderr arrives in arbitrary chunks; only complete lines are
+// consumed and the text after the endpoint line is left for the pump.
+
+#include "TestUtil.hpp"
+#include <cdp/browser/ChromeLauncher.hpp>
+#include <string>
+
+using cdp::ChromeLauncher;
+
+namespace {
+
+#ifndef _WIN32
+void testEndpointLine() {
+    std::string pending = "[1:2:ERROR:gpu_init.cc(1)] GPU disabled\r\n"
+                          "\n"
+                          "DevTools listening on ws://127.0.0.1:39211/devtools/browser/abc-123\r\n"
+                          "[1:3:INFO] after";
+    std::string lastLine;
+    auto url = ChromeLauncher::scanStderr(pending, lastLine);
+    CDP_CHECK(url && *url == "ws://127.0.0.1:39211/devtools/browser/abc-123");
+    CDP_CHECK(lastLine == "[1:2:ERROR:gpu_init.cc(1)] GPU disabled");
+    CDP_CHECK(pending == "[1:3:INFO] after");
+}
+
+void testSplitChunks() {
+    std::string pending;
+    std::string lastLine;
+    pending += "early warn";
+    CDP_CHECK(!ChromeLauncher::scanStderr(pending, lastLine));
+    CDP_CHECK(pending == "early warn" && lastLine.empty());
+
+    pending += "ing\nDevTools listen";
+    CDP_CHECK(!ChromeLauncher::scanStderr(pending, lastLine));
+    CDP_CHECK(lastLine == "early warning");
+    CDP_CHECK(pending == "DevTools listen");
+
+    pending += "ing on ws://[::1]:9222/devtools/browser/x\n";
+    auto url = ChromeLauncher::scanStderr(pending, lastLine);
+    CDP_CHECK(url && *url == "ws://[::1]:9222/devtools/browser/x");
+    CDP_CHECK(pending.empty());
+}
+
+void testNoEndpoint() {
+    std::string pending = "Failed to launch: missing libnss3.so\nExiting\n";
+    std::string lastLine;
+    CDP_CHECK(!ChromeLauncher::scanStderr(pending, lastLine));
+    CDP_CHECK(lastLine == "Exiting");
+    CDP_CHECK(pending.empty());
+}
+#endif
+
+}
+
+int main() {
+#ifndef _WIN32
+    testEndpointLine();
+    testSplitChunks();
+    testNoEndpoint();
+#endif
+    return cdptest::finish("chrome_launcher_test");
+}
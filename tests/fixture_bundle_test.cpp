@@ -0,0 +1,64 @@
+// FixtureBundle lookup tests.
+// A temporary directory stands in for a recorded bundle; concurrent lookups
+// must all share the one response built on first use.
+
+#include "TestUtil.hpp"
+#include <cdp/highlevel/FixtureBundle.hpp>
+#include <cdp/core/Base64.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cdp::highlevel::FixtureBundle;
+using cdp::highlevel::MockResponse;
+
+namespace {
+
+void writeFile(const std::filesystem::path& path, const std::string& content) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << content;
+}
+
+void testDirectoryLookup() {
+    auto root = std::filesystem::temp_directory_path() / "cdp_fixture_bundle_test";
+    std::filesystem::remove_all(root);
+    writeFile(root / "example.com" / "index.html", "<h1>home</h1>");
+    writeFile(root / "example.com" / "js" / "app.js", "console.log(1);");
+
+    auto opened = FixtureBundle::open(root.string());
+    CDP_CHECK(opened.ok());
+    if (!opened.ok()) return;
+    auto bundle = opened.value();
+    CDP_CHECK(bundle->size() == 2);
+    CDP_CHECK(bundle->contains("https://EXAMPLE.com/?q=1"));
+    CDP_CHECK(bundle->find("https://example.com/missing.css") == nullptr);
+
+    std::vector<std::shared_ptr<const MockResponse>> seen(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < seen.size(); ++i) {
+        threads.emplace_back([&, i] {
+            for (int n = 0; n < 50; ++n) seen[i] = bundle->find("https://example.com/js/app.js");
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    CDP_CHECK(seen[0] != nullptr);
+    for (const auto& response : seen) CDP_CHECK(response == seen[0]);
+
+    if (seen[0]) {
+        std::string json = seen[0]->fulfillParams()->json();
+        CDP_CHECK_MSG(json.find("application/javascript") != std::string::npos, json);
+        CDP_CHECK(json.find(cdp::Base64::encode(std::string("console.log(1);"))) != std::string::npos);
+    }
+    auto home = bundle->find("https://example.com");
+    CDP_CHECK(home != nullptr && home == bundle->find("https://example.com/"));
+    std::filesystem::remove_all(root);
+}
+
+}
+
+int main() {
+    testDirectoryLookup();
+    return cdptest::finish("fixture_bundle_test");
+}
@@ -0,0 +1,125 @@
+// HARExporter recording and streaming tests.
+// Network events come from a scripted transport; streamed files are read
+// back and parsed after the exporter closes them.
+
+#include "TestUtil.hpp"
+#include "FakeBrowser.hpp"
+#include <cdp/highlevel/Utilities.hpp>
+#include <cdp/protocol/CDPClient.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+
+using cdp::CDPClient;
+using cdp::JsonValue;
+using cdp::highlevel::HARExporter;
+using cdp::highlevel::HARStreamOptions;
+
+namespace {
+
+bool waitFor(const std::function<bool()>& condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+void pushRedirectedLoad(cdptest::ScriptedTransport& transport) {
+    transport.push(R"({"method":"Network.requestWillBeSent","params":{"requestId":"1","type":"Document",
+        "timestamp":1.0,"wallTime":1700000000,"request":{"url":"http://a.test/","method":"GET","headers":{}}}})");
+    transport.push(R"({"method":"Network.requestWillBeSent","params":{"requestId":"1","type":"Document",
+        "timestamp":1.2,"wallTime":1700000000.2,"request":{"url":"https://a.test/","method":"GET","headers":{}},
+        "redirectResponse":{"status":307,"statusText":"Temporary Redirect","mimeType":"",
+                            "headers":{"Location":"https://a.test/"}}}})");
+    transport.push(R"({"method":"Network.responseReceived","params":{"requestId":"1","type":"Document",
+        "response":{"status":200,"statusText":"OK","mimeType":"text/html","headers":{}}}})");
+    transport.push(R"({"method":"Network.loadingFinished","params":{"requestId":"1","timestamp":1.5,
+        "encodedDataLength":300}})");
+    transport.push(R"({"method":"Network.requestWillBeSent","params":{"requestId":"2","type":"Image",
+        "timestamp":1.6,"request":{"url":"https://a.test/logo.png","method":"GET","headers":{}}}})");
+    transport.push(R"({"method":"Network.loadingFailed","params":{"requestId":"2","timestamp":1.7,
+        "errorText":"net::ERR_ABORTED"}})");
+}
+
+JsonValue readHar(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return JsonValue::parse(std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()));
+}
+
+void testRedirectHopsRecorded() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>();
+    auto* transport = owned.get();
+    CDPClient client;
+    CDP_CHECK(client.connect(std::move(owned)));
+
+    HARExporter exporter(client.connection());
+    CDP_CHECK(exporter.startRecording().ok());
+    pushRedirectedLoad(*transport);
+    CDP_CHECK(waitFor([&] { return exporter.entries().size() == 3; }));
+    exporter.stopRecording();
+    if (exporter.entries().size() != 3) return;
+
+    const auto& hop = exporter.entries()[0];
+    CDP_CHECK(hop.url == "http://a.test/" && hop.status == 307);
+    CDP_CHECK(hop.responseHeaders.at("Location") == "https://a.test/");
+    CDP_CHECK(hop.duration > 199 && hop.duration < 201);
+    const auto& page = exporter.entries()[1];
+    CDP_CHECK(page.url == "https://a.test/" && page.status == 200 && page.responseSize == 300);
+    CDP_CHECK(page.responseHeaders.empty());
+    CDP_CHECK(exporter.entries()[2].errorText == "net::ERR_ABORTED");
+}
+
+void testRotationFailureKeepsCurrentFile() {
+    auto dir = std::filesystem::temp_directory_path() / "cdp_har_exporter_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "capture.2.har");
+
+    auto owned = std::make_unique<cdptest::ScriptedTransport>();
+    auto* transport = owned.get();
+    CDPClient client;
+    CDP_CHECK(client.connect(std::move(owned)));
+
+    HARExporter exporter(client.connection());
+    HARStreamOptions options;
+    options.maxEntriesPerFile = 1;
+    std::string path = (dir / "capture.har").string();
+    auto started = exporter.startStreaming(path, options);
+    CDP_CHECK_MSG(started.ok(), started.ok() ? "" : started.error().message);
+    pushRedirectedLoad(*transport);
+    CDP_CHECK(waitFor([&] { return exporter.streamedEntries() == 3; }));
+    CDP_CHECK(exporter.isStreaming());
+    CDP_CHECK(exporter.lastError().find("capture.2.har") != std::string::npos);
+    exporter.stopRecording();
+
+    auto files = exporter.streamFiles();
+    CDP_CHECK(files.size() == 2);
+    if (files.size() == 2) {
+        auto first = readHar(files[0]);
+        auto second = readHar(files[1]);
+        CDP_CHECK(first["log"]["entries"].asArray().size() == 1);
+        CDP_CHECK(first["log"]["entries"][0]["response"]["status"].getInt() == 307);
+        CDP_CHECK(second["log"]["entries"].asArray().size() == 2);
+        CDP_CHECK(second["log"]["entries"][1]["_error"].getString() == "net::ERR_ABORTED");
+    }
+
+    HARExporter blocked(client.connection());
+    auto result = blocked.startStreaming((dir / "capture.2.har").string());
+    CDP_CHECK(!result.ok());
+    CDP_CHECK(!blocked.lastError().empty());
+    std::filesystem::remove_all(dir);
+}
+
+}
+
+int main() {
+    testRedirectHopsRecorded();
+    testRotationFailureKeepsCurrentFile();
+    return cdptest::finish("har_exporter_test");
+}
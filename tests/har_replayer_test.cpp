@@ -0,0 +1,158 @@
+// HAR record/replay round trip.
+// HARExporter records from a scripted transport that answers
+// Network.getResponseBody; the exported HAR is loaded into HarReplayer.
+
+#include "TestUtil.hpp"
+#include "FakeBrowser.hpp"
+#include <cdp/core/Base64.hpp>
+#include <cdp/highlevel/HarReplayer.hpp>
+#include <cdp/highlevel/Utilities.hpp>
+#include <cdp/protocol/CDPClient.hpp>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+using cdp::Base64;
+using cdp::CDPClient;
+using cdp::JsonValue;
+using cdp::highlevel::HARExporter;
+using cdp::highlevel::HarReplayer;
+
+namespace {
+
+bool waitFor(const std::function<bool()>& condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+std::string respondWithBodies(const cdptest::Command& command) {
+    using cdptest::ScriptedTransport;
+    if (command.method != "Network.getResponseBody") return ScriptedTransport::result();
+    std::string id = command.params["requestId"].getString();
+    if (id == "get") return ScriptedTransport::result(R"({"body":"<p>hello</p>","base64Encoded":false})");
+    if (id == "post") {
+        return ScriptedTransport::result(R"({"body":")" + Base64::encode(std::string("{\"ok\":1}")) +
+                                         R"(","base64Encoded":true})");
+    }
+    return ScriptedTransport::error("No resource with given identifier found");
+}
+
+void pushLoads(cdptest::ScriptedTransport& transport) {
+    transport.push(R"({"method":"Network.requestWillBeSent","params":{"requestId":"get","type":"Document",
+        "timestamp":1.0,"request":{"url":"https://a.test/page?b=2&a=1","method":"GET","headers":{}}}})");
+    transport.push(R"({"method":"Network.responseReceived","params":{"requestId":"get",
+        "response":{"status":200,"statusText":"OK","mimeType":"text/html","headers":{"Content-Type":"text/html"}}}})");
+    transport.push(R"({"method":"Network.loadingFinished","params":{"requestId":"get","timestamp":1.1,
+        "encodedDataLength":120}})");
+    transport.push(R"({"method":"Network.requestWillBeSent","params":{"requestId":"post","type":"XHR",
+        "timestamp":1.2,"request":{"url":"https://a.test/api","method":"POST",
+        "headers":{"Content-Type":"application/json"},"postData":"{\"q\":1}"}}})");
+    transport.push(R"({"method":"Network.responseReceived","params":{"requestId":"post",
+        "response":{"status":201,"statusText":"Created","mimeType":"application/json","headers":{}}}})");
+    transport.push(R"({"method":"Network.loadingFinished","params":{"requestId":"post","timestamp":1.3,
+        "encodedDataLength":90}})");
+    transport.push(R"({"method":"Network.requestWillBeSent","params":{"requestId":"gone","type":"Image",
+        "timestamp":1.4,"request":{"url":"https://a.test/gone.png","method":"GET","headers":{}}}})");
+    transport.push(R"({"method":"Network.responseReceived","params":{"requestId":"gone",
+        "response":{"status":200,"statusText":"OK","mimeType":"image/png","headers":{}}}})");
+    transport.push(R"({"method":"Network.loadingFinished","params":{"requestId":"gone","timestamp":1.5,
+        "encodedDataLength":64}})");
+}
+
+bool bodyIs(const std::shared_ptr<const cdp::highlevel::MockResponse>& response, const std::string& body) {
+    if (!response) return false;
+    std::string json = response->fulfillParams()->json();
+    return json.find("\"" + Base64::encode(body) + "\"") != std::string::npos;
+}
+
+void testRoundTripGetAndPost() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>(respondWithBodies);
+    auto* transport = owned.get();
+    CDPClient client;
+    CDP_CHECK(client.connect(std::move(owned)));
+
+    HARExporter exporter(client.connection());
+    exporter.setRecordBodies(true);
+    CDP_CHECK(exporter.startRecording().ok());
+    pushLoads(*transport);
+    CDP_CHECK(waitFor([&] { return exporter.entries().size() == 3; }));
+    exporter.stopRecording();
+    CDP_CHECK(transport->count("Network.getResponseBody") == 3);
+    if (exporter.entries().size() != 3) return;
+
+    const auto& post = exporter.entries()[1];
+    CDP_CHECK(post.requestBody == "{\"q\":1}");
+    CDP_CHECK(post.responseBody == "{\"ok\":1}" && post.responseBodyRecorded);
+    CDP_CHECK(!exporter.entries()[2].responseBodyRecorded);
+
+    auto loaded = HarReplayer::load(JsonValue::parse(exporter.exportHAR()));
+    CDP_CHECK(static_cast<bool>(loaded));
+    if (!loaded) return;
+    auto replayer = loaded.value();
+    CDP_CHECK(replayer->size() == 2);
+    CDP_CHECK(replayer->stats().skipped == 1);
+
+    CDP_CHECK(bodyIs(replayer->find("GET", "https://a.test/page?a=1&b=2"), "<p>hello</p>"));
+    CDP_CHECK(bodyIs(replayer->find("POST", "https://a.test/api", "{\"q\":1}"), "{\"ok\":1}"));
+    CDP_CHECK(replayer->find("POST", "https://a.test/api", "{\"q\":2}") == nullptr);
+    CDP_CHECK(replayer->find("POST", "https://a.test/api") == nullptr);
+    CDP_CHECK(replayer->find("GET", "https://a.test/gone.png") == nullptr);
+    CDP_CHECK(replayer->stats().hits == 2 && replayer->stats().misses == 3);
+}
+
+void testBodiesDisabled() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>(respondWithBodies);
+    auto* transport = owned.get();
+    CDPClient client;
+    CDP_CHECK(client.connect(std::move(owned)));
+
+    HARExporter exporter(client.connection());
+    CDP_CHECK(!exporter.recordBodies());
+    CDP_CHECK(exporter.startRecording().ok());
+    pushLoads(*transport);
+    CDP_CHECK(waitFor([&] { return exporter.entries().size() == 3; }));
+    exporter.stopRecording();
+    CDP_CHECK(transport->count("Network.getResponseBody") == 0);
+
+    auto loaded = HarReplayer::load(JsonValue::parse(exporter.exportHAR()));
+    CDP_CHECK(static_cast<bool>(loaded));
+    if (loaded) CDP_CHECK(loaded.value()->size() == 0 && loaded.value()->stats().skipped == 3);
+}
+
+void testBodyReplyAfterDestruction() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>([](const cdptest::Command& command) {
+        return command.method == "Network.getResponseBody" ? std::string() : cdptest::ScriptedTransport::result();
+    });
+    auto* transport = owned.get();
+    CDPClient client;
+    CDP_CHECK(client.connect(std::move(owned)));
+
+    {
+        HARExporter exporter(client.connection());
+        exporter.setRecordBodies(true);
+        CDP_CHECK(exporter.startRecording().ok());
+        pushLoads(*transport);
+        CDP_CHECK(waitFor([&] { return transport->count("Network.getResponseBody") == 3; }));
+    }
+
+    for (const auto& command : transport->commands()) {
+        if (command.method != "Network.getResponseBody") continue;
+        transport->push("{\"id\":" + std::to_string(command.id) + R"(,"result":{"body":"x","base64Encoded":false}})");
+    }
+    CDP_CHECK(waitFor([&] { return client.connection().pendingCommandCount() == 0; }));
+}
+
+}
+
+int main() {
+    testRoundTripGetAndPost();
+    testBodiesDisabled();
+    testBodyReplyAfterDestruction();
+    return cdptest::finish("har_replayer_test");
+}
@@ -0,0 +1,187 @@
+// ManagedPage recycle tests.
+// Pages run against a scripted browser over flat sessions; each recycle
+// attaches a new session, so commands are told apart by their sessionId.
+
+#include "TestUtil.hpp"
+#include "FakeBrowser.hpp"
+#include <cdp/highlevel/Browser.hpp>
+#include <cdp/highlevel/NetworkInterceptor.hpp>
+#include <memory>
+#include <string>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using cdp::CDPClientConfig;
+using cdp::ProcessMonitor;
+using cdp::ProcessMonitorOptions;
+using cdp::highlevel::Browser;
+using cdp::highlevel::InterceptorHandle;
+using cdp::highlevel::ManagedPage;
+using cdp::highlevel::NetworkInterceptor;
+using cdp::highlevel::PageRecyclePolicy;
+
+namespace {
+
+size_t countOn(const cdptest::ScriptedTransport& transport, const std::string& method,
+               const std::string& sessionId) {
+    size_t n = 0;
+    for (const auto& command : transport.commands()) {
+        n += command.method == method && command.sessionId == sessionId;
+    }
+    return n;
+}
+
+std::string lastSession(const cdptest::ScriptedTransport& transport) {
+    std::string sessionId;
+    for (const auto& command : transport.commands()) {
+        if (!command.sessionId.empty()) sessionId = command.sessionId;
+    }
+    return sessionId;
+}
+
+void testRecycleReappliesInterception() {
+    cdptest::FakeChrome chrome;
+    Browser browser;
+    CDP_CHECK(browser.connect(chrome.create()).ok());
+    auto created = browser.newPage();
+    CDP_CHECK(created.ok());
+    if (!created) return;
+    ManagedPage* page = created.value();
+    std::string firstSession = lastSession(*chrome.transport);
+
+    NetworkInterceptor interceptor(page->client());
+    InterceptorHandle handle = interceptor.blockResource("*.png");
+    CDP_CHECK(interceptor.enable().ok());
+    CDP_CHECK(countOn(*chrome.transport, "Fetch.enable", firstSession) == 1);
+
+    std::string oldTarget = page->targetId();
+    CDP_CHECK(page->recycle().ok());
+    CDP_CHECK(page->targetId() != oldTarget && page->recycleCount() == 1);
+
+    std::string secondSession = lastSession(*chrome.transport);
+    CDP_CHECK(secondSession != firstSession);
+    CDP_CHECK(countOn(*chrome.transport, "Fetch.enable", secondSession) == 1);
+    CDP_CHECK(countOn(*chrome.transport, "Target.getTargetInfo", secondSession) == 1);
+    std::string firstPatterns;
+    std::string secondPatterns;
+    for (const auto& command : chrome.transport->commands()) {
+        if (command.method != "Fetch.enable") continue;
+        (command.sessionId == firstSession ? firstPatterns : secondPatterns) = command.params.serialize();
+    }
+    CDP_CHECK(!firstPatterns.empty() && firstPatterns == secondPatterns);
+
+    CDP_CHECK(interceptor.disable().ok());
+    CDP_CHECK(page->recycle().ok());
+    CDP_CHECK(countOn(*chrome.transport, "Fetch.enable", lastSession(*chrome.transport)) == 0);
+}
+
+void testReapplyFailureFailsRecycle() {
+    cdptest::FakeChrome chrome;
+    Browser browser;
+    CDP_CHECK(browser.connect(chrome.create()).ok());
+    auto created = browser.newPage();
+    CDP_CHECK(created.ok());
+    if (!created) return;
+    ManagedPage* page = created.value();
+
+    NetworkInterceptor interceptor(page->client());
+    InterceptorHandle handle = interceptor.blockResource("*.png");
+    CDP_CHECK(interceptor.enable().ok());
+
+    chrome.script = [](const cdptest::Command& command) {
+        if (command.method == "Fetch.enable") return cdptest::ScriptedTransport::error("Fetch unavailable");
+        return std::string();
+    };
+    std::string oldTarget = page->targetId();
+    auto recycled = page->recycle();
+    CDP_CHECK(!recycled.ok());
+    CDP_CHECK_MSG(!recycled.ok() && recycled.error().message.find("Fetch unavailable") != std::string::npos,
+                  recycled.ok() ? "" : recycled.error().message);
+    CDP_CHECK(page->targetId() == oldTarget && page->recycleCount() == 0);
+}
+
+void testInspectorFollowsCrashDetection() {
+    cdptest::FakeChrome chrome;
+    Browser browser;
+    CDP_CHECK(browser.connect(chrome.create()).ok());
+    auto plain = browser.newPage();
+    CDP_CHECK(plain.ok());
+    if (!plain) return;
+    CDP_CHECK(chrome.transport->count("Inspector.enable") == 0);
+    CDP_CHECK(plain.value()->recycle().ok());
+    CDP_CHECK(chrome.transport->count("Inspector.enable") == 0);
+
+    cdptest::FakeChrome watched;
+    CDPClientConfig config;
+    config.detectCrashes = true;
+    Browser detecting(config);
+    CDP_CHECK(detecting.connect(watched.create()).ok());
+    auto page = detecting.newPage();
+    CDP_CHECK(page.ok());
+    if (!page) return;
+    std::string firstSession = lastSession(*watched.transport);
+    CDP_CHECK(countOn(*watched.transport, "Inspector.enable", firstSession) == 1);
+    CDP_CHECK(page.value()->recycle().ok());
+    CDP_CHECK(countOn(*watched.transport, "Inspector.enable", lastSession(*watched.transport)) == 1);
+    CDP_CHECK(watched.transport->count("Inspector.enable") == 2);
+}
+
+#ifdef __linux__
+// The monitor is rooted at this process, which the scripted browser reports as a renderer.
+void testRendererRssBudget() {
+    cdptest::FakeChrome chrome;
+    std::string pid = std::to_string(getpid());
+    chrome.script = [pid](const cdptest::Command& command) {
+        if (command.method != "SystemInfo.getProcessInfo") return std::string();
+        return cdptest::ScriptedTransport::result(R"({"processInfo":[{"id":)" + pid +
+                                                  R"(,"type":"renderer","cpuTime":0}]})");
+    };
+    Browser browser;
+    CDP_CHECK(browser.connect(chrome.create()).ok());
+    auto created = browser.newPage();
+    CDP_CHECK(created.ok());
+    if (!created) return;
+    ManagedPage* page = created.value();
+
+    PageRecyclePolicy policy;
+    policy.maxRendererRssBytes = 1;
+    CDP_CHECK(policy.enabled());
+    page->setRecyclePolicy(policy);
+    CDP_CHECK(page->recycleReason().empty());
+
+    ProcessMonitorOptions options;
+    options.collectPss = false;
+    options.collectFds = false;
+    options.processInfoEverySamples = 1;
+    ProcessMonitor monitor(static_cast<uint32_t>(getpid()), options);
+    browser.attachProcessMonitor(monitor);
+    CDP_CHECK(browser.processMonitor() == &monitor);
+    CDP_CHECK(page->recycleReason() == "rendererRss");
+    CDP_CHECK(chrome.transport->count("SystemInfo.getProcessInfo") == 1);
+    auto sample = monitor.latest();
+    CDP_CHECK(sample && sample->rssBytesOfType("renderer") > 0);
+
+    auto recycled = page->recycleIfNeeded();
+    CDP_CHECK(recycled.ok() && recycled.value());
+    CDP_CHECK(page->recycleCount() == 1);
+
+    policy.maxRendererRssBytes = sample ? sample->rssBytesOfType("renderer") * 4 : 0;
+    page->setRecyclePolicy(policy);
+    CDP_CHECK(page->recycleReason().empty());
+    auto kept = page->recycleIfNeeded();
+    CDP_CHECK(kept.ok() && !kept.value());
+}
+#endif
+
+}
+
+int main() {
+    testRecycleReappliesInterception();
+    testReapplyFailureFailsRecycle();
+    testInspectorFollowsCrashDetection();
+#ifdef __linux__
+    testRendererRssBudget();
+#endif
+    return cdptest::finish("managed_page_test");
+}
@@ -0,0 +1,152 @@
+// NetworkCapture column store tests.
+// Network events are fed straight into recordEvent(), so no browser or
+// connection is needed; writeHAR output is parsed back and checked.
+
+#include "TestUtil.hpp"
+#include "FakeBrowser.hpp"
+#include <cdp/highlevel/NetworkCapture.hpp>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using cdp::CDPConnection;
+using cdp::JsonValue;
+using cdp::highlevel::NetworkCapture;
+using cdp::highlevel::NetworkCaptureOptions;
+
+namespace {
+
+void feed(NetworkCapture& capture, const std::string& method, const std::string& params) {
+    capture.recordEvent(method, JsonValue::parse(params));
+}
+
+void recordSession(NetworkCapture& capture) {
+    feed(capture, "Network.requestWillBeSent", R"({"requestId":"1","type":"Document","timestamp":10.0,
+        "wallTime":1700000000.5,"request":{"url":"https://a.test/","method":"GET","headers":{"Accept":"text/html"}}})");
+    feed(capture, "Network.requestWillBeSent", R"({"requestId":"1","type":"Document","timestamp":10.1,
+        "wallTime":1700000000.6,"request":{"url":"https://a.test/home","method":"GET","headers":{}},
+        "redirectResponse":{"status":301,"statusText":"Moved","mimeType":"","headers":{"Location":"/home"}}})");
+    feed(capture, "Network.requestWillBeSent", R"({"requestId":"2","type":"Script","timestamp":10.2,
+        "wallTime":1700000000.7,"request":{"url":"https://cdn.test/x.js","method":"GET","headers":{}}})");
+    feed(capture, "Network.responseReceived", R"({"requestId":"1","type":"Document","response":{"status":200,
+        "statusText":"OK","mimeType":"text/html","headers":{"Content-Type":"text/html"},
+        "timing":{"dnsStart":0,"dnsEnd":5,"connectStart":5,"connectEnd":20,"sslStart":10,"sslEnd":20,
+                  "sendStart":21,"sendEnd":22,"receiveHeadersEnd":50}}})");
+    feed(capture, "Network.loadingFailed", R"({"requestId":"2","type":"Script","timestamp":10.25,
+        "errorText":"net::ERR_BLOCKED_BY_CLIENT"})");
+    feed(capture, "Network.loadingFinished", R"({"requestId":"1","timestamp":10.35,"encodedDataLength":1234})");
+    feed(capture, "Network.requestWillBeSent", R"({"requestId":"3","type":"XHR","timestamp":10.4,
+        "request":{"url":"https://a.test/pending","method":"POST","headers":{}}})");
+    feed(capture, "Network.loadingFinished", R"({"requestId":"unknown","timestamp":11,"encodedDataLength":9})");
+}
+
+bool near(double a, double b) { return std::fabs(a - b) < 0.01; }
+
+void testColumns() {
+    CDPConnection connection;
+    NetworkCapture capture(connection);
+    recordSession(capture);
+
+    CDP_CHECK(capture.size() == 4);
+    CDP_CHECK(capture.pendingCount() == 1);
+    CDP_CHECK(capture.failedCount() == 1);
+    CDP_CHECK(capture.totalBytes() == 1234);
+    CDP_CHECK(capture.requestsByHost().at("a.test") == 3);
+    CDP_CHECK(capture.requestsByHost().at("cdn.test") == 1);
+    CDP_CHECK(capture.bytesByType().at("Document") == 1234);
+    CDP_CHECK(capture.bytesByHost().at("cdn.test") == 0);
+
+    auto redirect = capture.entry(0);
+    CDP_CHECK(redirect.url == "https://a.test/" && redirect.status == 301 && redirect.statusText == "Moved");
+    CDP_CHECK(redirect.responseHeaders.at("Location") == "/home");
+    CDP_CHECK(redirect.requestHeaders.at("Accept") == "text/html");
+    CDP_CHECK(near(redirect.duration, 100));
+
+    auto page = capture.entry(1);
+    CDP_CHECK(page.url == "https://a.test/home" && page.status == 200 && page.mimeType == "text/html");
+    CDP_CHECK(page.responseHeaders.at("Content-Type") == "text/html");
+    CDP_CHECK(page.responseSize == 1234);
+    CDP_CHECK(near(page.duration, 250));
+    CDP_CHECK(near(page.dns, 5) && near(page.connect, 15) && near(page.ssl, 10));
+    CDP_CHECK(near(page.send, 1) && near(page.wait, 28));
+
+    auto failed = capture.entry(2);
+    CDP_CHECK(failed.errorText == "net::ERR_BLOCKED_BY_CLIENT" && failed.resourceType == "Script");
+    CDP_CHECK(capture.entry(9).url.empty());
+
+    auto slowest = capture.slowest(2);
+    CDP_CHECK(slowest.size() == 2 && slowest[0].url == "https://a.test/home");
+    CDP_CHECK(capture.memoryUsage() > 0);
+
+    capture.clear();
+    CDP_CHECK(capture.size() == 0 && capture.pendingCount() == 0 && capture.totalBytes() == 0);
+    feed(capture, "Network.requestWillBeSent", R"({"requestId":"9","request":{"url":"https://b.test/","method":"GET"}})");
+    CDP_CHECK(capture.size() == 1 && capture.entry(0).url == "https://b.test/");
+}
+
+void testWriteHar() {
+    CDPConnection connection;
+    NetworkCapture capture(connection);
+    recordSession(capture);
+
+    std::ostringstream out;
+    CDP_CHECK(capture.writeHAR(out).ok());
+    JsonValue har = JsonValue::parse(out.str());
+    const auto& entries = har["log"]["entries"].asArray();
+    CDP_CHECK(har["log"]["version"].getString() == "1.2");
+    CDP_CHECK(entries.size() == 3);
+    if (entries.size() == 3) {
+        CDP_CHECK(entries[0]["response"]["status"].getInt() == 301);
+        CDP_CHECK(entries[1]["request"]["url"].getString() == "https://a.test/home");
+        CDP_CHECK(entries[1]["response"]["content"]["size"].getInt() == 1234);
+        CDP_CHECK(entries[1]["timings"]["dns"].getNumber() == 5);
+        CDP_CHECK(entries[2]["_error"].getString() == "net::ERR_BLOCKED_BY_CLIENT");
+    }
+
+    NetworkCaptureOptions options;
+    options.includePending = true;
+    options.captureHeaders = false;
+    NetworkCapture all(connection, options);
+    recordSession(all);
+    std::ostringstream allOut;
+    CDP_CHECK(all.writeHAR(allOut).ok());
+    JsonValue allHar = JsonValue::parse(allOut.str());
+    CDP_CHECK(allHar["log"]["entries"].asArray().size() == 4);
+    CDP_CHECK(all.entry(1).responseHeaders.empty());
+    CDP_CHECK(all.entry(3).method == "POST");
+}
+
+void testStartSubscribes() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>();
+    auto* transport = owned.get();
+    CDPConnection connection;
+    CDP_CHECK(connection.connect(std::move(owned)));
+    connection.startMessageThread();
+
+    NetworkCapture capture(connection);
+    CDP_CHECK(capture.start().ok());
+    CDP_CHECK(capture.isRecording());
+    CDP_CHECK(transport->count("Network.enable") == 1);
+    transport->push(R"({"method":"Network.requestWillBeSent","params":{"requestId":"1",
+        "request":{"url":"https://a.test/","method":"GET","headers":{}}}})");
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (capture.size() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    CDP_CHECK(capture.size() == 1);
+    capture.stop();
+    CDP_CHECK(!capture.isRecording());
+    connection.disconnect();
+}
+
+}
+
+int main() {
+    testColumns();
+    testWriteHar();
+    testStartSubscribes();
+    return cdptest::finish("network_capture_test");
+}
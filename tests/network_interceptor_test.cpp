@@ -0,0 +1,294 @@
+// NetworkInterceptor pattern derivation tests.
+// Rules are added to an interceptor that was never enabled, so nothing is
+// sent; requestPatterns() reports what Fetch.enable would receive.
+
+#include "TestUtil.hpp"
+#include "FakeBrowser.hpp"
+#include <cdp/highlevel/NetworkInterceptor.hpp>
+#include <cdp/highlevel/HarReplayer.hpp>
+#include <cdp/highlevel/AdblockEngine.hpp>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cdp::CDPClient;
+using cdp::HeaderEntry;
+using cdp::JsonValue;
+using cdp::RequestPattern;
+using cdp::highlevel::HarReplayer;
+using cdp::highlevel::InterceptAction;
+using cdp::highlevel::InterceptedRequest;
+using cdp::highlevel::InterceptorHandle;
+using cdp::highlevel::InterceptorOptions;
+using cdp::highlevel::MockResponse;
+using cdp::highlevel::NetworkInterceptor;
+
+namespace {
+
+InterceptAction block(const InterceptedRequest&) {
+    return InterceptAction::fail("Blocked");
+}
+
+bool hasPattern(const std::vector<RequestPattern>& patterns, const std::string& url,
+                const std::string& type = "", const std::string& stage = "Request") {
+    for (const auto& p : patterns) {
+        if (p.urlPattern == url && p.resourceType == type && p.requestStage == stage) return true;
+    }
+    return false;
+}
+
+std::string describe(const std::vector<RequestPattern>& patterns) {
+    std::string out;
+    for (const auto& p : patterns) {
+        out += "[" + p.urlPattern + " " + p.resourceType + " " + p.requestStage + "]";
+    }
+    return out;
+}
+
+void testLetterFreeAndHostPatterns() {
+    CDPClient client;
+    NetworkInterceptor interceptor(client);
+    CDP_CHECK(interceptor.requestPatterns().empty());
+
+    auto digits = interceptor.intercept("*/1234/*", block);
+    auto host = interceptor.intercept("*://*.DoubleClick.NET/*", block);
+    auto hostOnly = interceptor.intercept("https://Ads.Example.com", block);
+    auto hostAndPath = interceptor.intercept("*://cdn.example.com/Images/*.PNG", block);
+
+    auto patterns = interceptor.requestPatterns();
+    CDP_CHECK_MSG(patterns.size() == 4, describe(patterns));
+    CDP_CHECK(hasPattern(patterns, "*/1234/*"));
+    CDP_CHECK(hasPattern(patterns, "*://*.doubleclick.net/*"));
+    CDP_CHECK(hasPattern(patterns, "*https://ads.example.com*"));
+    CDP_CHECK(hasPattern(patterns, "*://cdn.example.com/*"));
+    CDP_CHECK(!hasPattern(patterns, "*"));
+}
+
+void testCaseDependentPatternsCatchAll() {
+    CDPClient client;
+    NetworkInterceptor interceptor(client);
+
+    auto host = interceptor.intercept("*://ads.example.com/*", block);
+    auto path = interceptor.intercept("*.png", block);
+    auto redirect = interceptor.intercept("*/go?u=https://x.example.com/*", block);
+
+    auto patterns = interceptor.requestPatterns();
+    CDP_CHECK_MSG(patterns.size() == 1, describe(patterns));
+    CDP_CHECK(hasPattern(patterns, "*"));
+}
+
+void testResourceTypesAndStages() {
+    CDPClient client;
+    NetworkInterceptor interceptor(client);
+
+    auto images = interceptor.intercept("*/2024/*", "Image", block);
+    auto scripts = interceptor.intercept("*.js", "Script", block);
+    auto scriptsToo = interceptor.intercept("*/123/*", "Script", block);
+    auto responses = interceptor.interceptResponse("*://api.example.com/*", [](const InterceptedRequest&) {
+        return InterceptAction::defer();
+    });
+
+    auto patterns = interceptor.requestPatterns();
+    CDP_CHECK_MSG(patterns.size() == 3, describe(patterns));
+    CDP_CHECK(hasPattern(patterns, "*/2024/*", "Image"));
+    CDP_CHECK(hasPattern(patterns, "*", "Script"));
+    CDP_CHECK(hasPattern(patterns, "*://api.example.com/*", "", "Response"));
+}
+
+void testCaseSensitiveOption() {
+    CDPClient client;
+    InterceptorOptions options;
+    options.caseSensitivePatterns = true;
+    NetworkInterceptor interceptor(client, options);
+
+    auto ads = interceptor.intercept("*doubleclick.net*", block);
+    auto images = interceptor.intercept("*.png", block);
+    auto api = interceptor.intercept("*/api/*", block);
+
+    auto patterns = interceptor.requestPatterns();
+    CDP_CHECK_MSG(patterns.size() == 3, describe(patterns));
+    CDP_CHECK(hasPattern(patterns, "*doubleclick.net*"));
+    CDP_CHECK(hasPattern(patterns, "*.png*"));
+    CDP_CHECK(hasPattern(patterns, "*/api/*"));
+}
+
+void testFilteringAndRemoval() {
+    CDPClient client;
+    NetworkInterceptor interceptor(client);
+
+    InterceptorHandle handle = interceptor.intercept("*/1234/*", block);
+    CDP_CHECK(hasPattern(interceptor.requestPatterns(), "*/1234/*"));
+
+    CDP_CHECK(static_cast<bool>(interceptor.setPatternFiltering(false)));
+    auto unfiltered = interceptor.requestPatterns();
+    CDP_CHECK_MSG(unfiltered.size() == 1 && hasPattern(unfiltered, "*"), describe(unfiltered));
+    CDP_CHECK(static_cast<bool>(interceptor.setPatternFiltering(true)));
+
+    handle.remove();
+    CDP_CHECK(interceptor.requestPatterns().empty());
+
+    auto wildcard = interceptor.intercept("***", block);
+    CDP_CHECK(hasPattern(interceptor.requestPatterns(), "*"));
+    CDP_CHECK(static_cast<bool>(interceptor.clear()));
+    CDP_CHECK(interceptor.requestPatterns().empty());
+}
+
+size_t count(const std::string& haystack, const std::string& needle) {
+    size_t n = 0;
+    for (size_t at = haystack.find(needle); at != std::string::npos; at = haystack.find(needle, at + 1)) n++;
+    return n;
+}
+
+void testRepeatedResponseHeaders() {
+    std::vector<HeaderEntry> headers = {
+        {"Set-Cookie", "a=1; Path=/"}, {"Set-Cookie", "b=2; Path=/"}, {"Content-Type", "text/html"}};
+    auto mock = MockResponse::preEncoded(nullptr, 0, headers);
+    std::string params = mock.fulfillParams()->json();
+    CDP_CHECK_MSG(count(params, "\"Set-Cookie\"") == 2, params);
+    CDP_CHECK(params.find("a=1; Path=/") != std::string::npos);
+    CDP_CHECK(params.find("b=2; Path=/") != std::string::npos);
+
+    auto har = JsonValue::parse(R"({"log":{"entries":[{
+        "request":{"method":"GET","url":"https://example.com/login"},
+        "response":{"status":200,"headers":[
+            {"name":"Set-Cookie","value":"session=abc"},
+            {"name":"Set-Cookie","value":"theme=dark"},
+            {"name":"Content-Length","value":"2"}],
+            "content":{"text":"ok"}}}]}})");
+    auto replayer = HarReplayer::load(har);
+    CDP_CHECK(static_cast<bool>(replayer));
+    auto response = replayer.value()->find("GET", "https://example.com/login");
+    CDP_CHECK(response != nullptr);
+    if (response) {
+        std::string json = response->fulfillParams()->json();
+        CDP_CHECK_MSG(count(json, "\"Set-Cookie\"") == 2, json);
+        CDP_CHECK(json.find("session=abc") != std::string::npos);
+        CDP_CHECK(json.find("theme=dark") != std::string::npos);
+        CDP_CHECK(json.find("Content-Length") == std::string::npos);
+    }
+}
+
+void testRuleApplyErrors() {
+    auto transport = std::make_unique<cdptest::ScriptedTransport>([](const cdptest::Command& command) {
+        if (command.method == "Fetch.enable") {
+            for (const auto& pattern : command.params["patterns"].asArray()) {
+                if (pattern["urlPattern"].getString() == "*/5678/*") {
+                    return cdptest::ScriptedTransport::error("Invalid pattern");
+                }
+            }
+        }
+        return cdptest::ScriptedTransport::result();
+    });
+    CDPClient client;
+    CDP_CHECK(client.connect(std::move(transport)));
+    NetworkInterceptor interceptor(client);
+    CDP_CHECK(interceptor.enable().ok());
+
+    auto accepted = interceptor.intercept("*/1234/*", block);
+    CDP_CHECK(accepted.applied().ok());
+
+    auto rejected = interceptor.intercept("*/5678/*", block);
+    CDP_CHECK(!rejected.applied().ok());
+    CDP_CHECK(rejected.applied().hasError() && rejected.applied().error().message == "Invalid pattern");
+    CDP_CHECK(rejected.isActive());
+
+    InterceptorHandle moved = std::move(rejected);
+    CDP_CHECK(!moved.applied().ok());
+
+    moved.remove();
+    auto again = interceptor.intercept("*/90/*", block);
+    CDP_CHECK(again.applied().ok());
+    interceptor.disable();
+}
+
+bool waitFor(const std::function<bool()>& condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+void testDeadlinesReleasedOnResolve() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>();
+    auto* transport = owned.get();
+    CDPClient client;
+    CDP_CHECK(client.connect(std::move(owned)));
+
+    InterceptorOptions options;
+    options.workerThreads = 1;
+    options.decisionTimeoutMs = 60000;
+    NetworkInterceptor interceptor(client, options);
+    CDP_CHECK(interceptor.enable().ok());
+    auto handle = interceptor.intercept("*/1234/*", block);
+
+    for (int i = 0; i < 3; ++i) {
+        transport->push(R"({"method":"Fetch.requestPaused","params":{"requestId":"r)" + std::to_string(i) +
+                        R"(","request":{"url":"https://example.com/1234/a","method":"GET","headers":{}},)"
+                        R"("resourceType":"Document","frameId":"F"}})");
+    }
+    CDP_CHECK(waitFor([&] { return transport->count("Fetch.failRequest") == 3; }));
+    auto stats = interceptor.stats();
+    CDP_CHECK(stats.failed == 3);
+    CDP_CHECK(stats.timedOut == 0);
+    CDP_CHECK_MSG(stats.pendingDeadlines == 0, std::to_string(stats.pendingDeadlines));
+    interceptor.disable();
+}
+
+std::string paused(const std::string& id, const std::string& url, const std::string& type,
+                   const std::string& frameId, const std::string& referer) {
+    return R"({"method":"Fetch.requestPaused","params":{"requestId":")" + id + R"(","request":{"url":")" + url +
+           R"(","method":"GET","headers":{"Referer":")" + referer + R"("}},"resourceType":")" + type +
+           R"(","frameId":")" + frameId + R"("}})";
+}
+
+void testFilterSourceIsFrameDocument() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>([](const cdptest::Command& command) {
+        if (command.method == "Target.getTargetInfo") {
+            return cdptest::ScriptedTransport::result(R"({"targetInfo":{"targetId":"MAIN"}})");
+        }
+        return cdptest::ScriptedTransport::result();
+    });
+    auto* transport = owned.get();
+    CDPClient client;
+    CDP_CHECK(client.connect(std::move(owned)));
+
+    auto engine = cdp::highlevel::AdblockEngine::compile("||ads.example^$third-party\n");
+    CDP_CHECK(engine.ok());
+    if (!engine.ok()) return;
+    NetworkInterceptor interceptor(client);
+    CDP_CHECK(interceptor.enable().ok());
+    auto handle = interceptor.blockWithFilters(engine.value());
+
+    transport->push(R"({"method":"Page.frameNavigated","params":{"frame":{"id":"MAIN","url":"https://site.test/"}}})");
+    transport->push(R"({"method":"Page.frameAttached","params":{"frameId":"CHILD","parentFrameId":"MAIN"}})");
+    transport->push(paused("r1", "https://ads.example/a.js", "Script", "MAIN", "https://ads.example/"));
+    transport->push(paused("r2", "https://ads.example/frame", "Document", "CHILD", "https://ads.example/"));
+    CDP_CHECK(waitFor([&] { return transport->count("Fetch.failRequest") == 2; }));
+
+    transport->push(R"({"method":"Page.frameNavigated","params":{"frame":{"id":"CHILD","parentId":"MAIN","url":"https://ads.example/frame"}}})");
+    transport->push(paused("r3", "https://ads.example/b.js", "Script", "CHILD", "https://site.test/"));
+    transport->push(paused("r4", "https://ads.example/", "Document", "MAIN", "https://site.test/"));
+    CDP_CHECK(waitFor([&] { return transport->count("Fetch.continueRequest") == 2; }));
+    CDP_CHECK(transport->count("Fetch.failRequest") == 2);
+    interceptor.disable();
+}
+
+}
+
+int main() {
+    testLetterFreeAndHostPatterns();
+    testCaseDependentPatternsCatchAll();
+    testResourceTypesAndStages();
+    testCaseSensitiveOption();
+    testFilteringAndRemoval();
+    testRepeatedResponseHeaders();
+    testRuleApplyErrors();
+    testDeadlinesReleasedOnResolve();
+    testFilterSourceIsFrameDocument();
+    return cdptest::finish("network_interceptor_test");
+}
@@ -0,0 +1,133 @@
+// PagePool lease/return/recycle tests.
+// A scripted browser answers Target and page commands over flat sessions and
+// fires Page.loadEventFired for every navigation.
+
+#include "TestUtil.hpp"
+#include "FakeBrowser.hpp"
+#include <cdp/highlevel/PagePool.hpp>
+#include <memory>
+#include <string>
+
+using cdp::CDPEvent;
+namespace ErrorCode = cdp::highlevel::ErrorCode;
+using cdp::highlevel::Browser;
+using cdp::highlevel::ManagedPage;
+using cdp::highlevel::PageLease;
+using cdp::highlevel::PagePool;
+using cdp::highlevel::PagePoolOptions;
+
+namespace {
+
+PagePoolOptions poolOptions(size_t pages) {
+    PagePoolOptions options;
+    options.pagesPerContext = pages;
+    options.resetTimeoutMs = 2000;
+    return options;
+}
+
+void testLeaseAndReturn() {
+    cdptest::FakeChrome chrome;
+    Browser browser;
+    CDP_CHECK(browser.connect(chrome.create()).ok());
+
+    PagePool pool(browser, poolOptions(2));
+    auto started = pool.start();
+    CDP_CHECK_MSG(started.ok(), started.ok() ? "" : started.error().message);
+    if (!started) return;
+    CDP_CHECK(pool.stats().capacity == 2 && pool.stats().idle == 2);
+
+    auto first = pool.lease(1000);
+    auto second = pool.lease(1000);
+    CDP_CHECK(first.ok() && second.ok());
+    if (!first || !second) return;
+    CDP_CHECK(first.value().get() != second.value().get());
+
+    auto none = pool.lease(20);
+    CDP_CHECK(!none.ok() && none.error().code == ErrorCode::Timeout);
+    CDP_CHECK(pool.stats().leased == 2 && pool.stats().leaseTimeouts == 1);
+
+    ManagedPage* page = first.value().get();
+    auto& connection = page->client().connection();
+    connection.onEvent("Network.responseReceived", [](const CDPEvent&) {});
+    connection.onAnyEvent([](const CDPEvent&) {});
+    auto kept = page->client().Network.onScoped("dataReceived", [](const CDPEvent&) {});
+    first.value().release();
+    CDP_CHECK(!first.value().valid());
+
+    auto methods = connection.eventHandlerMethods();
+    auto has = [&](const std::string& method) {
+        for (const auto& m : methods) {
+            if (m == method) return true;
+        }
+        return false;
+    };
+    CDP_CHECK(!has("Network.responseReceived"));
+    CDP_CHECK(has("Network.dataReceived"));
+
+    auto stats = pool.stats();
+    CDP_CHECK(stats.returns == 1 && stats.leased == 1 && stats.idle == 1);
+
+    auto again = pool.lease(1000);
+    CDP_CHECK(again.ok() && again.value().get() == page);
+    CDP_CHECK(pool.stats().leases == 3);
+}
+
+void testRecycleOnReturn() {
+    cdptest::FakeChrome chrome;
+    Browser browser;
+    CDP_CHECK(browser.connect(chrome.create()).ok());
+
+    auto options = poolOptions(1);
+    options.recyclePolicy.maxNavigations = 1;
+    PagePool pool(browser, options);
+    CDP_CHECK(pool.start().ok());
+
+    size_t targetsBefore = chrome.transport->count("Target.createTarget");
+    {
+        auto lease = pool.lease(1000);
+        CDP_CHECK(lease.ok());
+        if (!lease) return;
+        CDP_CHECK(lease.value()->page().navigate("https://a.test/", 2000).ok());
+    }
+
+    auto stats = pool.stats();
+    CDP_CHECK(stats.recycledPages == 1 && stats.idle == 1 && stats.replacedPages == 0);
+    CDP_CHECK(chrome.transport->count("Target.createTarget") == targetsBefore + 1);
+
+    auto lease = pool.lease(1000);
+    CDP_CHECK(lease.ok() && lease.value()->recycleCount() == 1);
+}
+
+void testShutdownWaitsForLease() {
+    cdptest::FakeChrome chrome;
+    Browser browser;
+    CDP_CHECK(browser.connect(chrome.create()).ok());
+
+    auto pool = std::make_unique<PagePool>(browser, poolOptions(2));
+    CDP_CHECK(pool->start().ok());
+    auto lease = pool->lease(1000);
+    CDP_CHECK(lease.ok());
+    if (!lease) return;
+
+    pool->shutdown();
+    CDP_CHECK(lease.value().get() != nullptr && lease.value()->isConnected());
+    CDP_CHECK(chrome.transport->count("Target.closeTarget") == 1);
+    CDP_CHECK(chrome.transport->count("Target.disposeBrowserContext") == 0);
+    CDP_CHECK(!pool->start().ok());
+    CDP_CHECK(!pool->lease(10).ok());
+
+    lease.value().release();
+    CDP_CHECK(chrome.transport->count("Target.closeTarget") == 2);
+    CDP_CHECK(chrome.transport->count("Target.disposeBrowserContext") == 1);
+    CDP_CHECK(pool->stats().leased == 0);
+    pool.reset();
+}
+
+}
+
+int main() {
+    testLeaseAndReturn();
+    testRecycleOnReturn();
+    testShutdownWaitsForLease();
+    return cdptest::finish("page_pool_test");
+}
@@ -0,0 +1,365 @@
+// PNG and inflate decoder tests.
+// Fixtures are 3x5 images whose rows cycle through filter types 0-4; the
+// expected RGBA follows the decoder's 8-bit expansion rules.
+
+#include "TestUtil.hpp"
+#include <cdp/core/Png.hpp>
+#include <cdp/core/Inflate.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::vector<uint8_t> kGray1Png = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x05, 0x01, 0x00, 0x00, 0x00, 0x00, 0xa8, 0x0a, 0x6b,
+    0x0f, 0x00, 0x00, 0x00, 0x12, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x58, 0xc0, 0xc8, 0xc0,
+    0xd4, 0xc0, 0xfc, 0x80, 0x25, 0x01, 0x00, 0x0b, 0x52, 0x02, 0x6b, 0xb7, 0x42, 0xfe, 0x8c, 0x00,
+    0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+const std::vector<uint8_t> kGray1Rgba = {
+    0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0xff,
+    0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0xff,
+    0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff
+};
+
+const std::vector<uint8_t> kGray8KeyPng = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x05, 0x08, 0x00, 0x00, 0x00, 0x00, 0xa5, 0x1a, 0x09,
+    0x7e, 0x00, 0x00, 0x00, 0x02, 0x74, 0x52, 0x4e, 0x53, 0x00, 0x4d, 0x7e, 0xfe, 0xf0, 0x15, 0x00,
+    0x00, 0x00, 0x1c, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0xd0, 0xbb, 0x29, 0xc7, 0x68, 0x6f,
+    0xbc, 0x96, 0xa9, 0xe7, 0x76, 0x10, 0xf3, 0x26, 0x21, 0x2b, 0x96, 0xfd, 0xc5, 0x2b, 0x00, 0x3f,
+    0xfd, 0x06, 0xe0, 0xa7, 0xaf, 0x26, 0xbb, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae,
+    0x42, 0x60, 0x82
+};
+const std::vector<uint8_t> kGray8KeyRgba = {
+    0x2e, 0x2e, 0x2e, 0xff, 0xd9, 0xd9, 0xd9, 0xff, 0x1e, 0x1e, 0x1e, 0xff, 0x3f, 0x3f, 0x3f, 0xff,
+    0x72, 0x72, 0x72, 0xff, 0x1f, 0x1f, 0x1f, 0xff, 0xcb, 0xcb, 0xcb, 0xff, 0x4d, 0x4d, 0x4d, 0x00,
+    0x71, 0x71, 0x71, 0xff, 0x17, 0x17, 0x17, 0xff, 0x44, 0x44, 0x44, 0xff, 0x94, 0x94, 0x94, 0xff,
+    0xd6, 0xd6, 0xd6, 0xff, 0x49, 0x49, 0x49, 0xff, 0x3c, 0x3c, 0x3c, 0xff
+};
+
+const std::vector<uint8_t> kGray16Png = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x05, 0x10, 0x00, 0x00, 0x00, 0x00, 0xf5, 0x8a, 0xd5,
+    0x3d, 0x00, 0x00, 0x00, 0x2c, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x98, 0xfb, 0x31, 0xa6,
+    0xc3, 0xe4, 0x30, 0x63, 0x82, 0x41, 0x5c, 0x55, 0xb1, 0x05, 0xd3, 0x81, 0xaf, 0x09, 0xb7, 0x2c,
+    0x26, 0x32, 0xbf, 0x93, 0xf0, 0x99, 0xf6, 0x5f, 0x9d, 0xe5, 0x83, 0x25, 0x9f, 0x94, 0xa4, 0x14,
+    0x00, 0x0a, 0x0f, 0x0d, 0xd1, 0x75, 0xac, 0x80, 0x30, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e,
+    0x44, 0xae, 0x42, 0x60, 0x82
+};
+const std::vector<uint8_t> kGray16Rgba = {
+    0x9d, 0x9d, 0x9d, 0xff, 0x5c, 0x5c, 0x5c, 0xff, 0x34, 0x34, 0x34, 0xff, 0x60, 0x60, 0x60, 0xff,
+    0xbe, 0xbe, 0xbe, 0xff, 0x31, 0x31, 0x31, 0xff, 0x20, 0x20, 0x20, 0xff, 0x1e, 0x1e, 0x1e, 0xff,
+    0x69, 0x69, 0x69, 0xff, 0xfe, 0xfe, 0xfe, 0xff, 0xda, 0xda, 0xda, 0xff, 0xa0, 0xa0, 0xa0, 0xff,
+    0xee, 0xee, 0xee, 0xff, 0xe8, 0xe8, 0xe8, 0xff, 0xb9, 0xb9, 0xb9, 0xff
+};
+
+const std::vector<uint8_t> kRgb8KeyPng = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x05, 0x08, 0x02, 0x00, 0x00, 0x00, 0x0f, 0x13, 0xc1,
+    0xf5, 0x00, 0x00, 0x00, 0x06, 0x74, 0x52, 0x4e, 0x53, 0x00, 0x0a, 0x00, 0x14, 0x00, 0x1e, 0xc5,
+    0x36, 0x29, 0xff, 0x00, 0x00, 0x00, 0x3d, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x32, 0x00,
+    0xcd, 0xff, 0x00, 0x99, 0x7f, 0x5c, 0x7c, 0x29, 0x99, 0xfd, 0xaf, 0xe5, 0x01, 0x93, 0x25, 0x3c,
+    0x43, 0x2f, 0x73, 0x77, 0xa6, 0x28, 0x02, 0x81, 0x02, 0x64, 0x34, 0xc0, 0x6f, 0x9c, 0x29, 0x58,
+    0x03, 0x80, 0xdf, 0xd1, 0xd5, 0x1b, 0xc5, 0x0d, 0x65, 0x28, 0x04, 0x81, 0xfa, 0x94, 0x4b, 0x9d,
+    0x18, 0x8d, 0x34, 0xe2, 0x0c, 0x50, 0x15, 0x04, 0x3e, 0x55, 0x68, 0xea, 0x00, 0x00, 0x00, 0x00,
+    0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+const std::vector<uint8_t> kRgb8KeyRgba = {
+    0x99, 0x7f, 0x5c, 0xff, 0x7c, 0x29, 0x99, 0xff, 0xfd, 0xaf, 0xe5, 0xff, 0x93, 0x25, 0x3c, 0xff,
+    0xd6, 0x54, 0xaf, 0xff, 0x4d, 0xfa, 0xd7, 0xff, 0x14, 0x27, 0xa0, 0xff, 0x0a, 0x14, 0x1e, 0x00,
+    0xe9, 0x23, 0x2f, 0xff, 0x8a, 0xf2, 0x21, 0xff, 0x1f, 0x9e, 0xe4, 0xff, 0x91, 0xc5, 0xb1, 0xff,
+    0x0b, 0xec, 0xb5, 0xff, 0x56, 0x3b, 0xfc, 0xff, 0x1e, 0x6f, 0x93, 0xff
+};
+
+const std::vector<uint8_t> kRgb8StoredPng = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x05, 0x08, 0x02, 0x00, 0x00, 0x00, 0x0f, 0x13, 0xc1,
+    0xf5, 0x00, 0x00, 0x00, 0x3d, 0x49, 0x44, 0x41, 0x54, 0x78, 0x01, 0x01, 0x32, 0x00, 0xcd, 0xff,
+    0x00, 0x42, 0x7e, 0xcb, 0xc8, 0xfe, 0x29, 0x55, 0xe5, 0xcd, 0x01, 0x8e, 0x46, 0xdc, 0x00, 0x8e,
+    0xdb, 0x34, 0xa2, 0x96, 0x02, 0x9c, 0x14, 0x71, 0xe8, 0xa3, 0x4f, 0x36, 0xe7, 0x39, 0x03, 0x7b,
+    0xd5, 0x24, 0x53, 0x81, 0x7b, 0x59, 0x8e, 0x55, 0x04, 0x38, 0xc9, 0x82, 0xf3, 0x6a, 0x2a, 0x8d,
+    0x04, 0x6b, 0x53, 0x8a, 0x16, 0x67, 0x59, 0x9a, 0xd1, 0xcb, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+    0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+const std::vector<uint8_t> kRgb8StoredRgba = {
+    0x42, 0x7e, 0xcb, 0xff, 0xc8, 0xfe, 0x29, 0xff, 0x55, 0xe5, 0xcd, 0xff, 0x8e, 0x46, 0xdc, 0xff,
+    0x8e, 0xd4, 0xb7, 0xff, 0xc2, 0x76, 0x4d, 0xff, 0x2a, 0x5a, 0x4d, 0xff, 0x76, 0x77, 0x06, 0xff,
+    0xf8, 0x5d, 0x86, 0xff, 0x90, 0x02, 0x4a, 0xff, 0xd6, 0xbd, 0xa3, 0xff, 0x40, 0x1b, 0xe9, 0xff,
+    0xc8, 0xcb, 0xcc, 0xff, 0xc9, 0x35, 0xf6, 0xff, 0xcd, 0x1f, 0x61, 0xff
+};
+
+const std::vector<uint8_t> kPalette4Png = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x05, 0x04, 0x03, 0x00, 0x00, 0x00, 0x72, 0x5f, 0x4b,
+    0x91, 0x00, 0x00, 0x00, 0x0f, 0x50, 0x4c, 0x54, 0x45, 0xff, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00,
+    0x00, 0xff, 0x09, 0x08, 0x07, 0xc8, 0x64, 0x32, 0x07, 0x02, 0xcd, 0xf6, 0x00, 0x00, 0x00, 0x02,
+    0x74, 0x52, 0x4e, 0x53, 0x00, 0x80, 0x9b, 0x2b, 0x4e, 0x18, 0x00, 0x00, 0x00, 0x17, 0x49, 0x44,
+    0x41, 0x54, 0x78, 0xda, 0x63, 0x10, 0x54, 0x60, 0x64, 0xb1, 0x61, 0x92, 0x61, 0x60, 0x66, 0x62,
+    0x67, 0xf9, 0xc8, 0x00, 0x00, 0x08, 0x45, 0x01, 0x92, 0x38, 0x50, 0x20, 0x43, 0x00, 0x00, 0x00,
+    0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+const std::vector<uint8_t> kPalette4Rgba = {
+    0x00, 0xff, 0x00, 0x80, 0x00, 0xff, 0x00, 0x80, 0x00, 0x00, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00,
+    0xc8, 0x64, 0x32, 0xff, 0xc8, 0x64, 0x32, 0xff, 0x00, 0x00, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00,
+    0xc8, 0x64, 0x32, 0xff, 0x00, 0xff, 0x00, 0x80, 0x00, 0x00, 0xff, 0xff, 0x09, 0x08, 0x07, 0xff,
+    0xff, 0x00, 0x00, 0x00, 0x09, 0x08, 0x07, 0xff, 0x09, 0x08, 0x07, 0xff
+};
+
+const std::vector<uint8_t> kGrayAlpha8Png = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x05, 0x08, 0x04, 0x00, 0x00, 0x00, 0x2a, 0x78, 0x9e,
+    0x29, 0x00, 0x00, 0x00, 0x2c, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x98, 0xaf, 0xed, 0x69,
+    0xb2, 0xbe, 0x9d, 0xf1, 0x6b, 0x90, 0x98, 0xf8, 0xba, 0x47, 0x4c, 0x12, 0x6e, 0xca, 0x32, 0x4c,
+    0x5c, 0xcc, 0x1b, 0xd4, 0xcc, 0xbe, 0x6f, 0x12, 0x67, 0x11, 0x67, 0xda, 0xd0, 0x11, 0x2c, 0x04,
+    0x00, 0xc7, 0x80, 0x0a, 0xb7, 0xd6, 0x6f, 0x49, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e,
+    0x44, 0xae, 0x42, 0x60, 0x82
+};
+const std::vector<uint8_t> kGrayAlpha8Rgba = {
+    0x9f, 0x9f, 0x9f, 0x2b, 0x49, 0x49, 0x49, 0x34, 0xaf, 0xaf, 0xaf, 0x87, 0xf5, 0xf5, 0xf5, 0x52,
+    0x0b, 0x0b, 0x0b, 0x69, 0xb9, 0xb9, 0xb9, 0x4b, 0x0d, 0x0d, 0x0d, 0x98, 0x2e, 0x2e, 0x2e, 0x85,
+    0xbb, 0xbb, 0xbb, 0x55, 0xb6, 0xb6, 0xb6, 0x72, 0xa8, 0xa8, 0xa8, 0x72, 0x63, 0x63, 0x63, 0x7a,
+    0xcd, 0xcd, 0xcd, 0x74, 0x66, 0x66, 0x66, 0xfc, 0xb6, 0xb6, 0xb6, 0x0e
+};
+
+const std::vector<uint8_t> kRgba8SplitPng = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x05, 0x08, 0x06, 0x00, 0x00, 0x00, 0x80, 0x71, 0x56,
+    0xa2, 0x00, 0x00, 0x00, 0x26, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x41, 0x00, 0xbe, 0xff,
+    0x00, 0x0e, 0x8f, 0xf1, 0x84, 0x63, 0xb0, 0xe4, 0xb2, 0xba, 0x29, 0x70, 0x34, 0x01, 0x74, 0xf0,
+    0x64, 0xac, 0xf4, 0x07, 0x9c, 0x49, 0x48, 0x34, 0x3d, 0xd1, 0x02, 0xf2, 0x04, 0xf7, 0x32, 0x9f,
+    0xd2, 0x41, 0x00, 0x00, 0x00, 0x00, 0x26, 0x49, 0x44, 0x41, 0x54, 0x42, 0x35, 0xca, 0xf8, 0x1d,
+    0x00, 0x14, 0x91, 0x03, 0x0e, 0x94, 0x20, 0x7f, 0xd5, 0xd5, 0x28, 0x62, 0xb8, 0x7c, 0x85, 0xe1,
+    0x04, 0x06, 0xd0, 0x16, 0x7e, 0xc4, 0x8e, 0xb9, 0x46, 0x6d, 0x9c, 0x7d, 0x41, 0xbd, 0x3a, 0x1c,
+    0xd6, 0xd6, 0x4c, 0x14, 0x80, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60,
+    0x82
+};
+const std::vector<uint8_t> kRgba8SplitRgba = {
+    0x0e, 0x8f, 0xf1, 0x84, 0x63, 0xb0, 0xe4, 0xb2, 0xba, 0x29, 0x70, 0x34, 0x74, 0xf0, 0x64, 0xac,
+    0x68, 0xf7, 0x00, 0xf5, 0xb0, 0x2b, 0x3d, 0xc6, 0x66, 0xf4, 0x5b, 0xde, 0xaa, 0x2c, 0xca, 0xed,
+    0xcd, 0x2b, 0x51, 0x57, 0x41, 0x0e, 0x4d, 0xee, 0x4a, 0xf2, 0xb3, 0x4f, 0x43, 0x0a, 0x07, 0x34,
+    0x47, 0xde, 0x63, 0x6c, 0x0e, 0x80, 0x6c, 0x95, 0x7b, 0xa6, 0x84, 0xd6
+};
+
+const std::vector<uint8_t> kRgba16Png = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x05, 0x10, 0x06, 0x00, 0x00, 0x00, 0xd0, 0xe1, 0x8a,
+    0xe1, 0x00, 0x00, 0x00, 0x88, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x7d, 0x00, 0x82, 0xff,
+    0x00, 0x43, 0x1c, 0x1f, 0x2e, 0xb5, 0x23, 0xea, 0x94, 0xd7, 0x5c, 0x42, 0xf3, 0x4d, 0xbd, 0x09,
+    0x93, 0xe1, 0x58, 0x5d, 0xc0, 0x02, 0x03, 0x4c, 0xb2, 0x01, 0x58, 0x3d, 0x48, 0x7a, 0xf2, 0x6d,
+    0x3d, 0x9c, 0xc7, 0x61, 0x5e, 0x6d, 0x05, 0x9b, 0xf9, 0xb7, 0xfe, 0x79, 0xd9, 0x53, 0x6a, 0xea,
+    0x57, 0x75, 0x02, 0xbd, 0x5e, 0xea, 0x91, 0xf5, 0x16, 0xd1, 0xa8, 0x01, 0xd3, 0x3c, 0x0a, 0xaf,
+    0xae, 0x30, 0xc5, 0x70, 0xd4, 0x68, 0x5f, 0x93, 0xcf, 0xf1, 0x04, 0x03, 0x7a, 0x9c, 0x4e, 0xb4,
+    0x72, 0xe1, 0x3f, 0x14, 0x83, 0xa4, 0x9a, 0x70, 0x03, 0x77, 0x8c, 0x36, 0xf0, 0x2a, 0x93, 0xb5,
+    0x9d, 0x63, 0x2b, 0xbb, 0x04, 0xa1, 0x87, 0x05, 0x2c, 0xb6, 0xe3, 0xf8, 0x6e, 0xcb, 0xc2, 0x7d,
+    0x37, 0xae, 0x51, 0x9f, 0xf3, 0xf7, 0xf5, 0x34, 0x36, 0x27, 0x39, 0xaf, 0x9a, 0x55, 0x4a, 0x3c,
+    0x8d, 0x94, 0x15, 0x88, 0x39, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60,
+    0x82
+};
+const std::vector<uint8_t> kRgba16Rgba = {
+    0x43, 0x1f, 0xb5, 0xea, 0xd7, 0x42, 0x4d, 0x09, 0xe1, 0x5d, 0x02, 0x4c, 0x58, 0x48, 0xf2, 0x3d,
+    0x1f, 0xa6, 0xf7, 0x36, 0x1d, 0x7f, 0x61, 0x8d, 0x15, 0x32, 0xe7, 0x0e, 0x20, 0xe2, 0xa6, 0x66,
+    0x8d, 0xe7, 0xf4, 0x7e, 0x84, 0x67, 0xe5, 0x46, 0xd5, 0x3e, 0xc8, 0xe2, 0xa1, 0x25, 0x7b, 0xdb,
+    0x25, 0x6c, 0x9b, 0x3e, 0x4f, 0xbb, 0x49, 0x81, 0x46, 0xef, 0x70, 0x30
+};
+
+
+// zlib stream using a dynamic Huffman block; inflates to dynamicText().
+const std::vector<uint8_t> kDynamicDeflate = {
+    0x78, 0xda, 0x95, 0x95, 0x5b, 0x56, 0xc3, 0x30, 0x0c, 0x44, 0xff, 0x59, 0x85, 0x96, 0x60, 0x49,
+    0xb6, 0x63, 0xb3, 0x1b, 0x1e, 0x05, 0x5a, 0x1e, 0x86, 0xb4, 0xa5, 0xc0, 0xea, 0xe9, 0xb1, 0x26,
+    0x0b, 0x98, 0xef, 0xe4, 0x1e, 0x45, 0xd2, 0xd5, 0x64, 0x1d, 0x17, 0x49, 0xb7, 0x72, 0x7a, 0xd9,
+    0xc9, 0xd7, 0x79, 0xff, 0xf0, 0x2a, 0xf7, 0xeb, 0xb8, 0x7c, 0xc8, 0xd3, 0xf8, 0x91, 0xc3, 0xf9,
+    0xfd, 0xf3, 0x28, 0xe3, 0x7b, 0xb7, 0xce, 0xc7, 0x6f, 0x77, 0x7f, 0xbf, 0xf2, 0x38, 0x9e, 0x25,
+    0xdd, 0x5c, 0x5f, 0x11, 0xe5, 0x20, 0x9d, 0x90, 0x71, 0x50, 0x9e, 0x90, 0x73, 0x50, 0x9f, 0x50,
+    0x26, 0x3f, 0xaf, 0x4e, 0xaa, 0x70, 0x94, 0x95, 0x49, 0x55, 0x8e, 0xf2, 0xa8, 0xb5, 0x90, 0xb3,
+    0x88, 0xbe, 0x1a, 0x47, 0xd5, 0x18, 0x61, 0xe7, 0xa8, 0x16, 0xdb, 0x52, 0x52, 0x0c, 0x4d, 0x50,
+    0x83, 0x75, 0xc3, 0x50, 0x8f, 0xd4, 0x43, 0x73, 0x74, 0xa7, 0xce, 0x2e, 0x3b, 0x66, 0xa9, 0xac,
+    0x24, 0x3d, 0x36, 0xa7, 0xac, 0x26, 0xf0, 0x44, 0x2b, 0xab, 0x17, 0xea, 0x91, 0xaa, 0x58, 0x43,
+    0x7f, 0xa4, 0x2c, 0x6e, 0x98, 0x67, 0x67, 0x85, 0xc6, 0x75, 0x93, 0xbe, 0x64, 0xf8, 0x62, 0xa4,
+    0x2f, 0x39, 0xa3, 0x1e, 0x1b, 0x27, 0x2d, 0xfa, 0x33, 0xd2, 0x97, 0x62, 0x31, 0x4f, 0x23, 0x7d,
+    0x29, 0x4b, 0xec, 0xcf, 0x48, 0x5f, 0x2a, 0x7c, 0x31, 0xd2, 0x97, 0xba, 0xd5, 0x23, 0x7d, 0x59,
+    0xb6, 0xfe, 0x48, 0x5f, 0x96, 0x6d, 0x9e, 0x6c, 0xbc, 0x60, 0x7f, 0x4e, 0xfa, 0xd2, 0xe1, 0x8b,
+    0x93, 0xbe, 0x74, 0xf8, 0xe9, 0x6c, 0xbe, 0x24, 0x1c, 0x84, 0xb3, 0x01, 0x93, 0x70, 0x81, 0xce,
+    0x26, 0x8c, 0xe2, 0xe4, 0xbd, 0xb0, 0x11, 0x0a, 0x67, 0xbc, 0xb2, 0x20, 0x42, 0xcd, 0x49, 0x69,
+    0xd4, 0x91, 0xa2, 0xde, 0xe8, 0xd4, 0xc6, 0x54, 0x49, 0x6d, 0xb4, 0x5c, 0xff, 0x13, 0xff, 0xa8,
+    0x18, 0xf3, 0x9b
+};
+
+std::string dynamicText() {
+    std::string text;
+    for (int i = 0; i < 40; ++i) {
+        text += "row " + std::to_string(i) + ": the quick brown fox jumps over the lazy dog " +
+                std::to_string(i * i) + "\n";
+    }
+    return text;
+}
+
+uint32_t crc32(const uint8_t* data, size_t len) {
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; ++i) {
+        c ^= data[i];
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+// Recomputes the CRC of the chunk starting at `pos` after a test edits its body.
+void fixCrc(std::vector<uint8_t>& png, size_t pos) {
+    size_t len = (size_t(png[pos]) << 24) | (size_t(png[pos + 1]) << 16) |
+                 (size_t(png[pos + 2]) << 8) | size_t(png[pos + 3]);
+    uint32_t crc = crc32(png.data() + pos + 4, len + 4);
+    for (size_t i = 0; i < 4; ++i) png[pos + 8 + len + i] = static_cast<uint8_t>(crc >> (24 - 8 * i));
+}
+
+void checkDecode(const std::string& name, const std::vector<uint8_t>& png,
+                 const std::vector<uint8_t>& expected) {
+    std::vector<uint8_t> rgba;
+    int width = 0;
+    int height = 0;
+    bool ok = cdp::PngDecoder::decode(png.data(), png.size(), rgba, width, height);
+    CDP_CHECK_MSG(ok, name);
+    CDP_CHECK_MSG(width == 3 && height == 5, name);
+    CDP_CHECK_MSG(rgba == expected, name);
+}
+
+void testColorTypes() {
+    checkDecode("gray 1-bit", kGray1Png, kGray1Rgba);
+    checkDecode("gray 8-bit with tRNS key", kGray8KeyPng, kGray8KeyRgba);
+    checkDecode("gray 16-bit", kGray16Png, kGray16Rgba);
+    checkDecode("rgb 8-bit with tRNS key", kRgb8KeyPng, kRgb8KeyRgba);
+    checkDecode("rgb 8-bit stored blocks", kRgb8StoredPng, kRgb8StoredRgba);
+    checkDecode("palette 4-bit with tRNS", kPalette4Png, kPalette4Rgba);
+    checkDecode("gray+alpha 8-bit", kGrayAlpha8Png, kGrayAlpha8Rgba);
+    checkDecode("rgba 8-bit split IDAT", kRgba8SplitPng, kRgba8SplitRgba);
+    checkDecode("rgba 16-bit", kRgba16Png, kRgba16Rgba);
+}
+
+void testRowStreaming() {
+    cdp::PngDecoder decoder;
+    CDP_CHECK(decoder.open(kRgba8SplitPng));
+    std::vector<uint8_t> row(static_cast<size_t>(decoder.width()) * 4);
+    for (int y = 0; y < decoder.height(); ++y) {
+        CDP_CHECK(decoder.readRow(row.data()));
+        CDP_CHECK(std::equal(row.begin(), row.end(),
+                             kRgba8SplitRgba.begin() + static_cast<std::ptrdiff_t>(row.size()) * y));
+    }
+    CDP_CHECK(decoder.rowsRead() == 5);
+    CDP_CHECK(!decoder.readRow(row.data()));
+}
+
+void testCorruptInput() {
+    std::vector<uint8_t> rgba;
+    int width = 0;
+    int height = 0;
+
+    std::vector<uint8_t> badSignature = kGray8KeyPng;
+    badSignature[1] = 'X';
+    CDP_CHECK(!cdp::PngDecoder::decode(badSignature.data(), badSignature.size(), rgba, width, height));
+
+    std::vector<uint8_t> truncated(kRgba16Png.begin(), kRgba16Png.begin() + 60);
+    CDP_CHECK(!cdp::PngDecoder::decode(truncated.data(), truncated.size(), rgba, width, height));
+
+    std::vector<uint8_t> huge = kGray8KeyPng;
+    for (size_t i = 16; i < 24; ++i) huge[i] = i % 4 == 0 ? 0x00 : 0xff;
+    fixCrc(huge, 8);
+    cdp::PngDecoder hugeDecoder;
+    CDP_CHECK(!hugeDecoder.open(huge));
+    CDP_CHECK(hugeDecoder.error() == "Image too large");
+
+    cdp::PngDecoder limited;
+    limited.setMaxPixels(14);
+    CDP_CHECK(!limited.open(kGray8KeyPng));
+    CDP_CHECK(limited.error() == "Image too large");
+
+    cdp::PngDecoder exact;
+    exact.setMaxPixels(15);
+    CDP_CHECK(exact.open(kGray8KeyPng));
+
+    std::vector<uint8_t> badCrc = kGray8KeyPng;
+    badCrc[29] ^= 0x01;
+    cdp::PngDecoder crcDecoder;
+    CDP_CHECK(!crcDecoder.open(badCrc));
+    CDP_CHECK(crcDecoder.error() == "PNG chunk CRC mismatch");
+
+    // Flip a bit of the zlib Adler-32 trailer in the IDAT and re-seal the chunk CRC.
+    std::vector<uint8_t> badAdler = kGray8KeyPng;
+    size_t idat = 8 + 25 + 14;
+    size_t idatLen = badAdler[idat + 3];
+    badAdler[idat + 8 + idatLen - 1] ^= 0x01;
+    fixCrc(badAdler, idat);
+    cdp::PngDecoder adlerDecoder;
+    CDP_CHECK(adlerDecoder.open(badAdler));
+    std::vector<uint8_t> row(static_cast<size_t>(adlerDecoder.width()) * 4);
+    bool rowsOk = true;
+    for (int y = 0; y < adlerDecoder.height() && rowsOk; ++y) rowsOk = adlerDecoder.readRow(row.data());
+    CDP_CHECK(!rowsOk);
+    CDP_CHECK(adlerDecoder.error() == "Adler-32 checksum mismatch");
+}
+
+void testInflate() {
+    std::string expected = dynamicText();
+
+    std::vector<uint8_t> out;
+    CDP_CHECK(cdp::Inflater::inflate(kDynamicDeflate.data(), kDynamicDeflate.size(), out));
+    CDP_CHECK(std::string(out.begin(), out.end()) == expected);
+
+    // Feed the stream a byte at a time and drain in small reads.
+    cdp::Inflater inflater;
+    for (const uint8_t& byte : kDynamicDeflate) inflater.addInput(&byte, 1);
+    std::string streamed;
+    uint8_t buf[7];
+    while (size_t n = inflater.read(buf, sizeof(buf))) {
+        streamed.append(reinterpret_cast<const char*>(buf), n);
+    }
+    CDP_CHECK(!inflater.failed());
+    CDP_CHECK(inflater.done());
+    CDP_CHECK(streamed == expected);
+    CDP_CHECK(inflater.totalOut() == expected.size());
+
+    // Interleave input and output: short input suspends instead of failing.
+    cdp::Inflater resumable;
+    std::string resumed;
+    for (const uint8_t& byte : kDynamicDeflate) {
+        resumable.addInput(&byte, 1);
+        while (size_t n = resumable.read(buf, sizeof(buf))) {
+            resumed.append(reinterpret_cast<const char*>(buf), n);
+        }
+        CDP_CHECK(!resumable.failed());
+        if (resumable.done()) break;
+        CDP_CHECK(resumable.needsInput());
+    }
+    CDP_CHECK(resumable.done());
+    CDP_CHECK(resumed == expected);
+
+    cdp::Inflater truncated;
+    truncated.addInput(kDynamicDeflate.data(), kDynamicDeflate.size() - 10);
+    while (truncated.read(buf, sizeof(buf)) > 0) {}
+    CDP_CHECK(!truncated.failed());
+    CDP_CHECK(truncated.needsInput());
+    truncated.finish();
+    truncated.read(buf, sizeof(buf));
+    CDP_CHECK(truncated.failed());
+    CDP_CHECK(truncated.error() == "Unexpected end of compressed data");
+
+    std::vector<uint8_t> badAdler = kDynamicDeflate;
+    badAdler.back() ^= 0x01;
+    out.clear();
+    CDP_CHECK(!cdp::Inflater::inflate(badAdler.data(), badAdler.size(), out));
+    CDP_CHECK(std::string(out.begin(), out.end()) == expected);
+}
+
+}
+
+int main() {
+    testColorTypes();
+    testRowStreaming();
+    testCorruptInput();
+    testInflate();
+    return cdptest::finish("png_test");
+}
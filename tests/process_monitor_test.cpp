@@ -0,0 +1,85 @@
+// ProcessMonitor /proc/<pid>/stat parsing tests.
+// The lines are captured from Chrome processes; the live check samples the
+// test process itself and only runs on Linux.
+
+#include "TestUtil.hpp"
+#include <cdp/browser/ProcessMonitor.hpp>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using cdp::ProcessMonitor;
+using cdp::ProcStat;
+
+namespace {
+
+void testRendererLine() {
+    const std::string line =
+        "41230 (chrome) S 41187 41180 41180 0 -1 4194560 88213 0 12 0 1530 412 0 0 20 0 18 0 "
+        "9876543 1234567168 30512 18446744073709551615 1 1 0 0 0 0 0 4098 1098990847 0 0 0 17 3 "
+        "0 0 0 0 0 0 0 0 0 0 0 0 0\n";
+    ProcStat fields;
+    CDP_CHECK(ProcessMonitor::parseStat(line, fields));
+    CDP_CHECK(fields.command == "chrome");
+    CDP_CHECK(fields.parentPid == 41187);
+    CDP_CHECK(fields.cpuTicks == 1530 + 412);
+    CDP_CHECK(fields.threads == 18);
+    CDP_CHECK(fields.startTime == 9876543);
+    CDP_CHECK(fields.rssPages == 30512);
+}
+
+void testCommandWithSpacesAndParens() {
+    const std::string line =
+        "77 (Chrome (Helper) x) R 12 77 77 0 -1 0 0 0 0 0 7 3 0 0 20 0 4 0 555 1000 42 0";
+    ProcStat fields;
+    CDP_CHECK(ProcessMonitor::parseStat(line, fields));
+    CDP_CHECK(fields.command == "Chrome (Helper) x");
+    CDP_CHECK(fields.parentPid == 12);
+    CDP_CHECK(fields.cpuTicks == 10);
+    CDP_CHECK(fields.threads == 4);
+    CDP_CHECK(fields.startTime == 555);
+    CDP_CHECK(fields.rssPages == 42);
+}
+
+void testRejectsMalformed() {
+    ProcStat fields;
+    CDP_CHECK(!ProcessMonitor::parseStat("", fields));
+    CDP_CHECK(!ProcessMonitor::parseStat("12 chrome S 1 2 3", fields));
+    CDP_CHECK(!ProcessMonitor::parseStat("12 (chrome)", fields));
+    CDP_CHECK(!ProcessMonitor::parseStat("12 (chrome) S 1 2 3 4 5", fields));
+}
+
+#ifdef __linux__
+void testOwnProcess() {
+    std::ifstream in("/proc/self/stat");
+    std::string line((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    ProcStat fields;
+    CDP_CHECK(ProcessMonitor::parseStat(line, fields));
+    CDP_CHECK(fields.parentPid == static_cast<uint32_t>(getppid()));
+    CDP_CHECK(fields.threads >= 1 && fields.rssPages > 0 && fields.startTime > 0);
+
+    auto sample = ProcessMonitor::sampleTree(static_cast<uint32_t>(getpid()));
+    CDP_CHECK(!sample.processes.empty());
+    if (!sample.processes.empty()) {
+        CDP_CHECK(sample.processes[0].pid == static_cast<uint32_t>(getpid()));
+        CDP_CHECK(sample.processes[0].type == "browser");
+        CDP_CHECK(sample.rssBytes > 0 && sample.openFds > 0);
+    }
+}
+#endif
+
+}
+
+int main() {
+    testRendererLine();
+    testCommandWithSpacesAndParens();
+    testRejectsMalformed();
+#ifdef __linux__
+    testOwnProcess();
+#endif
+    return cdptest::finish("process_monitor_test");
+}
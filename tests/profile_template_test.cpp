@@ -0,0 +1,167 @@
+// Profile template clone and launcher fallback tests.
+// Templates are built by hand (files plus the marker) so Chrome is never
+// started; the launcher points at a stub executable that is never run.
+
+#include "TestUtil.hpp"
+#include <cdp/browser/ProfileTemplate.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using cdp::ChromeChannel;
+using cdp::ChromeLaunchOptions;
+using cdp::ChromeLauncher;
+using cdp::ProfileCloneStats;
+using cdp::ProfileDeleter;
+using cdp::ProfileTemplate;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const fs::path kRoot = fs::temp_directory_path() / "cdp_profile_template_test";
+
+void writeFile(const fs::path& path, const std::string& content) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << content;
+}
+
+std::string readFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+fs::path makeTemplate(const std::string& name, const ChromeLaunchOptions& options) {
+    fs::path dir = kRoot / name;
+    writeFile(dir / "Local State", "{\"browser\":{}}");
+    writeFile(dir / "Default" / "Preferences", std::string(300000, 'p'));
+    writeFile(dir / "Default" / "Extensions" / "abc" / "manifest.json", "{}");
+    fs::create_directories(dir / "Default" / "Empty");
+    writeFile(dir / ProfileTemplate::kMarkerFile, "1\n" + ProfileTemplate::extensionKey(options));
+    return dir;
+}
+
+size_t countEntries(const fs::path& dir) {
+    std::error_code ec;
+    if (!fs::exists(dir, ec)) return 0;
+    return static_cast<size_t>(std::distance(fs::directory_iterator(dir), fs::directory_iterator()));
+}
+
+void testCloneCopiesTree() {
+    ChromeLaunchOptions options;
+    ProfileTemplate profileTemplate(makeTemplate("plain", options).string());
+    CDP_CHECK(profileTemplate.isPrepared());
+
+    fs::path dest = kRoot / "clone";
+    ProfileCloneStats stats;
+    CDP_CHECK_MSG(profileTemplate.cloneTo(dest.string(), &stats), profileTemplate.lastError());
+    CDP_CHECK(stats.files == 3);
+    CDP_CHECK(stats.directories == 4);
+    CDP_CHECK(stats.bytes == 14 + 300000 + 2);
+    CDP_CHECK(readFile(dest / "Local State") == "{\"browser\":{}}");
+    CDP_CHECK(readFile(dest / "Default" / "Preferences").size() == 300000);
+    CDP_CHECK(fs::is_directory(dest / "Default" / "Empty"));
+    CDP_CHECK(!fs::exists(dest / ProfileTemplate::kMarkerFile));
+
+    ProfileTemplate missing((kRoot / "missing").string());
+    CDP_CHECK(!missing.isPrepared());
+    CDP_CHECK(!missing.cloneTo((kRoot / "clone-missing").string()));
+    CDP_CHECK(!missing.lastError().empty());
+}
+
+void testMatchesExtensionSet() {
+    writeFile(kRoot / "ext" / "a" / "manifest.json", "{}");
+    writeFile(kRoot / "ext" / "b" / "manifest.json", "{}");
+
+    ChromeLaunchOptions plain;
+    ChromeLaunchOptions withA;
+    withA.extensions = {(kRoot / "ext" / "a").string()};
+    ChromeLaunchOptions withAB;
+    withAB.extensions = {(kRoot / "ext" / "b").string(), (kRoot / "ext" / "a").string()};
+    ChromeLaunchOptions withBA;
+    withBA.extensions = {(kRoot / "ext" / "a").string(), (kRoot / "ext" / "b" / ".." / "b").string()};
+
+    CDP_CHECK(ProfileTemplate::extensionKey(plain).empty());
+    CDP_CHECK(ProfileTemplate::extensionKey(withAB) == ProfileTemplate::extensionKey(withBA));
+
+    ProfileTemplate plainTemplate(makeTemplate("plain", plain).string());
+    CDP_CHECK(plainTemplate.matches(plain));
+    CDP_CHECK(!plainTemplate.matches(withA));
+
+    ProfileTemplate abTemplate(makeTemplate("ab", withAB).string());
+    CDP_CHECK(abTemplate.matches(withBA));
+    CDP_CHECK(!abTemplate.matches(withA));
+    CDP_CHECK(!abTemplate.matches(plain));
+
+    ChromeLaunchOptions noIncognito = withAB;
+    noIncognito.extensionIncognitoEnabled = false;
+    CDP_CHECK(!abTemplate.matches(noIncognito));
+
+    writeFile(kRoot / "legacy" / ProfileTemplate::kMarkerFile, "1\n");
+    ProfileTemplate legacy((kRoot / "legacy").string());
+    CDP_CHECK(legacy.matches(plain) && !legacy.matches(withA));
+}
+
+#ifndef _WIN32
+void testLauncherRejectsUnusableTemplate() {
+    fs::path stub = kRoot / "bin" / "chrome";
+    writeFile(stub, "#!/bin/sh\nexit 1\n");
+    fs::permissions(stub, fs::perms::owner_all);
+
+    ChromeLaunchOptions options;
+    options.preferredChannel = ChromeChannel::Custom;
+    options.customChromePath = stub.string();
+    options.tempProfileRoot = (kRoot / "profiles").string();
+    options.tempProfilePrefix = "cdp_template_test_";
+    options.extensions = {(kRoot / "ext" / "a").string()};
+    fs::create_directories(options.tempProfileRoot);
+
+    options.profileTemplateDir = (kRoot / "unprepared").string();
+    {
+        ChromeLauncher launcher(options);
+        CDP_CHECK(!launcher.launch());
+        CDP_CHECK_MSG(launcher.lastError().find("not prepared") != std::string::npos, launcher.lastError());
+    }
+
+    options.profileTemplateDir = (kRoot / "plain").string();
+    {
+        ChromeLauncher launcher(options);
+        CDP_CHECK(!launcher.launch());
+        CDP_CHECK_MSG(launcher.lastError().find("different extensions") != std::string::npos,
+                      launcher.lastError());
+    }
+    ProfileDeleter::instance().flush();
+    CDP_CHECK(countEntries(options.tempProfileRoot) == 0);
+}
+#endif
+
+void testDeleterShutdown() {
+    fs::path victim = kRoot / "victim";
+    writeFile(victim / "Default" / "Preferences", "{}");
+    ProfileDeleter::instance().remove(victim.string());
+    ProfileDeleter::instance().shutdown();
+    CDP_CHECK(ProfileDeleter::instance().pending() == 0);
+    CDP_CHECK(!fs::exists(victim));
+
+    writeFile(victim / "Default" / "Preferences", "{}");
+    ProfileDeleter::instance().remove(victim.string());
+    ProfileDeleter::instance().flush();
+    CDP_CHECK(!fs::exists(victim));
+    ProfileDeleter::instance().shutdown();
+}
+
+}
+
+int main() {
+    std::error_code ec;
+    fs::remove_all(kRoot, ec);
+    testCloneCopiesTree();
+    testMatchesExtensionSet();
+#ifndef _WIN32
+    testLauncherRejectsUnusableTemplate();
+#endif
+    testDeleterShutdown();
+    fs::remove_all(kRoot, ec);
+    return cdptest::finish("profile_template_test");
+}
@@ -0,0 +1,135 @@
+// ResponseCache persistence tests.
+// Each case works in its own temporary directory and drives store()/lookup()
+// directly, without an interceptor.
+
+#include "TestUtil.hpp"
+#include <cdp/highlevel/ResponseCache.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cdp::highlevel::InterceptedRequest;
+using cdp::highlevel::ResponseCache;
+using cdp::highlevel::ResponseCacheOptions;
+
+namespace {
+
+std::filesystem::path freshDir(const std::string& name) {
+    auto dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(dir);
+    return dir;
+}
+
+InterceptedRequest response(const std::string& url) {
+    InterceptedRequest req;
+    req.method = "GET";
+    req.url = url;
+    req.responseStage = true;
+    req.responseStatusCode = 200;
+    req.responseHeaders = {{"Content-Type", "text/plain"}, {"Cache-Control", "max-age=600"}};
+    return req;
+}
+
+bool storeText(ResponseCache& cache, const std::string& url, const std::string& body) {
+    return cache.store(response(url), reinterpret_cast<const uint8_t*>(body.data()), body.size());
+}
+
+size_t countFiles(const std::filesystem::path& dir) {
+    size_t n = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) n += entry.is_regular_file();
+    return n;
+}
+
+void testPersistAndReopen() {
+    auto dir = freshDir("cdp_response_cache_reopen");
+    ResponseCacheOptions options;
+    options.directory = dir.string();
+    {
+        ResponseCache cache(options);
+        CDP_CHECK(cache.open().ok());
+        CDP_CHECK(storeText(cache, "https://example.com/a", "alpha"));
+        CDP_CHECK(storeText(cache, "https://example.com/b", "alpha"));
+        CDP_CHECK(cache.lookup(response("https://example.com/a")) != nullptr);
+        CDP_CHECK(cache.lookup(response("https://example.com/missing")) == nullptr);
+        auto stats = cache.stats();
+        CDP_CHECK(stats.entries == 2 && stats.bytes == 5 && stats.hits == 1 && stats.misses == 1);
+        CDP_CHECK(cache.flush().ok());
+    }
+    CDP_CHECK(countFiles(dir / "blobs") == 1);
+
+    ResponseCache reopened(options);
+    CDP_CHECK(reopened.open().ok());
+    CDP_CHECK(reopened.stats().entries == 2);
+    CDP_CHECK(reopened.lookup(response("https://example.com/b")) != nullptr);
+    std::filesystem::remove_all(dir);
+}
+
+void testOrphanedBlobsRemovedOnOpen() {
+    auto dir = freshDir("cdp_response_cache_orphans");
+    ResponseCacheOptions options;
+    options.directory = dir.string();
+    {
+        ResponseCache cache(options);
+        CDP_CHECK(cache.open().ok());
+        CDP_CHECK(storeText(cache, "https://example.com/kept", "kept"));
+        CDP_CHECK(cache.flush().ok());
+        CDP_CHECK(storeText(cache, "https://example.com/unflushed", "never indexed"));
+        cache.detach();
+        std::filesystem::copy_file(dir / "index.json", dir / "index.saved");
+    }
+    std::filesystem::rename(dir / "index.saved", dir / "index.json");
+    std::filesystem::create_directories(dir / "blobs" / "ab");
+    std::ofstream(dir / "blobs" / "ab" / "cdef.7.tmp") << "partial";
+    std::ofstream(dir / "blobs" / "stray") << "stray";
+    CDP_CHECK(countFiles(dir / "blobs") == 4);
+
+    ResponseCache cache(options);
+    CDP_CHECK(cache.open().ok());
+    CDP_CHECK(countFiles(dir / "blobs") == 1);
+    CDP_CHECK(cache.stats().entries == 1);
+    CDP_CHECK(cache.lookup(response("https://example.com/kept")) != nullptr);
+    CDP_CHECK(cache.lookup(response("https://example.com/unflushed")) == nullptr);
+
+    std::filesystem::remove(dir / "index.json");
+    ResponseCache unindexed(options);
+    CDP_CHECK(unindexed.open().ok());
+    CDP_CHECK(countFiles(dir / "blobs") == 0);
+    std::filesystem::remove_all(dir);
+}
+
+void testConcurrentStores() {
+    auto dir = freshDir("cdp_response_cache_concurrent");
+    ResponseCacheOptions options;
+    options.directory = dir.string();
+    ResponseCache cache(options);
+    CDP_CHECK(cache.open().ok());
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, t] {
+            for (int i = 0; i < 25; ++i) {
+                std::string url = "https://example.com/" + std::to_string(t) + "/" + std::to_string(i);
+                storeText(cache, url, "body " + std::to_string(i));
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    auto stats = cache.stats();
+    CDP_CHECK(stats.entries == 100);
+    CDP_CHECK(stats.errors == 0);
+    CDP_CHECK(countFiles(dir / "blobs") == 25);
+    CDP_CHECK(cache.lookup(response("https://example.com/3/24")) != nullptr);
+    std::filesystem::remove_all(dir);
+}
+
+}
+
+int main() {
+    testPersistAndReopen();
+    testOrphanedBlobsRemovedOnOpen();
+    testConcurrentStores();
+    return cdptest::finish("response_cache_test");
+}
@@ -0,0 +1,146 @@
+// ScreencastRecorder acking, buffering and stats tests.
+// Frames are pushed as Page.screencastFrame events on a scripted transport;
+// every frame must be acked even when it is dropped or evicted.
+
+#include "TestUtil.hpp"
+#include "FakeBrowser.hpp"
+#include <cdp/core/Base64.hpp>
+#include <cdp/highlevel/Screencast.hpp>
+#include <cdp/protocol/CDPClient.hpp>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+
+using cdp::Base64;
+using cdp::CDPClient;
+using cdp::CDPEvent;
+using cdp::highlevel::ScreencastFramePtr;
+using cdp::highlevel::ScreencastOptions;
+using cdp::highlevel::ScreencastRecorder;
+
+namespace {
+
+bool waitFor(const std::function<bool()>& condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+// Acks for session 3 fail so ackErrors has something to count.
+std::string respond(const cdptest::Command& command) {
+    if (command.method == "Page.screencastFrameAck" && command.params["sessionId"].getInt() == 3) {
+        return cdptest::ScriptedTransport::error("Unknown session");
+    }
+    return cdptest::ScriptedTransport::result();
+}
+
+void pushFrame(cdptest::ScriptedTransport& transport, int sessionId) {
+    std::string data = Base64::encode("frame-" + std::to_string(sessionId));
+    transport.push(R"({"method":"Page.screencastFrame","params":{"data":")" + data + R"(","sessionId":)" +
+                   std::to_string(sessionId) + R"(,"metadata":{"timestamp":0,"deviceWidth":800,)"
+                   R"("deviceHeight":600,"pageScaleFactor":1,"offsetTop":0,"scrollOffsetX":0,"scrollOffsetY":0}}})");
+}
+
+std::string text(const ScreencastFramePtr& frame) {
+    return frame ? std::string(frame->data.begin(), frame->data.end()) : std::string();
+}
+
+std::set<int> ackedSessions(const cdptest::ScriptedTransport& transport) {
+    std::set<int> sessions;
+    for (const auto& command : transport.commands()) {
+        if (command.method == "Page.screencastFrameAck") sessions.insert(command.params["sessionId"].getInt());
+    }
+    return sessions;
+}
+
+void testAcksAndRingEviction() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>(respond);
+    auto* transport = owned.get();
+    CDPClient client;
+    CDP_CHECK(client.connect(std::move(owned)));
+
+    ScreencastRecorder recorder(client);
+    ScreencastOptions options;
+    options.bufferFrames = 2;
+    CDP_CHECK(recorder.start(options).ok());
+    CDP_CHECK(transport->count("Page.startScreencast") == 1);
+
+    // A pool reset drops unscoped handlers; the recorder's must survive it.
+    client.connection().removeUnscopedEventHandlers();
+
+    for (int i = 1; i <= 5; ++i) pushFrame(*transport, i);
+    CDP_CHECK(waitFor([&] { return recorder.stats().framesDecoded == 5; }));
+    CDP_CHECK(waitFor([&] { return recorder.stats().ackErrors == 1; }));
+    CDP_CHECK(ackedSessions(*transport) == std::set<int>({1, 2, 3, 4, 5}));
+
+    auto frames = recorder.frames();
+    CDP_CHECK(frames.size() == 2);
+    if (frames.size() == 2) {
+        CDP_CHECK(text(frames[0]) == "frame-4" && text(frames[1]) == "frame-5");
+        CDP_CHECK(frames[0]->sequence == 4 && frames[1]->sequence == 5);
+        CDP_CHECK(frames[1]->deviceWidth == 800 && frames[1]->deviceHeight == 600);
+    }
+    CDP_CHECK(recorder.framesSince(4).size() == 1);
+    CDP_CHECK(text(recorder.latestFrame()) == "frame-5");
+    CDP_CHECK(recorder.waitForFrame(5, 20) == nullptr);
+
+    auto stats = recorder.stats();
+    CDP_CHECK(stats.framesReceived == 5 && stats.framesEvicted == 3 && stats.framesDropped == 0);
+
+    CDP_CHECK(recorder.stop().ok());
+    CDP_CHECK(transport->count("Page.stopScreencast") == 1);
+    CDP_CHECK(client.connection().eventHandlerMethods().empty());
+}
+
+void testPendingQueueDropsOldest() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>();
+    auto* transport = owned.get();
+    CDPClient client;
+    CDP_CHECK(client.connect(std::move(owned)));
+
+    ScreencastRecorder recorder(client);
+    ScreencastOptions options;
+    options.bufferFrames = 8;
+    options.maxPendingFrames = 1;
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::promise<void> firstDecoded;
+    bool first = true;
+    recorder.onFrame([&](const ScreencastFramePtr&) {
+        if (!first) return;
+        first = false;
+        firstDecoded.set_value();
+        released.wait();
+    });
+    CDP_CHECK(recorder.start(options).ok());
+
+    pushFrame(*transport, 1);
+    CDP_CHECK(firstDecoded.get_future().wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    for (int i = 2; i <= 4; ++i) pushFrame(*transport, i);
+    CDP_CHECK(waitFor([&] { return recorder.stats().framesReceived == 4; }));
+    release.set_value();
+
+    CDP_CHECK(waitFor([&] { return recorder.stats().framesDecoded == 2; }));
+    auto stats = recorder.stats();
+    CDP_CHECK(stats.framesDropped == 2 && stats.framesEvicted == 0);
+    CDP_CHECK(ackedSessions(*transport) == std::set<int>({1, 2, 3, 4}));
+    auto frames = recorder.frames();
+    CDP_CHECK(frames.size() == 2 && text(frames.back()) == "frame-4");
+    CDP_CHECK(recorder.stop().ok());
+}
+
+}
+
+int main() {
+    testAcksAndRingEviction();
+    testPendingQueueDropsOldest();
+    return cdptest::finish("screencast_test");
+}
@@ -0,0 +1,208 @@
+// Flat-session multiplexing tests.
+// A fake root transport stands in for the browser pipe, so routing by
+// sessionId can be checked without launching Chrome.
+
+#include "TestUtil.hpp"
+#include <cdp/net/SessionTransport.hpp>
+#include <cdp/protocol/CDPConnection.hpp>
+#include <cdp/core/Cbor.hpp>
+#include <cdp/core/Json.hpp>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+using cdp::Cbor;
+using cdp::CDPConnection;
+using cdp::CDPResponse;
+using cdp::JsonValue;
+using cdp::SessionRouter;
+using cdp::Transport;
+using cdp::TransportCallbacks;
+using cdp::WireFormat;
+
+namespace {
+
+class FakeTransport : public Transport {
+public:
+    explicit FakeTransport(WireFormat format = WireFormat::Json) : format_(format) {}
+
+    bool isConnected() const override { return connected_; }
+    bool send(const std::string& message) override {
+        sent.push_back(message);
+        return connected_;
+    }
+    int pollAll(int) override {
+        int count = 0;
+        while (!inbox.empty()) {
+            std::string message = std::move(inbox.front());
+            inbox.pop_front();
+            emitMessage(message);
+            count++;
+        }
+        return count;
+    }
+    void close() override { connected_ = false; }
+    WireFormat wireFormat() const override { return format_; }
+
+    void hangUp() {
+        connected_ = false;
+        emitClose("Pipe closed by browser");
+    }
+
+    std::deque<std::string> inbox;
+    std::vector<std::string> sent;
+
+private:
+    WireFormat format_;
+    bool connected_ = true;
+};
+
+struct Recorder {
+    std::vector<std::string> messages;
+    std::string closed;
+
+    TransportCallbacks callbacks() {
+        TransportCallbacks cb;
+        cb.onMessage = [this](const std::string& m) { messages.push_back(m); };
+        cb.onClose = [this](const std::string& r) { closed = r.empty() ? "closed" : r; };
+        return cb;
+    }
+};
+
+const std::string kSession = "8C1F3D5E7A9B0C2D4E6F8A1B3C5D7E9F";
+
+void testJsonSessionIds() {
+    std::string command = R"({"id":1,"method":"Page.enable","params":{}})";
+    std::string tagged = SessionRouter::withSessionId(command, kSession, WireFormat::Json);
+    CDP_CHECK(tagged == R"({"id":1,"method":"Page.enable","params":{},"sessionId":")" + kSession + "\"}");
+    CDP_CHECK(JsonValue::parse(tagged)["sessionId"].getString() == kSession);
+    CDP_CHECK(SessionRouter::sessionIdOf(tagged, WireFormat::Json) == kSession);
+    CDP_CHECK(SessionRouter::withSessionId(command, "", WireFormat::Json) == command);
+    CDP_CHECK(SessionRouter::withSessionId("{}", "S", WireFormat::Json) == R"({"sessionId":"S"})");
+
+    CDP_CHECK(SessionRouter::sessionIdOf(command, WireFormat::Json).empty());
+    CDP_CHECK(SessionRouter::sessionIdOf(
+        R"({"method":"Target.attachedToTarget","params":{"sessionId":"S9","waitingForDebugger":false}})",
+        WireFormat::Json).empty());
+    CDP_CHECK(SessionRouter::sessionIdOf(
+        R"({"method":"Target.attachedToTarget","params":{"sessionId":"S9"}})", WireFormat::Json).empty());
+    CDP_CHECK(SessionRouter::sessionIdOf(
+        R"({"id":3,"result":{"value":"\"sessionId\":\"S9"}})", WireFormat::Json).empty());
+    CDP_CHECK(SessionRouter::sessionIdOf(
+        R"({"method":"Page.loadEventFired","params":{"timestamp":1.5},"sessionId":"S7"})",
+        WireFormat::Json) == "S7");
+}
+
+void testCborSessionIds() {
+    JsonValue command = JsonValue::parse(R"({"id":1,"method":"Page.enable","params":{"a":[1,2]}})");
+    std::string encoded = Cbor::encode(command);
+    std::string tagged = SessionRouter::withSessionId(encoded, kSession, WireFormat::Cbor);
+
+    auto bytes = reinterpret_cast<const uint8_t*>(tagged.data());
+    CDP_CHECK(Cbor::messageSize(bytes, tagged.size()) == static_cast<int64_t>(tagged.size()));
+    JsonValue decoded = Cbor::decode(tagged);
+    CDP_CHECK(decoded["sessionId"].getString() == kSession);
+    CDP_CHECK(decoded["params"]["a"].asArray().size() == 2);
+    CDP_CHECK(SessionRouter::sessionIdOf(tagged, WireFormat::Cbor) == kSession);
+    CDP_CHECK(SessionRouter::sessionIdOf(SessionRouter::withSessionId(encoded, "S1", WireFormat::Cbor),
+                                         WireFormat::Cbor) == "S1");
+    CDP_CHECK(SessionRouter::sessionIdOf(encoded, WireFormat::Cbor).empty());
+
+    JsonValue nested = JsonValue::parse(R"({"method":"Target.attachedToTarget","params":{"sessionId":"S9"}})");
+    CDP_CHECK(SessionRouter::sessionIdOf(Cbor::encode(nested), WireFormat::Cbor).empty());
+}
+
+void testRouting() {
+    auto root = std::make_unique<FakeTransport>();
+    FakeTransport* pipe = root.get();
+    auto router = SessionRouter::create(std::move(root));
+
+    auto browser = router->open();
+    auto pageA = router->open("A");
+    auto pageB = router->open("B");
+    CDP_CHECK(browser && pageA && pageB);
+    CDP_CHECK(router->open("A") == nullptr);
+    CDP_CHECK(router->sessionCount() == 3);
+
+    Recorder browserRec, aRec, bRec;
+    browser->setCallbacks(browserRec.callbacks());
+    pageA->setCallbacks(aRec.callbacks());
+    pageB->setCallbacks(bRec.callbacks());
+
+    CDP_CHECK(pageA->send(R"({"id":1,"method":"Runtime.enable","params":{}})"));
+    CDP_CHECK(browser->send(R"({"id":1,"method":"Target.getTargets","params":{}})"));
+    CDP_CHECK(pipe->sent.size() == 2);
+    CDP_CHECK(SessionRouter::sessionIdOf(pipe->sent[0], WireFormat::Json) == "A");
+    CDP_CHECK(SessionRouter::sessionIdOf(pipe->sent[1], WireFormat::Json).empty());
+
+    pipe->inbox.push_back(R"({"id":1,"result":{},"sessionId":"A"})");
+    pipe->inbox.push_back(R"({"id":1,"result":{"targetInfos":[]}})");
+    pipe->inbox.push_back(R"({"method":"Page.frameNavigated","params":{},"sessionId":"B"})");
+    pipe->inbox.push_back(R"({"method":"Page.frameNavigated","params":{},"sessionId":"Z"})");
+    pipe->inbox.push_back(R"({"id":2,"result":{},"sessionId":"A"})");
+
+    CDP_CHECK(pageB->pollAll(0) == 1);
+    CDP_CHECK(browser->pollAll(0) == 1);
+    CDP_CHECK(pageA->pollAll(0) == 2);
+    CDP_CHECK(aRec.messages.size() == 2 && aRec.messages[1].find("\"id\":2") != std::string::npos);
+    CDP_CHECK(bRec.messages.size() == 1);
+    CDP_CHECK(browserRec.messages.size() == 1);
+
+    pipe->inbox.push_back(R"({"method":"Target.detachedFromTarget","params":{"sessionId":"A","targetId":"T"}})");
+    CDP_CHECK(browser->pollAll(0) == 1);
+    CDP_CHECK(pageA->pollAll(0) == 0);
+    CDP_CHECK(aRec.closed == "Session detached");
+    CDP_CHECK(!pageA->isConnected());
+    CDP_CHECK(!pageA->send(R"({"id":3,"method":"Runtime.enable","params":{}})"));
+    CDP_CHECK(router->sessionCount() == 2);
+
+    pageB->close();
+    CDP_CHECK(router->sessionCount() == 1);
+    auto reopened = router->open("B");
+    CDP_CHECK(reopened != nullptr);
+
+    pipe->hangUp();
+    CDP_CHECK(browser->pollAll(0) == 0);
+    CDP_CHECK(browserRec.closed == "Pipe closed by browser");
+    CDP_CHECK(!reopened->isConnected());
+}
+
+void testConnectionOverSession() {
+    auto root = std::make_unique<FakeTransport>();
+    FakeTransport* pipe = root.get();
+    auto router = SessionRouter::create(std::move(root));
+
+    CDPConnection connection;
+    CDP_CHECK(connection.connect(router->open(kSession)));
+
+    bool answered = false;
+    std::string value;
+    int64_t id = connection.sendCommand("Runtime.evaluate", JsonValue::parse(R"({"expression":"1+1"})"),
+        [&](const CDPResponse& resp) {
+            answered = true;
+            value = resp.result["result"]["value"].getString();
+        });
+    CDP_CHECK(id > 0);
+    CDP_CHECK(pipe->sent.size() == 1);
+    CDP_CHECK(SessionRouter::sessionIdOf(pipe->sent.back(), WireFormat::Json) == kSession);
+
+    pipe->inbox.push_back(R"({"id":)" + std::to_string(id) + R"(,"result":{"result":{"value":"other"}},"sessionId":"X"})");
+    pipe->inbox.push_back(R"({"id":)" + std::to_string(id) + R"(,"result":{"result":{"value":"two"}},"sessionId":")" +
+                          kSession + "\"}");
+    connection.poll(10);
+    CDP_CHECK(answered);
+    CDP_CHECK(value == "two");
+    connection.disconnect();
+    CDP_CHECK(router->sessionCount() == 0);
+}
+
+}
+
+int main() {
+    testJsonSessionIds();
+    testCborSessionIds();
+    testRouting();
+    testConnectionOverSession();
+    return cdptest::finish("session_transport_test");
+}
@@ -0,0 +1,222 @@
+// StreamReader pipelined IO.read tests and tracing sink lifetime.
+// The scripted stream holds IO.read replies and releases them in reverse
+// pairs, so the reader must reassemble chunks by sequence number.
+
+#include "TestUtil.hpp"
+#include "FakeBrowser.hpp"
+#include <cdp/highlevel/StreamReader.hpp>
+#include <cdp/highlevel/Utilities.hpp>
+#include <cdp/protocol/CDPConnection.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cdp::CDPConnection;
+using cdp::highlevel::PerformanceMonitor;
+using cdp::highlevel::Result;
+using cdp::highlevel::StreamReadOptions;
+using cdp::highlevel::StreamReader;
+namespace ErrorCode = cdp::highlevel::ErrorCode;
+
+namespace {
+
+const std::string kExpected = "aaaabbbbccccddddeeeeffff";
+
+// Six 4-byte chunks, alternately plain and base64; the last one carries eof.
+class ScriptedStream {
+public:
+    std::unique_ptr<cdptest::ScriptedTransport> create() {
+        auto owned = std::make_unique<cdptest::ScriptedTransport>([this](const cdptest::Command& command) {
+            return respond(command);
+        });
+        transport_ = owned.get();
+        return owned;
+    }
+
+    int reads() const { return reads_.load(); }
+
+private:
+    std::string respond(const cdptest::Command& command) {
+        if (command.method != "IO.read") return cdptest::ScriptedTransport::result();
+        if (command.params["handle"].getString() != "stream-1") {
+            return cdptest::ScriptedTransport::error("Invalid stream handle");
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        int index = reads_++;
+        held_.push_back(reply(command.id, index));
+        if (held_.size() == 2 || index >= 5) {
+            std::reverse(held_.begin(), held_.end());
+            for (const auto& message : held_) transport_->push(message);
+            held_.clear();
+        }
+        return "";
+    }
+
+    static std::string reply(int64_t id, int index) {
+        static const char* chunks[] = {"aaaa", "YmJiYg==", "cccc", "ZGRkZA==", "eeee", "ffff"};
+        std::string body;
+        if (index < 6) {
+            body = std::string(R"({"data":")") + chunks[index] + R"(","base64Encoded":)" +
+                   (index == 1 || index == 3 ? "true" : "false") + R"(,"eof":)" + (index == 5 ? "true" : "false") + "}";
+        } else {
+            body = R"({"data":"","eof":true})";
+        }
+        return "{\"id\":" + std::to_string(id) + ",\"result\":" + body + "}";
+    }
+
+    cdptest::ScriptedTransport* transport_ = nullptr;
+    std::mutex mutex_;
+    std::vector<std::string> held_;
+    std::atomic<int> reads_{0};
+};
+
+// Records the bytes and checks that no more than maxInFlight reads run ahead
+// of the chunk being written.
+struct BoundedSink {
+    const ScriptedStream& stream;
+    int maxInFlight;
+    std::string received;
+    int maxAhead = 0;
+
+    bool operator()(const uint8_t* data, size_t length) {
+        int chunk = static_cast<int>(received.size() / 4);
+        maxAhead = (std::max)(maxAhead, stream.reads() - chunk);
+        received.append(reinterpret_cast<const char*>(data), length);
+        return true;
+    }
+};
+
+void checkClosed(const cdptest::ScriptedTransport& transport) {
+    CDP_CHECK(transport.count("IO.close") == 1);
+    for (const auto& command : transport.commands()) {
+        if (command.method == "IO.close") CDP_CHECK(command.params["handle"].getString() == "stream-1");
+    }
+}
+
+void testReassemblesOutOfOrder(bool messageThread) {
+    ScriptedStream stream;
+    auto owned = stream.create();
+    auto* transport = owned.get();
+    CDPConnection connection;
+    CDP_CHECK(connection.connect(std::move(owned)));
+    if (messageThread) connection.startMessageThread();
+
+    StreamReadOptions options;
+    options.maxInFlight = 3;
+    options.chunkSize = 1;
+    options.timeoutMs = 5000;
+    BoundedSink sink{stream, options.maxInFlight};
+    auto result = StreamReader(connection).read("stream-1", std::ref(sink), options);
+
+    CDP_CHECK_MSG(result.ok(), result.ok() ? "" : result.error().message);
+    CDP_CHECK(result.ok() && result.value() == static_cast<int64_t>(kExpected.size()));
+    CDP_CHECK_MSG(sink.received == kExpected, sink.received);
+    CDP_CHECK_MSG(sink.maxAhead == options.maxInFlight, std::to_string(sink.maxAhead));
+    for (const auto& command : transport->commands()) {
+        if (command.method == "IO.read") CDP_CHECK(command.params["size"].getInt() == 4096);
+    }
+    checkClosed(*transport);
+    if (messageThread) connection.stopMessageThread();
+}
+
+void testSinkAbort() {
+    ScriptedStream stream;
+    auto owned = stream.create();
+    auto* transport = owned.get();
+    CDPConnection connection;
+    CDP_CHECK(connection.connect(std::move(owned)));
+    connection.startMessageThread();
+
+    int calls = 0;
+    auto result = StreamReader(connection).read("stream-1", [&](const uint8_t*, size_t) {
+        return ++calls < 2;
+    });
+    CDP_CHECK(!result.ok() && result.error().code == ErrorCode::Cancelled);
+    CDP_CHECK(calls == 2);
+    checkClosed(*transport);
+
+    auto invalid = StreamReader(connection).read("stream-2", [](const uint8_t*, size_t) { return true; });
+    CDP_CHECK(!invalid.ok() && invalid.error().code == ErrorCode::ProtocolError);
+    connection.stopMessageThread();
+}
+
+void testReadAsync() {
+    ScriptedStream stream;
+    auto owned = stream.create();
+    auto* transport = owned.get();
+    CDPConnection connection;
+    CDP_CHECK(connection.connect(std::move(owned)));
+    connection.startMessageThread();
+
+    StreamReadOptions options;
+    options.maxInFlight = 2;
+    auto sink = std::make_shared<BoundedSink>(BoundedSink{stream, options.maxInFlight});
+    std::promise<Result<int64_t>> done;
+    StreamReader(connection).readAsync("stream-1", [sink](const uint8_t* data, size_t length) {
+        return (*sink)(data, length);
+    }, options, [&done](const Result<int64_t>& result) { done.set_value(result); });
+
+    auto future = done.get_future();
+    CDP_CHECK(future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    auto result = future.get();
+    CDP_CHECK(result.ok() && result.value() == static_cast<int64_t>(kExpected.size()));
+    CDP_CHECK(sink->received == kExpected);
+    CDP_CHECK(sink->maxAhead <= options.maxInFlight);
+    checkClosed(*transport);
+    connection.stopMessageThread();
+}
+
+void testTracingInline() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>();
+    auto* transport = owned.get();
+    CDPConnection connection;
+    CDP_CHECK(connection.connect(std::move(owned)));
+    connection.startMessageThread();
+
+    transport->push(R"({"method":"Tracing.dataCollected","params":{"value":[{"name":"a"},{"name":"b"}]}})");
+    transport->push(R"({"method":"Tracing.tracingComplete","params":{}})");
+    auto trace = PerformanceMonitor(connection).stopTracing();
+    CDP_CHECK(trace.ok() && trace.value() == R"([{"name":"a"},{"name":"b"}])");
+    CDP_CHECK(connection.eventHandlerMethods().empty());
+    connection.stopMessageThread();
+}
+
+void testTracingTimeoutDetachesSink() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>();
+    auto* transport = owned.get();
+    CDPConnection connection;
+    CDP_CHECK(connection.connect(std::move(owned)));
+    connection.startMessageThread();
+
+    auto calls = std::make_shared<std::atomic<int>>(0);
+    auto result = PerformanceMonitor(connection).stopTracingToSink([calls](const uint8_t*, size_t) {
+        ++*calls;
+        return true;
+    }, {}, 50);
+    CDP_CHECK(!result.ok() && result.error().code == ErrorCode::Timeout);
+    CDP_CHECK(connection.eventHandlerMethods().empty());
+
+    transport->push(R"({"method":"Tracing.dataCollected","params":{"value":[{"name":"late"}]}})");
+    connection.sendCommandSync("Runtime.evaluate", 5000);
+    CDP_CHECK(*calls == 0);
+    connection.stopMessageThread();
+}
+
+}
+
+int main() {
+    testReassemblesOutOfOrder(true);
+    testReassemblesOutOfOrder(false);
+    testSinkAbort();
+    testReadAsync();
+    testTracingInline();
+    testTracingTimeoutDetachesSink();
+    return cdptest::finish("stream_reader_test");
+}
@@ -0,0 +1,145 @@
+// UrlMatcher tests: checks the compiled matcher against the std::regex
+// translation NetworkInterceptor used before it (case-insensitive
+// regex_search, '*' -> ".*", '?' -> ".").
+
+#include "TestUtil.hpp"
+#include <cdp/highlevel/UrlMatcher.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+using cdp::highlevel::UrlMatcher;
+
+namespace {
+
+std::regex legacyRegex(const std::string& pattern) {
+    std::string regexStr;
+    for (char c : pattern) {
+        switch (c) {
+            case '*': regexStr += ".*"; break;
+            case '?': regexStr += "."; break;
+            case '.': case '+': case '^': case '$': case '(': case ')':
+            case '[': case ']': case '{': case '}': case '|': case '\\':
+                regexStr += '\\';
+                regexStr += c;
+                break;
+            default: regexStr += c; break;
+        }
+    }
+    return std::regex(regexStr, std::regex::icase);
+}
+
+std::string randomString(std::mt19937& rng, const std::string& alphabet, size_t minLen, size_t maxLen) {
+    std::uniform_int_distribution<size_t> lenDist(minLen, maxLen);
+    std::uniform_int_distribution<size_t> charDist(0, alphabet.size() - 1);
+    std::string out(lenDist(rng), ' ');
+    for (auto& c : out) c = alphabet[charDist(rng)];
+    return out;
+}
+
+void testKnownPatterns() {
+    CDP_CHECK(UrlMatcher::globMatch("*.png", "https://example.com/logo.PNG"));
+    CDP_CHECK(UrlMatcher::globMatch("example.com/api/*", "https://example.com/api/v1"));
+    CDP_CHECK(UrlMatcher::globMatch("v?/users", "https://x/api/v2/users?id=1"));
+    CDP_CHECK(UrlMatcher::globMatch("", "https://anything"));
+    CDP_CHECK(UrlMatcher::globMatch("*", ""));
+    CDP_CHECK(!UrlMatcher::globMatch("*.png", "https://example.com/logo.jpg"));
+    CDP_CHECK(!UrlMatcher::globMatch("a*b*c", "https://cba"));
+    CDP_CHECK(!UrlMatcher::globMatch("v?/users", "https://x/api/v/users"));
+}
+
+void testEquivalenceWithRegex() {
+    std::mt19937 rng(20261018);
+    const std::string patternAlphabet = "abcAB./:?*?*";
+    const std::string urlAlphabet = "abcdABC./:";
+
+    for (int round = 0; round < 50; ++round) {
+        UrlMatcher matcher;
+        std::vector<std::string> patterns;
+        std::vector<std::regex> regexes;
+        for (uint64_t id = 0; id < 40; ++id) {
+            patterns.push_back(randomString(rng, patternAlphabet, 0, 6));
+            regexes.push_back(legacyRegex(patterns.back()));
+            matcher.add(id, patterns.back());
+        }
+        matcher.build();
+
+        std::vector<uint32_t> indices;
+        for (int u = 0; u < 60; ++u) {
+            std::string url = randomString(rng, urlAlphabet, 0, 24);
+
+            std::vector<uint64_t> expected;
+            for (uint64_t id = 0; id < patterns.size(); ++id) {
+                if (std::regex_search(url, regexes[id])) expected.push_back(id);
+            }
+
+            CDP_CHECK_MSG(matcher.match(url) == expected, "url=" + url);
+
+            matcher.matchIndices(url, indices);
+            CDP_CHECK(indices.size() == expected.size());
+            for (uint64_t id : expected) {
+                CDP_CHECK_MSG(UrlMatcher::globMatch(patterns[id], url),
+                              "pattern=" + patterns[id] + " url=" + url);
+            }
+        }
+    }
+}
+
+void testUnbuiltMatcher() {
+    UrlMatcher matcher;
+    matcher.add(7, "*/API/*");
+    matcher.add(9, "*.css");
+    CDP_CHECK((matcher.match("https://x/api/items") == std::vector<uint64_t>{7}));
+    matcher.build();
+    CDP_CHECK((matcher.match("https://x/api/site.CSS") == std::vector<uint64_t>{7, 9}));
+    matcher.clear();
+    CDP_CHECK(matcher.empty());
+    CDP_CHECK(matcher.match("https://x/api/items").empty());
+}
+
+void testCaseSensitive() {
+    UrlMatcher matcher(true);
+    matcher.add(1, "*/API/*");
+    matcher.add(2, "*.png");
+    matcher.add(3, "*x?z*");
+    for (bool built : {false, true}) {
+        if (built) matcher.build();
+        CDP_CHECK((matcher.match("https://host/API/a.png") == std::vector<uint64_t>{1, 2}));
+        CDP_CHECK(matcher.match("https://host/api/a.PNG").empty());
+        CDP_CHECK((matcher.match("https://host/xYz") == std::vector<uint64_t>{3}));
+        CDP_CHECK(matcher.match("https://host/XYZ").empty());
+    }
+    CDP_CHECK(UrlMatcher(true).caseSensitive());
+    CDP_CHECK(!UrlMatcher().caseSensitive());
+}
+
+void testEveryByteAsAnchor() {
+    // One anchor per byte value exercises the full character-class range.
+    UrlMatcher matcher;
+    for (int b = 1; b < 256; ++b) {
+        if (b == '*' || b == '?') continue;
+        matcher.add(static_cast<uint64_t>(b), std::string(1, static_cast<char>(b)) + "z");
+    }
+    matcher.build();
+    for (int b = 1; b < 256; ++b) {
+        if (b == '*' || b == '?') continue;
+        std::string url = "x" + std::string(1, static_cast<char>(b)) + "z";
+        auto ids = matcher.match(url);
+        CDP_CHECK_MSG(std::find(ids.begin(), ids.end(), static_cast<uint64_t>(b)) != ids.end(),
+                      "byte " + std::to_string(b));
+    }
+}
+
+}
+
+int main() {
+    testKnownPatterns();
+    testEquivalenceWithRegex();
+    testUnbuiltMatcher();
+    testCaseSensitive();
+    testEveryByteAsAnchor();
+    return cdptest::finish("url_matcher_test");
+}
@@ -0,0 +1,149 @@
+// MJPEG-in-AVI writer tests.
+// Frames are minimal JPEG headers; the test only checks the container layout
+// (RIFF sizes, movi chunks and the idx1 index), not the image data.
+
+#include "TestUtil.hpp"
+#include <cdp/highlevel/VideoWriter.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using cdp::highlevel::MjpegAviWriter;
+using cdp::highlevel::VideoWriterOptions;
+
+namespace {
+
+uint32_t read32(const std::vector<uint8_t>& data, size_t at) {
+    return static_cast<uint32_t>(data[at]) | static_cast<uint32_t>(data[at + 1]) << 8 |
+           static_cast<uint32_t>(data[at + 2]) << 16 | static_cast<uint32_t>(data[at + 3]) << 24;
+}
+
+bool fourcc(const std::vector<uint8_t>& data, size_t at, const char* expected) {
+    return at + 4 <= data.size() && std::memcmp(data.data() + at, expected, 4) == 0;
+}
+
+std::vector<uint8_t> jpeg(int width, int height, size_t padding) {
+    std::vector<uint8_t> out = {0xFF, 0xD8, 0xFF, 0xC0, 0x00, 0x11, 0x08,
+                                static_cast<uint8_t>(height >> 8), static_cast<uint8_t>(height),
+                                static_cast<uint8_t>(width >> 8), static_cast<uint8_t>(width)};
+    out.resize(out.size() + padding, 0x11);
+    out.push_back(0xFF);
+    out.push_back(0xD9);
+    return out;
+}
+
+std::vector<uint8_t> readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+struct Chunk {
+    size_t offset;
+    uint32_t size;
+};
+
+void testContainerLayout() {
+    const std::string path = "cdp_video_writer_test.avi";
+    VideoWriterOptions options;
+    options.fps = 10;
+
+    MjpegAviWriter writer;
+    CDP_CHECK(writer.open(path, options).ok());
+    CDP_CHECK(!writer.open(path, options).ok());
+
+    auto a = jpeg(32, 16, 20);
+    auto b = jpeg(32, 16, 7);
+    CDP_CHECK(writer.writeFrame(a.data(), a.size(), 100.0).ok());
+    CDP_CHECK(writer.writeFrame(b.data(), b.size(), 100.3).ok());
+    CDP_CHECK(writer.writeFrame(a.data(), a.size(), 100.31).ok());
+    CDP_CHECK(writer.writeFrame(b.data(), b.size(), 100.4).ok());
+    CDP_CHECK(!writer.writeFrame(nullptr, 0, 0).ok());
+
+    CDP_CHECK(writer.framesWritten() == 3);
+    CDP_CHECK(writer.framesSkipped() == 1);
+    CDP_CHECK(writer.frameCount() == 5);
+    CDP_CHECK(writer.close().ok());
+    CDP_CHECK(!writer.isOpen());
+
+    auto data = readFile(path);
+    std::remove(path.c_str());
+    CDP_CHECK(std::ifstream(path + ".idx.tmp").fail());
+    if (data.size() < 224) {
+        CDP_CHECK_MSG(false, "file too short: " + std::to_string(data.size()));
+        return;
+    }
+
+    CDP_CHECK(fourcc(data, 0, "RIFF"));
+    CDP_CHECK(read32(data, 4) == data.size() - 8);
+    CDP_CHECK(fourcc(data, 8, "AVI "));
+    CDP_CHECK(fourcc(data, 12, "LIST") && fourcc(data, 20, "hdrl"));
+    CDP_CHECK(fourcc(data, 24, "avih"));
+    CDP_CHECK(read32(data, 32) == 100000);
+    CDP_CHECK(read32(data, 32 + 16) == 5);
+    CDP_CHECK(read32(data, 32 + 32) == 32 && read32(data, 32 + 36) == 16);
+    CDP_CHECK(fourcc(data, 108, "vids") && fourcc(data, 112, "MJPG"));
+    CDP_CHECK(read32(data, 108 + 32) == 5);
+
+    CDP_CHECK(fourcc(data, 212, "LIST") && fourcc(data, 220, "movi"));
+    size_t moviEnd = 220 + read32(data, 216);
+    CDP_CHECK(moviEnd + 8 <= data.size());
+
+    std::vector<Chunk> chunks;
+    size_t pos = 224;
+    while (pos + 8 <= moviEnd) {
+        CDP_CHECK(fourcc(data, pos, "00dc"));
+        uint32_t size = read32(data, pos + 4);
+        chunks.push_back({pos, size});
+        pos += 8 + size + (size & 1u);
+    }
+    CDP_CHECK(pos == moviEnd);
+    CDP_CHECK(chunks.size() == 5);
+    if (chunks.size() == 5) {
+        CDP_CHECK(chunks[0].size == a.size());
+        CDP_CHECK(chunks[1].size == 0 && chunks[2].size == 0);
+        CDP_CHECK(chunks[3].size == b.size());
+        CDP_CHECK(chunks[4].size == b.size());
+        CDP_CHECK(data[chunks[0].offset + 8] == 0xFF && data[chunks[0].offset + 9] == 0xD8);
+    }
+
+    CDP_CHECK(fourcc(data, moviEnd, "idx1"));
+    uint32_t indexSize = read32(data, moviEnd + 4);
+    CDP_CHECK(indexSize == chunks.size() * 16);
+    CDP_CHECK(moviEnd + 8 + indexSize == data.size());
+    for (size_t i = 0; i < chunks.size() && moviEnd + 8 + i * 16 + 16 <= data.size(); ++i) {
+        size_t entry = moviEnd + 8 + i * 16;
+        CDP_CHECK(fourcc(data, entry, "00dc"));
+        CDP_CHECK(read32(data, entry + 4) == (chunks[i].size > 0 ? 0x10u : 0u));
+        CDP_CHECK(read32(data, entry + 8) == chunks[i].offset - 220);
+        CDP_CHECK(read32(data, entry + 12) == chunks[i].size);
+    }
+}
+
+void testRejectsInvalidInput() {
+    MjpegAviWriter writer;
+    auto frame = jpeg(8, 8, 0);
+    CDP_CHECK(!writer.writeFrame(frame.data(), frame.size()).ok());
+
+    VideoWriterOptions options;
+    options.fps = 0;
+    CDP_CHECK(!writer.open("cdp_video_writer_invalid.avi", options).ok());
+
+    const std::string path = "cdp_video_writer_notjpeg.avi";
+    CDP_CHECK(writer.open(path).ok());
+    uint8_t png[] = {0x89, 'P', 'N', 'G', 0, 0, 0, 0};
+    CDP_CHECK(!writer.writeFrame(png, sizeof(png)).ok());
+    CDP_CHECK(writer.close().ok());
+    std::remove(path.c_str());
+}
+
+}
+
+int main() {
+    testContainerLayout();
+    testRejectsInvalidInput();
+    return cdptest::finish("video_writer_test");
+}
@@ -0,0 +1,151 @@
+// Crash and hang detection tests.
+// A scripted transport leaves chosen commands unanswered; crashes arrive as
+// Inspector events and late probe replies are pushed by hand.
+
+#include "TestUtil.hpp"
+#include "FakeBrowser.hpp"
+#include <cdp/protocol/CDPClient.hpp>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+
+using cdp::CDPClient;
+using cdp::CDPClientConfig;
+using cdp::CDPErrorCategory;
+using cdp::CDPResponse;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool waitFor(const std::function<bool()>& condition, int timeoutMs = 5000) {
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!condition()) {
+        if (Clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+long long elapsedMs(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+}
+
+// Runtime.evaluate (the probe) and Page.navigate are never answered.
+std::string hangingResponder(const cdptest::Command& command) {
+    if (command.method == "Runtime.evaluate" || command.method == "Page.navigate") return "";
+    return cdptest::ScriptedTransport::result();
+}
+
+CDPClientConfig watchdogConfig(bool enabled, bool revive = false) {
+    CDPClientConfig config;
+    config.autoEnableDomains = false;
+    config.enableHeartbeat = false;
+    config.autoReconnect = false;
+    config.enableWatchdog = enabled;
+    config.watchdogIntervalMs = 100;
+    config.watchdogDeadlineMs = 60;
+    config.watchdogMissedProbes = 2;
+    config.watchdogReviveOnLateReply = revive;
+    return config;
+}
+
+int64_t probeId(const cdptest::ScriptedTransport& transport) {
+    int64_t id = -1;
+    for (const auto& command : transport.commands()) {
+        if (command.method == "Runtime.evaluate") id = command.id;
+    }
+    return id;
+}
+
+void testCrashFailsPendingCommands() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>(hangingResponder);
+    auto* transport = owned.get();
+    CDPClient client(watchdogConfig(false));
+    CDP_CHECK(client.connect(std::move(owned)));
+
+    auto start = Clock::now();
+    auto pending = std::async(std::launch::async, [&] {
+        return client.connection().sendCommandSync("Page.navigate", 10000);
+    });
+    CDP_CHECK(waitFor([&] { return transport->count("Page.navigate") == 1; }));
+    transport->push(R"({"method":"Inspector.targetCrashed","params":{}})");
+
+    CDP_CHECK(pending.wait_for(std::chrono::seconds(2)) == std::future_status::ready);
+    CDPResponse response = pending.get();
+    CDP_CHECK(response.hasError && response.errorCode == CDPResponse::TargetCrashedCode);
+    CDP_CHECK(response.errorCategory() == CDPErrorCategory::Crashed);
+    CDP_CHECK(elapsedMs(start) < 2000);
+    CDP_CHECK(client.connection().isTargetDead());
+    CDP_CHECK(client.connection().deadReason() == "Target crashed");
+
+    start = Clock::now();
+    auto after = client.connection().sendCommandSync("Page.enable", 10000);
+    CDP_CHECK(after.isCrashed() && elapsedMs(start) < 1000);
+}
+
+void testUnansweredProbeMarksDead() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>(hangingResponder);
+    auto* transport = owned.get();
+    CDPClient client(watchdogConfig(true));
+    std::atomic<int> deadCalls{0};
+    client.connection().onTargetDead([&](const std::string&) { deadCalls++; });
+
+    auto start = Clock::now();
+    CDP_CHECK(client.connect(std::move(owned)));
+    CDP_CHECK(waitFor([&] { return client.connection().isTargetDead(); }));
+    // First probe after one interval, then two missed deadlines.
+    CDP_CHECK(elapsedMs(start) >= 100 + 2 * 60);
+    CDP_CHECK(transport->count("Runtime.evaluate") == 1);
+    CDP_CHECK(client.connection().deadReason().find("unresponsive") != std::string::npos);
+    CDP_CHECK(deadCalls == 1);
+}
+
+void testLateReplyRevivesOnlyWhenEnabled() {
+    for (bool revive : {false, true}) {
+        auto owned = std::make_unique<cdptest::ScriptedTransport>(hangingResponder);
+        auto* transport = owned.get();
+        CDPClient client(watchdogConfig(true, revive));
+        CDP_CHECK(client.connect(std::move(owned)));
+        CDP_CHECK(waitFor([&] { return client.connection().isTargetDead(); }));
+
+        int64_t id = probeId(*transport);
+        CDP_CHECK(id >= 0);
+        transport->push("{\"id\":" + std::to_string(id) + ",\"result\":{\"result\":{\"type\":\"number\"}}}");
+        if (revive) {
+            CDP_CHECK(waitFor([&] { return !client.connection().isTargetDead(); }));
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(150));
+            CDP_CHECK(client.connection().isTargetDead());
+        }
+    }
+}
+
+void testPausedDebuggerSuspendsProbing() {
+    auto owned = std::make_unique<cdptest::ScriptedTransport>(hangingResponder);
+    auto* transport = owned.get();
+    CDPClient client(watchdogConfig(true));
+    transport->push(R"({"method":"Debugger.paused","params":{"reason":"other","callFrames":[]}})");
+    CDP_CHECK(client.connect(std::move(owned)));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    CDP_CHECK(!client.connection().isTargetDead());
+    CDP_CHECK(transport->count("Runtime.evaluate") == 0);
+
+    transport->push(R"({"method":"Debugger.resumed","params":{}})");
+    CDP_CHECK(waitFor([&] { return client.connection().isTargetDead(); }));
+}
+
+}
+
+int main() {
+    testCrashFailsPendingCommands();
+    testUnansweredProbeMarksDead();
+    testLateReplyRevivesOnlyWhenEnabled();
+    testPausedDebuggerSuspendsProbing();
+    return cdptest::finish("watchdog_test");
+}